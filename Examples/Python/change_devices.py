@@ -3,7 +3,8 @@
 """This example demonstrates changing device types
 
 The code loops through each device type and writes out a quilt image for
-each one.
+each one. It then writes the same quilts with `SaveQuilts()`, which renders
+the views shared by the device types only once.
 """
 
 import vtk
@@ -47,3 +48,7 @@ for device_type in renWin.GetDeviceTypes():
 
     # Write out the quilt
     renWin.SaveQuilt(f"quilt_{device_type}{suffix}.png")
+
+# Write the quilts for all device types from a single pass over the scene.
+# The files are named "quilt_all_<device_type><suffix>.png".
+renWin.SaveQuilts(renWin.GetDeviceTypes(), "quilt_all_")
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+
+"""This example demonstrates playing a quilt movie on the device
+
+The movie is decoded on a background thread while the render window keeps
+showing the frame that is due each time it renders. A repeating timer renders
+the window at the movie's frame rate. Pressing "space" switches between the
+movie and the live scene.
+
+Usage:
+
+    python play_quilt_movie.py quilt_qs5x9.avi
+"""
+
+import sys
+
+import vtk
+from vtk import vtkRenderingLookingGlass
+
+if len(sys.argv) < 2:
+    sys.exit(f"Usage: {sys.argv[0]} <quilt movie>")
+
+movie = sys.argv[1]
+
+renWin = vtkRenderingLookingGlass.vtkLookingGlassInterface.CreateLookingGlassRenderWindow()
+ren = vtk.vtkRenderer()
+renWin.AddRenderer(ren)
+
+# A live scene to switch to
+cone = vtk.vtkConeSource()
+coneMapper = vtk.vtkPolyDataMapper()
+coneMapper.SetInputConnection(cone.GetOutputPort())
+coneActor = vtk.vtkActor()
+coneActor.SetMapper(coneMapper)
+ren.AddActor(coneActor)
+
+iren = vtk.vtkRenderWindowInteractor()
+iren.SetRenderWindow(renWin)
+iren.Initialize()
+
+renWin.StartQuiltMoviePlayback(movie, True)
+
+
+def on_timer(obj, event):
+    renWin.Render()
+
+
+def on_key(obj, event):
+    if obj.GetKeySym() != "space":
+        return
+    if renWin.IsPlayingQuiltMovie():
+        renWin.StopQuiltMoviePlayback()
+    else:
+        renWin.StartQuiltMoviePlayback(movie, True)
+    renWin.Render()
+
+
+iren.AddObserver("TimerEvent", on_timer)
+iren.AddObserver("KeyPressEvent", on_key)
+iren.CreateRepeatingTimer(15)
+iren.Start()
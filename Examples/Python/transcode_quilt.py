@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+
+"""This example demonstrates converting existing quilt images to a new device
+
+Quilt images carry their tile layout in their file name, such as
+"quilt_qs5x9.png". This script reads such quilts, interpolates their views to
+the tile layout of another device type and writes the result with the
+matching suffix, without re-rendering the original scene. No GPU is needed,
+the tiles are converted in parallel on the CPU.
+
+Usage:
+
+    python transcode_quilt.py 32_gen3_l quilt_qs5x9.png [more quilts...]
+
+Frames of quilt movies can be converted the same way, one frame at a time.
+"""
+
+from pathlib import Path
+import sys
+
+import vtk
+from vtk import vtkRenderingLookingGlass
+
+Resampler = vtkRenderingLookingGlass.vtkLookingGlassQuiltResampler
+
+if len(sys.argv) < 3:
+    sys.exit(f"Usage: {sys.argv[0]} <device_type> <quilt files...>")
+
+device_type = sys.argv[1]
+
+resampler = Resampler()
+if not resampler.SetOutputDeviceType(device_type):
+    sys.exit(f"Unknown device type: {device_type}")
+
+# The views of the old quilts are assumed to have the aspect ratio of the
+# 16" device, which is what most "_qs5x9" quilts were rendered for.
+resampler.SetInputAspectRatio(1.777)
+
+reader = vtk.vtkPNGReader()
+writer = vtk.vtkPNGWriter()
+resampler.SetInputConnection(reader.GetOutputPort())
+writer.SetInputConnection(resampler.GetOutputPort())
+
+out_tiles = resampler.GetOutputTiles()
+out_suffix = f"_qs{out_tiles[0]}x{out_tiles[1]}"
+
+for file_name in sys.argv[2:]:
+    tiles = [0, 0]
+    if not Resampler.ParseQuiltFileSuffix(file_name, tiles):
+        print(f"Skipping {file_name}, no tile layout in its name")
+        continue
+
+    path = Path(file_name)
+    in_suffix = f"_qs{tiles[0]}x{tiles[1]}"
+    stem = path.stem[:path.stem.rfind(in_suffix)]
+    out_name = path.with_name(f"{stem}_{device_type}{out_suffix}.png")
+
+    reader.SetFileName(file_name)
+    resampler.SetInputTiles(tiles)
+    writer.SetFileName(str(out_name))
+    writer.Write()
+    print(f"Wrote {out_name}")
@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Helpers shared by the tests that save quilts: the scene they render, the
+// prefix of the files they write, and the comparison of two saved quilts.
+
+#ifndef LookingGlassTestUtilities_h
+#define LookingGlassTestUtilities_h
+
+#include "vtkActor.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPNGReader.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace LookingGlassTestUtilities
+{
+// Add an orange sphere over a blue background to the renderer.
+inline void AddSphere(vtkRenderer* renderer)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  actor->GetProperty()->SetColor(1.0, 0.5, 0.2);
+  renderer->AddActor(actor);
+  renderer->SetBackground(0.1, 0.2, 0.3);
+}
+
+// Return the prefix of the files a test writes to the temporary directory.
+inline std::string GetTemporaryPrefix(int argc, char* argv[], const std::string& testName)
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string prefix = std::string(tempDir) + "/" + testName;
+  delete[] tempDir;
+  return prefix;
+}
+
+// Compare two saved RGB quilts of the same size. At most `maxFraction` of
+// the values may differ by more than `tolerance`. Quilts of views rendered
+// with the same cameras at the same size only differ by a rounding step
+// along a few edges, which the defaults allow.
+inline bool CompareQuilts(const std::string& expectedFile, const std::string& actualFile,
+  int tolerance = 2, double maxFraction = 1.0 / 600.0)
+{
+  vtkNew<vtkPNGReader> expectedReader;
+  expectedReader->SetFileName(expectedFile.c_str());
+  expectedReader->Update();
+  vtkNew<vtkPNGReader> actualReader;
+  actualReader->SetFileName(actualFile.c_str());
+  actualReader->Update();
+  vtkImageData* expected = expectedReader->GetOutput();
+  vtkImageData* actual = actualReader->GetOutput();
+
+  int expectedDims[3];
+  int actualDims[3];
+  expected->GetDimensions(expectedDims);
+  actual->GetDimensions(actualDims);
+  if (expectedDims[0] != actualDims[0] || expectedDims[1] != actualDims[1] ||
+    expected->GetNumberOfScalarComponents() != 3 || actual->GetNumberOfScalarComponents() != 3)
+  {
+    std::cerr << actualFile << " is " << actualDims[0] << "x" << actualDims[1] << ", expected "
+              << expectedDims[0] << "x" << expectedDims[1] << " RGB\n";
+    return false;
+  }
+
+  const vtkIdType numberOfValues = static_cast<vtkIdType>(expectedDims[0]) * expectedDims[1] * 3;
+  const auto* e = static_cast<unsigned char*>(expected->GetScalarPointer());
+  const auto* a = static_cast<unsigned char*>(actual->GetScalarPointer());
+  vtkIdType differing = 0;
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+  {
+    if (std::abs(static_cast<int>(e[i]) - static_cast<int>(a[i])) > tolerance)
+    {
+      ++differing;
+    }
+  }
+  if (differing > maxFraction * numberOfValues)
+  {
+    std::cerr << actualFile << " differs from " << expectedFile << " by more than " << tolerance
+              << " in " << differing << " of " << numberOfValues << " values\n";
+    return false;
+  }
+  return true;
+}
+}
+
+#endif
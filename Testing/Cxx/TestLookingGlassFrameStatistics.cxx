@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Collects the statistics of a few frames rendered through a
+// vtkLookingGlassPass. Every frame must invoke one FrameEvent, and every
+// tile must have been timed by the rendering phases.
+
+#include "vtkActor.h"
+#include "vtkCallbackCommand.h"
+#include "vtkCamera.h"
+#include "vtkLookingGlassFrameStatistics.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkSphereSource.h"
+
+#include <iostream>
+
+namespace
+{
+void CountFrame(vtkObject*, unsigned long, void* clientData, void*)
+{
+  ++*static_cast<int*>(clientData);
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassFrameStatistics(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  vtkLookingGlassInterface* lgInterface = lgpass->GetInterface();
+  lgInterface->Initialize();
+  lgInterface->CollectStatisticsOn();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+  renderer->ResetCamera();
+
+  int frames = 0;
+  vtkNew<vtkCallbackCommand> observer;
+  observer->SetCallback(CountFrame);
+  observer->SetClientData(&frames);
+  lgInterface->AddObserver(vtkLookingGlassFrameStatistics::FrameEvent, observer);
+
+  const int numberOfFrames = 5;
+  for (int i = 0; i < numberOfFrames; ++i)
+  {
+    renderer->GetActiveCamera()->Azimuth(5.0);
+    renderWindow->Render();
+  }
+
+  vtkLookingGlassFrameStatistics* stats = lgInterface->GetStatistics();
+  if (frames != numberOfFrames || stats->GetNumberOfFrames() != numberOfFrames ||
+    stats->GetFrameNumber() != static_cast<vtkTypeUInt64>(numberOfFrames))
+  {
+    std::cerr << "Expected " << numberOfFrames << " frames, got " << frames << " events and "
+              << stats->GetNumberOfFrames() << " frames\n";
+    return EXIT_FAILURE;
+  }
+  if (stats->IsFrameOpen())
+  {
+    std::cerr << "The last frame was not closed by DrawLightField()\n";
+    return EXIT_FAILURE;
+  }
+
+  if (stats->GetAverageFrameTime() <= 0.0 ||
+    stats->GetFrameTimePercentile(95.0) < stats->GetFrameTimePercentile(50.0))
+  {
+    std::cerr << "Unexpected frame times\n";
+    return EXIT_FAILURE;
+  }
+  if (stats->GetAverageCPUTime(vtkLookingGlassFrameStatistics::TILE_RENDER) <= 0.0 ||
+    stats->GetLastBytes(vtkLookingGlassFrameStatistics::BLIT) <= 0 ||
+    stats->GetLastBytes(vtkLookingGlassFrameStatistics::INTERLACE) <= 0)
+  {
+    std::cerr << "The rendering phases were not timed\n";
+    return EXIT_FAILURE;
+  }
+
+  if (stats->GetNumberOfTiles() != lgInterface->GetNumberOfTiles())
+  {
+    std::cerr << "Expected " << lgInterface->GetNumberOfTiles() << " tiles, got "
+              << stats->GetNumberOfTiles() << "\n";
+    return EXIT_FAILURE;
+  }
+  for (int tile = 0; tile < stats->GetNumberOfTiles(); ++tile)
+  {
+    if (stats->GetAverageTileCPUTime(tile) <= 0.0)
+    {
+      std::cerr << "Tile " << tile << " was not timed\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // nothing is collected once the option is off
+  lgInterface->CollectStatisticsOff();
+  renderWindow->Render();
+  if (frames != numberOfFrames || stats->GetNumberOfFrames() != numberOfFrames)
+  {
+    std::cerr << "A frame was collected with the statistics off\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
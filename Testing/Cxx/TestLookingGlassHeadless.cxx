@@ -0,0 +1,83 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders quilts in an EGL or OSMesa Looking Glass window and saves one.
+// Without a device the light field must not be drawn, yet every frame must
+// be complete in the statistics as soon as it is rendered.
+
+#include "vtkActor.h"
+#include "vtkLookingGlassFrameStatistics.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderer.h"
+#include "vtkRenderingOpenGLConfigure.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include <vtksys/SystemTools.hxx>
+
+#ifdef VTK_OPENGL_HAS_EGL
+#include "vtkEGLLookingGlassRenderWindow.h"
+using HeadlessWindow = vtkEGLLookingGlassRenderWindow;
+#else
+#include "vtkOSOpenGLLookingGlassRenderWindow.h"
+using HeadlessWindow = vtkOSOpenGLLookingGlassRenderWindow;
+#endif
+
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassHeadless(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+
+  vtkNew<HeadlessWindow> renderWindow;
+  renderWindow->AddRenderer(renderer);
+  vtkLookingGlassInterface* lgInterface = renderWindow->GetInterface();
+  lgInterface->CollectStatisticsOn();
+  renderer->ResetCamera();
+
+  renderWindow->Render();
+  renderWindow->Render();
+
+  vtkLookingGlassFrameStatistics* stats = lgInterface->GetStatistics();
+  if (!lgInterface->IsDeviceConnected() &&
+    (stats->GetNumberOfFrames() != 2 || stats->IsFrameOpen() ||
+      stats->GetLastCPUTime(vtkLookingGlassFrameStatistics::INTERLACE) != 0.0))
+  {
+    std::cerr << "Expected 2 complete frames without interlacing, got "
+              << stats->GetNumberOfFrames() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName =
+    std::string(tempDir) + "/TestLookingGlassHeadless" + renderWindow->QuiltFileSuffix() + ".png";
+  delete[] tempDir;
+  vtksys::SystemTools::RemoveFile(fileName);
+
+  renderWindow->SaveQuilt(fileName.c_str());
+  if (!vtksys::SystemTools::FileExists(fileName, true))
+  {
+    std::cerr << "The quilt was not saved to " << fileName << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
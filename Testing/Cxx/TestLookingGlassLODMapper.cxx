@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Builds level of detail files from a colored point cloud and a sphere and
+// renders them in quilts. The nodes must be selected once per quilt rather
+// than once per tile, refined past the root, and kept within the budgets.
+
+#include "vtkActor.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassLODMapper.h"
+#include "vtkLookingGlassLODWriter.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPointData.h"
+#include "vtkPointSource.h"
+#include "vtkPolyData.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassLODMapper(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string cloudFile = std::string(tempDir) + "/TestLookingGlassLODCloud.lglod";
+  const std::string sphereFile = std::string(tempDir) + "/TestLookingGlassLODSphere.lglod";
+  delete[] tempDir;
+
+  // a point cloud colored by position
+  vtkNew<vtkPointSource> source;
+  source->SetNumberOfPoints(200000);
+  source->SetRadius(1.0);
+  source->Update();
+  vtkNew<vtkPolyData> cloud;
+  cloud->ShallowCopy(source->GetOutput());
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(cloud->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < cloud->GetNumberOfPoints(); ++i)
+  {
+    double p[3];
+    cloud->GetPoint(i, p);
+    for (int c = 0; c < 3; ++c)
+    {
+      colors->SetTypedComponent(i, c, static_cast<unsigned char>((p[c] + 1.0) * 127.0));
+    }
+  }
+  cloud->GetPointData()->SetScalars(colors);
+
+  vtkNew<vtkLookingGlassLODWriter> writer;
+  writer->SetFileName(cloudFile.c_str());
+  writer->SetMaximumPrimitivesPerNode(4096);
+  if (!writer->Write(cloud) || writer->GetNumberOfNodes() < 9)
+  {
+    std::cerr << "Unable to write the point cloud, " << writer->GetNumberOfNodes() << " nodes\n";
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkLookingGlassLODMapper> mapper;
+  mapper->SetFileName(cloudFile.c_str());
+  mapper->SynchronousLoadingOn();
+  mapper->SetPixelError(0.5);
+  const double* bounds = mapper->GetBounds();
+  const double* cloudBounds = cloud->GetBounds();
+  for (int i = 0; i < 6; ++i)
+  {
+    if (std::fabs(bounds[i] - cloudBounds[i]) > 1e-6)
+    {
+      std::cerr << "Wrong bounds from the file\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  vtkLookingGlassInterface* lgInterface = lgpass->GetInterface();
+  lgInterface->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+  mapper->SetInterface(lgInterface);
+  renderer->ResetCamera();
+
+  renderWindow->Render();
+  renderWindow->Render();
+  if (mapper->GetNumberOfSelections() != 2 || mapper->GetNumberOfRenderedNodes() <= 1 ||
+    mapper->GetNumberOfRenderedNodes() > mapper->GetNodeBudget() ||
+    mapper->GetNumberOfPendingNodes() != 0)
+  {
+    std::cerr << "Expected one refined selection per quilt, got " << mapper->GetNumberOfSelections()
+              << " selections of " << mapper->GetNumberOfRenderedNodes() << " nodes\n";
+    return EXIT_FAILURE;
+  }
+
+  // only the root fits, the nodes of the previous quilts are released
+  mapper->SetNodeBudget(1);
+  mapper->SetMaximumResidentNodes(1);
+  renderWindow->Render();
+  if (mapper->GetNumberOfRenderedNodes() != 1 || mapper->GetNumberOfRenderedPrimitives() > 4096 ||
+    mapper->GetNumberOfResidentNodes() > 9)
+  {
+    std::cerr << "The node budget was not respected: " << mapper->GetNumberOfRenderedNodes()
+              << " nodes drawn, " << mapper->GetNumberOfResidentNodes() << " loaded\n";
+    return EXIT_FAILURE;
+  }
+
+  // a surface
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(256);
+  sphere->SetPhiResolution(256);
+  sphere->Update();
+  writer->SetFileName(sphereFile.c_str());
+  if (!writer->Write(sphere->GetOutput()))
+  {
+    std::cerr << "Unable to write the sphere\n";
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkLookingGlassLODMapper> sphereMapper;
+  sphereMapper->SetFileName(sphereFile.c_str());
+  sphereMapper->SetInterface(lgInterface);
+  sphereMapper->SynchronousLoadingOn();
+  actor->SetMapper(sphereMapper);
+  renderer->ResetCamera();
+  renderWindow->Render();
+  if (sphereMapper->GetNumberOfSelections() != 1 || sphereMapper->GetNumberOfRenderedNodes() < 1 ||
+    sphereMapper->GetNumberOfRenderedPrimitives() == 0)
+  {
+    std::cerr << "The sphere was not rendered\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares a quilt with itself, then with the quilt of a coarser version of
+// the same sphere. The first comparison must find identical tiles and the
+// second must find every metric lower.
+
+#include "vtkActor.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkLookingGlassQualityAnalyzer.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQualityAnalyzer(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  vtkLookingGlassInterface* lgInterface = lgpass->GetInterface();
+  lgInterface->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+  renderer->ResetCamera();
+
+  vtkNew<vtkLookingGlassQualityAnalyzer> analyzer;
+  analyzer->SetRenderWindow(renderWindow);
+  analyzer->SetInterface(lgInterface);
+  analyzer->SetNumberOfFrames(3);
+
+  if (!analyzer->CaptureReference() || !analyzer->CaptureCandidate())
+  {
+    std::cerr << "Unable to capture the quilts\n";
+    return EXIT_FAILURE;
+  }
+  const int tiles = lgInterface->GetNumberOfTiles();
+  if (analyzer->GetTilePSNR()->GetNumberOfValues() != tiles ||
+    analyzer->GetTileSSIM()->GetNumberOfValues() != tiles ||
+    analyzer->GetMinimumPSNR() != vtkLookingGlassQualityAnalyzer::MaximumPSNR ||
+    analyzer->GetMinimumSSIM() < 0.999 || analyzer->GetInterlacedMaximumDifference() != 0 ||
+    analyzer->GetReferenceFrameTime() <= 0.0 || analyzer->GetCandidateFrameTime() <= 0.0)
+  {
+    std::cerr << "The same quilt compared as different: PSNR " << analyzer->GetMinimumPSNR()
+              << " SSIM " << analyzer->GetMinimumSSIM() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  sphere->SetThetaResolution(6);
+  sphere->SetPhiResolution(4);
+  if (!analyzer->CaptureCandidate())
+  {
+    std::cerr << "Unable to capture the coarse quilt\n";
+    return EXIT_FAILURE;
+  }
+  if (analyzer->GetMeanPSNR() >= vtkLookingGlassQualityAnalyzer::MaximumPSNR ||
+    analyzer->GetMeanSSIM() >= 1.0 || analyzer->GetInterlacedPSNR() >= analyzer->MaximumPSNR ||
+    analyzer->GetInterlacedMaximumDifference() == 0 ||
+    analyzer->GetInterlacedDifference()->GetNumberOfPoints() == 0)
+  {
+    std::cerr << "The coarse quilt compared as identical\n";
+    return EXIT_FAILURE;
+  }
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string fileName = std::string(tempDir) + "/TestLookingGlassQualityAnalyzer.json";
+  delete[] tempDir;
+  if (!analyzer->WriteResults(fileName.c_str()))
+  {
+    std::cerr << "Unable to write the results\n";
+    return EXIT_FAILURE;
+  }
+  vtksys::ifstream file(fileName.c_str());
+  Json::CharReaderBuilder builder;
+  Json::Value results;
+  std::string errors;
+  if (!Json::parseFromStream(builder, file, &results, &errors) ||
+    static_cast<int>(results["tiles"].size()) != tiles ||
+    std::fabs(results["meanPSNR"].asDouble() - analyzer->GetMeanPSNR()) > 1e-9)
+  {
+    std::cerr << "Invalid results: " << errors << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Records a camera path in segments split between two workers, the way
+// separate processes would, then resumes after a lost segment and joins
+// the segments. The joined sequence must hold the frames of the segments
+// unchanged.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCameraInterpolator.h"
+#include "vtkCellArray.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkLookingGlassQuiltAnimationRecorder.h"
+#include "vtkLookingGlassQuiltSequenceReader.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkTestUtilities.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+bool SameFrame(const char* fileA, int frameA, const char* fileB, int frameB)
+{
+  vtkNew<vtkLookingGlassQuiltSequenceReader> readers[2];
+  vtkNew<vtkImageData> quilts[2];
+  const char* files[2] = { fileA, fileB };
+  const int frames[2] = { frameA, frameB };
+  for (int i = 0; i < 2; ++i)
+  {
+    readers[i]->SetFileName(files[i]);
+    if (!readers[i]->Open() || !readers[i]->ReadFrame(frames[i], quilts[i]))
+    {
+      return false;
+    }
+  }
+  int* dims = quilts[0]->GetDimensions();
+  return std::memcmp(quilts[0]->GetScalarPointer(), quilts[1]->GetScalarPointer(),
+           static_cast<size_t>(dims[0]) * dims[1] * 3) == 0;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltAnimation(int argc, char* argv[])
+{
+  // a tetrahedron
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(0, 1, 0);
+  points->InsertNextPoint(0, 0, 1);
+  vtkNew<vtkCellArray> polys;
+  const vtkIdType faces[4][3] = { { 0, 2, 1 }, { 0, 1, 3 }, { 0, 3, 2 }, { 1, 2, 3 } };
+  for (const auto& face : faces)
+  {
+    polys->InsertNextCell(3, face);
+  }
+  vtkNew<vtkPolyData> tetrahedron;
+  tetrahedron->SetPoints(points);
+  tetrahedron->SetPolys(polys);
+
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputData(tetrahedron);
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->SetBackground(0.3, 0.4, 0.6);
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  lgpass->GetInterface()->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+
+  // half a turn around the tetrahedron
+  vtkNew<vtkCameraInterpolator> path;
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetFocalPoint(0.25, 0.25, 0.25);
+  camera->SetPosition(0.25, 0.25, 4.0);
+  renderer->ResetCameraClippingRange();
+  path->AddCamera(0.0, camera);
+  camera->Azimuth(180.0);
+  path->AddCamera(1.0, camera);
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestLookingGlassQuiltAnimation.lgq";
+  delete[] tempDir;
+
+  vtkNew<vtkLookingGlassQuiltAnimationRecorder> recorder;
+  recorder->SetRenderWindow(renderWindow);
+  recorder->SetInterface(lgpass->GetInterface());
+  recorder->SetCameraPath(path);
+  recorder->SetFileName(fileName.c_str());
+  recorder->SetNumberOfFrames(7);
+  recorder->SetSegmentSize(3);
+  recorder->SetNumberOfWorkers(2);
+  recorder->RemoveSegmentsOff();
+  for (int s = 0; s < recorder->GetNumberOfSegments(); ++s)
+  {
+    vtksys::SystemTools::RemoveFile(recorder->GetSegmentFileName(s));
+  }
+
+  // worker 0 records segments 0 and 2, worker 1 segment 1
+  int recorded[2];
+  for (int worker = 0; worker < 2; ++worker)
+  {
+    recorder->SetWorkerIndex(worker);
+    if (!recorder->Record())
+    {
+      return EXIT_FAILURE;
+    }
+    recorded[worker] = recorder->GetNumberOfSegmentsRecorded();
+  }
+  if (recorder->GetNumberOfSegments() != 3 || recorded[0] != 2 || recorded[1] != 1)
+  {
+    std::cerr << "The segments were not split between the workers\n";
+    return EXIT_FAILURE;
+  }
+
+  // a crash lost segment 1, only that one is recorded again
+  vtksys::SystemTools::RemoveFile(recorder->GetSegmentFileName(1));
+  for (int worker = 0; worker < 2; ++worker)
+  {
+    recorder->SetWorkerIndex(worker);
+    if (!recorder->Record() || recorder->GetNumberOfSegmentsRecorded() != worker ||
+      recorder->GetNumberOfSegmentsSkipped() != 2 - 2 * worker)
+    {
+      std::cerr << "Worker " << worker << " did not resume\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!recorder->ConcatenateSegments())
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->SetFileName(fileName.c_str());
+  if (!reader->Open() || reader->GetNumberOfFrames() != 7)
+  {
+    std::cerr << "The joined sequence does not have all the frames\n";
+    return EXIT_FAILURE;
+  }
+  reader->Close();
+
+  const std::string segment = recorder->GetSegmentFileName(1);
+  if (!SameFrame(fileName.c_str(), 4, segment.c_str(), 1) ||
+    SameFrame(fileName.c_str(), 0, fileName.c_str(), 6))
+  {
+    std::cerr << "The joined frames do not match the segments\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders the quilt in each storage format, switching between them in an
+// order where a texture that kept the format of its previous allocation
+// would be caught, with and without trimming, and with 24 and 32 bit depth
+// buffers. The memory estimates must match what the settings allocate, and
+// unknown device types must be reported.
+
+#include "vtkActor.h"
+#include "vtkCommand.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLFramebufferObject.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkOpenGLState.h"
+#include "vtkPNGReader.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTestUtilities.h"
+#include "vtkTextureObject.h"
+#include "vtk_glad.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+// the bits of the red and alpha channels of the quilt texture as allocated
+void GetQuiltBits(vtkLookingGlassInterface* lgInterface, vtkOpenGLRenderWindow* rw,
+  int& red, int& alpha, int size[2])
+{
+  vtkOpenGLFramebufferObject* renderFramebuffer;
+  vtkOpenGLFramebufferObject* quiltFramebuffer;
+  lgInterface->GetFramebuffers(rw, renderFramebuffer, quiltFramebuffer);
+  vtkTextureObject* texture = quiltFramebuffer->GetColorAttachmentAsTextureObject(0);
+  texture->Activate();
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_RED_SIZE, &red);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_ALPHA_SIZE, &alpha);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &size[0]);
+  glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &size[1]);
+  texture->Deactivate();
+}
+
+// the bits of the depth buffer the tiles are rendered into
+int GetRenderDepthBits(vtkLookingGlassInterface* lgInterface, vtkOpenGLRenderWindow* rw)
+{
+  vtkOpenGLFramebufferObject* renderFramebuffer;
+  vtkOpenGLFramebufferObject* quiltFramebuffer;
+  lgInterface->GetFramebuffers(rw, renderFramebuffer, quiltFramebuffer);
+  rw->GetState()->PushFramebufferBindings();
+  renderFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
+  int depth = 0;
+  glGetFramebufferAttachmentParameteriv(
+    GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth);
+  rw->GetState()->PopFramebufferBindings();
+  return depth;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltFormats(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+
+  // a 2048x2048 quilt of 4x8 tiles of 512x256
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType("standard");
+  lgInterface->Initialize();
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->SetSize(renderSize);
+  renderWindow->AddRenderer(renderer);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+  renderer->ResetCamera();
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string fileName = std::string(tempDir) + "/TestLookingGlassQuiltFormats.png";
+  delete[] tempDir;
+
+  const vtkTypeInt64 quiltPixels = 2048 * 2048;
+  const vtkTypeInt64 tilePixels = 512 * 256;
+  // a 32 bit depth buffer takes 8 bytes when it holds a stencil
+  const vtkTypeInt64 tileBytes = 4 + (rw->GetStencilCapable() ? 8 : 4);
+
+  struct Format
+  {
+    int Format;
+    const char* Name;
+    int Red;
+    int Alpha;
+    int Bytes;
+  };
+  const Format formats[] = {
+    { vtkLookingGlassInterface::RGBA16F, "RGBA16F", 16, 16, 8 },
+    { vtkLookingGlassInterface::RGBA8, "RGBA8", 8, 8, 4 },
+    { vtkLookingGlassInterface::RGB8, "RGB8", 8, 0, 3 },
+    { vtkLookingGlassInterface::RGB10A2, "RGB10A2", 10, 2, 4 },
+    { vtkLookingGlassInterface::RGB8, "RGB8", 8, 0, 3 },
+    { vtkLookingGlassInterface::RGBA8, "RGBA8", 8, 8, 4 },
+  };
+  for (const Format& format : formats)
+  {
+    lgInterface->SetQuiltFormat(format.Format);
+    lgInterface->RenderQuilt(rw);
+
+    int red = 0;
+    int alpha = 0;
+    int size[2] = { 0, 0 };
+    GetQuiltBits(lgInterface, rw, red, alpha, size);
+    if (red != format.Red || alpha != format.Alpha || size[0] != 2048 || size[1] != 2048)
+    {
+      std::cerr << format.Name << " quilt allocated with " << red << " red and " << alpha
+                << " alpha bits at " << size[0] << "x" << size[1] << "\n";
+      return EXIT_FAILURE;
+    }
+
+    // the quilt is saved as RGB whatever its format
+    lgInterface->SaveQuilt(fileName.c_str());
+    vtkNew<vtkPNGReader> reader;
+    reader->SetFileName(fileName.c_str());
+    reader->Update();
+    int dims[3];
+    reader->GetOutput()->GetDimensions(dims);
+    if (dims[0] != 2048 || dims[1] != 2048 ||
+      reader->GetOutput()->GetNumberOfScalarComponents() != 3)
+    {
+      std::cerr << format.Name << " quilt saved as " << dims[0] << "x" << dims[1] << "\n";
+      return EXIT_FAILURE;
+    }
+
+    const vtkTypeInt64 expected = quiltPixels * format.Bytes + tilePixels * tileBytes;
+    const vtkTypeInt64 estimate = lgInterface->GetEstimatedGPUMemory("standard", rw);
+    if (estimate != expected)
+    {
+      std::cerr << format.Name << " estimate is " << estimate << " bytes, expected " << expected
+                << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // the depth of the tiles
+  if (GetRenderDepthBits(lgInterface, rw) != 32 ||
+    lgInterface->GetRenderTargetMemory() != tilePixels * tileBytes)
+  {
+    std::cerr << "Expected 32 bit depth tiles\n";
+    return EXIT_FAILURE;
+  }
+  lgInterface->SetRenderDepthBits(24);
+  lgInterface->RenderQuilt(rw);
+  if (GetRenderDepthBits(lgInterface, rw) != 24 ||
+    lgInterface->GetRenderTargetMemory() != tilePixels * 8 ||
+    lgInterface->GetEstimatedGPUMemory("standard", rw) != quiltPixels * 4 + tilePixels * 8)
+  {
+    std::cerr << "Expected 24 bit depth tiles\n";
+    return EXIT_FAILURE;
+  }
+
+  // 819x455 tiles leave a pixel unused along the right and top of the large
+  // quilt, which trimming drops
+  if (lgInterface->GetEstimatedHostMemory("large") != 4096 * 4096 * 3)
+  {
+    std::cerr << "Wrong host memory estimate for an untrimmed quilt\n";
+    return EXIT_FAILURE;
+  }
+  lgInterface->TrimQuiltToTilesOn();
+  if (lgInterface->GetEstimatedHostMemory("large") != 4095 * 4095 * 3 ||
+    lgInterface->GetEstimatedGPUMemory("large") != 4095 * 4095 * 4 + 819 * 455 * 8)
+  {
+    std::cerr << "Wrong estimates for a trimmed quilt\n";
+    return EXIT_FAILURE;
+  }
+
+  // no estimate for a device that does not exist
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  lgInterface->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  if (lgInterface->GetEstimatedGPUMemory("none") != -1 || !errorObserver->GetError())
+  {
+    std::cerr << "Expected an error for the GPU memory of an unknown device\n";
+    return EXIT_FAILURE;
+  }
+  errorObserver->Clear();
+  if (lgInterface->GetEstimatedHostMemory("none") != -1 || !errorObserver->GetError())
+  {
+    std::cerr << "Expected an error for the host memory of an unknown device\n";
+    return EXIT_FAILURE;
+  }
+  lgInterface->ReleaseGraphicsResources(rw);
+
+  vtkNew<vtkLookingGlassInterface> large;
+  large->SetDeviceType("large");
+  large->TrimQuiltToTilesOn();
+  large->Initialize();
+  large->GetRenderSize(renderSize);
+  renderWindow->SetSize(renderSize);
+  large->RenderQuilt(rw);
+  int red = 0;
+  int alpha = 0;
+  int size[2] = { 0, 0 };
+  GetQuiltBits(large, rw, red, alpha, size);
+  int textureSize[2];
+  large->GetQuiltTextureSize(textureSize);
+  if (size[0] != 4095 || size[1] != 4095 || textureSize[0] != 4095 || textureSize[1] != 4095)
+  {
+    std::cerr << "The trimmed quilt is " << size[0] << "x" << size[1] << "\n";
+    return EXIT_FAILURE;
+  }
+
+  large->ReleaseGraphicsResources(rw);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Plays quilt sequence files on a window. Every quilt uploaded must be one
+// of the frames of the movie, a looping movie must start over, and when the
+// display falls far behind a short movie every frame must either be shown
+// or counted as dropped.
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassQuiltSequenceWriter.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkTestUtilities.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+// Each frame is a gradient shifted by the frame number, its blue channel
+// tells which frame it is.
+void FillQuilt(vtkImageData* quilt, int frame)
+{
+  int* dims = quilt->GetDimensions();
+  auto* pixel = static_cast<unsigned char*>(quilt->GetScalarPointer());
+  for (int y = 0; y < dims[1]; ++y)
+  {
+    for (int x = 0; x < dims[0]; ++x)
+    {
+      *pixel++ = static_cast<unsigned char>(x + 7 * frame);
+      *pixel++ = static_cast<unsigned char>(y);
+      *pixel++ = static_cast<unsigned char>(10 + 20 * frame);
+    }
+  }
+}
+
+bool WriteMovie(const std::string& fileName, int firstFrame, int numberOfFrames,
+  double frameRate, const int size[2])
+{
+  vtkNew<vtkImageData> quilt;
+  quilt->SetDimensions(size[0], size[1], 1);
+  quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+
+  vtkNew<vtkLookingGlassQuiltSequenceWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetQuiltTiles(4, 8);
+  writer->SetDeviceType("standard");
+  writer->SetFrameRate(frameRate);
+  if (!writer->Start())
+  {
+    std::cerr << "Unable to start writing " << fileName << "\n";
+    return false;
+  }
+  for (int frame = firstFrame; frame < firstFrame + numberOfFrames; ++frame)
+  {
+    FillQuilt(quilt, frame);
+    if (!writer->Write(quilt))
+    {
+      std::cerr << "Unable to write frame " << frame << "\n";
+      return false;
+    }
+  }
+  return writer->End();
+}
+
+// Return the frame held by the quilt, -1 if it holds none of them.
+int GetShownFrame(
+  vtkLookingGlassInterface* lgInterface, vtkImageData* image, vtkImageData* expected)
+{
+  lgInterface->ReadQuilt(image);
+  const auto* pixels = static_cast<unsigned char*>(image->GetScalarPointer());
+  if (pixels[2] < 10 || (pixels[2] - 10) % 20 != 0)
+  {
+    return -1;
+  }
+  int frame = (pixels[2] - 10) / 20;
+
+  FillQuilt(expected, frame);
+  const auto* e = static_cast<unsigned char*>(expected->GetScalarPointer());
+  const vtkIdType numberOfValues = expected->GetNumberOfPoints() * 3;
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+  {
+    if (pixels[i] != e[i])
+    {
+      std::cerr << "The quilt differs from frame " << frame << " at value " << i << "\n";
+      return -1;
+    }
+  }
+  return frame;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltMoviePlayback(int argc, char* argv[])
+{
+  // a 2048x2048 quilt of 4x8 tiles
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType("standard");
+  lgInterface->Initialize();
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+  int size[2];
+  lgInterface->GetQuiltTextureSize(size);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->SetSize(renderSize);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string prefix = std::string(tempDir) + "/TestLookingGlassQuiltMoviePlayback";
+  delete[] tempDir;
+
+  // frames 0 to 2 loop, frames 3 to 12 are over in a tenth of a second
+  const std::string loopFile = prefix + "_loop.lgq";
+  const std::string shortFile = prefix + "_short.lgq";
+  if (!WriteMovie(loopFile, 0, 3, 20.0, size) || !WriteMovie(shortFile, 3, 10, 100.0, size))
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkImageData> image;
+  vtkNew<vtkImageData> expected;
+  expected->SetDimensions(size[0], size[1], 1);
+  expected->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+
+  // the frames come in order and start over after the last one
+  if (!lgInterface->StartQuiltMoviePlayback(loopFile.c_str(), true))
+  {
+    std::cerr << "Unable to play " << loopFile << "\n";
+    return EXIT_FAILURE;
+  }
+  auto start = std::chrono::steady_clock::now();
+  int lastFrame = -1;
+  bool loopedOver = false;
+  while (std::chrono::steady_clock::now() - start < std::chrono::seconds(2) && !loopedOver)
+  {
+    lgInterface->UpdateQuiltMoviePlayback(rw);
+    int frame = GetShownFrame(lgInterface, image, expected);
+    if (frame < 0 || frame > 2)
+    {
+      if (lastFrame >= 0)
+      {
+        std::cerr << "The quilt no longer holds a frame of the movie\n";
+        return EXIT_FAILURE;
+      }
+      continue;
+    }
+    loopedOver = frame < lastFrame;
+    lastFrame = frame;
+  }
+  if (!loopedOver || !lgInterface->IsPlayingQuiltMovie())
+  {
+    std::cerr << "The looping movie did not start over, last frame " << lastFrame << "\n";
+    return EXIT_FAILURE;
+  }
+  lgInterface->StopQuiltMoviePlayback();
+
+  // by the time the window renders the short movie is over, the frames
+  // decoded ahead are dropped by the display and the rest are skipped
+  if (!lgInterface->StartQuiltMoviePlayback(shortFile.c_str()))
+  {
+    std::cerr << "Unable to play " << shortFile << "\n";
+    return EXIT_FAILURE;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  int shownFrames = 0;
+  start = std::chrono::steady_clock::now();
+  while (lgInterface->IsPlayingQuiltMovie() &&
+    std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+  {
+    lgInterface->UpdateQuiltMoviePlayback(rw);
+    int frame = GetShownFrame(lgInterface, image, expected);
+    if (frame != lastFrame)
+    {
+      if (frame < 3)
+      {
+        std::cerr << "Frame " << frame << " is not a frame of the short movie\n";
+        return EXIT_FAILURE;
+      }
+      ++shownFrames;
+      lastFrame = frame;
+    }
+  }
+  int droppedFrames = lgInterface->GetNumberOfDroppedMovieFrames();
+  if (lgInterface->IsPlayingQuiltMovie() || droppedFrames == 0 ||
+    shownFrames + droppedFrames != 10)
+  {
+    std::cerr << "Showed " << shownFrames << " and dropped " << droppedFrames
+              << " of the 10 frames\n";
+    return EXIT_FAILURE;
+  }
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Converts a synthetic 5x9 quilt, in which every tile is filled with a value
+// proportional to its view index, to a 3x3 layout and checks that the
+// output views are interpolated between the right input views.
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltResampler.h"
+#include "vtkNew.h"
+
+#include <cmath>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltResampler(int, char*[])
+{
+  int tiles[2] = { 0, 0 };
+  if (!vtkLookingGlassQuiltResampler::ParseQuiltFileSuffix("/data/_qs1x1/quilt_qs5x9.png", tiles) ||
+    tiles[0] != 5 || tiles[1] != 9)
+  {
+    std::cerr << "Failed to parse the quilt suffix, got " << tiles[0] << "x" << tiles[1] << "\n";
+    return EXIT_FAILURE;
+  }
+  if (vtkLookingGlassQuiltResampler::ParseQuiltFileSuffix("quilt.png", tiles))
+  {
+    std::cerr << "Parsed a suffix from a name without one\n";
+    return EXIT_FAILURE;
+  }
+
+  const int tileSize[2] = { 4, 2 };
+  vtkNew<vtkImageData> quilt;
+  quilt->SetDimensions(5 * tileSize[0], 9 * tileSize[1], 1);
+  quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  for (int y = 0; y < 9 * tileSize[1]; ++y)
+  {
+    for (int x = 0; x < 5 * tileSize[0]; ++x)
+    {
+      int view = (y / tileSize[1]) * 5 + x / tileSize[0];
+      auto* pixel = static_cast<unsigned char*>(quilt->GetScalarPointer(x, y, 0));
+      pixel[0] = pixel[1] = pixel[2] = static_cast<unsigned char>(view * 5);
+    }
+  }
+
+  vtkNew<vtkLookingGlassQuiltResampler> resampler;
+  resampler->SetInputData(quilt);
+  resampler->SetInputTiles(5, 9);
+  resampler->SetOutputTiles(3, 3);
+  resampler->SetOutputTileSize(2, 2);
+  resampler->Update();
+
+  vtkImageData* output = resampler->GetOutput();
+  int dims[3];
+  output->GetDimensions(dims);
+  if (dims[0] != 6 || dims[1] != 6 || output->GetNumberOfScalarComponents() != 3)
+  {
+    std::cerr << "Unexpected output size " << dims[0] << "x" << dims[1] << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // output view j of 9 sits at input view j * 44 / 8
+  for (int y = 0; y < dims[1]; ++y)
+  {
+    for (int x = 0; x < dims[0]; ++x)
+    {
+      int view = (y / 2) * 3 + x / 2;
+      double expected = view * 44.0 / 8.0 * 5.0;
+      auto* pixel = static_cast<unsigned char*>(output->GetScalarPointer(x, y, 0));
+      if (std::abs(pixel[0] - expected) > 1.0)
+      {
+        std::cerr << "View " << view << " has value " << static_cast<int>(pixel[0])
+                  << ", expected " << expected << "\n";
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
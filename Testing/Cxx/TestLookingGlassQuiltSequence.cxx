@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes a few synthetic quilts to quilt sequence files, then reads the
+// frames back out of order, and a single tile, and compares them. The views
+// are shifted copies of a noisy texture, so LZ4 alone cannot compress them
+// and they are stored raw, while predicting them from the previous view
+// makes the file much smaller. Files with corrupt headers must be rejected
+// when they are opened.
+
+#include "vtkCommand.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltSequenceFormat.h"
+#include "vtkLookingGlassQuiltSequenceReader.h"
+#include "vtkLookingGlassQuiltSequenceWriter.h"
+#include "vtkNew.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTestUtilities.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+void FillQuilt(vtkImageData* quilt, int frame, const int tileSize[2])
+{
+  int* dims = quilt->GetDimensions();
+  for (int y = 0; y < dims[1]; ++y)
+  {
+    for (int x = 0; x < dims[0]; ++x)
+    {
+      int view = (y / tileSize[1]) * 5 + x / tileSize[0];
+      unsigned int u = static_cast<unsigned int>(x % tileSize[0] + 2 * view);
+      unsigned int v = static_cast<unsigned int>(y % tileSize[1]);
+      auto* pixel = static_cast<unsigned char*>(quilt->GetScalarPointer(x, y, 0));
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+        unsigned int hash = (u * 73856093u) ^ (v * 19349663u) ^ ((frame * 3 + c) * 83492791u);
+        hash = hash * 2654435761u;
+        pixel[c] = static_cast<unsigned char>(hash >> 24);
+      }
+    }
+  }
+}
+
+bool WriteAndReadBack(const std::string& fileName, int compression, int numberOfFrames,
+  const int tileSize[2], vtkImageData* quilt)
+{
+  vtkNew<vtkLookingGlassQuiltSequenceWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetQuiltTiles(5, 9);
+  writer->SetDeviceType("standard");
+  writer->SetFrameRate(24.0);
+  writer->SetCompression(compression);
+  writer->SetMaximumDisparity(4);
+  if (!writer->Start())
+  {
+    std::cerr << "Unable to start writing " << fileName << "\n";
+    return false;
+  }
+  for (int frame = 0; frame < numberOfFrames; ++frame)
+  {
+    FillQuilt(quilt, frame, tileSize);
+    if (!writer->Write(quilt))
+    {
+      std::cerr << "Unable to write frame " << frame << "\n";
+      return false;
+    }
+  }
+  if (!writer->End())
+  {
+    std::cerr << "Unable to finish " << fileName << "\n";
+    return false;
+  }
+
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->SetFileName(fileName.c_str());
+  if (!reader->Open())
+  {
+    std::cerr << "Unable to open " << fileName << "\n";
+    return false;
+  }
+  if (reader->GetNumberOfFrames() != numberOfFrames || reader->GetQuiltTiles()[0] != 5 ||
+    reader->GetQuiltTiles()[1] != 9 || reader->GetTileSize()[0] != tileSize[0] ||
+    reader->GetFrameRate() != 24.0 || reader->GetDeviceType() != "standard")
+  {
+    std::cerr << "Unexpected header values\n";
+    return false;
+  }
+
+  const size_t quiltBytes = static_cast<size_t>(5 * tileSize[0]) * 9 * tileSize[1] * 3;
+  vtkNew<vtkImageData> decoded;
+  for (int frame = numberOfFrames - 1; frame >= 0; --frame)
+  {
+    FillQuilt(quilt, frame, tileSize);
+    if (!reader->ReadFrame(frame, decoded) ||
+      std::memcmp(decoded->GetScalarPointer(), quilt->GetScalarPointer(), quiltBytes) != 0)
+    {
+      std::cerr << "Frame " << frame << " does not match what was written\n";
+      return false;
+    }
+  }
+
+  // the last tile of the first frame, in a tightly packed buffer
+  FillQuilt(quilt, 0, tileSize);
+  std::vector<unsigned char> tile(tileSize[0] * tileSize[1] * 3);
+  if (!reader->ReadTile(0, 44, tile.data(), tileSize[0] * 3))
+  {
+    std::cerr << "Unable to read a single tile\n";
+    return false;
+  }
+  for (int y = 0; y < tileSize[1]; ++y)
+  {
+    auto* expected =
+      static_cast<unsigned char*>(quilt->GetScalarPointer(4 * tileSize[0], 8 * tileSize[1] + y, 0));
+    if (std::memcmp(tile.data() + y * tileSize[0] * 3, expected, tileSize[0] * 3) != 0)
+    {
+      std::cerr << "Tile row " << y << " does not match what was written\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Patch a field of the header of a valid file, the reader must refuse to
+// open the result.
+template <typename T>
+bool RejectsHeader(const std::string& validFile, const std::string& fileName,
+  vtkTypeUInt32 offset, T value, const char* what)
+{
+  std::ifstream input(validFile, std::ios::binary);
+  std::vector<char> data(
+    (std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  std::memcpy(data.data() + offset, &value, sizeof(T));
+  std::ofstream output(fileName, std::ios::binary);
+  output.write(data.data(), static_cast<std::streamsize>(data.size()));
+  output.close();
+
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  reader->SetFileName(fileName.c_str());
+  if (reader->Open() || reader->IsOpen() || !errorObserver->GetError())
+  {
+    std::cerr << "A file with " << what << " was opened\n";
+    return false;
+  }
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltSequence(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string prefix = std::string(tempDir) + "/TestLookingGlassQuiltSequence";
+  delete[] tempDir;
+
+  const int tileSize[2] = { 32, 8 };
+  vtkNew<vtkImageData> quilt;
+  quilt->SetDimensions(5 * tileSize[0], 9 * tileSize[1], 1);
+  quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+
+  const std::string lz4File = prefix + "_lz4.lgq";
+  const std::string disparityFile = prefix + "_disparity.lgq";
+  if (!WriteAndReadBack(lz4File, vtkLookingGlassQuiltSequenceWriter::LZ4, 3, tileSize, quilt) ||
+    !WriteAndReadBack(
+      disparityFile, vtkLookingGlassQuiltSequenceWriter::DISPARITY_LZ4, 3, tileSize, quilt))
+  {
+    return EXIT_FAILURE;
+  }
+
+  unsigned long lz4Size = vtksys::SystemTools::FileLength(lz4File);
+  unsigned long disparitySize = vtksys::SystemTools::FileLength(disparityFile);
+  if (disparitySize * 2 > lz4Size)
+  {
+    std::cerr << "Predicting the views did not help, " << disparitySize << " bytes instead of "
+              << lz4Size << "\n";
+    return EXIT_FAILURE;
+  }
+
+  namespace format = vtkLookingGlassQuiltSequenceFormat;
+  const std::string corruptFile = prefix + "_corrupt.lgq";
+  const vtkTypeUInt32 tilesOffset = format::QuiltTilesOffset;
+  const vtkTypeUInt32 tileSizeOffset = format::TileSizeOffset;
+  if (!RejectsHeader(lz4File, corruptFile, format::MagicOffset, 'X', "a wrong magic") ||
+    !RejectsHeader(lz4File, corruptFile, format::VersionOffset, vtkTypeUInt32(0), "version 0") ||
+    !RejectsHeader(
+      lz4File, corruptFile, format::VersionOffset, format::Version + 1, "a future version") ||
+    !RejectsHeader(lz4File, corruptFile, tilesOffset, vtkTypeInt32(0), "no tile columns") ||
+    !RejectsHeader(lz4File, corruptFile, tilesOffset + 4, vtkTypeInt32(-9), "negative tile rows") ||
+    !RejectsHeader(lz4File, corruptFile, tileSizeOffset, vtkTypeInt32(0), "an empty tile") ||
+    !RejectsHeader(lz4File, corruptFile, tileSizeOffset, vtkTypeInt32(tileSize[0] + 1),
+      "tiles past the quilt") ||
+    !RejectsHeader(lz4File, corruptFile, format::QuiltSizeOffset + 4, vtkTypeInt32(1 << 30),
+      "a quilt larger than its tiles") ||
+    !RejectsHeader(lz4File, corruptFile, format::NumberOfFramesOffset, vtkTypeUInt64(1) << 32,
+      "2^32 frames") ||
+    !RejectsHeader(lz4File, corruptFile, format::NumberOfFramesOffset,
+      vtkTypeUInt64(VTK_INT_MAX), "an index larger than the file") ||
+    !RejectsHeader(lz4File, corruptFile, format::IndexOffsetOffset, ~vtkTypeUInt64(0) - 15,
+      "an index offset that overflows"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reads rendered quilts through vtkLookingGlassQuiltSource. The source must
+// only read the quilt again after a render, keep its output scalars across
+// updates, and stack the same tiles as the quilt holds with the TILES layout.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkLookingGlassQuiltSource.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPointData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkSphereSource.h"
+
+#include <cstring>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltSource(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->SetBackground(0.3, 0.4, 0.6);
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  vtkLookingGlassInterface* lgInterface = lgpass->GetInterface();
+  lgInterface->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+  renderer->ResetCamera();
+
+  vtkNew<vtkLookingGlassQuiltSource> source;
+  source->SetInterface(lgInterface);
+  renderWindow->Render();
+  source->Update();
+
+  vtkImageData* quilt = source->GetOutput();
+  int size[2];
+  lgInterface->GetQuiltTextureSize(size);
+  int* dims = quilt->GetDimensions();
+  if (dims[0] != size[0] || dims[1] != size[1] || quilt->GetNumberOfScalarComponents() != 3)
+  {
+    std::cerr << "Unexpected quilt size " << dims[0] << "x" << dims[1] << "\n";
+    return EXIT_FAILURE;
+  }
+  if (source->GetQuiltNumber() != lgInterface->GetQuiltRenderCount())
+  {
+    std::cerr << "The source does not hold the last quilt\n";
+    return EXIT_FAILURE;
+  }
+
+  // no render, no read
+  vtkMTimeType readTime = quilt->GetPointData()->GetScalars()->GetMTime();
+  void* pixels = quilt->GetScalarPointer();
+  source->Update();
+  if (quilt->GetPointData()->GetScalars()->GetMTime() != readTime)
+  {
+    std::cerr << "The quilt was read again without a render\n";
+    return EXIT_FAILURE;
+  }
+
+  renderer->GetActiveCamera()->Azimuth(30.0);
+  renderWindow->Render();
+  source->Update();
+  if (quilt->GetPointData()->GetScalars()->GetMTime() == readTime ||
+    source->GetQuiltNumber() != lgInterface->GetQuiltRenderCount())
+  {
+    std::cerr << "The quilt was not read after a render\n";
+    return EXIT_FAILURE;
+  }
+  if (quilt->GetScalarPointer() != pixels)
+  {
+    std::cerr << "The quilt was not read in place\n";
+    return EXIT_FAILURE;
+  }
+
+  // the stacked tiles must match the tiles of the quilt
+  vtkNew<vtkImageData> copy;
+  copy->DeepCopy(quilt);
+  source->SetLayoutToTiles();
+  source->Update();
+
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+  const int tcount = lgInterface->GetNumberOfTiles();
+  dims = quilt->GetDimensions();
+  if (dims[0] != renderSize[0] || dims[1] != renderSize[1] * tcount)
+  {
+    std::cerr << "Unexpected tile stack size " << dims[0] << "x" << dims[1] << "\n";
+    return EXIT_FAILURE;
+  }
+
+  const int* tiles = lgInterface->GetQuiltTiles();
+  for (int tile = 0; tile < tcount; ++tile)
+  {
+    const int x = (tile % tiles[0]) * renderSize[0];
+    const int y = (tile / tiles[0]) * renderSize[1];
+    for (int row = 0; row < renderSize[1]; ++row)
+    {
+      if (std::memcmp(copy->GetScalarPointer(x, y + row, 0),
+            quilt->GetScalarPointer(0, tile * renderSize[1] + row, 0), renderSize[0] * 3) != 0)
+      {
+        std::cerr << "Tile " << tile << " differs from the quilt\n";
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Streams quilts to a client over loopback. Every quilt is filled with a
+// value that grows with each frame, so the client can check that frames
+// arrive whole and in order. The target latency is set so low that the
+// server has to shrink the quilts, which the client must see as well.
+// Frame headers with impossible sizes must make the client disconnect
+// before it receives or allocates anything. Closing the server must not wait
+// for a client that stopped reading.
+
+#include "vtkClientSocket.h"
+#include "vtkCommand.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltClient.h"
+#include "vtkLookingGlassQuiltServer.h"
+#include "vtkLookingGlassQuiltStreamProtocol.h"
+#include "vtkNew.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestErrorObserver.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int NumberOfQuilts = 60;
+const int QuiltSize[2] = { 40, 36 };
+
+struct ClientResult
+{
+  std::atomic<bool> Failed{ false };
+  std::atomic<int> FramesReceived{ 0 };
+  std::atomic<int> ShrunkFrames{ 0 };
+};
+
+void RunClient(int port, ClientResult* result)
+{
+  vtkNew<vtkLookingGlassQuiltClient> client;
+  if (!client->Connect("localhost", port))
+  {
+    result->Failed = true;
+    return;
+  }
+
+  int lastValue = -1;
+  while (client->ReceiveFrame(5.0))
+  {
+    vtkImageData* frame = client->GetFrame();
+    int* dims = frame->GetDimensions();
+    const int scale = client->GetScale();
+    const auto* pixels = static_cast<unsigned char*>(frame->GetScalarPointer());
+    const int value = pixels[0];
+    bool uniform = true;
+    for (int i = 0; i < dims[0] * dims[1] * 3; ++i)
+    {
+      uniform = uniform && pixels[i] == value;
+    }
+    if (!uniform || value <= lastValue || dims[0] != QuiltSize[0] / scale ||
+      dims[1] != QuiltSize[1] / scale || client->GetQuiltTiles()[0] != 5)
+    {
+      std::cerr << "Unexpected frame " << client->GetFrameId() << "\n";
+      result->Failed = true;
+      return;
+    }
+    lastValue = value;
+    ++result->FramesReceived;
+    if (scale > 1)
+    {
+      ++result->ShrunkFrames;
+    }
+
+    // a display would upload and show the frame here
+    client->Acknowledge();
+  }
+}
+
+// Send a frame header and nothing else, the client must refuse it.
+bool RejectsFrameHeader(int width, int height, vtkTypeUInt32 payloadSize, const char* what)
+{
+  namespace protocol = vtkLookingGlassQuiltStreamProtocol;
+  vtkNew<vtkServerSocket> serverSocket;
+  if (serverSocket->CreateServer(0) != 0)
+  {
+    std::cerr << "Unable to listen\n";
+    return false;
+  }
+  vtkNew<vtkLookingGlassQuiltClient> client;
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  client->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  if (!client->Connect("localhost", serverSocket->GetServerPort()))
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkClientSocket> socket;
+  socket.TakeReference(serverSocket->WaitForConnection(5000));
+  if (!socket)
+  {
+    std::cerr << "The client did not connect\n";
+    return false;
+  }
+
+  unsigned char header[protocol::FrameHeaderSize] = {};
+  protocol::Put(header, protocol::FrameMagicOffset, protocol::FrameMagic);
+  protocol::Put(header, protocol::CodecOffset, vtkTypeUInt32(protocol::LZ4Codec));
+  protocol::Put(header, protocol::FrameIdOffset, vtkTypeUInt64(1));
+  protocol::Put(header, protocol::SizeOffset, vtkTypeInt32(width));
+  protocol::Put(header, protocol::SizeOffset + 4, vtkTypeInt32(height));
+  protocol::Put(header, protocol::PayloadSizeOffset, payloadSize);
+  socket->Send(header, protocol::FrameHeaderSize);
+
+  if (client->ReceiveFrame(5.0) || client->IsConnected() || !errorObserver->GetError())
+  {
+    std::cerr << "A frame with " << what << " was accepted\n";
+    return false;
+  }
+  return true;
+}
+
+// Close the server while it is blocked sending a quilt larger than the
+// socket buffers to a client that never reads.
+bool ClosesWhileBlocked()
+{
+  vtkNew<vtkLookingGlassQuiltServer> server;
+  server->CompressOff();
+  if (!server->Listen(0))
+  {
+    return false;
+  }
+  vtkNew<vtkClientSocket> socket;
+  if (socket->ConnectToServer("localhost", server->GetPort()) != 0 ||
+    !server->WaitForClient(5.0))
+  {
+    std::cerr << "The client did not connect\n";
+    return false;
+  }
+
+  vtkNew<vtkImageData> quilt;
+  quilt->SetDimensions(2048, 2048, 1);
+  quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  std::memset(quilt->GetScalarPointer(), 1, 2048 * 2048 * 3);
+  server->SendQuilt(quilt);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  auto start = std::chrono::steady_clock::now();
+  server->Close();
+  if (std::chrono::steady_clock::now() - start > std::chrono::seconds(2))
+  {
+    std::cerr << "Closing the server waited for the client\n";
+    return false;
+  }
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassQuiltStream(int, char*[])
+{
+  vtkNew<vtkLookingGlassQuiltServer> server;
+  server->SetMaximumFramesInFlight(1);
+  server->SetTargetLatency(1e-9);
+  server->SetMaximumScale(2);
+  if (!server->Listen(0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  ClientResult result;
+  std::thread clientThread(RunClient, server->GetPort(), &result);
+  if (!server->WaitForClient(5.0))
+  {
+    std::cerr << "The client did not connect\n";
+    clientThread.join();
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkImageData> quilt;
+  quilt->SetDimensions(QuiltSize[0], QuiltSize[1], 1);
+  quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  for (int i = 0; i < NumberOfQuilts; ++i)
+  {
+    std::memset(quilt->GetScalarPointer(), 2 * i + 1, QuiltSize[0] * QuiltSize[1] * 3);
+    server->SendQuilt(quilt);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  // wait for the last quilt to be sent and acknowledged
+  std::vector<std::pair<vtkTypeUInt64, double>> latencies;
+  std::vector<std::pair<vtkTypeUInt64, double>> received;
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (std::chrono::steady_clock::now() < end &&
+    (server->GetNumberOfFramesSent() + server->GetNumberOfFramesSkipped() < NumberOfQuilts ||
+      latencies.size() < server->GetNumberOfFramesSent()))
+  {
+    server->GetFrameLatencies(received);
+    latencies.insert(latencies.end(), received.begin(), received.end());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  server->Close();
+  clientThread.join();
+
+  const vtkTypeUInt64 sent = server->GetNumberOfFramesSent();
+  std::cout << "Sent " << sent << " frames, skipped " << server->GetNumberOfFramesSkipped()
+            << ", average latency " << server->GetAverageLatency() * 1000.0 << " ms\n";
+  if (result.Failed || sent + server->GetNumberOfFramesSkipped() != NumberOfQuilts ||
+    static_cast<vtkTypeUInt64>(result.FramesReceived) != sent || latencies.size() != sent)
+  {
+    std::cerr << "Received " << result.FramesReceived << " frames and " << latencies.size()
+              << " acknowledgements\n";
+    return EXIT_FAILURE;
+  }
+  for (const auto& latency : latencies)
+  {
+    if (latency.second <= 0.0)
+    {
+      std::cerr << "Frame " << latency.first << " has no latency\n";
+      return EXIT_FAILURE;
+    }
+  }
+  if (sent > 10 && result.ShrunkFrames == 0)
+  {
+    std::cerr << "The quilts were never shrunk\n";
+    return EXIT_FAILURE;
+  }
+
+  if (!RejectsFrameHeader(0, QuiltSize[1], 16, "no columns") ||
+    !RejectsFrameHeader(QuiltSize[0], -1, 16, "a negative height") ||
+    !RejectsFrameHeader(65536, 65536, 16, "a size that overflows an int") ||
+    !RejectsFrameHeader(QuiltSize[0], QuiltSize[1], 0x80000000u, "a 2 GB payload") ||
+    !RejectsFrameHeader(4, 4, 100000, "more payload than the frame can compress to"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (!ClosesWhileBlocked())
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
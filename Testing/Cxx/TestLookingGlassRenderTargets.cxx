@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders quilts and saves them at other sizes and for other devices. The
+// targets of the same size must be shared between them, and the targets a
+// quilt no longer uses must be released.
+
+#include "vtkActor.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassRenderTargets(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType("portrait");
+  lgInterface->Initialize();
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->SetSize(renderSize);
+  renderWindow->AddRenderer(renderer);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+  renderer->ResetCamera();
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string prefix = std::string(tempDir) + "/TestLookingGlassRenderTargets";
+  delete[] tempDir;
+
+  // the tiles with their 32 bit depth buffer
+  const vtkTypeInt64 tileBytes = static_cast<vtkTypeInt64>(renderSize[0]) * renderSize[1] * 12;
+  auto check = [&](const char* step, int targets, bool tileOnly) {
+    if (lgInterface->GetNumberOfRenderTargets() != targets ||
+      (tileOnly && lgInterface->GetRenderTargetMemory() != tileBytes))
+    {
+      std::cerr << "After " << step << ": " << lgInterface->GetNumberOfRenderTargets()
+                << " targets of " << lgInterface->GetRenderTargetMemory() << " bytes\n";
+      return false;
+    }
+    return true;
+  };
+
+  lgInterface->RenderQuilt(rw);
+  if (!check("the first quilt", 1, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // tiles of the same size share the target of the quilt tiles
+  lgInterface->SaveQuiltStreamed(rw, (prefix + "_full.png").c_str(), 1.0);
+  if (!check("saving at full size", 1, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // smaller tiles replace it, until the next quilt
+  lgInterface->SaveQuiltStreamed(rw, (prefix + "_half.png").c_str(), 0.5);
+  if (!check("saving at half size", 1, false) || lgInterface->GetRenderTargetMemory() >= tileBytes)
+  {
+    return EXIT_FAILURE;
+  }
+  lgInterface->RenderQuilt(rw);
+  if (!check("the second quilt", 1, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // the portrait views reuse the target of the tiles, the targets of the
+  // portrait quilt are released before the large ones are allocated
+  lgInterface->SaveQuilts(rw, { "portrait", "large" }, (prefix + "_").c_str());
+  if (!check("saving two devices", 2, false) ||
+    !vtksys::SystemTools::FileExists(prefix + "_portrait_qs8x6.png", true) ||
+    !vtksys::SystemTools::FileExists(prefix + "_large_qs5x9.png", true))
+  {
+    return EXIT_FAILURE;
+  }
+  lgInterface->RenderQuilt(rw);
+  if (!check("the third quilt", 1, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  lgInterface->ReleaseTransientTargetsOn();
+  lgInterface->RenderQuilt(rw);
+  if (!check("releasing the transient targets", 0, false))
+  {
+    return EXIT_FAILURE;
+  }
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  return EXIT_SUCCESS;
+}
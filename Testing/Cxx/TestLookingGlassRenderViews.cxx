@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders the views of two cameras to NumPy files. The files must have the
+// sizes of the views, and the view matrices written for the first camera
+// must be those computed by GetViewMatrices(), and no quilt must have been
+// allocated for them.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCollection.h"
+#include "vtkCommand.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTestUtilities.h"
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Return the data of a .npy file, without its header
+std::vector<char> ReadArray(const std::string& fileName)
+{
+  vtksys::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::vector<char> contents(
+    (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (contents.size() < 10 || contents[1] != 'N')
+  {
+    return std::vector<char>();
+  }
+  size_t headerSize = 10 + static_cast<unsigned char>(contents[8]) +
+    256 * static_cast<unsigned char>(contents[9]);
+  return std::vector<char>(contents.begin() + headerSize, contents.end());
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassRenderViews(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType("portrait");
+  lgInterface->Initialize();
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->SetSize(renderSize);
+  renderWindow->AddRenderer(renderer);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+
+  vtkNew<vtkCollection> cameras;
+  for (double azimuth : { 0.0, 90.0 })
+  {
+    vtkNew<vtkCamera> camera;
+    camera->SetPosition(0.0, 0.0, 3.0);
+    camera->Azimuth(azimuth);
+    camera->SetClippingRange(1.0, 5.0);
+    cameras->AddItem(camera);
+  }
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string directory = std::string(tempDir) + "/TestLookingGlassRenderViews";
+  delete[] tempDir;
+  vtksys::SystemTools::RemoveADirectory(directory);
+
+  if (!lgInterface->RenderViews(rw, cameras, directory.c_str(), true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // the quilt cannot be read when it was never allocated
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  lgInterface->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  vtkNew<vtkImageData> quilt;
+  lgInterface->ReadQuilt(quilt);
+  if (!errorObserver->GetError())
+  {
+    std::cerr << "Rendering the views allocated a quilt\n";
+    return EXIT_FAILURE;
+  }
+
+  const size_t views = lgInterface->GetNumberOfTiles();
+  const size_t pixels = views * renderSize[0] * renderSize[1];
+  for (const char* index : { "000000", "000001" })
+  {
+    if (ReadArray(directory + "/views_" + index + ".npy").size() != pixels * 3 ||
+      ReadArray(directory + "/depth_" + index + ".npy").size() != pixels * sizeof(float) ||
+      ReadArray(directory + "/matrices_" + index + ".npy").size() != views * 32 * sizeof(double))
+    {
+      std::cerr << "Missing or truncated files for camera " << index << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // the view matrices do not depend on the clipping range the renderer uses
+  std::vector<char> written = ReadArray(directory + "/matrices_000000.npy");
+  const double* matrices = reinterpret_cast<const double*>(written.data());
+  vtkNew<vtkDoubleArray> expected;
+  lgInterface->GetViewMatrices(vtkCamera::SafeDownCast(cameras->GetItemAsObject(0)), expected);
+  for (size_t view = 0; view < views; ++view)
+  {
+    for (int i = 0; i < 16; ++i)
+    {
+      if (std::abs(matrices[view * 32 + i] - expected->GetComponent(view, i)) > 1e-9)
+      {
+        std::cerr << "The view matrix of view " << view << " differs\n";
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  return EXIT_SUCCESS;
+}
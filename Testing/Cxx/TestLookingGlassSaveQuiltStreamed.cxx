@@ -0,0 +1,82 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Saves the quilt of a scene rendered as usual and streamed row by row. At
+// the RenderSize the streamed quilt must have the pixels of the rendered
+// one, and an oversampled quilt must have the oversampled size.
+
+#include "LookingGlassTestUtilities.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPNGReader.h"
+#include "vtkRenderer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassSaveQuiltStreamed(int argc, char* argv[])
+{
+  vtkNew<vtkRenderer> renderer;
+  LookingGlassTestUtilities::AddSphere(renderer);
+
+  // the tiles of the portrait quilt cover it exactly, as the streamed one
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType("portrait");
+  lgInterface->Initialize();
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+  int quiltTiles[2];
+  lgInterface->GetQuiltTiles(quiltTiles);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->SetSize(renderSize);
+  renderWindow->AddRenderer(renderer);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+  renderer->ResetCamera();
+
+  const std::string prefix =
+    LookingGlassTestUtilities::GetTemporaryPrefix(argc, argv, "TestLookingGlassSaveQuiltStreamed");
+
+  const std::string rendered = prefix + "_rendered.png";
+  const std::string streamed = prefix + "_streamed.png";
+  lgInterface->RenderQuilt(rw);
+  lgInterface->SaveQuilt(rendered.c_str());
+  lgInterface->SaveQuiltStreamed(rw, streamed.c_str());
+  bool ok = LookingGlassTestUtilities::CompareQuilts(rendered, streamed);
+
+  // oversampled tiles make a larger quilt of the same layout
+  lgInterface->SaveQuiltStreamed(rw, (prefix + "_oversampled.png").c_str(), 2.0);
+  vtkNew<vtkPNGReader> reader;
+  reader->SetFileName((prefix + "_oversampled.png").c_str());
+  reader->Update();
+  int dims[3];
+  reader->GetOutput()->GetDimensions(dims);
+  if (dims[0] != 2 * renderSize[0] * quiltTiles[0] || dims[1] != 2 * renderSize[1] * quiltTiles[1])
+  {
+    std::cerr << "The oversampled quilt is " << dims[0] << "x" << dims[1] << "\n";
+    ok = false;
+  }
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
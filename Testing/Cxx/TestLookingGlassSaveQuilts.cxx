@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Saves the quilts of a scene for sets of device types with SaveQuilts()
+// and compares each quilt written with the quilt rendered by an interface
+// set up for that device. The sets cover a device alone, devices in
+// different groups, devices in the same group whose tile sizes are not a
+// power of two apart, and devices sharing views as is or halved.
+
+#include "LookingGlassTestUtilities.h"
+#include "vtkCommand.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkTestErrorObserver.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+// The quilt a device renders on its own and the suffix of its files.
+struct RenderedQuilt
+{
+  std::string FileName;
+  std::string Suffix;
+};
+
+// Render and save the quilt of a device, as the reference for the quilts
+// SaveQuilts() writes for it.
+RenderedQuilt RenderQuilt(
+  vtkOpenGLRenderWindow* rw, const std::string& deviceType, const std::string& prefix)
+{
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType(deviceType);
+  lgInterface->TrimQuiltToTilesOn();
+  lgInterface->Initialize();
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+  rw->SetSize(renderSize);
+
+  RenderedQuilt rendered;
+  rendered.FileName = prefix + deviceType + "_rendered.png";
+  rendered.Suffix = lgInterface->QuiltFileSuffix();
+  lgInterface->RenderQuilt(rw);
+  lgInterface->SaveQuilt(rendered.FileName.c_str());
+  lgInterface->ReleaseGraphicsResources(rw);
+  return rendered;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassSaveQuilts(int argc, char* argv[])
+{
+  vtkNew<vtkRenderer> renderer;
+  LookingGlassTestUtilities::AddSphere(renderer);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->AddRenderer(renderer);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+  renderer->ResetCamera();
+
+  const std::string prefix =
+    LookingGlassTestUtilities::GetTemporaryPrefix(argc, argv, "TestLookingGlassSaveQuilts_");
+
+  // the quilts cover the tiles only, so that no pixel is left undefined
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType("standard");
+  lgInterface->TrimQuiltToTilesOn();
+  lgInterface->Initialize();
+
+  // the sets of device types, and the devices whose tiles are the views of
+  // another halved
+  struct Case
+  {
+    std::string Name;
+    std::vector<std::string> DeviceTypes;
+    std::vector<std::string> Halved;
+  };
+  const std::vector<Case> cases = {
+    { "portrait_", { "portrait" }, {} },
+    { "standard_", { "standard" }, {} },
+    // in different groups
+    { "both_", { "portrait", "standard" }, {} },
+    // in the same group, 857 and 1170 pixel tiles rendered each at its size
+    { "gen3_", { "16_gen3_l", "32_gen3_l" }, {} },
+    // in the same group, 819x455 tiles for the first two and 1638x910 ones
+    { "halved_", { "8k" }, { "large", "4k_gen2" } },
+  };
+
+  std::map<std::string, RenderedQuilt> rendered;
+  bool ok = true;
+  for (const auto& c : cases)
+  {
+    std::vector<std::string> deviceTypes = c.DeviceTypes;
+    deviceTypes.insert(deviceTypes.end(), c.Halved.begin(), c.Halved.end());
+    for (const auto& deviceType : deviceTypes)
+    {
+      if (!rendered.count(deviceType))
+      {
+        rendered[deviceType] = RenderQuilt(rw, deviceType, prefix);
+      }
+    }
+
+    const std::string casePrefix = prefix + c.Name;
+    lgInterface->SaveQuilts(rw, deviceTypes, casePrefix.c_str());
+
+    // Views rendered at the tile size only differ by a rounding step along a
+    // few edges, the defaults allow it. Halved views average 2x2 pixels where
+    // the rendered ones antialias the edges their own way: allow 32 levels of
+    // difference in 2% of the values.
+    for (const auto& deviceType : deviceTypes)
+    {
+      const std::string saved = casePrefix + deviceType + rendered[deviceType].Suffix + ".png";
+      const bool halved =
+        std::find(c.Halved.begin(), c.Halved.end(), deviceType) != c.Halved.end();
+      const int tolerance = halved ? 32 : 2;
+      const double maxFraction = halved ? 0.02 : 1.0 / 600.0;
+      ok = LookingGlassTestUtilities::CompareQuilts(
+             rendered[deviceType].FileName, saved, tolerance, maxFraction) &&
+        ok;
+    }
+  }
+
+  // the file names need a prefix
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  lgInterface->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  lgInterface->SaveQuilts(rw, { "standard" }, nullptr);
+  if (!errorObserver->GetError())
+  {
+    std::cerr << "SaveQuilts() without a file prefix did not report an error\n";
+    ok = false;
+  }
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,261 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Replicates a scene from a forked process to a host in this one. The
+// replicator makes one change per step and checks how many bytes and arrays
+// each step sent, while the host checks that its renderer follows.
+
+#include "vtkActor.h"
+#include "vtkActorCollection.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkLookingGlassSceneHost.h"
+#include "vtkLookingGlassSceneReplicator.h"
+#include "vtkMatrix4x4.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+
+#include <cmath>
+#include <iostream>
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+const int GridSize = 20;
+
+void MakeGrid(vtkPolyData* grid)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> elevation;
+  elevation->SetName("elevation");
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < GridSize; ++j)
+  {
+    for (int i = 0; i < GridSize; ++i)
+    {
+      const double z = std::sin(0.3 * i) * std::cos(0.3 * j);
+      points->InsertNextPoint(i, j, z);
+      elevation->InsertNextValue(static_cast<float>(z));
+      if (i > 0 && j > 0)
+      {
+        const vtkIdType corner = j * GridSize + i;
+        const vtkIdType triangles[2][3] = { { corner - GridSize - 1, corner - GridSize, corner },
+          { corner - GridSize - 1, corner, corner - 1 } };
+        polys->InsertNextCell(3, triangles[0]);
+        polys->InsertNextCell(3, triangles[1]);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->SetPolys(polys);
+  grid->GetPointData()->SetScalars(elevation);
+}
+
+bool Check(bool condition, const char* what)
+{
+  if (!condition)
+  {
+    std::cerr << what << "\n";
+  }
+  return condition;
+}
+
+// the application side, run in the forked process
+int Replicate(int port)
+{
+  vtkNew<vtkPolyData> grid;
+  MakeGrid(grid);
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkActor> actors[2];
+  for (auto& actor : actors)
+  {
+    // both actors share the grid, the host gets its arrays once
+    vtkNew<vtkPolyDataMapper> mapper;
+    mapper->SetInputData(grid);
+    actor->SetMapper(mapper);
+    renderer->AddActor(actor);
+  }
+  renderer->GetActiveCamera()->SetPosition(10, 10, 40);
+  renderer->GetActiveCamera()->SetFocalPoint(10, 10, 0);
+
+  vtkNew<vtkLookingGlassSceneReplicator> replicator;
+  replicator->SetRenderer(renderer);
+  if (!replicator->Connect("localhost", port) || !replicator->SendStep())
+  {
+    return EXIT_FAILURE;
+  }
+  const vtkTypeUInt64 fullStep = replicator->GetLastStepBytes();
+  vtkDataArray* arrays[4] = { grid->GetPoints()->GetData(), grid->GetPolys()->GetOffsetsArray(),
+    grid->GetPolys()->GetConnectivityArray(), grid->GetPointData()->GetScalars() };
+  vtkTypeUInt64 gridBytes = 0;
+  for (vtkDataArray* array : arrays)
+  {
+    gridBytes += array->GetNumberOfValues() * array->GetDataTypeSize();
+  }
+  bool ok = Check(replicator->GetNumberOfArraysSent() == 4, "The grid arrays were not sent") &&
+    Check(replicator->GetNumberOfArraysReused() == 4, "The second actor sent its arrays") &&
+    Check(fullStep > gridBytes && fullStep < gridBytes + 2048, "Unexpected first step size");
+
+  // camera only
+  renderer->GetActiveCamera()->Azimuth(10);
+  ok = ok && replicator->SendStep() &&
+    Check(replicator->GetLastStepBytes() < 200, "The camera step is too large");
+
+  // property and transform of one actor
+  actors[1]->GetProperty()->SetColor(1, 0, 0);
+  actors[1]->SetPosition(25, 0, 0);
+  ok = ok && replicator->SendStep() &&
+    Check(replicator->GetLastStepBytes() < 500, "The actor step is too large");
+
+  // new scalars, the points and cells stay on the host
+  auto* elevation = vtkFloatArray::SafeDownCast(grid->GetPointData()->GetScalars());
+  for (vtkIdType i = 0; i < elevation->GetNumberOfValues(); ++i)
+  {
+    elevation->SetValue(i, elevation->GetValue(i) + 1.0f);
+  }
+  elevation->Modified();
+  grid->Modified();
+  ok = ok && replicator->SendStep() &&
+    Check(replicator->GetNumberOfArraysSent() == 5, "Unchanged arrays were sent again") &&
+    Check(replicator->GetLastStepBytes() < fullStep / 2, "The scalars step is too large");
+
+  // nothing changed
+  ok = ok && replicator->SendStep() &&
+    Check(replicator->GetLastStepBytes() < 100, "An unchanged scene was sent");
+
+  renderer->RemoveActor(actors[1]);
+  ok = ok && replicator->SendStep();
+
+  std::cout << "Bytes per step: average " << replicator->GetAverageStepBytes() << ", first "
+            << fullStep << ", last " << replicator->GetLastStepBytes() << "\n";
+  replicator->Disconnect();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int Host(vtkLookingGlassSceneHost* host)
+{
+  vtkNew<vtkRenderer> renderer;
+  host->SetRenderer(renderer);
+  if (!Check(host->WaitForClient(10.0), "The replicator did not connect"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // full scene
+  if (!Check(host->ReceiveStep(10.0), "No first step") ||
+    !Check(renderer->GetActors()->GetNumberOfItems() == 2, "Actors are missing") ||
+    !Check(host->GetNumberOfCachedArrays() == 4 && host->GetNumberOfCacheHits() == 4,
+      "The actors do not share their arrays") ||
+    !Check(renderer->GetActiveCamera()->GetPosition()[2] == 40.0, "The camera was not set"))
+  {
+    return EXIT_FAILURE;
+  }
+  auto* first = vtkActor::SafeDownCast(renderer->GetActors()->GetItemAsObject(0));
+  auto* second = vtkActor::SafeDownCast(renderer->GetActors()->GetItemAsObject(1));
+  auto* data = vtkPolyData::SafeDownCast(first->GetMapper()->GetInputDataObject(0, 0));
+  if (!Check(data && data->GetNumberOfPoints() == GridSize * GridSize &&
+        data->GetNumberOfPolys() == 2 * (GridSize - 1) * (GridSize - 1) &&
+        data->GetPointData()->GetScalars(),
+        "The poly data is incomplete"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // camera
+  if (!Check(host->ReceiveStep(10.0), "No camera step") ||
+    !Check(renderer->GetActiveCamera()->GetPosition()[0] != 10.0, "The camera did not move"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // property and transform
+  if (!Check(host->ReceiveStep(10.0), "No actor step") ||
+    !Check(second->GetProperty()->GetColor()[1] == 0.0, "The color was not set") ||
+    !Check(second->GetUserMatrix() && second->GetUserMatrix()->GetElement(0, 3) == 25.0,
+      "The actor did not move"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // scalars, the old ones leave the cache
+  if (!Check(host->ReceiveStep(10.0), "No scalars step"))
+  {
+    return EXIT_FAILURE;
+  }
+  data = vtkPolyData::SafeDownCast(first->GetMapper()->GetInputDataObject(0, 0));
+  double range[2];
+  data->GetPointData()->GetScalars()->GetRange(range);
+  if (!Check(range[0] >= 0.0, "The scalars were not updated") ||
+    !Check(host->GetNumberOfCachedArrays() == 4, "The cache kept unused arrays"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // empty step, then removal
+  if (!Check(host->ReceiveStep(10.0), "No empty step") ||
+    !Check(host->ReceiveStep(10.0), "No removal step") ||
+    !Check(renderer->GetActors()->GetNumberOfItems() == 1, "The actor was not removed"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // the replicator disconnects
+  return Check(!host->ReceiveStep(10.0) && !host->IsConnected(), "The host is still connected")
+    ? EXIT_SUCCESS
+    : EXIT_FAILURE;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassSceneReplication(int, char*[])
+{
+  vtkNew<vtkLookingGlassSceneHost> host;
+  if (!host->Listen(0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  pid_t child = fork();
+  if (child < 0)
+  {
+    std::cerr << "Unable to fork\n";
+    return EXIT_FAILURE;
+  }
+  if (child == 0)
+  {
+    _exit(Replicate(host->GetPort()));
+  }
+
+  int result = Host(host);
+  if (result != EXIT_SUCCESS)
+  {
+    kill(child, SIGKILL);
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  host->Close();
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+  {
+    std::cerr << "The replicator failed\n";
+    return EXIT_FAILURE;
+  }
+  return result;
+}
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Records a short session with an interaction, a property change and a
+// data change, resets the scene and replays the session. The replay must
+// render every frame, end on the recorded camera and property, and write
+// results that can be parsed back.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkDoubleArray.h"
+#include "vtkInteractorStyleTrackballCamera.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkLookingGlassSessionPlayer.h"
+#include "vtkLookingGlassSessionRecorder.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkProperty.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowInteractor.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassSession(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+  vtkNew<vtkRenderWindowInteractor> interactor;
+  vtkNew<vtkInteractorStyleTrackballCamera> style;
+  interactor->SetInteractorStyle(style);
+  interactor->SetRenderWindow(renderWindow);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  vtkLookingGlassInterface* lgInterface = lgpass->GetInterface();
+  lgInterface->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+  renderer->ResetCamera();
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string logName = std::string(tempDir) + "/TestLookingGlassSession.jsonl";
+  const std::string resultsName = std::string(tempDir) + "/TestLookingGlassSession.json";
+  delete[] tempDir;
+
+  double initialPosition[3];
+  renderer->GetActiveCamera()->GetPosition(initialPosition);
+
+  vtkNew<vtkLookingGlassSessionRecorder> recorder;
+  recorder->SetRenderWindow(renderWindow);
+  recorder->SetInterface(lgInterface);
+  recorder->SetInteractor(interactor);
+  recorder->SetFileName(logName.c_str());
+  if (!recorder->Start())
+  {
+    std::cerr << "Unable to start recording\n";
+    return EXIT_FAILURE;
+  }
+
+  renderWindow->Render();
+  style->InvokeEvent(vtkCommand::StartInteractionEvent);
+  for (int i = 0; i < 3; ++i)
+  {
+    renderer->GetActiveCamera()->Azimuth(10.0);
+    renderWindow->Render();
+  }
+  style->InvokeEvent(vtkCommand::EndInteractionEvent);
+  actor->GetProperty()->SetColor(1.0, 0.5, 0.25);
+  renderWindow->Render();
+  sphere->SetThetaResolution(24);
+  renderWindow->Render();
+  recorder->Stop();
+
+  if (recorder->GetNumberOfFrames() != 6 || recorder->IsRecording())
+  {
+    std::cerr << "Recorded " << recorder->GetNumberOfFrames() << " frames instead of 6\n";
+    return EXIT_FAILURE;
+  }
+
+  double finalPosition[3];
+  renderer->GetActiveCamera()->GetPosition(finalPosition);
+  renderer->GetActiveCamera()->SetPosition(initialPosition);
+  actor->GetProperty()->SetColor(1.0, 1.0, 1.0);
+
+  vtkNew<vtkLookingGlassSessionPlayer> player;
+  player->SetRenderWindow(renderWindow);
+  player->SetInterface(lgInterface);
+  player->SetFileName(logName.c_str());
+  if (!player->Replay())
+  {
+    std::cerr << "Unable to replay the session\n";
+    return EXIT_FAILURE;
+  }
+
+  if (player->GetNumberOfFrames() != 6 || player->GetNumberOfInteractiveFrames() != 3 ||
+    player->GetAverageFrameTime() <= 0.0 || player->GetAverageInteractiveFrameTime() <= 0.0 ||
+    player->GetFrameTimePercentile(100.0) < player->GetAverageFrameTime())
+  {
+    std::cerr << "Unexpected replay: " << player->GetNumberOfFrames() << " frames, "
+              << player->GetNumberOfInteractiveFrames() << " interactive\n";
+    return EXIT_FAILURE;
+  }
+
+  double position[3];
+  renderer->GetActiveCamera()->GetPosition(position);
+  for (int i = 0; i < 3; ++i)
+  {
+    if (std::fabs(position[i] - finalPosition[i]) > 1e-9)
+    {
+      std::cerr << "The replay did not restore the camera\n";
+      return EXIT_FAILURE;
+    }
+  }
+  if (actor->GetProperty()->GetColor()[1] != 0.5)
+  {
+    std::cerr << "The replay did not restore the property\n";
+    return EXIT_FAILURE;
+  }
+
+  if (!player->WriteResults(resultsName.c_str()))
+  {
+    std::cerr << "Unable to write the results\n";
+    return EXIT_FAILURE;
+  }
+  vtksys::ifstream file(resultsName.c_str());
+  Json::CharReaderBuilder builder;
+  Json::Value results;
+  std::string errors;
+  if (!Json::parseFromStream(builder, file, &results, &errors) ||
+    results["frames"].asInt() != 6 || results["frameTimesMs"].size() != 6 ||
+    !results["phases"].isMember("TileRender"))
+  {
+    std::cerr << "Invalid results: " << errors << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
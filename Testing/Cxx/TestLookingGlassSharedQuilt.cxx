@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Publishes quilts from this process while a forked process reads them
+// through shared memory. Every quilt is filled with a value derived from
+// its frame number, so the reader can tell a torn copy from a good one.
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassSharedQuiltPublisher.h"
+#include "vtkLookingGlassSharedQuiltReader.h"
+#include "vtkNew.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+const int NumberOfFrames = 200;
+
+unsigned char FrameValue(vtkTypeUInt64 frame)
+{
+  return static_cast<unsigned char>(frame % 251);
+}
+
+int Consume(const std::string& name)
+{
+  vtkNew<vtkLookingGlassSharedQuiltReader> reader;
+  reader->SetName(name.c_str());
+  if (!reader->Open())
+  {
+    std::cerr << "Unable to open " << name << "\n";
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkImageData> quilt;
+  vtkTypeUInt64 last = 0;
+  int framesRead = 0;
+  while (last < NumberOfFrames)
+  {
+    if (!reader->WaitForFrame(last, 10.0) && reader->GetLatestFrame() <= last)
+    {
+      std::cerr << "No new frame after frame " << last << "\n";
+      return EXIT_FAILURE;
+    }
+    if (!reader->ReadLatest(quilt))
+    {
+      return EXIT_FAILURE;
+    }
+
+    vtkTypeUInt64 frame = reader->GetFrame();
+    int* dims = quilt->GetDimensions();
+    if (frame <= last || dims[0] != 40 || dims[1] != 36 || reader->GetQuiltTiles()[0] != 5 ||
+      reader->GetDeviceType() != "standard")
+    {
+      std::cerr << "Unexpected frame " << frame << " after " << last << "\n";
+      return EXIT_FAILURE;
+    }
+
+    const auto* pixels = static_cast<unsigned char*>(quilt->GetScalarPointer());
+    for (int i = 0; i < dims[0] * dims[1] * 3; ++i)
+    {
+      if (pixels[i] != FrameValue(frame))
+      {
+        std::cerr << "Frame " << frame << " was torn at byte " << i << "\n";
+        return EXIT_FAILURE;
+      }
+    }
+    last = frame;
+    ++framesRead;
+  }
+
+  std::cout << "Read " << framesRead << " of " << NumberOfFrames << " frames\n";
+  return EXIT_SUCCESS;
+}
+}
+
+//------------------------------------------------------------------------------
+int TestLookingGlassSharedQuilt(int, char*[])
+{
+  const std::string name = "vtkLookingGlassTest" + std::to_string(getpid());
+
+  // the segment exists before the reader process starts
+  vtkNew<vtkLookingGlassSharedQuiltPublisher> publisher;
+  publisher->SetName(name.c_str());
+  publisher->SetDeviceType("standard");
+  publisher->SetQuiltTiles(5, 9);
+  if (!publisher->Open(40, 36))
+  {
+    return EXIT_FAILURE;
+  }
+
+  pid_t child = fork();
+  if (child < 0)
+  {
+    std::cerr << "Unable to fork\n";
+    return EXIT_FAILURE;
+  }
+  if (child == 0)
+  {
+    // skip the static destructors of the parent process
+    _exit(Consume(name));
+  }
+
+  for (int frame = 1; frame <= NumberOfFrames; ++frame)
+  {
+    unsigned char* pixels = publisher->BeginFrame(40, 36);
+    if (!pixels)
+    {
+      kill(child, SIGKILL);
+      waitpid(child, nullptr, 0);
+      return EXIT_FAILURE;
+    }
+    std::memset(pixels, FrameValue(frame), 40 * 36 * 3);
+    publisher->EndFrame();
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+
+  int status = 0;
+  waitpid(child, &status, 0);
+  publisher->Close();
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+  {
+    std::cerr << "The reader process failed\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
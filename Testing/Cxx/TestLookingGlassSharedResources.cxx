@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders the quilts of several interfaces into one window. The interfaces
+// with the same layout must share their quilt and render target, and the
+// resources must stay around until the last of them releases them, even when
+// one of them asks for its transient targets to be released.
+
+#include "vtkActor.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLFramebufferObject.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderer.h"
+#include "vtkSphereSource.h"
+
+#include <iostream>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassSharedResources(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+
+  // two interfaces with the same layout, one for another device and one
+  // that keeps its quilt to itself
+  vtkNew<vtkLookingGlassInterface> first;
+  vtkNew<vtkLookingGlassInterface> second;
+  vtkNew<vtkLookingGlassInterface> other;
+  vtkNew<vtkLookingGlassInterface> own;
+  for (vtkLookingGlassInterface* lgInterface : { first.Get(), second.Get(), own.Get() })
+  {
+    lgInterface->SetDeviceType("portrait");
+  }
+  other->SetDeviceType("large");
+  for (vtkLookingGlassInterface* lgInterface : { first.Get(), second.Get(), other.Get() })
+  {
+    lgInterface->ShareQuiltOn();
+  }
+  for (vtkLookingGlassInterface* lgInterface :
+    { first.Get(), second.Get(), other.Get(), own.Get() })
+  {
+    lgInterface->Initialize();
+  }
+  int renderSize[2];
+  first->GetRenderSize(renderSize);
+
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetOffScreenRendering(true);
+  renderWindow->SetSize(renderSize);
+  renderWindow->AddRenderer(renderer);
+  vtkOpenGLRenderWindow* rw = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required\n";
+    return EXIT_FAILURE;
+  }
+  rw->Initialize();
+  rw->MakeCurrent();
+  renderer->ResetCamera();
+
+  vtkOpenGLFramebufferObject* firstRender;
+  vtkOpenGLFramebufferObject* firstQuilt;
+  first->GetFramebuffers(rw, firstRender, firstQuilt);
+  vtkOpenGLFramebufferObject* secondRender;
+  vtkOpenGLFramebufferObject* secondQuilt;
+  second->GetFramebuffers(rw, secondRender, secondQuilt);
+  vtkOpenGLFramebufferObject* otherRender;
+  vtkOpenGLFramebufferObject* otherQuilt;
+  other->GetFramebuffers(rw, otherRender, otherQuilt);
+  vtkOpenGLFramebufferObject* ownRender;
+  vtkOpenGLFramebufferObject* ownQuilt;
+  own->GetFramebuffers(rw, ownRender, ownQuilt);
+
+  if (firstQuilt != secondQuilt || firstRender != secondRender || ownRender != firstRender)
+  {
+    std::cerr << "The interfaces with the same layout do not share their framebuffers\n";
+    return EXIT_FAILURE;
+  }
+  if (otherQuilt == firstQuilt || otherRender == firstRender || ownQuilt == firstQuilt)
+  {
+    std::cerr << "Framebuffers are shared between different layouts\n";
+    return EXIT_FAILURE;
+  }
+
+  // the interfaces render in turn and keep the target of their tiles, the
+  // quad drawing the quilts is shared as well
+  for (int frame = 0; frame < 2; ++frame)
+  {
+    for (vtkLookingGlassInterface* lgInterface :
+      { first.Get(), second.Get(), other.Get(), own.Get() })
+    {
+      lgInterface->RenderQuilt(rw);
+      lgInterface->DrawLightField(rw);
+    }
+  }
+  if (first->GetNumberOfRenderTargets() != 2 || other->GetNumberOfRenderTargets() != 2)
+  {
+    std::cerr << "Expected the targets of the two tile sizes, got "
+              << first->GetNumberOfRenderTargets() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // the resources outlive the interfaces that release them first
+  first->ReleaseGraphicsResources(rw);
+  other->ReleaseGraphicsResources(rw);
+  if (first->GetNumberOfRenderTargets() != 0 || second->GetNumberOfRenderTargets() != 2)
+  {
+    std::cerr << "The targets were released with the first interface\n";
+    return EXIT_FAILURE;
+  }
+  second->GetFramebuffers(rw, secondRender, secondQuilt);
+  if (secondQuilt != firstQuilt || secondRender != firstRender)
+  {
+    std::cerr << "The quilt was released while it was still used\n";
+    return EXIT_FAILURE;
+  }
+  second->RenderQuilt(rw);
+  second->DrawLightField(rw);
+  own->RenderQuilt(rw);
+  own->DrawLightField(rw);
+
+  // the targets no longer used by anyone are released
+  if (second->GetNumberOfRenderTargets() != 1)
+  {
+    std::cerr << "Expected the target of the portrait tiles only, got "
+              << second->GetNumberOfRenderTargets() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // an interface releasing its transient targets leaves them to the other
+  // users of the window
+  own->ReleaseTransientTargetsOn();
+  own->RenderQuilt(rw);
+  if (second->GetNumberOfRenderTargets() != 1)
+  {
+    std::cerr << "The transient targets were released under another interface\n";
+    return EXIT_FAILURE;
+  }
+
+  second->ReleaseGraphicsResources(rw);
+  own->ReleaseGraphicsResources(rw);
+  return EXIT_SUCCESS;
+}
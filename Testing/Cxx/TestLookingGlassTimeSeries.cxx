@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Loads the frames of a sphere whose resolution changes over time. A frame
+// requested after the source had time to load ahead must be ready, and the
+// frames of a recording from a fixed camera must follow the series.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCameraInterpolator.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkLookingGlassQuiltAnimationRecorder.h"
+#include "vtkLookingGlassQuiltSequenceReader.h"
+#include "vtkLookingGlassTimeSeriesSource.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassTimeSeries(int argc, char* argv[])
+{
+  vtkNew<vtkLookingGlassTimeSeriesSource> series;
+  series->SetNumberOfFrames(4);
+  series->SetPrefetchCount(2);
+  series->SetFrameLoader([](int frame) {
+    // a slow reader
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(8 + 4 * frame);
+    sphere->SetPhiResolution(8 + 4 * frame);
+    sphere->Update();
+    return vtkSmartPointer<vtkDataObject>(sphere->GetOutput());
+  });
+
+  series->SetFrame(0);
+  series->Update();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  series->SetFrame(1);
+  series->Update();
+  vtkPolyData* output = vtkPolyData::SafeDownCast(series->GetOutputDataObject(0));
+  if (!output || output->GetNumberOfPolys() != 2 * 12 * (12 - 2))
+  {
+    std::cerr << "Wrong output for frame 1\n";
+    return EXIT_FAILURE;
+  }
+  if (series->GetNumberOfPrefetchHits() != 1)
+  {
+    std::cerr << "Frame 1 was not loaded ahead\n";
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(series->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  lgpass->GetInterface()->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+
+  // the camera does not move, only the data does
+  vtkNew<vtkCameraInterpolator> path;
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetPosition(0.0, 0.0, 3.0);
+  renderer->ResetCameraClippingRange();
+  path->AddCamera(0.0, camera);
+  path->AddCamera(1.0, camera);
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestLookingGlassTimeSeries.lgq";
+  delete[] tempDir;
+
+  vtkNew<vtkLookingGlassQuiltAnimationRecorder> recorder;
+  recorder->SetRenderWindow(renderWindow);
+  recorder->SetInterface(lgpass->GetInterface());
+  recorder->SetCameraPath(path);
+  recorder->SetTimeSeries(series);
+  recorder->SetFileName(fileName.c_str());
+  recorder->SetNumberOfFrames(4);
+  recorder->SetSegmentSize(4);
+  const std::string segment = recorder->GetSegmentFileName(0);
+  vtksys::SystemTools::RemoveFile(segment);
+  if (!recorder->Record() || series->GetFrame() != 3)
+  {
+    std::cerr << "The series did not follow the recording\n";
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->SetFileName(segment.c_str());
+  vtkNew<vtkImageData> quilts[2];
+  if (!reader->Open() || reader->GetNumberOfFrames() != 4 || !reader->ReadFrame(0, quilts[0]) ||
+    !reader->ReadFrame(3, quilts[1]))
+  {
+    std::cerr << "Unable to read the recording\n";
+    return EXIT_FAILURE;
+  }
+  int* dims = quilts[0]->GetDimensions();
+  if (std::memcmp(quilts[0]->GetScalarPointer(), quilts[1]->GetScalarPointer(),
+        static_cast<size_t>(dims[0]) * dims[1] * 3) == 0)
+  {
+    std::cerr << "The recorded frames do not follow the series\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Captures the trace of two frames rendered through a vtkLookingGlassPass
+// and checks the spans and counters of the written file. Without
+// LookingGlass_ENABLE_TRACING the capture must fail to start.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassPass.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderer.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderStepsPass.h"
+#include "vtkRenderWindow.h"
+#include "vtkSphereSource.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTestUtilities.h"
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <iostream>
+#include <string>
+
+//------------------------------------------------------------------------------
+int TestLookingGlassTrace(int argc, char* argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(300, 300);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkRenderStepsPass> basicPasses;
+  vtkNew<vtkLookingGlassPass> lgpass;
+  vtkLookingGlassInterface* lgInterface = lgpass->GetInterface();
+  lgInterface->Initialize();
+  lgpass->SetDelegatePass(basicPasses);
+  vtkOpenGLRenderer::SafeDownCast(renderer)->SetPass(lgpass);
+  renderer->ResetCamera();
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestLookingGlassTrace.json";
+  delete[] tempDir;
+  vtksys::SystemTools::RemoveFile(fileName);
+
+  // the captures that must not start report an error
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  lgInterface->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+
+  if (!vtkLookingGlassInterface::IsTracingAvailable())
+  {
+    if (lgInterface->StartTraceCapture(fileName.c_str(), 2) || lgInterface->IsCapturingTrace())
+    {
+      std::cerr << "A trace capture started without tracing support\n";
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  if (!lgInterface->StartTraceCapture(fileName.c_str(), 2) ||
+    lgInterface->StartTraceCapture(fileName.c_str(), 2))
+  {
+    std::cerr << "Expected exactly one capture to start\n";
+    return EXIT_FAILURE;
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    renderer->GetActiveCamera()->Azimuth(5.0);
+    renderWindow->Render();
+  }
+  if (lgInterface->IsCapturingTrace())
+  {
+    std::cerr << "The capture did not stop after its frames\n";
+    return EXIT_FAILURE;
+  }
+
+  Json::Value root;
+  {
+    vtksys::ifstream file(fileName.c_str());
+    Json::CharReaderBuilder builder;
+    std::string errors;
+    if (!file || !Json::parseFromStream(builder, file, &root, &errors))
+    {
+      std::cerr << "Unable to parse " << fileName << ": " << errors << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  int frames = 0;
+  int quilts = 0;
+  int tiles = 0;
+  int tileCounters = 0;
+  for (const Json::Value& event : root["traceEvents"])
+  {
+    const std::string name = event["name"].asString();
+    const std::string phase = event["ph"].asString();
+    if (phase == "X" && event["dur"].asDouble() < 0.0)
+    {
+      std::cerr << "Span " << name << " ends before it starts\n";
+      return EXIT_FAILURE;
+    }
+    // the GPU spans are on track 0, only count the CPU ones
+    const bool cpu = event["tid"].asInt() != 0;
+    frames += phase == "X" && name.compare(0, 6, "Frame ") == 0;
+    quilts += phase == "X" && name == "RenderQuilt";
+    tiles += phase == "X" && cpu && name == "Tile";
+    tileCounters += phase == "C" && name == "Tile 0" && event["args"].isMember("props");
+  }
+
+  const int tcount = lgInterface->GetNumberOfTiles();
+  if (frames != 2 || quilts != 2 || tiles != 2 * tcount || tileCounters != 2)
+  {
+    std::cerr << "Unexpected trace: " << frames << " frames, " << quilts << " quilts, " << tiles
+              << " tile spans and " << tileCounters << " counters of tile 0\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
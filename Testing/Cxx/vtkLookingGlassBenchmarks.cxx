@@ -0,0 +1,426 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders standard scenes for every device preset offscreen and reports how
+// long each part of the frames takes, as JSON:
+//
+//   vtkLookingGlassBenchmarks [--frames N] [--warmup N] [--scenes a,b]
+//     [--devices a,b] [--data DIR] [--volume FILE] [--output FILE]
+//
+// The scenes are
+//   dragon       the dragon of the tests, read from DIR/Data/dragon.ply
+//   mesh         a sphere of about a million triangles
+//   ct           a shaded volume with volumetric scattering, like the
+//                cinematic rendering examples, read from FILE (a legacy
+//                .vtk image such as head_and_neck_ct.vtk) or generated
+//   translucent  overlapping translucent spheres with depth peeling
+//
+// No Looking Glass is needed, and the benchmarks run on software OpenGL
+// such as Mesa llvmpipe, so that CPU-only hosts can track regressions. The
+// dragon is skipped when its file is not found. Each result holds the
+// average CPU time, and GPU time when timer queries are supported, of the
+// tiles, of the interlacing (a plain copy of the quilt without a device)
+// and of the readback and encoding of a recorded quilt sequence, with
+// their throughput, the quilts per second and the peak memory of the
+// process so far. The results go to stdout unless --output is given.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkColorTransferFunction.h"
+#include "vtkGPUVolumeRayCastMapper.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassFrameStatistics.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPLYReader.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkProperty.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStructuredPointsReader.h"
+#include "vtkVolume.h"
+#include "vtkVolumeProperty.h"
+
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+// windows.h must come first
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+struct Options
+{
+  int Frames = 10;
+  int Warmup = 2;
+  std::vector<std::string> Scenes = { "dragon", "mesh", "ct", "translucent" };
+  std::vector<std::string> Devices;
+  std::string DataDirectory;
+  std::string VolumeFile;
+  std::string Output;
+};
+
+std::vector<std::string> Split(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ','))
+  {
+    if (!item.empty())
+    {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// peak resident memory of the process in bytes, 0 if unknown
+double PeakMemory()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return static_cast<double>(counters.PeakWorkingSetSize);
+  }
+  return 0.0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0.0;
+  }
+#if defined(__APPLE__)
+  return static_cast<double>(usage.ru_maxrss);
+#else
+  return usage.ru_maxrss * 1024.0;
+#endif
+#endif
+}
+
+void AddSurface(vtkRenderer* renderer, vtkAlgorithm* source, double opacity = 1.0)
+{
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(source->GetOutputPort());
+  mapper->Update();
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  actor->GetProperty()->SetColor(1.0, 0.65, 0.7);
+  actor->GetProperty()->SetSpecular(0.5);
+  actor->GetProperty()->SetOpacity(opacity);
+  renderer->AddActor(actor);
+}
+
+// fill the renderer with a scene, false if the scene cannot be set up
+bool SetupScene(const std::string& scene, const Options& options, vtkRenderer* renderer)
+{
+  if (scene == "dragon")
+  {
+    const std::string fileName = options.DataDirectory + "/Data/dragon.ply";
+    if (options.DataDirectory.empty() || !vtksys::SystemTools::FileExists(fileName, true))
+    {
+      return false;
+    }
+    vtkNew<vtkPLYReader> reader;
+    reader->SetFileName(fileName.c_str());
+    AddSurface(renderer, reader);
+    return true;
+  }
+  if (scene == "mesh")
+  {
+    // 2 x 708 x 710 triangles
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(710);
+    sphere->SetPhiResolution(710);
+    AddSurface(renderer, sphere);
+    return true;
+  }
+  if (scene == "translucent")
+  {
+    for (int i = 0; i < 5; ++i)
+    {
+      vtkNew<vtkSphereSource> sphere;
+      sphere->SetThetaResolution(64);
+      sphere->SetPhiResolution(64);
+      sphere->SetCenter(0.3 * (i - 2), 0.1 * (i % 2), 0.2 * (i % 3));
+      AddSurface(renderer, sphere, 0.4);
+    }
+    renderer->SetUseDepthPeeling(true);
+    renderer->SetMaximumNumberOfPeels(8);
+    return true;
+  }
+  if (scene == "ct")
+  {
+    vtkSmartPointer<vtkAlgorithm> source;
+    double range[2] = { 37.0, 277.0 };
+    if (!options.VolumeFile.empty())
+    {
+      auto reader = vtkSmartPointer<vtkStructuredPointsReader>::New();
+      reader->SetFileName(options.VolumeFile.c_str());
+      reader->Update();
+      reader->GetOutput()->GetScalarRange(range);
+      source = reader;
+    }
+    else
+    {
+      // a 256^3 volume, about the size of a head CT
+      auto wavelet = vtkSmartPointer<vtkRTAnalyticSource>::New();
+      wavelet->SetWholeExtent(-127, 128, -127, 128, -127, 128);
+      source = wavelet;
+    }
+
+    vtkNew<vtkGPUVolumeRayCastMapper> mapper;
+    mapper->SetInputConnection(source->GetOutputPort());
+    mapper->SetVolumetricScatteringBlending(2.0);
+    mapper->SetGlobalIlluminationReach(0.2);
+    vtkNew<vtkColorTransferFunction> colors;
+    colors->AddRGBPoint(range[0], 0.0, 0.0, 0.0);
+    colors->AddRGBPoint(range[0] + 0.5 * (range[1] - range[0]), 0.9, 0.5, 0.3);
+    colors->AddRGBPoint(range[1], 1.0, 1.0, 0.9);
+    vtkNew<vtkPiecewiseFunction> opacities;
+    opacities->AddPoint(range[0], 0.0);
+    opacities->AddPoint(range[0] + 0.4 * (range[1] - range[0]), 0.0);
+    opacities->AddPoint(range[1], 0.8);
+    vtkNew<vtkVolume> volume;
+    volume->SetMapper(mapper);
+    volume->GetProperty()->SetColor(colors);
+    volume->GetProperty()->SetScalarOpacity(opacities);
+    volume->GetProperty()->SetInterpolationTypeToLinear();
+    volume->GetProperty()->ShadeOn();
+    volume->GetProperty()->SetScalarOpacityUnitDistance(1.5);
+    renderer->AddVolume(volume);
+    return true;
+  }
+  return false;
+}
+
+// average CPU and GPU times of a phase, the GPU one only when measured
+void AddPhase(Json::Value& result, const char* name, vtkLookingGlassFrameStatistics* stats,
+  int phase, double divisor = 1.0)
+{
+  result[name]["cpuMs"] = stats->GetAverageCPUTime(phase) / divisor;
+  const double gpu = stats->GetAverageGPUTime(phase);
+  if (gpu >= 0.0)
+  {
+    result[name]["gpuMs"] = gpu / divisor;
+  }
+}
+
+// bytes per second moved by a phase, from its CPU time
+double Throughput(vtkLookingGlassFrameStatistics* stats, int phase)
+{
+  const double ms = stats->GetAverageCPUTime(phase);
+  return ms > 0.0 ? stats->GetAverageBytes(phase) * 1000.0 / ms : 0.0;
+}
+
+bool RunBenchmark(const std::string& scene, const std::string& device, const Options& options,
+  const std::string& scratch, Json::Value& result)
+{
+  vtkNew<vtkRenderer> renderer;
+  renderer->SetBackground(0.2, 0.3, 0.4);
+  if (!SetupScene(scene, options, renderer))
+  {
+    result["skipped"] = true;
+    return true;
+  }
+
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  lgInterface->SetDeviceType(device);
+  lgInterface->Initialize();
+  lgInterface->CollectStatisticsOn();
+  vtkLookingGlassFrameStatistics* stats = lgInterface->GetStatistics();
+  stats->SetWindowSize(options.Frames);
+
+  vtkNew<vtkRenderWindow> window;
+  window->SetOffScreenRendering(true);
+  window->SetShowWindow(false);
+  window->SetAlphaBitPlanes(true);
+  window->SetMultiSamples(0);
+  window->AddRenderer(renderer);
+  auto* rw = vtkOpenGLRenderWindow::SafeDownCast(window);
+  if (!rw)
+  {
+    std::cerr << "An OpenGL render window is required" << std::endl;
+    return false;
+  }
+
+  // the renderers take the size of the tiles being rendered from the window
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+  rw->SetSize(renderSize);
+  lgInterface->SetTileSizeCallback([rw](int width, int height) { rw->SetSize(width, height); });
+  rw->Initialize();
+  rw->MakeCurrent();
+  renderer->ResetCamera();
+
+  // recording reads back and encodes every quilt
+  const std::string sequence = scratch + "/" + scene + device + ".lgq";
+  lgInterface->StartRecordingQuilt(sequence.c_str());
+
+  const int total = options.Warmup + options.Frames;
+  for (int frame = 0; frame < total; ++frame)
+  {
+    if (frame == options.Warmup)
+    {
+      stats->Reset();
+    }
+    renderer->GetActiveCamera()->Azimuth(2.0);
+    renderer->ResetCameraClippingRange();
+    lgInterface->RenderQuilt(rw);
+    lgInterface->DrawLightField(rw);
+  }
+  lgInterface->StopRecordingQuilt();
+  vtksys::SystemTools::RemoveFile(sequence);
+
+  const int tiles = lgInterface->GetNumberOfTiles();
+  int quiltSize[2];
+  lgInterface->GetQuiltTextureSize(quiltSize);
+  const double frameMs = stats->GetAverageFrameTime();
+  result["tiles"] = tiles;
+  result["tileSize"].append(renderSize[0]);
+  result["tileSize"].append(renderSize[1]);
+  result["quiltSize"].append(quiltSize[0]);
+  result["quiltSize"].append(quiltSize[1]);
+  result["frames"] = stats->GetNumberOfFrames();
+  result["gpuFrames"] = stats->GetNumberOfGPUFrames();
+  result["frameMs"] = frameMs;
+  result["frameMsP95"] = stats->GetFrameTimePercentile(95.0);
+  result["quiltsPerSecond"] = frameMs > 0.0 ? 1000.0 / frameMs : 0.0;
+  AddPhase(result, "tile", stats, vtkLookingGlassFrameStatistics::TILE_RENDER, tiles);
+  AddPhase(result, "blit", stats, vtkLookingGlassFrameStatistics::BLIT);
+  AddPhase(result, "interlace", stats, vtkLookingGlassFrameStatistics::INTERLACE);
+  AddPhase(result, "readback", stats, vtkLookingGlassFrameStatistics::READBACK);
+  AddPhase(result, "encode", stats, vtkLookingGlassFrameStatistics::ENCODE);
+  result["readback"]["bytesPerSecond"] =
+    Throughput(stats, vtkLookingGlassFrameStatistics::READBACK);
+  result["encode"]["bytesPerSecond"] = Throughput(stats, vtkLookingGlassFrameStatistics::ENCODE);
+  result["peakMemoryBytes"] = PeakMemory();
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  rw->Finalize();
+  return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  Options options;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--frames" && hasValue)
+    {
+      options.Frames = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (arg == "--warmup" && hasValue)
+    {
+      options.Warmup = std::max(0, std::atoi(argv[++i]));
+    }
+    else if (arg == "--scenes" && hasValue)
+    {
+      options.Scenes = Split(argv[++i]);
+    }
+    else if (arg == "--devices" && hasValue)
+    {
+      options.Devices = Split(argv[++i]);
+    }
+    else if (arg == "--data" && hasValue)
+    {
+      options.DataDirectory = argv[++i];
+    }
+    else if (arg == "--volume" && hasValue)
+    {
+      options.VolumeFile = argv[++i];
+    }
+    else if (arg == "--output" && hasValue)
+    {
+      options.Output = argv[++i];
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0]
+                << " [--frames N] [--warmup N] [--scenes a,b] [--devices a,b] [--data DIR]"
+                   " [--volume FILE] [--output FILE]"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (options.Devices.empty())
+  {
+    for (const auto& device : vtkLookingGlassInterface::GetDevices())
+    {
+      options.Devices.push_back(device.first);
+    }
+  }
+
+  // the recorded sequences only live while their benchmark runs
+  const std::string scratch = options.Output.empty()
+    ? vtksys::SystemTools::GetCurrentWorkingDirectory()
+    : vtksys::SystemTools::GetFilenamePath(vtksys::SystemTools::CollapseFullPath(options.Output));
+
+  Json::Value root;
+  root["frames"] = options.Frames;
+  root["warmup"] = options.Warmup;
+  root["results"] = Json::arrayValue;
+  bool ok = true;
+  for (const std::string& scene : options.Scenes)
+  {
+    for (const std::string& device : options.Devices)
+    {
+      Json::Value result;
+      result["scene"] = scene;
+      result["device"] = device;
+      if (!RunBenchmark(scene, device, options, scratch, result))
+      {
+        result["failed"] = true;
+        ok = false;
+      }
+      std::cerr << scene << " " << device << ": " << result.get("frameMs", 0.0).asDouble()
+                << " ms per quilt" << (result.isMember("skipped") ? " (skipped)" : "")
+                << std::endl;
+      root["results"].append(result);
+    }
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  if (options.Output.empty())
+  {
+    std::cout << Json::writeString(builder, root) << std::endl;
+  }
+  else
+  {
+    vtksys::ofstream file(options.Output.c_str());
+    file << Json::writeString(builder, root) << std::endl;
+    ok = ok && static_cast<bool>(file);
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
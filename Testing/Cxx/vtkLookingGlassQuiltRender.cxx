@@ -0,0 +1,462 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Renders the quilts of scenes described in JSON manifests, without a
+// Looking Glass or a visible window:
+//
+//   vtkLookingGlassQuiltRender [--jobs N] [--output-dir DIR] scene.json...
+//
+// Each manifest renders to its own offscreen window, and with --jobs the
+// manifests are rendered by up to N threads, each with its own context.
+// A manifest looks like this, file names are relative to the manifest:
+//
+// {
+//   "output": "dragon",                 // file prefix, the manifest name by default
+//   "devices": ["standard", "portrait"], // device types, the interface default if absent
+//   "background": [0.2, 0.3, 0.4],
+//   "objects": [
+//     { "file": "dragon.ply", "color": [1.0, 0.65, 0.7], "specular": 0.5,
+//       "position": [0, 0, 0], "orientation": [0, 90, 0], "scale": [1, 1, 1] },
+//     { "file": "head.vti", "representation": "volume",
+//       "colors": [[0, 0, 0, 0], [255, 1, 0.8, 0.6]], "opacities": [[0, 0], [255, 0.2]] }
+//   ],
+//   "camera": { "focalPoint": [0, 0, 0], "position": [0, 0, 1], "viewUp": [0, 1, 0],
+//               "viewAngle": 30, "azimuth": 15, "elevation": 0, "zoom": 1.5 },
+//   "animation": { "frames": 90, "frameRate": 30,
+//                  "keyframes": [{ "azimuth": 0 }, { "azimuth": 180 }] }
+// }
+//
+// Without an animation a quilt is saved for each device as
+// `<output><device><suffix>.png`. With one, the camera goes through the
+// keyframes, which modify the camera like "camera" does, and each device
+// gets a `<output><device><suffix>.lgq` quilt sequence.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCameraInterpolator.h"
+#include "vtkColorTransferFunction.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetMapper.h"
+#include "vtkGenericDataObjectReader.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkNew.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPLYReader.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
+#include "vtkSmartVolumeMapper.h"
+#include "vtkVolume.h"
+#include "vtkVolumeProperty.h"
+#include "vtkXMLGenericDataObjectReader.h"
+
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// creating contexts and querying the device are not safe from several threads
+std::mutex ContextMutex;
+std::mutex OutputMutex;
+
+void Report(const std::string& message, bool error = false)
+{
+  std::lock_guard<std::mutex> lock(OutputMutex);
+  (error ? std::cerr : std::cout) << message << std::endl;
+}
+
+bool GetVector(const Json::Value& value, const char* key, double* result, int size)
+{
+  const Json::Value& array = value[key];
+  if (!array.isArray() || static_cast<int>(array.size()) != size)
+  {
+    return false;
+  }
+  for (int i = 0; i < size; ++i)
+  {
+    result[i] = array[i].asDouble();
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkDataObject> ReadDataset(const std::string& fileName)
+{
+  const std::string extension =
+    vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(fileName));
+  vtkSmartPointer<vtkAlgorithm> reader;
+  if (extension == ".ply")
+  {
+    auto ply = vtkSmartPointer<vtkPLYReader>::New();
+    ply->SetFileName(fileName.c_str());
+    reader = ply;
+  }
+  else if (extension == ".vtk")
+  {
+    auto legacy = vtkSmartPointer<vtkGenericDataObjectReader>::New();
+    legacy->SetFileName(fileName.c_str());
+    reader = legacy;
+  }
+  else
+  {
+    auto xml = vtkSmartPointer<vtkXMLGenericDataObjectReader>::New();
+    xml->SetFileName(fileName.c_str());
+    reader = xml;
+  }
+  reader->Update();
+  return reader->GetOutputDataObject(0);
+}
+
+bool AddObject(vtkRenderer* renderer, const Json::Value& object, const std::string& directory)
+{
+  const std::string fileName =
+    vtksys::SystemTools::CollapseFullPath(object["file"].asString(), directory);
+  vtkSmartPointer<vtkDataObject> data = ReadDataset(fileName);
+  if (!data || !vtkDataSet::SafeDownCast(data))
+  {
+    Report("Unable to read a dataset from " + fileName, true);
+    return false;
+  }
+
+  vtkSmartPointer<vtkProp3D> prop;
+  const std::string representation = object.get("representation", "surface").asString();
+  if (representation == "volume")
+  {
+    vtkImageData* image = vtkImageData::SafeDownCast(data);
+    if (!image)
+    {
+      Report(fileName + " is not an image, it cannot be rendered as a volume", true);
+      return false;
+    }
+    vtkNew<vtkSmartVolumeMapper> mapper;
+    mapper->SetInputData(image);
+    vtkNew<vtkColorTransferFunction> colors;
+    for (const Json::Value& point : object["colors"])
+    {
+      colors->AddRGBPoint(
+        point[0].asDouble(), point[1].asDouble(), point[2].asDouble(), point[3].asDouble());
+    }
+    vtkNew<vtkPiecewiseFunction> opacities;
+    for (const Json::Value& point : object["opacities"])
+    {
+      opacities->AddPoint(point[0].asDouble(), point[1].asDouble());
+    }
+    vtkNew<vtkVolume> volume;
+    volume->SetMapper(mapper);
+    volume->GetProperty()->SetColor(colors);
+    volume->GetProperty()->SetScalarOpacity(opacities);
+    volume->GetProperty()->SetInterpolationTypeToLinear();
+    volume->GetProperty()->SetShade(object.get("shade", false).asBool());
+    renderer->AddVolume(volume);
+    prop = volume;
+  }
+  else
+  {
+    vtkNew<vtkDataSetMapper> mapper;
+    mapper->SetInputData(vtkDataSet::SafeDownCast(data));
+    if (object.isMember("scalars"))
+    {
+      mapper->SetScalarModeToUsePointFieldData();
+      mapper->SelectColorArray(object["scalars"].asCString());
+      double range[2];
+      if (GetVector(object, "scalarRange", range, 2))
+      {
+        mapper->SetScalarRange(range);
+      }
+    }
+    else
+    {
+      mapper->ScalarVisibilityOff();
+    }
+
+    vtkNew<vtkActor> actor;
+    actor->SetMapper(mapper);
+    vtkProperty* property = actor->GetProperty();
+    double color[3];
+    if (GetVector(object, "color", color, 3))
+    {
+      property->SetColor(color);
+    }
+    property->SetOpacity(object.get("opacity", 1.0).asDouble());
+    property->SetAmbient(object.get("ambient", property->GetAmbient()).asDouble());
+    property->SetDiffuse(object.get("diffuse", property->GetDiffuse()).asDouble());
+    property->SetSpecular(object.get("specular", property->GetSpecular()).asDouble());
+    property->SetSpecularPower(
+      object.get("specularPower", property->GetSpecularPower()).asDouble());
+    if (representation == "wireframe")
+    {
+      property->SetRepresentationToWireframe();
+    }
+    else if (representation == "points")
+    {
+      property->SetRepresentationToPoints();
+    }
+    renderer->AddActor(actor);
+    prop = actor;
+  }
+
+  double values[3];
+  if (GetVector(object, "position", values, 3))
+  {
+    prop->SetPosition(values);
+  }
+  if (GetVector(object, "orientation", values, 3))
+  {
+    prop->SetOrientation(values);
+  }
+  if (GetVector(object, "scale", values, 3))
+  {
+    prop->SetScale(values);
+  }
+  return true;
+}
+
+// apply the settings of a "camera" or keyframe object to a camera
+void SetupCamera(vtkCamera* camera, const Json::Value& settings)
+{
+  double values[3];
+  if (GetVector(settings, "focalPoint", values, 3))
+  {
+    camera->SetFocalPoint(values);
+  }
+  if (GetVector(settings, "position", values, 3))
+  {
+    camera->SetPosition(values);
+  }
+  if (GetVector(settings, "viewUp", values, 3))
+  {
+    camera->SetViewUp(values);
+  }
+  if (settings.isMember("viewAngle"))
+  {
+    camera->SetViewAngle(settings["viewAngle"].asDouble());
+  }
+  camera->Azimuth(settings.get("azimuth", 0.0).asDouble());
+  camera->Elevation(settings.get("elevation", 0.0).asDouble());
+  camera->OrthogonalizeViewUp();
+  camera->Zoom(settings.get("zoom", 1.0).asDouble());
+}
+
+bool RenderScene(const std::string& manifest, const std::string& outputDirectory)
+{
+  Json::Value root;
+  {
+    vtksys::ifstream file(manifest.c_str());
+    Json::CharReaderBuilder builder;
+    std::string errors;
+    if (!file || !Json::parseFromStream(builder, file, &root, &errors) || !root.isObject())
+    {
+      Report("Unable to parse " + manifest + ": " + errors, true);
+      return false;
+    }
+  }
+
+  const std::string directory =
+    vtksys::SystemTools::GetFilenamePath(vtksys::SystemTools::CollapseFullPath(manifest));
+  std::string output = root.get("output", vtksys::SystemTools::GetFilenameWithoutLastExtension(
+                                            manifest))
+                         .asString();
+  output = vtksys::SystemTools::CollapseFullPath(
+    output, outputDirectory.empty() ? directory : outputDirectory);
+
+  vtkNew<vtkRenderer> renderer;
+  double background[3];
+  if (GetVector(root, "background", background, 3))
+  {
+    renderer->SetBackground(background);
+  }
+  for (const Json::Value& object : root["objects"])
+  {
+    if (!AddObject(renderer, object, directory))
+    {
+      return false;
+    }
+  }
+
+  vtkCamera* camera = renderer->GetActiveCamera();
+  const Json::Value& cameraSettings = root["camera"];
+  if (!cameraSettings.isMember("position"))
+  {
+    renderer->ResetCamera();
+  }
+  SetupCamera(camera, cameraSettings);
+  if (!cameraSettings.isMember("position"))
+  {
+    renderer->ResetCameraClippingRange();
+  }
+
+  std::vector<std::string> devices;
+  for (const Json::Value& device : root["devices"])
+  {
+    devices.push_back(device.asString());
+  }
+
+  vtkSmartPointer<vtkRenderWindow> window;
+  vtkNew<vtkLookingGlassInterface> lgInterface;
+  {
+    std::lock_guard<std::mutex> lock(ContextMutex);
+    window = vtkSmartPointer<vtkRenderWindow>::New();
+    window->SetOffScreenRendering(true);
+    window->SetShowWindow(false);
+    window->AddRenderer(renderer);
+    if (!devices.empty())
+    {
+      lgInterface->SetDeviceType(devices[0]);
+    }
+    lgInterface->Initialize();
+  }
+  auto* rw = vtkOpenGLRenderWindow::SafeDownCast(window);
+  if (!rw)
+  {
+    Report("An OpenGL render window is required", true);
+    return false;
+  }
+  if (devices.empty())
+  {
+    devices.push_back(lgInterface->GetDeviceType());
+  }
+
+  // the renderers take the size of the tiles being rendered from the window
+  int renderSize[2];
+  lgInterface->GetRenderSize(renderSize);
+  rw->SetSize(renderSize);
+  lgInterface->SetTileSizeCallback([rw](int width, int height) { rw->SetSize(width, height); });
+  rw->Initialize();
+  rw->MakeCurrent();
+
+  const Json::Value& animation = root["animation"];
+  bool ok = true;
+  if (!animation.isObject())
+  {
+    // all the devices from a single pass over the scene
+    lgInterface->SaveQuilts(rw, devices, output.c_str());
+    Report("Saved the quilts of " + output);
+  }
+  else
+  {
+    vtkNew<vtkCameraInterpolator> path;
+    vtkNew<vtkCamera> keyframe;
+    int time = 0;
+    for (const Json::Value& settings : animation["keyframes"])
+    {
+      keyframe->DeepCopy(camera);
+      SetupCamera(keyframe, settings);
+      path->AddCamera(time++, keyframe);
+    }
+    const int frames = animation.get("frames", 60).asInt();
+
+    for (const std::string& device : devices)
+    {
+      // each device needs its own quilt layout
+      vtkNew<vtkLookingGlassInterface> deviceInterface;
+      {
+        std::lock_guard<std::mutex> lock(ContextMutex);
+        deviceInterface->SetDeviceType(device);
+        deviceInterface->Initialize();
+      }
+      deviceInterface->GetRenderSize(renderSize);
+      rw->SetSize(renderSize);
+
+      const std::string fileName = output + device + deviceInterface->QuiltFileSuffix() + ".lgq";
+      deviceInterface->StartRecordingQuilt(fileName.c_str());
+      ok = ok && deviceInterface->IsRecordingQuilt();
+      for (int frame = 0; ok && frame < frames; ++frame)
+      {
+        if (path->GetNumberOfCameras() > 0)
+        {
+          const double t = frames > 1 ? path->GetMaximumT() * frame / (frames - 1.0) : 0.0;
+          path->InterpolateCamera(t, camera);
+        }
+        // recording writes a frame for every quilt rendered
+        deviceInterface->RenderQuilt(rw);
+      }
+      deviceInterface->StopRecordingQuilt();
+      deviceInterface->ReleaseGraphicsResources(rw);
+      Report((ok ? "Saved " : "Unable to save ") + fileName, !ok);
+    }
+  }
+
+  lgInterface->ReleaseGraphicsResources(rw);
+  std::lock_guard<std::mutex> lock(ContextMutex);
+  rw->Finalize();
+  return ok;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  int jobs = 1;
+  std::string outputDirectory;
+  std::vector<std::string> manifests;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--jobs" && i + 1 < argc)
+    {
+      jobs = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (arg == "--output-dir" && i + 1 < argc)
+    {
+      outputDirectory = argv[++i];
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return EXIT_FAILURE;
+    }
+    else
+    {
+      manifests.push_back(arg);
+    }
+  }
+  if (manifests.empty())
+  {
+    std::cerr << "Usage: " << argv[0] << " [--jobs N] [--output-dir DIR] scene.json..."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the scenes are independent, each thread takes the next one
+  std::atomic<size_t> next(0);
+  std::atomic<int> failures(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < manifests.size(); i = next++)
+    {
+      if (!RenderScene(manifests[i], outputDirectory))
+      {
+        ++failures;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int j = 1; j < std::min<int>(jobs, static_cast<int>(manifests.size())); ++j)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,53 @@
+import asyncio
+import threading
+
+from vtkmodules.lookingglass import RenderThread
+
+
+class FakeWindow:
+    """Records the thread of each call instead of rendering."""
+
+    def __init__(self):
+        self.calls = []
+
+    def Render(self):
+        self.calls.append(("Render", threading.get_ident()))
+
+    def SaveQuilt(self, file_name):
+        self.calls.append((file_name, threading.get_ident()))
+
+
+def test_calls_run_in_order_on_one_thread():
+    window = FakeWindow()
+    with RenderThread(window) as render_thread:
+        render_thread.render()
+        render_thread.save_quilt("quilt_qs5x9.png", render=True).result()
+
+    assert [name for name, _ in window.calls] == ["Render", "Render", "quilt_qs5x9.png"]
+    threads = {thread for _, thread in window.calls}
+    assert len(threads) == 1
+    assert threading.get_ident() not in threads
+
+
+def test_async_calls_do_not_block_the_loop():
+    window = FakeWindow()
+    started = threading.Event()
+    release = threading.Event()
+
+    def slow_render():
+        started.set()
+        release.wait()
+        window.Render()
+
+    async def main(render_thread):
+        render = render_thread.call_async(slow_render)
+        # the loop keeps running while the render is in flight
+        await asyncio.get_running_loop().run_in_executor(None, started.wait)
+        assert not render.done()
+        release.set()
+        await render
+        await render_thread.render_async()
+
+    with RenderThread(window) as render_thread:
+        asyncio.run(main(render_thread))
+    assert len(window.calls) == 2
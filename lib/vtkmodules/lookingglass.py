@@ -0,0 +1,332 @@
+"""Python helpers for the Looking Glass module.
+
+``SharedQuiltReader`` reads the quilts published by
+``vtkLookingGlassInterface.StartPublishingQuilt()`` or
+``vtkLookingGlassSharedQuiltPublisher`` from another process. It only needs
+the Python standard library, and numpy to return the quilts as arrays, so it
+can be used by processes that do not load VTK::
+
+    from vtkmodules.lookingglass import SharedQuiltReader
+
+    with SharedQuiltReader("lookingglass_quilt") as reader:
+        frame = 0
+        while reader.wait(frame, timeout=1.0):
+            info, quilt = reader.read()
+            frame = info["frame"]
+
+The layout of the shared memory is described in
+vtkLookingGlassSharedQuiltFormat.h.
+
+``quilt_array`` views the output of a ``vtkLookingGlassQuiltSource`` as a
+numpy array without copying it, in the same process::
+
+    from vtkmodules.lookingglass import quilt_array
+
+    source = vtkLookingGlassQuiltSource()
+    source.SetInterface(render_window.GetInterface())
+    source.SetLayoutToTiles()
+    render_window.Render()
+    source.Update()
+    tiles = quilt_array(source, tiles=True)  # tiles x height x width x 3
+
+``RenderThread`` renders a Looking Glass window on its own thread, so that
+the interpreter, a Jupyter kernel or an asyncio loop keeps running while a
+quilt renders::
+
+    from vtkmodules.lookingglass import RenderThread
+
+    with RenderThread(render_window) as render_thread:
+        await render_thread.render_async()
+        quilt = await render_thread.read_quilt_async()
+
+The render and save methods of the Looking Glass windows and interface
+release the GIL, so other Python threads run while they do. Rendering from
+a thread comes with rules, as OpenGL contexts and VTK objects are not
+thread safe:
+
+* Every call that uses the window's context goes through the render
+  thread once it exists: ``Render()``, ``Initialize()``, ``Finalize()``,
+  the quilt save, read and record methods, and
+  ``ReleaseGraphicsResources()``. Use ``call()`` for the ones without a
+  helper. Do not start an interactor on the window.
+* Objects the render reads, the renderers, cameras, lights, actors,
+  volumes, their properties, mappers and the pipelines feeding them, must
+  not be modified while a render is in flight. Modify them after awaiting
+  the render, or from the render thread with ``call()``.
+* Other VTK objects, such as the arrays returned by ``read_quilt()``, are
+  free to use from any thread.
+* Observers of the window, renderers and pipelines run on the render
+  thread.
+* Cocoa windows must render on the main thread, so ``RenderThread`` is not
+  supported on macOS.
+"""
+
+import asyncio
+import concurrent.futures
+import struct
+import sys
+import time
+from multiprocessing import shared_memory
+
+_MAGIC = b"LGSHARE\0"
+_VERSION = 1
+_HEADER_SIZE = 256
+_SLOT_HEADER_SIZE = 128
+_DEVICE_TYPE_LENGTH = 64
+
+# header: magic, version, header size, number of slots, (padding),
+# slot capacity, slot stride, latest frame, writer process, closed
+_HEADER = struct.Struct("=8sIIIIQQQqI")
+_LATEST_FRAME = struct.Struct("=Q")
+_LATEST_FRAME_OFFSET = 40
+_CLOSED_OFFSET = 56
+
+# slot: sequence, frame, timestamp, quilt size, quilt tiles, components,
+# (padding), aspect ratio, view angle, device type
+_SLOT = struct.Struct(f"=QQqiiiiiIdd{_DEVICE_TYPE_LENGTH}s")
+
+
+def _attach(name):
+    # The reader must not remove the segment when it exits, which the
+    # resource tracker of older Python versions does for every segment
+    try:
+        return shared_memory.SharedMemory(name=name, track=False)
+    except TypeError:
+        memory = shared_memory.SharedMemory(name=name)
+        if sys.platform != "win32":
+            from multiprocessing import resource_tracker
+
+            resource_tracker.unregister(memory._name, "shared_memory")
+        return memory
+
+
+class SharedQuiltReader:
+    """Read the latest quilt published through shared memory."""
+
+    def __init__(self, name):
+        self._memory = _attach(name)
+        self._buffer = self._memory.buf
+        header = _HEADER.unpack_from(self._buffer, 0)
+        magic, version, header_size, slots, _, capacity, stride = header[:7]
+        if magic != _MAGIC or version > _VERSION:
+            self.close()
+            raise ValueError(f"{name} does not hold published quilts")
+        self._slots = slots
+        self._capacity = capacity
+        self._stride = stride
+
+    def close(self):
+        """Release the shared memory. Arrays returned by read() stay valid."""
+        if self._memory is not None:
+            self._buffer = None
+            self._memory.close()
+            self._memory = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    @property
+    def latest_frame(self):
+        """The number of the latest published frame, 0 if there is none."""
+        return _LATEST_FRAME.unpack_from(self._buffer, _LATEST_FRAME_OFFSET)[0]
+
+    @property
+    def publisher_closed(self):
+        """True once the publisher stopped, no more frames will come."""
+        return struct.unpack_from("=I", self._buffer, _CLOSED_OFFSET)[0] != 0
+
+    def wait(self, frame, timeout=None):
+        """Wait for a frame newer than ``frame``.
+
+        Returns False if ``timeout`` seconds passed or the publisher stopped.
+        """
+        end = None if timeout is None else time.monotonic() + timeout
+        while self.latest_frame <= frame:
+            if self.publisher_closed:
+                return False
+            if end is not None and time.monotonic() > end:
+                return False
+            time.sleep(0.001)
+        return True
+
+    def read(self, attempts=100):
+        """Copy the latest quilt.
+
+        Returns ``(info, quilt)``, where ``info`` is a dict with the frame
+        number, the timestamp in nanoseconds since the epoch, the quilt size
+        and tiles, the aspect ratio, the view angle and the device type, and
+        ``quilt`` is a height x width x 3 numpy array of uint8, bottom row
+        first, or bytes if numpy is not available. Returns ``None`` if no
+        frame was published yet.
+        """
+        for _ in range(attempts):
+            frame = self.latest_frame
+            if frame == 0:
+                return None
+
+            offset = _HEADER_SIZE + ((frame - 1) % self._slots) * self._stride
+            before = _SLOT.unpack_from(self._buffer, offset)
+            sequence, slot_frame = before[0], before[1]
+            width, height = before[3], before[4]
+            size = width * height * 3
+            if sequence % 2 or width <= 0 or height <= 0 or size > self._capacity:
+                continue
+
+            start = offset + _SLOT_HEADER_SIZE
+            pixels = bytes(self._buffer[start:start + size])
+
+            # the copy is only valid if the slot was not written meanwhile
+            after = struct.unpack_from("=Q", self._buffer, offset)[0]
+            if after != sequence or slot_frame != frame:
+                continue
+
+            info = {
+                "frame": slot_frame,
+                "timestamp": before[2],
+                "quilt_size": (width, height),
+                "quilt_tiles": (before[5], before[6]),
+                "aspect_ratio": before[9],
+                "view_angle": before[10],
+                "device_type": before[11].split(b"\0", 1)[0].decode(),
+            }
+            try:
+                import numpy as np
+            except ImportError:
+                return info, pixels
+            quilt = np.frombuffer(pixels, dtype=np.uint8).reshape(height, width, 3)
+            return info, quilt
+
+        raise RuntimeError("The publisher kept overwriting the frames being read")
+
+
+def quilt_array(source, tiles=False):
+    """View the quilt held by a ``vtkLookingGlassQuiltSource`` as numpy.
+
+    Returns a height x width x 3 array of uint8, bottom row first, that
+    shares the memory of the source output. Later updates of the source
+    overwrite it in place while the quilt size stays the same.
+
+    With ``tiles=True``, returns a tiles x tile height x tile width x 3
+    array, tile 0 being the bottom left view. It is a view when the layout
+    of the source is ``TILES``. With the ``QUILT`` layout the tiles are not
+    contiguous and they are copied, use ``SetLayoutToTiles()`` to avoid it.
+    """
+    import numpy as np
+    from vtkmodules.util.numpy_support import vtk_to_numpy
+
+    image = source.GetOutput()
+    width, height, _ = image.GetDimensions()
+    pixels = vtk_to_numpy(image.GetPointData().GetScalars())
+    quilt = pixels.reshape(height, width, 3)
+    if not tiles:
+        return quilt
+
+    interface = source.GetInterface()
+    count = interface.GetNumberOfTiles()
+    tile_width, tile_height = interface.GetRenderSize()
+    if source.GetLayout() == source.TILES:
+        return quilt.reshape(count, tile_height, tile_width, 3)
+
+    columns, rows = interface.GetQuiltTiles()
+    grid = quilt[:rows * tile_height, :columns * tile_width]
+    grid = grid.reshape(rows, tile_height, columns, tile_width, 3).swapaxes(1, 2)
+    return np.ascontiguousarray(grid).reshape(count, tile_height, tile_width, 3)
+
+
+def view_matrices(interface, camera):
+    """Return the matrices of each view of the quilt for a base camera.
+
+    The result is a views x 2 x 4 x 4 numpy array holding the view and the
+    projection matrix of each view, as computed by
+    ``vtkLookingGlassInterface.GetViewMatrices()``, for rendering the views
+    with another renderer. The matrices of views rendered by
+    ``RenderViews()`` are in its ``matrices_<i>.npy`` files.
+    """
+    from vtkmodules.vtkCommonCore import vtkDoubleArray
+    from vtkmodules.util.numpy_support import vtk_to_numpy
+
+    matrices = vtkDoubleArray()
+    interface.GetViewMatrices(camera, matrices)
+    return vtk_to_numpy(matrices).reshape(-1, 2, 4, 4)
+
+
+class RenderThread:
+    """Run the rendering of a Looking Glass window on a dedicated thread.
+
+    All the methods return immediately. The plain methods return a
+    ``concurrent.futures.Future`` and the ``_async`` methods an asyncio
+    future to await. Calls run one after the other in the order they were
+    made. See the module documentation for the objects that must not be
+    touched while a call is in flight.
+    """
+
+    def __init__(self, render_window):
+        self._window = render_window
+        self._executor = concurrent.futures.ThreadPoolExecutor(
+            max_workers=1, thread_name_prefix="LookingGlassRender")
+
+    @property
+    def render_window(self):
+        return self._window
+
+    def close(self, wait=True):
+        """Stop the thread once the pending calls are done."""
+        self._executor.shutdown(wait=wait)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def call(self, function, *args, **kwargs):
+        """Call ``function`` on the render thread and return a future."""
+        return self._executor.submit(function, *args, **kwargs)
+
+    def call_async(self, function, *args, **kwargs):
+        """Like ``call()`` but return an asyncio future."""
+        return asyncio.wrap_future(self.call(function, *args, **kwargs))
+
+    def render(self):
+        """Render the quilt and draw it on the device."""
+        return self.call(self._window.Render)
+
+    def render_async(self):
+        return asyncio.wrap_future(self.render())
+
+    def save_quilt(self, file_name, render=False):
+        """Save the quilt as a PNG file, rendering it first if ``render``."""
+        def save():
+            if render:
+                self._window.Render()
+            self._window.SaveQuilt(file_name)
+        return self.call(save)
+
+    def save_quilt_async(self, file_name, render=False):
+        return asyncio.wrap_future(self.save_quilt(file_name, render))
+
+    def read_quilt(self, render=False):
+        """Read the quilt back as a height x width x 3 numpy array.
+
+        Each call returns a new array, bottom row first, that later renders
+        do not modify. The quilt is rendered first if ``render``.
+        """
+        def read():
+            from vtkmodules.vtkCommonDataModel import vtkImageData
+            from vtkmodules.util.numpy_support import vtk_to_numpy
+
+            if render:
+                self._window.Render()
+            image = vtkImageData()
+            self._window.GetInterface().ReadQuilt(image)
+            width, height, _ = image.GetDimensions()
+            pixels = vtk_to_numpy(image.GetPointData().GetScalars())
+            # the array keeps the VTK scalars alive through its base
+            return pixels.reshape(height, width, 3)
+        return self.call(read)
+
+    def read_quilt_async(self, render=False):
+        return asyncio.wrap_future(self.read_quilt(render))
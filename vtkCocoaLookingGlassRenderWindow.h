@@ -22,6 +22,7 @@
 
 #include "vtkCocoaRenderWindow.h"
 #include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkWrappingHints.h"               // For VTK_UNBLOCKTHREADS
 
 class vtkLookingGlassInterface;
 
@@ -42,6 +43,13 @@ public:
    */
   int* GetSize() VTK_SIZEHINT(2) override;
 
+  /**
+   * Render the quilt and draw it on the device. The Python GIL is released
+   * while rendering, see vtkmodules.lookingglass.RenderThread for rendering
+   * from a Python thread.
+   */
+  VTK_UNBLOCKTHREADS void Render() override;
+
   /**
    * Free up any graphics resources associated with this window
    * a value of nullptr means the context may already be destroyed
@@ -61,7 +69,22 @@ public:
   /**
    * Save a quilt to a PNG file
    */
-  void SaveQuilt(const char* fileName);
+  VTK_UNBLOCKTHREADS void SaveQuilt(const char* fileName);
+
+  /**
+   * Render the quilt row by row of tiles straight into a PNG file, so that
+   * quilts larger than the GPU or host memory can hold may be saved. `scale`
+   * oversamples each tile relative to the render size.
+   */
+  VTK_UNBLOCKTHREADS void SaveQuiltStreamed(const char* fileName, double scale = 1.0);
+
+  /**
+   * Save quilts for several device types while rendering the views they
+   * share only once. The files are named
+   * `<filePrefix><deviceType><suffix>.png`.
+   */
+  VTK_UNBLOCKTHREADS void SaveQuilts(
+    const std::vector<std::string>& deviceTypes, const char* filePrefix);
 
   /**
    * Start recording a quilt
@@ -73,6 +96,34 @@ public:
    */
   void StopRecordingQuilt();
 
+  /**
+   * Publish every rendered quilt to other processes through the named
+   * shared memory segment.
+   */
+  bool StartPublishingQuilt(const char* name);
+
+  /**
+   * Stop publishing quilts
+   */
+  void StopPublishingQuilt();
+
+  /**
+   * Play a quilt movie on the device instead of rendering the scene. The
+   * window keeps showing the frame that is due each time it renders, so it
+   * should be rendered at least at the movie's frame rate.
+   */
+  bool StartQuiltMoviePlayback(const char* fileName, bool loop = false);
+
+  /**
+   * Stop playing the quilt movie and go back to rendering the scene.
+   */
+  void StopQuiltMoviePlayback();
+
+  /**
+   * Check if a quilt movie is being played.
+   */
+  bool IsPlayingQuiltMovie() const;
+
   /**
    * Get the movie extension that should be used for quilt movies
    */
@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkEGLLookingGlassRenderWindow
+ * @brief   LookingGlass rendering window without a display server
+ *
+ * A drop in replacement for vtkEGLRenderWindow that renders the quilts of
+ * a LookingGlass display without an X server, such as on render servers
+ * or in containers. The quilts can be saved, recorded, published and sent
+ * like with the on-screen windows. When no device is attached the light
+ * field is not drawn at all.
+ *
+ * SetDeviceIndex() selects the LookingGlass device, use
+ * vtkEGLRenderWindow::SetDeviceIndex() to select the EGL device.
+ */
+
+#ifndef vtkEGLLookingGlassRenderWindow_h
+#define vtkEGLLookingGlassRenderWindow_h
+
+#include "vtkEGLRenderWindow.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkWrappingHints.h"               // For VTK_UNBLOCKTHREADS
+
+class vtkLookingGlassInterface;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkEGLLookingGlassRenderWindow
+  : public vtkEGLRenderWindow
+{
+public:
+  static vtkEGLLookingGlassRenderWindow* New();
+  vtkTypeMacro(vtkEGLLookingGlassRenderWindow, vtkEGLRenderWindow);
+
+  // Get the LookingGlassInterface being used by this window.
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+
+  /**
+   * Get the size (width and height) of the rendering window.
+   * We override so that durnig the render process we can return
+   * a size of the render framebuffer as opposed to the final
+   * buffer.
+   */
+  int* GetSize() VTK_SIZEHINT(2) override;
+
+  /**
+   * Render the quilt and draw it on the device. The Python GIL is released
+   * while rendering, see vtkmodules.lookingglass.RenderThread for rendering
+   * from a Python thread.
+   */
+  VTK_UNBLOCKTHREADS void Render() override;
+
+  /**
+   * Free up any graphics resources associated with this window
+   * a value of nullptr means the context may already be destroyed
+   */
+  void ReleaseGraphicsResources(vtkWindow*) override;
+
+  /**
+   * Set index of the Looking Glass device on which this window should appear.
+   */
+  void SetLGDeviceIndex(int index);
+
+  /**
+   * Save a quilt to a PNG file
+   */
+  VTK_UNBLOCKTHREADS void SaveQuilt(const char* fileName);
+
+  /**
+   * Render the quilt row by row of tiles straight into a PNG file, so that
+   * quilts larger than the GPU or host memory can hold may be saved. `scale`
+   * oversamples each tile relative to the render size.
+   */
+  VTK_UNBLOCKTHREADS void SaveQuiltStreamed(const char* fileName, double scale = 1.0);
+
+  /**
+   * Save quilts for several device types while rendering the views they
+   * share only once. The files are named
+   * `<filePrefix><deviceType><suffix>.png`.
+   */
+  VTK_UNBLOCKTHREADS void SaveQuilts(
+    const std::vector<std::string>& deviceTypes, const char* filePrefix);
+
+  /**
+   * Start recording a quilt
+   */
+  void StartRecordingQuilt(const char* fileName);
+
+  /**
+   * Stop recording a quilt
+   */
+  void StopRecordingQuilt();
+
+  /**
+   * Publish every rendered quilt to other processes through the named
+   * shared memory segment.
+   */
+  bool StartPublishingQuilt(const char* name);
+
+  /**
+   * Stop publishing quilts
+   */
+  void StopPublishingQuilt();
+
+  /**
+   * Play a quilt movie on the device instead of rendering the scene. The
+   * window keeps showing the frame that is due each time it renders, so it
+   * should be rendered at least at the movie's frame rate.
+   */
+  bool StartQuiltMoviePlayback(const char* fileName, bool loop = false);
+
+  /**
+   * Stop playing the quilt movie and go back to rendering the scene.
+   */
+  void StopQuiltMoviePlayback();
+
+  /**
+   * Check if a quilt movie is being played.
+   */
+  bool IsPlayingQuiltMovie() const;
+
+  /**
+   * Get the movie extension that should be used for quilt movies
+   */
+  static const char* MovieFileExtension();
+
+  /**
+   * Get the quilt file suffix as a string. The suffix encodes the number of
+   * tiles in the width and the height. For example, if the quilt file name
+   * is "quilt_qs5x9.png", the suffix is "_qs5x9", and it means that the quilt
+   * is 5 tiles wide and 9 tiles high.
+   */
+  std::string QuiltFileSuffix() const;
+
+  /**
+   * Turn on/off use of near and far clipping limits.
+   */
+  void SetUseClippingLimits(bool b);
+
+  /**
+   * Turn on/off use of near and far clipping limits.
+   */
+  bool GetUseClippingLimits() const;
+  vtkBooleanMacro(UseClippingLimits, bool);
+
+  /**
+   * Set/Get limit for the ratio of the far clipping plane to the focal
+   * distance. This is a mechanism to limit parallex and resulting
+   * ghosting when using the looking glass display. The typical value
+   * should be around 1.2.
+   */
+  void SetFarClippingLimit(double d);
+
+  /**
+   * Set/Get limit for the ratio of the far clipping plane to the focal
+   * distance. This is a mechanism to limit parallex and resulting
+   * ghosting when using the looking glass display. The typical value
+   * should be around 1.2.
+   */
+  double GetFarClippingLimit() const;
+
+  /**
+   * Set/Get limit for the ratio of the near clipping plane to the focal
+   * distance. This is a mechanism to limit parallex and resulting
+   * ghosting when using the looking glass display. The typical value
+   * should be around 0.8.
+   */
+  void SetNearClippingLimit(double d);
+
+  /**
+   * Set/Get limit for the ratio of the near clipping plane to the focal
+   * distance. This is a mechanism to limit parallex and resulting
+   * ghosting when using the looking glass display. The typical value
+   * should be around 0.8.
+   */
+  double GetNearClippingLimit() const;
+
+  /**
+   * Check if a movie quilt is currently being recorded.
+   */
+  bool IsRecordingQuilt() const;
+
+  /**
+   * Set/Get which LookingGlass device to use. DeviceIndex starts at 0 and
+   * increases.
+   */
+  void SetDeviceIndex(int i);
+
+  /**
+   * Set/Get which LookingGlass device to use. DeviceIndex starts at 0 and
+   * increases.
+   */
+  int GetDeviceIndex() const;
+
+  /**
+   * Set/Get which LookingGlass device type to target. This allows a quilt to be
+   * generated for a device that is not connected in the future.
+   */
+  void SetDeviceType(const std::string &t);
+
+  /**
+   * Set/Get which LookingGlass device type to target. This allows a quilt to be
+   * generated for a device that is not connected in the future.
+   */
+  std::string GetDeviceType() const;
+
+  /**
+   * Returns a vector of available device types.
+   */
+  static std::vector<std::string> GetDeviceTypes();
+
+protected:
+  vtkEGLLookingGlassRenderWindow();
+  ~vtkEGLLookingGlassRenderWindow() override;
+
+  vtkLookingGlassInterface* Interface = nullptr;
+
+  void InitializeInterface();
+
+  void DoStereoRender() override;
+  bool InStereoRender;
+
+private:
+  vtkEGLLookingGlassRenderWindow(const vtkEGLLookingGlassRenderWindow&) = delete;
+  void operator=(const vtkEGLLookingGlassRenderWindow&) = delete;
+};
+
+#endif
@@ -0,0 +1,462 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassFrameStatistics.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLRenderTimer.h"
+#include "vtkRenderTimerLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+vtkStandardNewMacro(vtkLookingGlassFrameStatistics);
+
+namespace
+{
+const char* PhaseNames[vtkLookingGlassFrameStatistics::NUMBER_OF_PHASES] = { "CameraSetup",
+  "TileRender", "Blit", "Interlace", "Readback", "Encode" };
+
+double Milliseconds(std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassFrameStatistics::vtkLookingGlassFrameStatistics()
+  : WindowSize(120)
+  , GPUTiming(true)
+  , FrameNumber(0)
+  , NumberOfTiles(0)
+  , FrameOpen(false)
+  , Log(nullptr)
+  , ActivePhase(-1)
+  , ActiveTile(-1)
+  , ActiveTimer(nullptr)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassFrameStatistics::~vtkLookingGlassFrameStatistics()
+{
+  // without a context the queries can only be dropped
+  for (Query& query : this->Queries)
+  {
+    delete query.Timer;
+  }
+  for (vtkOpenGLRenderTimer* timer : this->FreeTimers)
+  {
+    delete timer;
+  }
+  delete this->ActiveTimer;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "WindowSize: " << this->WindowSize << "\n";
+  os << indent << "GPUTiming: " << (this->GPUTiming ? "On" : "Off") << "\n";
+  os << indent << "FrameNumber: " << this->FrameNumber << "\n";
+  os << indent << "NumberOfFrames: " << this->GetNumberOfFrames() << "\n";
+  os << indent << "AverageFrameTime: " << this->GetAverageFrameTime() << " ms\n";
+  for (int phase = 0; phase < NUMBER_OF_PHASES; ++phase)
+  {
+    os << indent << PhaseNames[phase] << ": CPU " << this->GetAverageCPUTime(phase) << " ms, GPU "
+       << this->GetAverageGPUTime(phase) << " ms, " << this->GetAverageBytes(phase)
+       << " bytes\n";
+  }
+}
+
+//------------------------------------------------------------------------------
+const char* vtkLookingGlassFrameStatistics::GetPhaseName(int phase)
+{
+  return phase >= 0 && phase < NUMBER_OF_PHASES ? PhaseNames[phase] : "Unknown";
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::Reset()
+{
+  // the queries still in flight belong to dropped frames, the numbers start
+  // from 1 so that they match none of the next ones
+  for (Query& query : this->Queries)
+  {
+    query.FrameNumber = 0;
+  }
+  this->Frames.clear();
+  this->FrameNumber = 0;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::BeginFrame(int numberOfTiles, vtkRenderTimerLog* log)
+{
+  if (this->FrameOpen)
+  {
+    this->EndFrame();
+  }
+
+  this->NumberOfTiles = numberOfTiles;
+  this->Current = Frame();
+  this->Current.Number = this->FrameNumber + 1;
+  this->Current.TileCPU.assign(numberOfTiles, 0.0);
+  this->Current.TileGPU.assign(numberOfTiles, 0.0);
+  this->Current.GPUTimed = this->GPUTiming && vtkOpenGLRenderTimer::IsSupported();
+  this->FrameOpen = true;
+  this->FrameStart = std::chrono::steady_clock::now();
+  this->Log = log && log->GetLoggingEnabled() ? log : nullptr;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::StartPhase(int phase, int tile)
+{
+  if (!this->FrameOpen || phase < 0 || phase >= NUMBER_OF_PHASES)
+  {
+    return;
+  }
+  if (this->ActivePhase >= 0)
+  {
+    this->StopPhase();
+  }
+
+  this->ActivePhase = phase;
+  this->ActiveTile = tile >= 0 && tile < this->NumberOfTiles ? tile : -1;
+  if (this->Log)
+  {
+    std::string name = std::string("LookingGlass ") + PhaseNames[phase];
+    if (this->ActiveTile >= 0)
+    {
+      name += " " + std::to_string(this->ActiveTile);
+    }
+    this->Log->MarkStartEvent(name);
+  }
+  if (this->Current.GPUTimed)
+  {
+    if (this->FreeTimers.empty())
+    {
+      this->ActiveTimer = new vtkOpenGLRenderTimer;
+    }
+    else
+    {
+      this->ActiveTimer = this->FreeTimers.back();
+      this->FreeTimers.pop_back();
+    }
+    this->ActiveTimer->Reset();
+    this->ActiveTimer->Start();
+  }
+  this->PhaseStart = std::chrono::steady_clock::now();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::StopPhase(vtkTypeInt64 bytes)
+{
+  if (this->ActivePhase < 0)
+  {
+    return;
+  }
+
+  const double cpu = Milliseconds(std::chrono::steady_clock::now() - this->PhaseStart);
+  this->Current.CPU[this->ActivePhase] += cpu;
+  this->Current.Bytes[this->ActivePhase] += bytes;
+  if (this->ActiveTile >= 0 && this->ActivePhase == TILE_RENDER)
+  {
+    this->Current.TileCPU[this->ActiveTile] += cpu;
+  }
+  if (this->ActiveTimer)
+  {
+    this->ActiveTimer->Stop();
+    this->Queries.push_back(
+      { this->Current.Number, this->ActivePhase, this->ActiveTile, this->ActiveTimer });
+    ++this->Current.PendingQueries;
+    this->ActiveTimer = nullptr;
+  }
+  if (this->Log)
+  {
+    this->Log->MarkEndEvent();
+  }
+  this->ActivePhase = -1;
+  this->ActiveTile = -1;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassFrameStatistics::EndFrame()
+{
+  if (!this->FrameOpen)
+  {
+    return false;
+  }
+  this->StopPhase();
+
+  this->Current.Time = Milliseconds(std::chrono::steady_clock::now() - this->FrameStart);
+  this->FrameNumber = this->Current.Number;
+  this->Frames.push_back(this->Current);
+  while (static_cast<int>(this->Frames.size()) > this->WindowSize)
+  {
+    this->Frames.pop_front();
+  }
+  this->FrameOpen = false;
+  this->Log = nullptr;
+
+  this->PollQueries();
+  this->Modified();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassFrameStatistics::Frame* vtkLookingGlassFrameStatistics::FindFrame(
+  vtkTypeUInt64 number)
+{
+  if (this->FrameOpen && this->Current.Number == number)
+  {
+    return &this->Current;
+  }
+  for (auto it = this->Frames.rbegin(); it != this->Frames.rend(); ++it)
+  {
+    if (it->Number == number)
+    {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::PollQueries()
+{
+  // the queries complete in order, stop at the first one still in flight
+  while (!this->Queries.empty() && this->Queries.front().Timer->Ready())
+  {
+    Query query = this->Queries.front();
+    this->Queries.pop_front();
+    Frame* frame = this->FindFrame(query.FrameNumber);
+    if (frame)
+    {
+      const double gpu = query.Timer->GetElapsedMilliseconds();
+      frame->GPU[query.Phase] += gpu;
+      if (query.Tile >= 0 && query.Phase == TILE_RENDER)
+      {
+        frame->TileGPU[query.Tile] += gpu;
+      }
+      --frame->PendingQueries;
+    }
+    this->FreeTimers.push_back(query.Timer);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassFrameStatistics::ReleaseGraphicsResources()
+{
+  // the results still in flight are lost, their frames never get GPU times
+  for (Query& query : this->Queries)
+  {
+    query.Timer->ReleaseGraphicsResources();
+    delete query.Timer;
+  }
+  this->Queries.clear();
+  for (vtkOpenGLRenderTimer* timer : this->FreeTimers)
+  {
+    timer->ReleaseGraphicsResources();
+    delete timer;
+  }
+  this->FreeTimers.clear();
+  if (this->ActiveTimer)
+  {
+    this->ActiveTimer->ReleaseGraphicsResources();
+    delete this->ActiveTimer;
+    this->ActiveTimer = nullptr;
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassFrameStatistics::GetNumberOfGPUFrames() const
+{
+  return static_cast<int>(std::count_if(this->Frames.begin(), this->Frames.end(),
+    [](const Frame& frame) { return frame.HasGPUTimes(); }));
+}
+
+//------------------------------------------------------------------------------
+const vtkLookingGlassFrameStatistics::Frame* vtkLookingGlassFrameStatistics::LastFrame(
+  bool gpu) const
+{
+  for (auto it = this->Frames.rbegin(); it != this->Frames.rend(); ++it)
+  {
+    if (!gpu || it->HasGPUTimes())
+    {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template <typename Getter>
+double vtkLookingGlassFrameStatistics::Average(Getter get, bool gpu) const
+{
+  double sum = 0.0;
+  int count = 0;
+  for (const Frame& frame : this->Frames)
+  {
+    if (!gpu || frame.HasGPUTimes())
+    {
+      sum += get(frame);
+      ++count;
+    }
+  }
+  return count > 0 ? sum / count : (gpu ? -1.0 : 0.0);
+}
+
+//------------------------------------------------------------------------------
+template <typename Getter>
+double vtkLookingGlassFrameStatistics::Percentile(Getter get, bool gpu, double percentile) const
+{
+  std::vector<double> values;
+  for (const Frame& frame : this->Frames)
+  {
+    if (!gpu || frame.HasGPUTimes())
+    {
+      values.push_back(get(frame));
+    }
+  }
+  if (values.empty())
+  {
+    return gpu ? -1.0 : 0.0;
+  }
+
+  // nearest rank
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size()));
+  rank = rank > 0 ? rank - 1 : 0;
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetLastFrameTime() const
+{
+  const Frame* frame = this->LastFrame(false);
+  return frame ? frame->Time : 0.0;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetAverageFrameTime() const
+{
+  return this->Average([](const Frame& frame) { return frame.Time; }, false);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetFrameTimePercentile(double percentile) const
+{
+  return this->Percentile([](const Frame& frame) { return frame.Time; }, false, percentile);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetLastCPUTime(int phase) const
+{
+  const Frame* frame = this->LastFrame(false);
+  return frame && phase >= 0 && phase < NUMBER_OF_PHASES ? frame->CPU[phase] : 0.0;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetAverageCPUTime(int phase) const
+{
+  if (phase < 0 || phase >= NUMBER_OF_PHASES)
+  {
+    return 0.0;
+  }
+  return this->Average([phase](const Frame& frame) { return frame.CPU[phase]; }, false);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetCPUTimePercentile(int phase, double percentile) const
+{
+  if (phase < 0 || phase >= NUMBER_OF_PHASES)
+  {
+    return 0.0;
+  }
+  return this->Percentile(
+    [phase](const Frame& frame) { return frame.CPU[phase]; }, false, percentile);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetLastGPUTime(int phase) const
+{
+  const Frame* frame = this->LastFrame(true);
+  return frame && phase >= 0 && phase < NUMBER_OF_PHASES ? frame->GPU[phase] : -1.0;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetAverageGPUTime(int phase) const
+{
+  if (phase < 0 || phase >= NUMBER_OF_PHASES)
+  {
+    return -1.0;
+  }
+  return this->Average([phase](const Frame& frame) { return frame.GPU[phase]; }, true);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetGPUTimePercentile(int phase, double percentile) const
+{
+  if (phase < 0 || phase >= NUMBER_OF_PHASES)
+  {
+    return -1.0;
+  }
+  return this->Percentile(
+    [phase](const Frame& frame) { return frame.GPU[phase]; }, true, percentile);
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkLookingGlassFrameStatistics::GetLastBytes(int phase) const
+{
+  const Frame* frame = this->LastFrame(false);
+  return frame && phase >= 0 && phase < NUMBER_OF_PHASES ? frame->Bytes[phase] : 0;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetAverageBytes(int phase) const
+{
+  if (phase < 0 || phase >= NUMBER_OF_PHASES)
+  {
+    return 0.0;
+  }
+  return this->Average(
+    [phase](const Frame& frame) { return static_cast<double>(frame.Bytes[phase]); }, false);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetAverageTileCPUTime(int tile) const
+{
+  if (tile < 0 || tile >= this->NumberOfTiles)
+  {
+    return 0.0;
+  }
+  return this->Average(
+    [tile](const Frame& frame) {
+      return tile < static_cast<int>(frame.TileCPU.size()) ? frame.TileCPU[tile] : 0.0;
+    },
+    false);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassFrameStatistics::GetAverageTileGPUTime(int tile) const
+{
+  if (tile < 0 || tile >= this->NumberOfTiles)
+  {
+    return -1.0;
+  }
+  return this->Average(
+    [tile](const Frame& frame) {
+      return tile < static_cast<int>(frame.TileGPU.size()) ? frame.TileGPU[tile] : 0.0;
+    },
+    true);
+}
@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassFrameStatistics
+ * @brief   CPU and GPU timings of the phases of Looking Glass frames.
+ *
+ * vtkLookingGlassInterface fills this object when its CollectStatistics
+ * option is on. Each frame, from the start of RenderQuilt() to the end of
+ * the DrawLightField() that shows the quilt, is split into phases. The CPU
+ * time of each phase is measured with a steady clock, and the GPU time with
+ * OpenGL timer queries through vtkOpenGLRenderTimer. GPU times become
+ * available a few frames later, without stalling the pipeline, so the GPU
+ * statistics cover the frames whose queries completed. The bytes of pixels
+ * each phase reads or writes are counted from the sizes of the images.
+ *
+ * The statistics are kept over a rolling window of the last WindowSize
+ * frames, and give the last value, the average and percentiles of each
+ * phase, plus the render time of each tile. The interface fires a
+ * FrameEvent with this object as call data when a frame is complete.
+ *
+ * When logging is enabled on the vtkRenderTimerLog of the render window,
+ * the phases also appear in it as "LookingGlass ..." events.
+ *
+ * @sa
+ * vtkLookingGlassInterface vtkRenderTimerLog
+ */
+
+#ifndef vtkLookingGlassFrameStatistics_h
+#define vtkLookingGlassFrameStatistics_h
+
+#include "vtkCommand.h" // For vtkCommand::UserEvent
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <chrono> // For std::chrono
+#include <deque>  // For std::deque
+#include <vector> // For std::vector
+
+class vtkOpenGLRenderTimer;
+class vtkRenderTimerLog;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassFrameStatistics : public vtkObject
+{
+public:
+  static vtkLookingGlassFrameStatistics* New();
+  vtkTypeMacro(vtkLookingGlassFrameStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * The phases of a frame. CAMERA_SETUP adjusts the cameras of each tile,
+   * TILE_RENDER renders the tiles, BLIT copies them into the quilt,
+   * INTERLACE draws the quilt on the device, READBACK reads the quilt back
+   * for recording, publishing or streaming, and ENCODE writes or sends it.
+   */
+  enum Phases
+  {
+    CAMERA_SETUP = 0,
+    TILE_RENDER,
+    BLIT,
+    INTERLACE,
+    READBACK,
+    ENCODE,
+    NUMBER_OF_PHASES
+  };
+
+  /**
+   * The event fired by vtkLookingGlassInterface for each complete frame.
+   */
+  enum
+  {
+    FrameEvent = vtkCommand::UserEvent + 1
+  };
+
+  /**
+   * Get the name of a phase, such as "TileRender".
+   */
+  static const char* GetPhaseName(int phase);
+
+  //@{
+  /**
+   * Set/Get the number of frames the statistics are computed over.
+   * Default is 120.
+   */
+  vtkSetClampMacro(WindowSize, int, 1, 100000);
+  vtkGetMacro(WindowSize, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get whether GPU times are measured. Default is on.
+   */
+  vtkSetMacro(GPUTiming, bool);
+  vtkGetMacro(GPUTiming, bool);
+  vtkBooleanMacro(GPUTiming, bool);
+  //@}
+
+  /**
+   * Forget all the frames.
+   */
+  void Reset();
+
+  /**
+   * Get the number of complete frames in the window, and the number of
+   * those with GPU times.
+   */
+  int GetNumberOfFrames() const { return static_cast<int>(this->Frames.size()); }
+  int GetNumberOfGPUFrames() const;
+
+  /**
+   * Get the number of the last complete frame, counting from 1.
+   */
+  vtkGetMacro(FrameNumber, vtkTypeUInt64);
+
+  //@{
+  /**
+   * Wall clock time of the frames in milliseconds.
+   */
+  double GetLastFrameTime() const;
+  double GetAverageFrameTime() const;
+  double GetFrameTimePercentile(double percentile) const;
+  //@}
+
+  //@{
+  /**
+   * CPU time of a phase in milliseconds, summed over the frame. The
+   * percentile is between 0 and 100.
+   */
+  double GetLastCPUTime(int phase) const;
+  double GetAverageCPUTime(int phase) const;
+  double GetCPUTimePercentile(int phase, double percentile) const;
+  //@}
+
+  //@{
+  /**
+   * GPU time of a phase in milliseconds, summed over the frame. Returns -1
+   * when no frame has GPU times yet.
+   */
+  double GetLastGPUTime(int phase) const;
+  double GetAverageGPUTime(int phase) const;
+  double GetGPUTimePercentile(int phase, double percentile) const;
+  //@}
+
+  //@{
+  /**
+   * Bytes of pixels read or written by a phase over the frame.
+   */
+  vtkTypeInt64 GetLastBytes(int phase) const;
+  double GetAverageBytes(int phase) const;
+  //@}
+
+  //@{
+  /**
+   * Average CPU and GPU time in milliseconds of the TILE_RENDER phase of
+   * each tile, to find the views that are more expensive. The GPU time is
+   * -1 when no frame has GPU times yet.
+   */
+  int GetNumberOfTiles() const { return this->NumberOfTiles; }
+  double GetAverageTileCPUTime(int tile) const;
+  double GetAverageTileGPUTime(int tile) const;
+  //@}
+
+  //@{
+  /**
+   * Used by vtkLookingGlassInterface to record a frame, with the OpenGL
+   * context current. Phases are recorded one at a time, and only while a
+   * frame is open. The log, if any, must stay valid until EndFrame().
+   * EndFrame() returns false if no frame was open.
+   */
+  void BeginFrame(int numberOfTiles, vtkRenderTimerLog* log = nullptr);
+  bool IsFrameOpen() const { return this->FrameOpen; }
+  void StartPhase(int phase, int tile = -1);
+  void StopPhase(vtkTypeInt64 bytes = 0);
+  bool EndFrame();
+  //@}
+
+  /**
+   * Release the timer queries, the context must be current.
+   */
+  void ReleaseGraphicsResources();
+
+protected:
+  vtkLookingGlassFrameStatistics();
+  ~vtkLookingGlassFrameStatistics() override;
+
+  struct Frame
+  {
+    vtkTypeUInt64 Number = 0;
+    double Time = 0.0;
+    double CPU[NUMBER_OF_PHASES] = {};
+    double GPU[NUMBER_OF_PHASES] = {};
+    vtkTypeInt64 Bytes[NUMBER_OF_PHASES] = {};
+    std::vector<double> TileCPU;
+    std::vector<double> TileGPU;
+    // timer queries not yet available
+    int PendingQueries = 0;
+    bool GPUTimed = false;
+
+    bool HasGPUTimes() const { return this->GPUTimed && this->PendingQueries == 0; }
+  };
+
+  struct Query
+  {
+    vtkTypeUInt64 FrameNumber;
+    int Phase;
+    int Tile;
+    vtkOpenGLRenderTimer* Timer;
+  };
+
+  // collect the results of the queries that are available
+  void PollQueries();
+  Frame* FindFrame(vtkTypeUInt64 number);
+
+  // statistics of a value over the frames, with GPU values only taken from
+  // the frames that have them
+  template <typename Getter>
+  double Average(Getter get, bool gpu) const;
+  template <typename Getter>
+  double Percentile(Getter get, bool gpu, double percentile) const;
+  const Frame* LastFrame(bool gpu) const;
+
+  int WindowSize;
+  bool GPUTiming;
+  vtkTypeUInt64 FrameNumber;
+  int NumberOfTiles;
+
+  std::deque<Frame> Frames;
+  Frame Current;
+  bool FrameOpen;
+  std::chrono::steady_clock::time_point FrameStart;
+  vtkRenderTimerLog* Log;
+
+  int ActivePhase;
+  int ActiveTile;
+  std::chrono::steady_clock::time_point PhaseStart;
+  vtkOpenGLRenderTimer* ActiveTimer;
+
+  std::deque<Query> Queries;
+  std::vector<vtkOpenGLRenderTimer*> FreeTimers;
+
+private:
+  vtkLookingGlassFrameStatistics(const vtkLookingGlassFrameStatistics&) = delete;
+  void operator=(const vtkLookingGlassFrameStatistics&) = delete;
+};
+
+#endif
@@ -43,9 +43,22 @@ IN THE SOFTWARE.
 #include "HoloPlayShadersOpen.h"
 
 #include "vtkCamera.h"
-#include "vtkDataArray.h"
+#include "vtkCollection.h"
+#include "vtkDoubleArray.h"
 #include "vtkImageData.h"
+#include "vtkLookingGlassFrameStatistics.h"
+#include "vtkLookingGlassQuiltClient.h"
+#include "vtkLookingGlassQuiltPlayer.h"
+#include "vtkLookingGlassQuiltSequenceReader.h"
+#include "vtkLookingGlassQuiltSequenceWriter.h"
+#include "vtkLookingGlassQuiltServer.h"
+#include "vtkLookingGlassRenderGraph.h"
+#include "vtkLookingGlassResourcePool.h"
+#include "vtkLookingGlassSharedQuiltPublisher.h"
+#include "vtkLookingGlassTrace.h"
+#include "vtkLookingGlassViewWriter.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOpenGLFramebufferObject.h"
@@ -55,15 +68,19 @@ IN THE SOFTWARE.
 #include "vtkOpenGLState.h"
 #include "vtkPNGWriter.h"
 #include "vtkPixelBufferObject.h"
-#include "vtkPixelExtent.h"
-#include "vtkPixelTransfer.h"
-#include "vtkPointData.h"
 #include "vtkRendererCollection.h"
 #include "vtkShaderProgram.h"
+#include "vtkSmartPointer.h"
 #include "vtkTextureObject.h"
 #include "vtkVector.h"
 
 #include "vtk_glad.h"
+#include "vtk_png.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
 
 #include "vtkRenderingOpenGLConfigure.h"
 
@@ -76,6 +93,17 @@ IN THE SOFTWARE.
 #ifdef VTK_USE_COCOA
 #include "vtkCocoaLookingGlassRenderWindow.h"
 #endif
+#ifdef VTK_OPENGL_HAS_EGL
+#include "vtkEGLLookingGlassRenderWindow.h"
+#endif
+#ifdef VTK_OPENGL_HAS_OSMESA
+#include "vtkOSOpenGLLookingGlassRenderWindow.h"
+#endif
+
+#if VTK_MODULE_ENABLE_VTK_IOFFMPEG
+// Used to play quilt movies
+#include "vtkFFMPEGVideoSource.h"
+#endif
 
 #ifdef VTK_USE_MICROSOFT_MEDIA_FOUNDATION
 // Use the MP4 writer on Windows
@@ -94,6 +122,101 @@ using MovieWriterClass = vtkOggTheoraWriter;
 static const char* MovieExtension = "ogv";
 #endif
 
+namespace
+{
+// Writes an RGB PNG one row at a time so that a quilt never has to be held
+// in memory as a whole. libpng reports errors through longjmp, so every call
+// into it sets its own jump buffer.
+class vtkQuiltPNGStream
+{
+public:
+  ~vtkQuiltPNGStream()
+  {
+    if (this->PNG)
+    {
+      png_destroy_write_struct(&this->PNG, &this->Info);
+    }
+    if (this->File)
+    {
+      fclose(this->File);
+    }
+  }
+
+  bool Open(const char* fileName, int width, int height)
+  {
+    this->File = vtksys::SystemTools::Fopen(fileName, "wb");
+    if (!this->File)
+    {
+      return false;
+    }
+    this->PNG = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (!this->PNG)
+    {
+      return false;
+    }
+    this->Info = png_create_info_struct(this->PNG);
+    if (!this->Info)
+    {
+      return false;
+    }
+    if (setjmp(png_jmpbuf(this->PNG)))
+    {
+      return false;
+    }
+    png_init_io(this->PNG, this->File);
+    png_set_IHDR(this->PNG, this->Info, width, height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+      PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(this->PNG, this->Info);
+    return true;
+  }
+
+  bool WriteRow(unsigned char* row)
+  {
+    if (setjmp(png_jmpbuf(this->PNG)))
+    {
+      return false;
+    }
+    png_write_row(this->PNG, row);
+    return true;
+  }
+
+  bool Close()
+  {
+    if (setjmp(png_jmpbuf(this->PNG)))
+    {
+      return false;
+    }
+    png_write_end(this->PNG, this->Info);
+    png_destroy_write_struct(&this->PNG, &this->Info);
+    this->PNG = nullptr;
+    this->Info = nullptr;
+    bool ok = fclose(this->File) == 0;
+    this->File = nullptr;
+    return ok;
+  }
+
+private:
+  FILE* File = nullptr;
+  png_structp PNG = nullptr;
+  png_infop Info = nullptr;
+};
+
+// creates a Looking Glass window of one of the OS specific classes
+template <typename WindowType>
+vtkOpenGLRenderWindow* NewRenderWindow(int deviceIndex)
+{
+  WindowType* renWin = WindowType::New();
+  renWin->SetLGDeviceIndex(deviceIndex);
+  return renWin;
+}
+
+// quilt sequences are recorded and played without going through a movie codec
+bool IsQuiltSequenceFile(const char* fileName)
+{
+  return fileName && vtksys::SystemTools::GetFilenameLastExtension(fileName) == ".lgq";
+}
+}
+
 //------------------------------------------------------------------------------
 const char* vtkLookingGlassInterface::MovieFileExtension()
 {
@@ -104,21 +227,40 @@ const char* vtkLookingGlassInterface::MovieFileExtension()
 vtkOpenGLRenderWindow* vtkLookingGlassInterface::CreateLookingGlassRenderWindow(int deviceIndex)
 {
 #ifdef WIN32
-  auto renWin = vtkWin32LookingGlassRenderWindow::New();
+  return NewRenderWindow<vtkWin32LookingGlassRenderWindow>(deviceIndex);
+#elif defined(VTK_USE_COCOA)
+  return NewRenderWindow<vtkCocoaLookingGlassRenderWindow>(deviceIndex);
+#else
+#ifdef VTK_USE_X
+  // render headless when there is no display server to open a window on
+  bool headless = !vtksys::SystemTools::HasEnv("DISPLAY");
+#else
+  bool headless = true;
+#endif
+#ifdef VTK_OPENGL_HAS_EGL
+  if (headless)
+  {
+    return NewRenderWindow<vtkEGLLookingGlassRenderWindow>(deviceIndex);
+  }
+#elif defined(VTK_OPENGL_HAS_OSMESA)
+  if (headless)
+  {
+    return NewRenderWindow<vtkOSOpenGLLookingGlassRenderWindow>(deviceIndex);
+  }
 #endif
+  (void)headless;
 #ifdef VTK_USE_X
-  auto renWin = vtkXLookingGlassRenderWindow::New();
+  return NewRenderWindow<vtkXLookingGlassRenderWindow>(deviceIndex);
+#else
+  (void)deviceIndex;
+  return nullptr;
 #endif
-#ifdef VTK_USE_COCOA
-  auto renWin = vtkCocoaLookingGlassRenderWindow::New();
 #endif
-
-  renWin->SetLGDeviceIndex(deviceIndex);
-
-  return renWin;
 }
 
 vtkStandardNewMacro(vtkLookingGlassInterface);
+vtkCxxSetObjectMacro(vtkLookingGlassInterface, QuiltServer, vtkLookingGlassQuiltServer);
+vtkCxxSetObjectMacro(vtkLookingGlassInterface, QuiltClient, vtkLookingGlassQuiltClient);
 
 //------------------------------------------------------------------------------
 vtkLookingGlassInterface::vtkLookingGlassInterface()
@@ -128,22 +270,41 @@ vtkLookingGlassInterface::vtkLookingGlassInterface()
   , FarClippingLimit(1.2)
   , NearClippingLimit(0.8)
   , ViewAngle(30.0)
-  , FinalBlend(nullptr)
-  , QuiltBlend(nullptr)
   , Initialized(false)
-  , RenderFramebuffer(nullptr)
   , QuiltFramebuffer(nullptr)
   , IsRecording(false)
+  , QuiltRenderCount(0)
+  , QuiltRenderers(nullptr)
+  , QuiltCameras(nullptr)
   , AdjustCameraAspectRatio(1.777)
-  , MovieImageBuffer(nullptr)
+  , QuiltFormat(RGBA8)
+  , AllocatedQuiltFormat(RGBA8)
+  , TrimQuiltToTiles(false)
+  , ReleaseTransientTargets(false)
+  , ShareQuilt(false)
+  , RenderDepthBits(32)
+  , CollectStatistics(false)
+  , Statistics(vtkLookingGlassFrameStatistics::New())
+  , ResourcePool(nullptr)
+  , UsingSharedQuilt(false)
   , MovieImageData(nullptr)
   , MovieWriter(nullptr)
+  , SequenceWriter(nullptr)
+  , QuiltPublisher(nullptr)
+  , QuiltServer(nullptr)
+  , QuiltClient(nullptr)
+  , MoviePlayer(nullptr)
+  , PlaybackBufferIndex(0)
 {
   this->DisplayPosition[0] = 0;
   this->DisplayPosition[1] = 0;
   this->DisplaySize[0] = 1280;
   this->DisplaySize[1] = 720;
   this->QuiltTexture = vtkTextureObject::New();
+  for (int i = 0; i < NumberOfPlaybackBuffers; ++i)
+  {
+    this->PlaybackBuffers[i] = nullptr;
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -154,48 +315,68 @@ vtkLookingGlassInterface::~vtkLookingGlassInterface()
     this->StopRecordingQuilt();
   }
 
-  if (this->RenderFramebuffer != nullptr)
+  if (this->MoviePlayer != nullptr)
   {
-    vtkErrorMacro(<< "Render Framebuffer should have been deleted in "
-                     "ReleaseGraphicsResources().");
+    delete this->MoviePlayer;
+    this->MoviePlayer = nullptr;
   }
+
   if (this->QuiltFramebuffer != nullptr)
   {
     vtkErrorMacro(<< "QuiltFramebuffer should have been deleted in "
                      "ReleaseGraphicsResources().");
   }
+  if (this->ResourcePool != nullptr)
+  {
+    if (this->ResourcePool->GetNumberOfUsers() == 1 &&
+      this->ResourcePool->GetRenderGraph()->GetNumberOfTargets() > 0)
+    {
+      vtkErrorMacro(<< "Render targets should have been deleted in "
+                       "ReleaseGraphicsResources().");
+    }
+    this->ReleaseResourcePool(nullptr);
+  }
   if (this->QuiltTexture != nullptr)
   {
     this->QuiltTexture->Delete();
     this->QuiltTexture = nullptr;
   }
-  if (this->FinalBlend != nullptr)
+
+  if (this->MovieImageData != nullptr)
   {
-    delete this->FinalBlend;
-    this->FinalBlend = nullptr;
+    this->MovieImageData->Delete();
+    this->MovieImageData = nullptr;
   }
-  if (this->QuiltBlend != nullptr)
+
+  if (this->MovieWriter != nullptr)
   {
-    delete this->QuiltBlend;
-    this->QuiltBlend = nullptr;
+    this->MovieWriter->Delete();
+    this->MovieWriter = nullptr;
   }
 
-  if (this->MovieImageBuffer != nullptr)
+  if (this->SequenceWriter != nullptr)
   {
-    this->MovieImageBuffer->Delete();
-    this->MovieImageBuffer = nullptr;
+    this->SequenceWriter->Delete();
+    this->SequenceWriter = nullptr;
   }
 
-  if (this->MovieImageData != nullptr)
+  if (this->QuiltPublisher != nullptr)
   {
-    this->MovieImageData->Delete();
-    this->MovieImageData = nullptr;
+    this->QuiltPublisher->Delete();
+    this->QuiltPublisher = nullptr;
   }
 
-  if (this->MovieWriter != nullptr)
+  this->SetQuiltServer(nullptr);
+  this->SetQuiltClient(nullptr);
+  this->Statistics->Delete();
+
+  for (int i = 0; i < NumberOfPlaybackBuffers; ++i)
   {
-    this->MovieWriter->Delete();
-    this->MovieWriter = nullptr;
+    if (this->PlaybackBuffers[i] != nullptr)
+    {
+      this->PlaybackBuffers[i]->Delete();
+      this->PlaybackBuffers[i] = nullptr;
+    }
   }
 
   // must tear down the message pipe before shut down the app
@@ -323,6 +504,22 @@ vtkLookingGlassInterface::DeviceTypes vtkLookingGlassInterface::GetDevices()
   return types;
 }
 
+bool vtkLookingGlassInterface::GetDeviceSettings(
+  const std::string& deviceType, int quiltSize[2], int quiltTiles[2], double& aspectRatio)
+{
+  auto byDevice = GetSettingsByDevice();
+  auto it = byDevice.find(deviceType);
+  if (it == byDevice.end())
+  {
+    return false;
+  }
+
+  std::copy(it->second.QuiltSize, it->second.QuiltSize + 2, quiltSize);
+  std::copy(it->second.QuiltTiles, it->second.QuiltTiles + 2, quiltTiles);
+  aspectRatio = it->second.AspectRatio;
+  return true;
+}
+
 vtkOpenGLRenderWindow* vtkLookingGlassInterface::CreateSharedLookingGlassRenderWindow(
   vtkOpenGLRenderWindow* srcWin)
 {
@@ -497,6 +694,14 @@ void vtkLookingGlassInterface::Initialize(void)
 //=========================================================
 // set up the camera with the view and the shader of the rendering object
 void vtkLookingGlassInterface::AdjustCamera(vtkCamera* cam, int currentViewIndex)
+{
+  int totalViews = this->QuiltTiles[0] * this->QuiltTiles[1];
+  this->AdjustCameraForView(
+    cam, currentViewIndex / (totalViews - 1.0), this->AdjustCameraAspectRatio);
+}
+
+void vtkLookingGlassInterface::AdjustCameraForView(
+  vtkCamera* cam, double viewFraction, double aspectRatio)
 {
   // The standard model Looking Glass screen is roughly 4.75" vertically. If we
   // assume the average viewing distance for a user sitting at their desk is
@@ -506,8 +711,7 @@ void vtkLookingGlassInterface::AdjustCamera(vtkCamera* cam, int currentViewIndex
   // const float fov = vtkMath::RadiansFromDegrees(14.0f);
   // float cameraDistance = -cameraSize / tan(fov / 2.0f);
 
-  int totalViews = this->QuiltTiles[0] * this->QuiltTiles[1];
-  double offsetAngle = (currentViewIndex / (totalViews - 1.0f) - 0.5f) *
+  double offsetAngle = (viewFraction - 0.5) *
     vtkMath::RadiansFromDegrees(this->ViewAngle); // start at -viewCone * 0.5 and go
                                                   // up to viewCone * 0.5
 
@@ -529,7 +733,6 @@ void vtkLookingGlassInterface::AdjustCamera(vtkCamera* cam, int currentViewIndex
   tmp = tmp + vright * offset;
   cam->SetFocalPoint(tmp.GetData());
 
-  double aspectRatio = this->AdjustCameraAspectRatio;
   double camViewAngle = vtkMath::RadiansFromDegrees(cam->GetViewAngle());
   double winSize = aspectRatio * cameraDistance * tan(camViewAngle / 2.0);
 
@@ -544,17 +747,27 @@ void vtkLookingGlassInterface::DrawLightField(
     copyTO->AssignToExistingTexture(this->QuiltTexture->GetHandle(), GL_TEXTURE_2D);
   }
   this->DrawLightFieldInternal(renWin, copyTO);
+  vtkLookingGlassTraceEndFrame();
 }
 
 // draw the quilt onto the currently bound framebuffer
 void vtkLookingGlassInterface::DrawLightField(vtkOpenGLRenderWindow* renWin)
 {
   this->DrawLightFieldInternal(renWin, this->QuiltTexture);
+  vtkLookingGlassTraceEndFrame();
+}
+
+void vtkLookingGlassInterface::SkipLightField()
+{
+  this->EndStatisticsFrame();
+  vtkLookingGlassTraceEndFrame();
 }
 
 void vtkLookingGlassInterface::DrawLightFieldInternal(
-  vtkOpenGLRenderWindow* renWin, vtkTextureObject* tex)
+  vtkOpenGLRenderWindow* renWin, vtkTextureObject* tex, const float* viewPortion)
 {
+  vtkLookingGlassTraceScope("DrawLightField");
+
   // Simple default vertex and fragment shaders
   static const std::string defaultVS =
     R"***(
@@ -582,41 +795,33 @@ void vtkLookingGlassInterface::DrawLightFieldInternal(
       }
   )***";
 
+  // the quads are shared with the other interfaces drawing into the window,
+  // the device settings are uniforms set for each draw
+  vtkLookingGlassResourcePool* pool = this->GetResourcePool(renWin);
   vtkOpenGLQuadHelper* blend = nullptr;
 
   if (!this->Connected)
   {
     // Use the QuiltBlend
-    if (!this->QuiltBlend)
-    {
-      this->QuiltBlend = new vtkOpenGLQuadHelper(renWin, defaultVS.c_str(), defaultFS.c_str(), "");
-    }
-    else
-    {
-      renWin->GetShaderCache()->ReadyShaderProgram(this->QuiltBlend->Program);
-    }
-    blend = this->QuiltBlend;
+    blend = pool->GetQuad("QuiltBlend", [&]() {
+      return new vtkOpenGLQuadHelper(renWin, defaultVS.c_str(), defaultFS.c_str(), "");
+    });
   }
   else
   {
     // Use the FinalBlend
-    if (!this->FinalBlend)
-    {
+    blend = pool->GetQuad("FinalBlend", [&]() {
       // just add the standard VTK header to the fragment shader
       std::string fshader = "//VTK::System::Dec\n\n";
       fshader += hpc_LightfieldFragShaderGLSL;
-      this->FinalBlend = new vtkOpenGLQuadHelper(renWin, defaultVS.c_str(), fshader.c_str(), "");
-    }
-    else
-    {
-      renWin->GetShaderCache()->ReadyShaderProgram(this->FinalBlend->Program);
-    }
-    blend = this->FinalBlend;
+      return new vtkOpenGLQuadHelper(renWin, defaultVS.c_str(), fshader.c_str(), "");
+    });
   }
 
   if (blend->Program)
   {
     auto& prog = blend->Program;
+    renWin->GetShaderCache()->ReadyShaderProgram(prog);
 
     if (this->Connected)
     {
@@ -639,10 +844,12 @@ void vtkLookingGlassInterface::DrawLightFieldInternal(
       tmp3[2] = this->NumberOfTiles;
       prog->SetUniform3f("tile", tmp3);
 
+      int quiltTextureSize[2];
+      this->GetQuiltTextureSize(quiltTextureSize);
       float tmp2[2];
-      tmp2[0] = this->RenderSize[0] * this->QuiltTiles[0] / (float)this->QuiltSize[0];
-      tmp2[1] = this->RenderSize[1] * this->QuiltTiles[1] / (float)this->QuiltSize[1];
-      prog->SetUniform2f("viewPortion", tmp2);
+      tmp2[0] = this->RenderSize[0] * this->QuiltTiles[0] / (float)quiltTextureSize[0];
+      tmp2[1] = this->RenderSize[1] * this->QuiltTiles[1] / (float)quiltTextureSize[1];
+      prog->SetUniform2f("viewPortion", viewPortion ? viewPortion : tmp2);
     }
 
     renWin->GetState()->vtkglDepthMask(GL_FALSE);
@@ -655,28 +862,101 @@ void vtkLookingGlassInterface::DrawLightFieldInternal(
     prog->SetUniformi("screenTex", tex->GetTextureUnit());
 
     // draw the full screen quad using the special shader
+    this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::INTERLACE);
+    vtkLookingGlassTraceBeginGPU("Interlace", -1);
     blend->Render();
+    vtkLookingGlassTraceEndGPU();
+    this->Statistics->StopPhase(
+      (static_cast<vtkTypeInt64>(tex->GetWidth()) * tex->GetHeight() +
+        static_cast<vtkTypeInt64>(this->DisplaySize[0]) * this->DisplaySize[1]) *
+      4);
 
     tex->Deactivate();
 
     renWin->GetState()->vtkglDepthMask(GL_TRUE);
   }
+
+  this->EndStatisticsFrame();
+}
+
+void vtkLookingGlassInterface::EndStatisticsFrame()
+{
+  if (this->Statistics->EndFrame())
+  {
+    this->InvokeEvent(vtkLookingGlassFrameStatistics::FrameEvent, this->Statistics);
+  }
+}
+
+bool vtkLookingGlassInterface::IsTracingAvailable()
+{
+#ifdef VTK_LOOKINGGLASS_TRACING
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool vtkLookingGlassInterface::StartTraceCapture(const char* fileName, int numberOfFrames)
+{
+#ifdef VTK_LOOKINGGLASS_TRACING
+  if (!fileName || numberOfFrames < 1)
+  {
+    vtkErrorMacro("A file name and at least one frame are required");
+    return false;
+  }
+  if (!vtkLookingGlassTracer::GetInstance().Start(fileName, numberOfFrames))
+  {
+    vtkErrorMacro("A trace is already being captured");
+    return false;
+  }
+  return true;
+#else
+  (void)fileName;
+  (void)numberOfFrames;
+  vtkErrorMacro("The module was built without LookingGlass_ENABLE_TRACING");
+  return false;
+#endif
+}
+
+bool vtkLookingGlassInterface::StopTraceCapture(vtkOpenGLRenderWindow* rw)
+{
+#ifdef VTK_LOOKINGGLASS_TRACING
+  if (!this->IsCapturingTrace() || !rw)
+  {
+    return false;
+  }
+  rw->MakeCurrent();
+  return vtkLookingGlassTracer::GetInstance().Stop();
+#else
+  (void)rw;
+  return false;
+#endif
+}
+
+bool vtkLookingGlassInterface::IsCapturingTrace() const
+{
+#ifdef VTK_LOOKINGGLASS_TRACING
+  return vtkLookingGlassTracer::GetInstance().IsCapturing();
+#else
+  return false;
+#endif
 }
 
 void vtkLookingGlassInterface::ReleaseGraphicsResources(vtkWindow* w)
 {
-  if (this->QuiltTexture && w)
+  if (this->IsCapturingTrace())
   {
-    this->QuiltTexture->ReleaseGraphicsResources(w);
+    // the queries in flight are read while the context is still around
+    vtkLookingGlassTraceStop();
   }
-  if (this->RenderFramebuffer)
+  this->Statistics->ReleaseGraphicsResources();
+  if (this->UsingSharedQuilt)
   {
-    if (w)
-    {
-      this->RenderFramebuffer->ReleaseGraphicsResources(w);
-    }
-    this->RenderFramebuffer->UnRegister(this);
-    this->RenderFramebuffer = nullptr;
+    this->ReleaseSharedQuilt(w);
+  }
+  if (this->QuiltTexture && w)
+  {
+    this->QuiltTexture->ReleaseGraphicsResources(w);
   }
   if (this->QuiltFramebuffer)
   {
@@ -687,117 +967,331 @@ void vtkLookingGlassInterface::ReleaseGraphicsResources(vtkWindow* w)
     this->QuiltFramebuffer->UnRegister(this);
     this->QuiltFramebuffer = nullptr;
   }
-  if (this->FinalBlend)
+  this->ReleaseResourcePool(w);
+  for (int i = 0; i < NumberOfPlaybackBuffers; ++i)
+  {
+    if (this->PlaybackBuffers[i])
+    {
+      this->PlaybackBuffers[i]->Delete();
+      this->PlaybackBuffers[i] = nullptr;
+    }
+  }
+  if (this->QuiltClient)
   {
-    delete this->FinalBlend;
-    this->FinalBlend = nullptr;
+    this->QuiltClient->ReleaseGraphicsResources(w);
   }
-  if (this->QuiltBlend)
+}
+
+namespace
+{
+// the target the tiles of a quilt are rendered into, without a window it
+// is described as for a window without stencil
+vtkLookingGlassRenderGraph::TargetDescription TileTarget(
+  vtkOpenGLRenderWindow* renWin, const int size[2], int depthBits)
+{
+  vtkLookingGlassRenderGraph::TargetDescription description;
+  description.Size[0] = size[0];
+  description.Size[1] = size[1];
+  description.DepthBits = depthBits;
+  description.Stencil = renWin && renWin->GetStencilCapable() != 0;
+  return description;
+}
+}
+
+vtkLookingGlassResourcePool* vtkLookingGlassInterface::GetResourcePool(
+  vtkOpenGLRenderWindow* rw)
+{
+  if (this->ResourcePool && this->ResourcePool->GetWindow() != rw)
+  {
+    // moved to another window, the resources of the previous one are given
+    // back in its context
+    vtkOpenGLRenderWindow* previous = this->ResourcePool->GetWindow();
+    previous->MakeCurrent();
+    this->ReleaseResourcePool(previous);
+    rw->MakeCurrent();
+  }
+  if (!this->ResourcePool)
+  {
+    this->ResourcePool = vtkLookingGlassResourcePool::Acquire(rw);
+  }
+  return this->ResourcePool;
+}
+
+void vtkLookingGlassInterface::ReleaseResourcePool(vtkWindow* w)
+{
+  if (!this->ResourcePool)
+  {
+    return;
+  }
+  if (this->UsingSharedQuilt)
+  {
+    this->ReleaseSharedQuilt(w);
+  }
+  this->ResourcePool->Release(w);
+  this->ResourcePool = nullptr;
+}
+
+void vtkLookingGlassInterface::ReleaseSharedQuilt(vtkWindow* w)
+{
+  // the pool releases the quilt with its last user, this interface goes
+  // back to a texture of its own
+  this->ResourcePool->ReleaseQuilt(this, w);
+  this->QuiltFramebuffer->UnRegister(this);
+  this->QuiltFramebuffer = nullptr;
+  this->QuiltTexture->UnRegister(this);
+  this->QuiltTexture = vtkTextureObject::New();
+  this->UsingSharedQuilt = false;
+}
+
+void vtkLookingGlassInterface::AllocateQuilt(
+  vtkOpenGLRenderWindow* renWin, vtkTextureObject* texture, vtkOpenGLFramebufferObject* framebuffer)
+{
+  int quiltTextureSize[2];
+  this->GetQuiltTextureSize(quiltTextureSize);
+
+  auto ostate = renWin->GetState();
+  ostate->PushFramebufferBindings();
+  framebuffer->SetContext(renWin);
+  framebuffer->Bind();
+
+  texture->SetContext(renWin);
+  // the texture keeps the format of its previous allocation otherwise
+  texture->ResetFormatAndType();
+  switch (this->QuiltFormat)
   {
-    delete this->QuiltBlend;
-    this->QuiltBlend = nullptr;
+    case RGB8:
+      texture->Allocate2D(quiltTextureSize[0], quiltTextureSize[1], 3, VTK_UNSIGNED_CHAR);
+      break;
+    case RGB10A2:
+      texture->SetInternalFormat(GL_RGB10_A2);
+      texture->Allocate2D(quiltTextureSize[0], quiltTextureSize[1], 4, VTK_UNSIGNED_CHAR);
+      break;
+    case RGBA16F:
+      texture->SetInternalFormat(GL_RGBA16F);
+      texture->Allocate2D(quiltTextureSize[0], quiltTextureSize[1], 4, VTK_FLOAT);
+      break;
+    case RGBA8:
+    default:
+      texture->Allocate2D(quiltTextureSize[0], quiltTextureSize[1], 4, VTK_UNSIGNED_CHAR);
+      break;
   }
+  texture->SetMinificationFilter(vtkTextureObject::Linear);
+  texture->SetMagnificationFilter(vtkTextureObject::Linear);
+  texture->SetWrapS(vtkTextureObject::Repeat);
+  texture->SetWrapT(vtkTextureObject::Repeat);
+
+  framebuffer->AddColorAttachment(0, texture);
+  framebuffer->ActivateDrawBuffer(0);
+  framebuffer->ActivateReadBuffer(0);
+
+  ostate->PopFramebufferBindings();
+}
+
+// gets/creates the framebuffer the tiles are rendered to
+vtkOpenGLFramebufferObject* vtkLookingGlassInterface::GetRenderFramebuffer(
+  vtkOpenGLRenderWindow* renWin)
+{
+  // the render framebuffer comes from the pool of the render graph, the
+  // tiles of the next quilt get the same one
+  return this->GetResourcePool(renWin)->GetRenderGraph()->GetPooledFramebuffer(
+    renWin, TileTarget(renWin, this->RenderSize, this->RenderDepthBits));
 }
 
 // gets/creates the framebuffers
 void vtkLookingGlassInterface::GetFramebuffers(vtkOpenGLRenderWindow* renWin,
   vtkOpenGLFramebufferObject*& renderFramebuffer, vtkOpenGLFramebufferObject*& quiltFramebuffer)
 {
-  auto ostate = renWin->GetState();
+  vtkLookingGlassResourcePool* pool = this->GetResourcePool(renWin);
+  renderFramebuffer = this->GetRenderFramebuffer(renWin);
 
-  if (this->QuiltFramebuffer == nullptr)
+  int quiltTextureSize[2];
+  this->GetQuiltTextureSize(quiltTextureSize);
+
+  if (this->ShareQuilt)
   {
-    ostate->PushFramebufferBindings();
-    this->RenderFramebuffer = vtkOpenGLFramebufferObject::New();
-    this->RenderFramebuffer->SetContext(renWin);
-    this->RenderFramebuffer->Bind();
+    // a quilt of its own is given up for the one of the pool
+    if (this->QuiltFramebuffer != nullptr && !this->UsingSharedQuilt)
+    {
+      this->QuiltTexture->ReleaseGraphicsResources(renWin);
+      this->QuiltFramebuffer->ReleaseGraphicsResources(renWin);
+    }
 
-    // verify that our multisample setting doe snot exceed the hardware
-    int multiSamples = 0;
-    if (renWin->GetMultiSamples())
+    vtkLookingGlassResourcePool::QuiltKey key;
+    key.Size[0] = quiltTextureSize[0];
+    key.Size[1] = quiltTextureSize[1];
+    key.Format = this->QuiltFormat;
+    key.TileSize[0] = this->RenderSize[0];
+    key.TileSize[1] = this->RenderSize[1];
+    vtkTextureObject* texture;
+    vtkOpenGLFramebufferObject* framebuffer;
+    pool->AcquireQuilt(
+      this, key,
+      [&](vtkTextureObject* t, vtkOpenGLFramebufferObject* f) {
+        this->AllocateQuilt(renWin, t, f);
+      },
+      texture, framebuffer);
+
+    if (framebuffer != this->QuiltFramebuffer)
     {
-      int msamples = 0;
-      ostate->vtkglGetIntegerv(GL_MAX_SAMPLES, &msamples);
-      if (multiSamples > msamples)
-      {
-        multiSamples = msamples;
-      }
-      if (multiSamples == 1)
+      if (this->QuiltFramebuffer != nullptr)
       {
-        multiSamples = 0;
+        this->QuiltFramebuffer->UnRegister(this);
       }
+      this->QuiltTexture->UnRegister(this);
+      this->QuiltFramebuffer = framebuffer;
+      this->QuiltFramebuffer->Register(this);
+      this->QuiltTexture = texture;
+      this->QuiltTexture->Register(this);
     }
-    this->RenderFramebuffer->PopulateFramebuffer(this->RenderSize[0], this->RenderSize[1],
-      true,                 // textures
-      1, VTK_UNSIGNED_CHAR, // 1 color buffer uchar
-      true, 32,             // depth buffer
-      multiSamples, renWin->GetStencilCapable() != 0 ? true : false);
-
-    this->QuiltFramebuffer = vtkOpenGLFramebufferObject::New();
-    this->QuiltFramebuffer->SetContext(renWin);
-    this->QuiltFramebuffer->Bind();
+    this->UsingSharedQuilt = true;
+    quiltFramebuffer = this->QuiltFramebuffer;
+    return;
+  }
 
-    this->QuiltTexture->SetContext(renWin);
-    this->QuiltTexture->Allocate2D(this->QuiltSize[0], this->QuiltSize[1], 4, VTK_UNSIGNED_CHAR);
-    this->QuiltTexture->SetMinificationFilter(vtkTextureObject::Linear);
-    this->QuiltTexture->SetMagnificationFilter(vtkTextureObject::Linear);
-    this->QuiltTexture->SetWrapS(vtkTextureObject::Repeat);
-    this->QuiltTexture->SetWrapT(vtkTextureObject::Repeat);
+  if (this->UsingSharedQuilt)
+  {
+    this->ReleaseSharedQuilt(renWin);
+  }
 
-    this->QuiltFramebuffer->AddColorAttachment(0, this->QuiltTexture);
-    this->QuiltFramebuffer->ActivateDrawBuffer(0);
-    this->QuiltFramebuffer->ActivateReadBuffer(0);
+  // a change of storage format requires a new quilt texture
+  if (this->QuiltFramebuffer != nullptr && this->AllocatedQuiltFormat != this->QuiltFormat)
+  {
+    this->QuiltTexture->ReleaseGraphicsResources(renWin);
+    this->QuiltFramebuffer->ReleaseGraphicsResources(renWin);
+    this->QuiltFramebuffer->UnRegister(this);
+    this->QuiltFramebuffer = nullptr;
+  }
 
-    ostate->PopFramebufferBindings();
+  if (this->QuiltFramebuffer == nullptr)
+  {
+    this->QuiltFramebuffer = vtkOpenGLFramebufferObject::New();
+    this->AllocateQuilt(renWin, this->QuiltTexture, this->QuiltFramebuffer);
+    this->AllocatedQuiltFormat = this->QuiltFormat;
   }
 
   // make sure the size is correct, nop if size is unchanged
-  this->RenderFramebuffer->Resize(this->RenderSize[0], this->RenderSize[1]);
-  this->QuiltFramebuffer->Resize(this->QuiltSize[0], this->QuiltSize[1]);
+  this->QuiltFramebuffer->Resize(quiltTextureSize[0], quiltTextureSize[1]);
 
-  renderFramebuffer = this->RenderFramebuffer;
   quiltFramebuffer = this->QuiltFramebuffer;
 }
 
-// Simply compute and return the position in the quilt for a tile
-void vtkLookingGlassInterface::GetTilePosition(int tile, int pos[2])
+void vtkLookingGlassInterface::ReleaseTransientGraphicsResources(vtkWindow* w)
 {
-  pos[0] = (tile % this->QuiltTiles[0]) * this->RenderSize[0];
-  pos[1] = (tile / this->QuiltTiles[0]) * this->RenderSize[1];
+  // the render targets are only needed while the tiles are rendered, the
+  // quilt texture has to stay around for DrawLightField(). The targets of a
+  // shared pool are not told apart by user, they stay for the other users
+  // and are released once no execution retains them.
+  if (this->ResourcePool && this->ResourcePool->GetNumberOfUsers() == 1)
+  {
+    this->ResourcePool->GetRenderGraph()->ReleaseGraphicsResources(w);
+  }
 }
 
-void vtkLookingGlassInterface::RenderQuilt(vtkOpenGLRenderWindow* rw,
-  vtkRendererCollection* renderers, std::function<void(void)>* renderFunc)
+void vtkLookingGlassInterface::GetQuiltTextureSize(int size[2])
 {
-  if (!renderers)
+  if (this->TrimQuiltToTiles)
   {
-    // If no renderers are provided, default to all on the render window
-    renderers = rw->GetRenderers();
+    size[0] = this->RenderSize[0] * this->QuiltTiles[0];
+    size[1] = this->RenderSize[1] * this->QuiltTiles[1];
+  }
+  else
+  {
+    size[0] = this->QuiltSize[0];
+    size[1] = this->QuiltSize[1];
   }
+}
 
-  vtkCollectionSimpleIterator rsit;
+namespace
+{
+int BytesPerQuiltPixel(int format)
+{
+  switch (format)
+  {
+    case vtkLookingGlassInterface::RGB8:
+      return 3;
+    case vtkLookingGlassInterface::RGBA16F:
+      return 8;
+    case vtkLookingGlassInterface::RGB10A2:
+    case vtkLookingGlassInterface::RGBA8:
+    default:
+      return 4;
+  }
+}
+}
 
-  // loop over the tiles, render,and blit
-  vtkOpenGLFramebufferObject* renderFramebuffer;
-  vtkOpenGLFramebufferObject* quiltFramebuffer;
-  this->GetFramebuffers(rw, renderFramebuffer, quiltFramebuffer);
+vtkTypeInt64 vtkLookingGlassInterface::GetEstimatedGPUMemory(
+  const std::string& deviceType, vtkOpenGLRenderWindow* rw)
+{
+  if (!GetSettingsByDevice().count(deviceType))
+  {
+    vtkErrorMacro("Unrecognized device type: '" << deviceType << "'");
+    return -1;
+  }
+  DeviceSettings settings = GetSettingsForDevice(deviceType);
 
-  auto ostate = rw->GetState();
+  int renderSize[2] = { settings.QuiltSize[0] / settings.QuiltTiles[0],
+    settings.QuiltSize[1] / settings.QuiltTiles[1] };
+  vtkTypeInt64 quiltSize[2] = { settings.QuiltSize[0], settings.QuiltSize[1] };
+  if (this->TrimQuiltToTiles)
+  {
+    quiltSize[0] = static_cast<vtkTypeInt64>(renderSize[0]) * settings.QuiltTiles[0];
+    quiltSize[1] = static_cast<vtkTypeInt64>(renderSize[1]) * settings.QuiltTiles[1];
+  }
 
-  ostate->PushFramebufferBindings();
-  renderFramebuffer->Bind(GL_READ_FRAMEBUFFER);
+  vtkTypeInt64 quiltBytes = quiltSize[0] * quiltSize[1] * BytesPerQuiltPixel(this->QuiltFormat);
 
-  int renderSize[2];
-  this->GetRenderSize(renderSize);
+  // the tiles are rendered into the same target as RenderQuilt() allocates
+  vtkTypeInt64 renderBytes = vtkLookingGlassRenderGraph::GetTargetBytes(
+    TileTarget(rw, renderSize, this->RenderDepthBits));
 
-  int tcount = this->GetNumberOfTiles();
+  return quiltBytes + renderBytes;
+}
 
-  // save the original camera settings
-  vtkRenderer* aren;
-  std::vector<vtkCamera*> Cameras;
-  for (renderers->InitTraversal(rsit); (aren = renderers->GetNextRenderer(rsit));)
-  {
-    // Ugly piece of code - we need to know if the camera already
+int vtkLookingGlassInterface::GetNumberOfRenderTargets()
+{
+  return this->ResourcePool ? this->ResourcePool->GetRenderGraph()->GetNumberOfTargets() : 0;
+}
+
+vtkTypeInt64 vtkLookingGlassInterface::GetRenderTargetMemory()
+{
+  return this->ResourcePool ? this->ResourcePool->GetRenderGraph()->GetTargetMemory() : 0;
+}
+
+vtkTypeInt64 vtkLookingGlassInterface::GetEstimatedHostMemory(const std::string& deviceType)
+{
+  if (!GetSettingsByDevice().count(deviceType))
+  {
+    vtkErrorMacro("Unrecognized device type: '" << deviceType << "'");
+    return -1;
+  }
+  DeviceSettings settings = GetSettingsForDevice(deviceType);
+
+  vtkTypeInt64 quiltSize[2] = { settings.QuiltSize[0], settings.QuiltSize[1] };
+  if (this->TrimQuiltToTiles)
+  {
+    quiltSize[0] = (quiltSize[0] / settings.QuiltTiles[0]) * settings.QuiltTiles[0];
+    quiltSize[1] = (quiltSize[1] / settings.QuiltTiles[1]) * settings.QuiltTiles[1];
+  }
+
+  // SaveQuilt() and movie recording read the quilt back as RGB
+  return quiltSize[0] * quiltSize[1] * 3;
+}
+
+// Simply compute and return the position in the quilt for a tile
+void vtkLookingGlassInterface::GetTilePosition(int tile, int pos[2])
+{
+  pos[0] = (tile % this->QuiltTiles[0]) * this->RenderSize[0];
+  pos[1] = (tile / this->QuiltTiles[0]) * this->RenderSize[1];
+}
+
+void vtkLookingGlassInterface::SaveTileCameras(vtkOpenGLRenderWindow* rw,
+  vtkRendererCollection* renderers, std::vector<vtkCamera*>& cameras)
+{
+  vtkCollectionSimpleIterator rsit;
+  vtkRenderer* aren;
+  for (renderers->InitTraversal(rsit); (aren = renderers->GetNextRenderer(rsit));)
+  {
+    // Ugly piece of code - we need to know if the camera already
     // exists or not. If it does not yet exist, we must reset the
     // camera here - otherwise it will never be done (missing its
     // oppportunity to be reset in the Render method of the
@@ -809,125 +1303,1003 @@ void vtkLookingGlassInterface::RenderQuilt(vtkOpenGLRenderWindow* rw,
     auto oldCam = aren->GetActiveCamera();
     oldCam->SetLeftEye(1);
     oldCam->Register(rw);
-    Cameras.push_back(oldCam);
+    cameras.push_back(oldCam);
     vtkNew<vtkCamera> newCam;
     aren->SetActiveCamera(newCam);
   }
+}
+
+void vtkLookingGlassInterface::SetupTileCameras(
+  vtkRendererCollection* renderers, const std::vector<vtkCamera*>& cameras, int tile)
+{
+  this->SetupViewCameras(renderers, cameras, tile / (this->NumberOfTiles - 1.0),
+    this->AdjustCameraAspectRatio);
+}
+
+void vtkLookingGlassInterface::SetupViewCameras(vtkRendererCollection* renderers,
+  const std::vector<vtkCamera*>& cameras, double viewFraction, double aspectRatio)
+{
+  vtkCollectionSimpleIterator rsit;
+  vtkRenderer* aren;
+  int count = 0;
+  for (renderers->InitTraversal(rsit); (aren = renderers->GetNextRenderer(rsit)); ++count)
+  {
+    // adjust camera
+    vtkCamera* cam = aren->GetActiveCamera();
+    cam->DeepCopy(cameras[count]);
+    this->AdjustCameraForView(cam, viewFraction, aspectRatio);
+    this->ApplyClippingLimits(cam);
+  }
+}
+
+void vtkLookingGlassInterface::ApplyClippingLimits(vtkCamera* cam)
+{
+  // limit the clipping range to limit parallax
+  if (this->GetUseClippingLimits())
+  {
+    double* cRange = cam->GetClippingRange();
+    double cameraDistance = cam->GetDistance();
+
+    double nearClippingLimit = this->GetNearClippingLimit();
+    double farClippingLimit = this->GetFarClippingLimit();
+
+    double newRange[2];
+    newRange[0] = cRange[0];
+    newRange[1] = cRange[1];
+    if (cRange[0] < cameraDistance * nearClippingLimit)
+    {
+      newRange[0] = cameraDistance * nearClippingLimit;
+    }
+    if (cRange[1] > cameraDistance * farClippingLimit)
+    {
+      newRange[1] = cameraDistance * farClippingLimit;
+    }
+    cam->SetClippingRange(newRange);
+  }
+}
+
+void vtkLookingGlassInterface::RestoreTileCameras(
+  vtkRendererCollection* renderers, std::vector<vtkCamera*>& cameras)
+{
+  vtkCollectionSimpleIterator rsit;
+  vtkRenderer* aren;
+  int count = 0;
+  for (renderers->InitTraversal(rsit); (aren = renderers->GetNextRenderer(rsit)); ++count)
+  {
+    aren->SetActiveCamera(cameras[count]);
+    cameras[count]->Delete();
+  }
+  cameras.clear();
+}
+
+vtkCamera* vtkLookingGlassInterface::GetQuiltCamera(vtkRenderer* renderer)
+{
+  if (!this->QuiltRenderers || !renderer)
+  {
+    return nullptr;
+  }
+  vtkCollectionSimpleIterator rsit;
+  vtkRenderer* aren;
+  size_t count = 0;
+  for (this->QuiltRenderers->InitTraversal(rsit);
+       (aren = this->QuiltRenderers->GetNextRenderer(rsit)); ++count)
+  {
+    if (aren == renderer)
+    {
+      return count < this->QuiltCameras->size() ? (*this->QuiltCameras)[count] : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+void vtkLookingGlassInterface::RenderQuilt(vtkOpenGLRenderWindow* rw,
+  vtkRendererCollection* renderers, std::function<void(void)>* renderFunc)
+{
+  if (!renderers)
+  {
+    // If no renderers are provided, default to all on the render window
+    renderers = rw->GetRenderers();
+  }
+
+  if (this->CollectStatistics)
+  {
+    // a quilt that was not drawn on the device ends its frame here
+    this->EndStatisticsFrame();
+    this->Statistics->BeginFrame(this->NumberOfTiles, rw->GetRenderTimer());
+  }
+  vtkLookingGlassTraceBeginFrame();
+  vtkLookingGlassTraceScope("RenderQuilt");
+
+  vtkOpenGLFramebufferObject* renderFramebuffer;
+  vtkOpenGLFramebufferObject* quiltFramebuffer;
+  this->GetFramebuffers(rw, renderFramebuffer, quiltFramebuffer);
+
+  // The tiles are rendered into a transient target and blitted into the
+  // quilt, which is then read back once for the recording and the stream,
+  // and straight into shared memory for the other processes. The passes
+  // that are not needed by this frame are culled.
+  vtkLookingGlassRenderGraph* graph = this->GetResourcePool(rw)->GetRenderGraph();
+  const int tileTarget =
+    graph->CreateTarget("Tile", TileTarget(rw, this->RenderSize, this->RenderDepthBits));
+  const int quilt = graph->ImportTarget("Quilt", quiltFramebuffer);
+  const int quiltImage = graph->CreateResource("QuiltImage");
+  graph->MarkOutput(quilt);
+
+  int quiltTextureSize[2];
+  this->GetQuiltTextureSize(quiltTextureSize);
+  const vtkTypeInt64 quiltBytes =
+    static_cast<vtkTypeInt64>(quiltTextureSize[0]) * quiltTextureSize[1] * 3;
+
+  graph->AddPass("RenderTiles", vtkLookingGlassRenderGraph::GPU, {}, { tileTarget, quilt }, [&]() {
+    vtkOpenGLFramebufferObject* tileFramebuffer = graph->GetFramebuffer(tileTarget);
+    auto ostate = rw->GetState();
+
+    ostate->PushFramebufferBindings();
+    tileFramebuffer->Bind(GL_READ_FRAMEBUFFER);
+
+    int renderSize[2];
+    this->GetRenderSize(renderSize);
+
+    int tcount = this->GetNumberOfTiles();
+
+    // save the original camera settings
+    std::vector<vtkCamera*> cameras;
+    this->SaveTileCameras(rw, renderers, cameras);
+    this->QuiltRenderers = renderers;
+    this->QuiltCameras = &cameras;
+
+    // loop over all the tiles and render then and blit them to the quilt
+    for (int tile = 0; tile < tcount; ++tile)
+    {
+      vtkLookingGlassTraceTileScope("Tile", tile);
+      vtkLookingGlassTraceBeginGPU("Tile", tile);
+      tileFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
+      ostate->vtkglViewport(0, 0, renderSize[0], renderSize[1]);
+      ostate->vtkglScissor(0, 0, renderSize[0], renderSize[1]);
+
+      this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::CAMERA_SETUP, tile);
+      this->SetupTileCameras(renderers, cameras, tile);
+
+      this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::TILE_RENDER, tile);
+      vtkLookingGlassTraceBeginTile(tile, renderers);
+      if (renderFunc)
+      {
+        (*renderFunc)();
+      }
+      else
+      {
+        renderers->Render();
+      }
+      vtkLookingGlassTraceEndTile(tile, renderers);
+
+      this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::BLIT, tile);
+      quiltFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
+
+      int destPos[2];
+      this->GetTilePosition(tile, destPos);
+
+      // blit to quilt
+      ostate->vtkglViewport(destPos[0], destPos[1], renderSize[0], renderSize[1]);
+      ostate->vtkglScissor(destPos[0], destPos[1], renderSize[0], renderSize[1]);
+      glBlitFramebuffer(0, 0, renderSize[0], renderSize[1], destPos[0], destPos[1],
+        destPos[0] + renderSize[0], destPos[1] + renderSize[1], GL_COLOR_BUFFER_BIT, GL_LINEAR);
+      this->Statistics->StopPhase(static_cast<vtkTypeInt64>(renderSize[0]) * renderSize[1] * 8);
+      vtkLookingGlassTraceEndGPU();
+    }
+    ostate->PopFramebufferBindings();
+
+    // restore the original camera settings
+    this->QuiltRenderers = nullptr;
+    this->QuiltCameras = nullptr;
+    this->RestoreTileCameras(renderers, cameras);
+
+    ++this->QuiltRenderCount;
+  });
+
+  graph->AddPass(
+    "ReadQuilt", vtkLookingGlassRenderGraph::READBACK, { quilt }, { quiltImage }, [&]() {
+      if (!this->MovieImageData)
+      {
+        this->MovieImageData = vtkImageData::New();
+      }
+      this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::READBACK);
+      this->ReadQuilt(this->MovieImageData);
+      this->Statistics->StopPhase(quiltBytes);
+    });
+
+  if (this->IsRecording)
+  {
+    // Write out a movie frame if we are recording
+    const int movie = graph->CreateResource("Movie");
+    graph->MarkOutput(movie);
+    graph->AddPass("RecordQuilt", vtkLookingGlassRenderGraph::HOST, { quiltImage }, { movie },
+      [this]() { this->EncodeQuiltMovieFrame(); });
+  }
+
+  if (this->IsPublishingQuilt())
+  {
+    const int sharedQuilt = graph->CreateResource("SharedQuilt");
+    graph->MarkOutput(sharedQuilt);
+    graph->AddPass("PublishQuilt", vtkLookingGlassRenderGraph::READBACK, { quilt },
+      { sharedQuilt }, [this]() { this->PublishQuiltFrame(); });
+  }
+
+  if (this->QuiltServer && this->QuiltServer->IsConnected())
+  {
+    // Stream the quilt to the client
+    const int stream = graph->CreateResource("Stream");
+    graph->MarkOutput(stream);
+    graph->AddPass("StreamQuilt", vtkLookingGlassRenderGraph::HOST, { quiltImage }, { stream },
+      [&]() {
+        float viewPortion[2] = {
+          this->RenderSize[0] * this->QuiltTiles[0] / static_cast<float>(quiltTextureSize[0]),
+          this->RenderSize[1] * this->QuiltTiles[1] / static_cast<float>(quiltTextureSize[1])
+        };
+        this->QuiltServer->SetQuiltTiles(this->QuiltTiles);
+        this->QuiltServer->SetViewPortion(viewPortion);
+        this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::ENCODE);
+        vtkLookingGlassTraceScope("SendQuilt");
+        this->QuiltServer->SendQuilt(this->MovieImageData);
+        this->Statistics->StopPhase(quiltBytes);
+      });
+  }
+
+  graph->Execute(rw);
+
+  if (this->ReleaseTransientTargets)
+  {
+    this->ReleaseTransientGraphicsResources(rw);
+  }
+}
+
+namespace
+{
+// Read the first color attachment of a framebuffer into an image that has
+// already been allocated with the size to read. The pixels are read straight
+// into 3 components, whatever the storage format is. Getting rid of the
+// alpha component eliminates the transparent background.
+void ReadColorBuffer(vtkOpenGLRenderWindow* renWin, vtkOpenGLFramebufferObject* framebuffer,
+  int width, int height, void* pixels, int x = 0, int y = 0)
+{
+  auto ostate = renWin->GetState();
+  ostate->PushReadFramebufferBinding();
+  framebuffer->Bind(GL_READ_FRAMEBUFFER);
+  framebuffer->ActivateReadBuffer(0);
+  int packAlignment = 4;
+  ostate->vtkglGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+  ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+  ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+  ostate->PopReadFramebufferBinding();
+}
+
+void ReadColorBuffer(
+  vtkOpenGLRenderWindow* renWin, vtkOpenGLFramebufferObject* framebuffer, vtkImageData* image)
+{
+  int* dims = image->GetDimensions();
+  ReadColorBuffer(renWin, framebuffer, dims[0], dims[1], image->GetScalarPointer());
+}
+}
+
+void vtkLookingGlassInterface::ReadQuilt(vtkImageData* image)
+{
+  int size[2];
+  this->GetQuiltTextureSize(size);
+
+  int* dims = image->GetDimensions();
+  if (dims[0] != size[0] || dims[1] != size[1] || image->GetNumberOfScalarComponents() != 3)
+  {
+    image->SetDimensions(size[0], size[1], 1);
+    image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  }
+
+  if (!this->QuiltFramebuffer)
+  {
+    vtkErrorMacro("The quilt must be rendered before it can be read");
+    return;
+  }
+
+  vtkLookingGlassTraceScope("ReadQuilt");
+  ReadColorBuffer(this->QuiltTexture->GetContext(), this->QuiltFramebuffer, image);
+}
+
+void vtkLookingGlassInterface::ReadQuiltTiles(vtkImageData* image)
+{
+  const int* size = this->RenderSize;
+  const int tcount = this->GetNumberOfTiles();
+
+  int* dims = image->GetDimensions();
+  if (dims[0] != size[0] || dims[1] != size[1] * tcount ||
+    image->GetNumberOfScalarComponents() != 3)
+  {
+    image->SetDimensions(size[0], size[1] * tcount, 1);
+    image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  }
+
+  if (!this->QuiltFramebuffer)
+  {
+    vtkErrorMacro("The quilt must be rendered before it can be read");
+    return;
+  }
 
-  // loop over all the tiles and render then and blit them to the quilt
+  // each tile is read straight to its place in the stack, tile 0 at the bottom
+  auto pixels = static_cast<unsigned char*>(image->GetScalarPointer());
+  const size_t tileBytes = static_cast<size_t>(size[0]) * size[1] * 3;
   for (int tile = 0; tile < tcount; ++tile)
   {
-    renderFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
-    ostate->vtkglViewport(0, 0, renderSize[0], renderSize[1]);
-    ostate->vtkglScissor(0, 0, renderSize[0], renderSize[1]);
+    int pos[2];
+    this->GetTilePosition(tile, pos);
+    ReadColorBuffer(this->QuiltTexture->GetContext(), this->QuiltFramebuffer, size[0], size[1],
+      pixels + tile * tileBytes, pos[0], pos[1]);
+  }
+}
 
-    int count = 0;
-    for (renderers->InitTraversal(rsit); (aren = renderers->GetNextRenderer(rsit)); ++count)
+void vtkLookingGlassInterface::SaveQuilt(const char* fileName)
+{
+  vtkNew<vtkImageData> image;
+  this->ReadQuilt(image);
+
+  vtkNew<vtkPNGWriter> writer;
+  writer->SetFileName(fileName);
+  writer->SetInputData(image);
+  writer->Write();
+}
+
+void vtkLookingGlassInterface::SaveQuiltStreamed(vtkOpenGLRenderWindow* rw, const char* fileName,
+  double scale, vtkRendererCollection* renderers, std::function<void(void)>* renderFunc)
+{
+  if (!renderers)
+  {
+    // If no renderers are provided, default to all on the render window
+    renderers = rw->GetRenderers();
+  }
+
+  if (scale <= 0.0)
+  {
+    vtkErrorMacro("Invalid quilt scale " << scale);
+    return;
+  }
+
+  int tileSize[2];
+  tileSize[0] = static_cast<int>(this->RenderSize[0] * scale + 0.5);
+  tileSize[1] = static_cast<int>(this->RenderSize[1] * scale + 0.5);
+  int quiltSize[2] = { tileSize[0] * this->QuiltTiles[0], tileSize[1] * this->QuiltTiles[1] };
+
+  auto ostate = rw->GetState();
+
+  // only a single tile has to fit in a texture, the quilt itself never
+  // exists on the GPU
+  int maxSize = 0;
+  ostate->vtkglGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  if (tileSize[0] > maxSize || tileSize[1] > maxSize)
+  {
+    vtkErrorMacro("Tile size " << tileSize[0] << "x" << tileSize[1]
+                               << " exceeds GL_MAX_TEXTURE_SIZE " << maxSize);
+    return;
+  }
+
+  vtkQuiltPNGStream stream;
+  if (!stream.Open(fileName, quiltSize[0], quiltSize[1]))
+  {
+    vtkErrorMacro("Unable to open " << fileName << " for writing");
+    return;
+  }
+
+  // the tiles share the framebuffer of the quilt tiles when they have the
+  // same size
+  vtkLookingGlassRenderGraph* graph = this->GetResourcePool(rw)->GetRenderGraph();
+  const int tileTarget =
+    graph->CreateTarget("StreamedTile", TileTarget(rw, tileSize, this->RenderDepthBits));
+  const int file = graph->CreateResource("QuiltFile");
+  graph->MarkOutput(file);
+
+  const bool resized = tileSize[0] != this->RenderSize[0] || tileSize[1] != this->RenderSize[1];
+  bool ok = true;
+  graph->AddPass("StreamTiles", vtkLookingGlassRenderGraph::GPU, {}, { tileTarget, file }, [&]() {
+    vtkOpenGLFramebufferObject* tileFramebuffer = graph->GetFramebuffer(tileTarget);
+    ostate->PushFramebufferBindings();
+
+    if (resized && this->TileSizeCallback)
     {
-      // adjust camera
-      vtkCamera* cam = aren->GetActiveCamera();
-      cam->DeepCopy(Cameras[count]);
-      this->AdjustCamera(cam, tile);
+      this->TileSizeCallback(tileSize[0], tileSize[1]);
+    }
 
-      // limit the clipping range to limit parallax
-      if (this->GetUseClippingLimits())
+    std::vector<vtkCamera*> cameras;
+    this->SaveTileCameras(rw, renderers, cameras);
+
+    // one row of tiles, packed as RGB
+    const size_t rowStride = static_cast<size_t>(quiltSize[0]) * 3;
+    std::vector<unsigned char> band(rowStride * tileSize[1]);
+    int packAlignment = 4;
+    int packRowLength = 0;
+    ostate->vtkglGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+    ostate->vtkglGetIntegerv(GL_PACK_ROW_LENGTH, &packRowLength);
+
+    // PNG is written top down while the first quilt row is at the bottom,
+    // so render the rows of tiles starting from the top of the quilt
+    for (int row = this->QuiltTiles[1] - 1; row >= 0 && ok; --row)
+    {
+      for (int col = 0; col < this->QuiltTiles[0]; ++col)
       {
-        double* cRange = cam->GetClippingRange();
-        double cameraDistance = cam->GetDistance();
+        int tile = row * this->QuiltTiles[0] + col;
+
+        tileFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
+        ostate->vtkglViewport(0, 0, tileSize[0], tileSize[1]);
+        ostate->vtkglScissor(0, 0, tileSize[0], tileSize[1]);
 
-        double nearClippingLimit = this->GetNearClippingLimit();
-        double farClippingLimit = this->GetFarClippingLimit();
+        this->SetupTileCameras(renderers, cameras, tile);
 
-        double newRange[2];
-        newRange[0] = cRange[0];
-        newRange[1] = cRange[1];
-        if (cRange[0] < cameraDistance * nearClippingLimit)
+        if (renderFunc)
         {
-          newRange[0] = cameraDistance * nearClippingLimit;
+          (*renderFunc)();
         }
-        if (cRange[1] > cameraDistance * farClippingLimit)
+        else
+        {
+          renderers->Render();
+        }
+
+        // read the tile straight into its place in the band
+        tileFramebuffer->Bind(GL_READ_FRAMEBUFFER);
+        tileFramebuffer->ActivateReadBuffer(0);
+        ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+        ostate->vtkglPixelStorei(GL_PACK_ROW_LENGTH, quiltSize[0]);
+        glReadPixels(0, 0, tileSize[0], tileSize[1], GL_RGB, GL_UNSIGNED_BYTE,
+          band.data() + static_cast<size_t>(col) * tileSize[0] * 3);
+        ostate->vtkglPixelStorei(GL_PACK_ROW_LENGTH, packRowLength);
+        ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+      }
+
+      for (int y = tileSize[1] - 1; y >= 0 && ok; --y)
+      {
+        ok = stream.WriteRow(band.data() + y * rowStride);
+      }
+    }
+
+    this->RestoreTileCameras(renderers, cameras);
+
+    if (resized && this->TileSizeCallback)
+    {
+      this->TileSizeCallback(this->RenderSize[0], this->RenderSize[1]);
+    }
+
+    ostate->PopFramebufferBindings();
+  });
+  graph->Execute(rw);
+
+  if (!ok || !stream.Close())
+  {
+    vtkErrorMacro("Error while writing " << fileName);
+  }
+}
+
+namespace
+{
+// the suffix of the quilt files of a layout, see QuiltFileSuffix()
+std::string FormatQuiltFileSuffix(const int quiltTiles[2])
+{
+  return "_qs" + std::to_string(quiltTiles[0]) + "x" + std::to_string(quiltTiles[1]);
+}
+
+// the number of times a view must be halved to get the tile size, -1 when
+// halving never gives it exactly
+int GetHalvings(const int viewSize[2], const int tileSize[2])
+{
+  int size[2] = { viewSize[0], viewSize[1] };
+  for (int halvings = 0;; ++halvings)
+  {
+    if (size[0] == tileSize[0] && size[1] == tileSize[1])
+    {
+      return halvings;
+    }
+    if (size[0] % 2 || size[1] % 2 || size[0] < tileSize[0] || size[1] < tileSize[1])
+    {
+      return -1;
+    }
+    size[0] /= 2;
+    size[1] /= 2;
+  }
+}
+}
+
+void vtkLookingGlassInterface::SaveQuilts(vtkOpenGLRenderWindow* rw,
+  const std::vector<std::string>& deviceTypes, const char* filePrefix,
+  vtkRendererCollection* renderers, std::function<void(void)>* renderFunc)
+{
+  if (!filePrefix)
+  {
+    vtkErrorMacro("No file prefix given");
+    return;
+  }
+
+  if (!renderers)
+  {
+    // If no renderers are provided, default to all on the render window
+    renderers = rw->GetRenderers();
+  }
+
+  // the quilt and tile layout of each target
+  struct Target
+  {
+    std::string DeviceType;
+    DeviceSettings Settings;
+    int TileSize[2];
+    int QuiltSize[2];
+    // the number of times the views are halved to get its tiles
+    int Halvings;
+    // the resource of its quilt in the render graph
+    int Quilt;
+  };
+
+  // the targets made from the same views, rendered at ViewSize
+  struct ViewGroup
+  {
+    int ViewSize[2];
+    std::vector<Target> Targets;
+  };
+
+  // Views can only be shared between targets whose tiles are rendered with
+  // the same projection, i.e. the same camera aspect ratio (which shears the
+  // view) and the same tile aspect ratio (which sets the frustum). Group the
+  // targets by both.
+  std::map<std::pair<int, int>, std::vector<Target>> projections;
+  for (const auto& deviceType : deviceTypes)
+  {
+    if (!GetSettingsByDevice().count(deviceType))
+    {
+      vtkWarningMacro("Unrecognized device type: '" << deviceType << "', skipping it");
+      continue;
+    }
+    Target target;
+    target.DeviceType = deviceType;
+    target.Settings = GetSettingsForDevice(deviceType);
+    target.TileSize[0] = target.Settings.QuiltSize[0] / target.Settings.QuiltTiles[0];
+    target.TileSize[1] = target.Settings.QuiltSize[1] / target.Settings.QuiltTiles[1];
+    target.QuiltSize[0] = this->TrimQuiltToTiles
+      ? target.TileSize[0] * target.Settings.QuiltTiles[0]
+      : target.Settings.QuiltSize[0];
+    target.QuiltSize[1] = this->TrimQuiltToTiles
+      ? target.TileSize[1] * target.Settings.QuiltTiles[1]
+      : target.Settings.QuiltSize[1];
+
+    std::pair<int, int> key(static_cast<int>(target.Settings.AspectRatio * 1000 + 0.5),
+      static_cast<int>(1000.0 * target.TileSize[0] / target.TileSize[1] + 0.5));
+    projections[key].push_back(target);
+  }
+
+  // Resampling a view to an arbitrary size aliases, but a linear blit to
+  // exactly half the size averages 2x2 pixels, a box filter. A target shares
+  // the views of a larger one when halving them gives its tile size, the
+  // others are rendered at their own size. The largest targets come first,
+  // so that each group renders at the size of its first target.
+  std::vector<ViewGroup> viewGroups;
+  for (auto& projection : projections)
+  {
+    std::vector<Target>& targets = projection.second;
+    std::stable_sort(targets.begin(), targets.end(),
+      [](const Target& a, const Target& b) { return a.TileSize[0] > b.TileSize[0]; });
+    const size_t firstGroup = viewGroups.size();
+    for (auto& target : targets)
+    {
+      auto group = viewGroups.begin() + firstGroup;
+      for (; group != viewGroups.end(); ++group)
+      {
+        target.Halvings = GetHalvings(group->ViewSize, target.TileSize);
+        if (target.Halvings >= 0)
         {
-          newRange[1] = cameraDistance * farClippingLimit;
+          break;
         }
-        cam->SetClippingRange(newRange);
       }
+      if (group == viewGroups.end())
+      {
+        target.Halvings = 0;
+        viewGroups.push_back(ViewGroup{ { target.TileSize[0], target.TileSize[1] }, {} });
+        group = viewGroups.end() - 1;
+      }
+      group->Targets.push_back(target);
     }
+  }
+
+  auto ostate = rw->GetState();
+  ostate->PushFramebufferBindings();
+
+  std::vector<vtkCamera*> cameras;
+  this->SaveTileCameras(rw, renderers, cameras);
 
-    if (renderFunc)
+  // the size last given to the TileSizeCallback
+  int reportedSize[2] = { this->RenderSize[0], this->RenderSize[1] };
+
+  // Each group renders its views into a target of its own and resamples
+  // them into its quilts, each quilt is then read back and written. The
+  // quilts of a group are done with before the next group starts, so that
+  // the targets of the groups share framebuffers when they have the same
+  // size and are released otherwise. The groups are all built before the
+  // passes are added, which refer to them.
+  vtkLookingGlassRenderGraph* graph = this->GetResourcePool(rw)->GetRenderGraph();
+  for (auto& group : viewGroups)
+  {
+    std::vector<Target>& targets = group.Targets;
+    const int* viewSize = group.ViewSize;
+    const int viewTarget =
+      graph->CreateTarget("View", TileTarget(rw, viewSize, this->RenderDepthBits));
+    std::vector<int> writes = { viewTarget };
+
+    // the views halved i + 1 times, down to the level above the smallest
+    // tiles, which are blitted straight into their quilt
+    int maxHalvings = 0;
+    for (const auto& target : targets)
+    {
+      maxHalvings = std::max(maxHalvings, target.Halvings);
+    }
+    std::vector<int> halfTargets;
+    for (int level = 1; level < maxHalvings; ++level)
     {
-      (*renderFunc)();
+      vtkLookingGlassRenderGraph::TargetDescription description;
+      description.Size[0] = viewSize[0] >> level;
+      description.Size[1] = viewSize[1] >> level;
+      halfTargets.push_back(graph->CreateTarget("HalfView", description));
+      writes.push_back(halfTargets.back());
     }
-    else
+
+    for (auto& target : targets)
     {
-      renderers->Render();
+      vtkLookingGlassRenderGraph::TargetDescription description;
+      description.Size[0] = target.QuiltSize[0];
+      description.Size[1] = target.QuiltSize[1];
+      target.Quilt = graph->CreateTarget("Quilt " + target.DeviceType, description);
+      writes.push_back(target.Quilt);
     }
 
-    quiltFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
+    graph->AddPass("RenderViews", vtkLookingGlassRenderGraph::GPU, {}, writes,
+      [&, viewSize, viewTarget, halfTargets]() {
+        // the view halved `level` times
+        auto getLevel = [&](int level) {
+          return level ? graph->GetFramebuffer(halfTargets[level - 1])
+                       : graph->GetFramebuffer(viewTarget);
+        };
+
+        for (auto& target : targets)
+        {
+          graph->GetFramebuffer(target.Quilt)->Bind(GL_DRAW_FRAMEBUFFER);
+          ostate->vtkglClearColor(0.0, 0.0, 0.0, 0.0);
+          ostate->vtkglViewport(0, 0, target.QuiltSize[0], target.QuiltSize[1]);
+          ostate->vtkglScissor(0, 0, target.QuiltSize[0], target.QuiltSize[1]);
+          ostate->vtkglClear(GL_COLOR_BUFFER_BIT);
+        }
+
+        // Tile i of n views the fraction i / (n - 1) of the view cone. Identical
+        // fractions across the targets are rendered once, keyed by the reduced
+        // fraction so that the comparison is exact.
+        std::map<std::pair<int, int>, std::vector<std::pair<Target*, int>>> views;
+        for (auto& target : targets)
+        {
+          int numberOfTiles = target.Settings.QuiltTiles[0] * target.Settings.QuiltTiles[1];
+          if (numberOfTiles < 2)
+          {
+            // a single view looks from the middle of the cone
+            views[std::make_pair(1, 2)].push_back(std::make_pair(&target, 0));
+            continue;
+          }
+          for (int tile = 0; tile < numberOfTiles; ++tile)
+          {
+            int num = tile;
+            int den = numberOfTiles - 1;
+            int a = num;
+            int b = den;
+            while (b != 0)
+            {
+              int t = a % b;
+              a = b;
+              b = t;
+            }
+            views[std::make_pair(num / a, den / a)].push_back(std::make_pair(&target, tile));
+          }
+        }
+        vtkDebugMacro("Rendering " << views.size() << " views for " << targets.size() << " quilts");
+
+        if (this->TileSizeCallback &&
+          (viewSize[0] != reportedSize[0] || viewSize[1] != reportedSize[1]))
+        {
+          reportedSize[0] = viewSize[0];
+          reportedSize[1] = viewSize[1];
+          this->TileSizeCallback(viewSize[0], viewSize[1]);
+        }
+
+        for (const auto& view : views)
+        {
+          getLevel(0)->Bind(GL_DRAW_FRAMEBUFFER);
+          ostate->vtkglViewport(0, 0, viewSize[0], viewSize[1]);
+          ostate->vtkglScissor(0, 0, viewSize[0], viewSize[1]);
+
+          double viewFraction = static_cast<double>(view.first.first) / view.first.second;
+          this->SetupViewCameras(
+            renderers, cameras, viewFraction, targets[0].Settings.AspectRatio);
+
+          if (renderFunc)
+          {
+            (*renderFunc)();
+          }
+          else
+          {
+            renderers->Render();
+          }
+
+          // halve the view down to the level above the smallest tile using it
+          int halvings = 0;
+          for (const auto& use : view.second)
+          {
+            halvings = std::max(halvings, use.first->Halvings);
+          }
+          for (int level = 1; level < halvings; ++level)
+          {
+            const int size[2] = { viewSize[0] >> level, viewSize[1] >> level };
+            getLevel(level - 1)->Bind(GL_READ_FRAMEBUFFER);
+            getLevel(level)->Bind(GL_DRAW_FRAMEBUFFER);
+            ostate->vtkglViewport(0, 0, size[0], size[1]);
+            ostate->vtkglScissor(0, 0, size[0], size[1]);
+            glBlitFramebuffer(0, 0, 2 * size[0], 2 * size[1], 0, 0, size[0], size[1],
+              GL_COLOR_BUFFER_BIT, GL_LINEAR);
+          }
+
+          // copy or halve the view into every quilt that uses it
+          for (const auto& use : view.second)
+          {
+            Target* target = use.first;
+            int tile = use.second;
+            int destPos[2] = { (tile % target->Settings.QuiltTiles[0]) * target->TileSize[0],
+              (tile / target->Settings.QuiltTiles[0]) * target->TileSize[1] };
+            const int level = std::max(target->Halvings - 1, 0);
+            const int srcSize[2] = { viewSize[0] >> level, viewSize[1] >> level };
+
+            getLevel(level)->Bind(GL_READ_FRAMEBUFFER);
+            graph->GetFramebuffer(target->Quilt)->Bind(GL_DRAW_FRAMEBUFFER);
+            ostate->vtkglViewport(destPos[0], destPos[1], target->TileSize[0], target->TileSize[1]);
+            ostate->vtkglScissor(destPos[0], destPos[1], target->TileSize[0], target->TileSize[1]);
+            glBlitFramebuffer(0, 0, srcSize[0], srcSize[1], destPos[0], destPos[1],
+              destPos[0] + target->TileSize[0], destPos[1] + target->TileSize[1],
+              GL_COLOR_BUFFER_BIT, target->Halvings ? GL_LINEAR : GL_NEAREST);
+          }
+        }
+      });
+
+    for (auto& target : targets)
+    {
+      const int file = graph->CreateResource("QuiltFile " + target.DeviceType);
+      graph->MarkOutput(file);
+      graph->AddPass(
+        "WriteQuilt", vtkLookingGlassRenderGraph::READBACK, { target.Quilt }, { file }, [&]() {
+          vtkNew<vtkImageData> image;
+          image->SetDimensions(target.QuiltSize[0], target.QuiltSize[1], 1);
+          image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+          ReadColorBuffer(rw, graph->GetFramebuffer(target.Quilt), image);
+
+          std::string fileName = std::string(filePrefix) + target.DeviceType +
+            FormatQuiltFileSuffix(target.Settings.QuiltTiles) + ".png";
+
+          vtkNew<vtkPNGWriter> writer;
+          writer->SetFileName(fileName.c_str());
+          writer->SetInputData(image);
+          writer->Write();
+        });
+    }
+  }
+  graph->Execute(rw);
 
-    int destPos[2];
-    this->GetTilePosition(tile, destPos);
+  this->RestoreTileCameras(renderers, cameras);
 
-    // blit to quilt
-    ostate->vtkglViewport(destPos[0], destPos[1], renderSize[0], renderSize[1]);
-    ostate->vtkglScissor(destPos[0], destPos[1], renderSize[0], renderSize[1]);
-    glBlitFramebuffer(0, 0, renderSize[0], renderSize[1], destPos[0], destPos[1],
-      destPos[0] + renderSize[0], destPos[1] + renderSize[1], GL_COLOR_BUFFER_BIT, GL_LINEAR);
+  if (this->TileSizeCallback &&
+    (reportedSize[0] != this->RenderSize[0] || reportedSize[1] != this->RenderSize[1]))
+  {
+    this->TileSizeCallback(this->RenderSize[0], this->RenderSize[1]);
   }
+
   ostate->PopFramebufferBindings();
+}
 
-  // restore the original camera settings
-  int count = 0;
-  for (renderers->InitTraversal(rsit); (aren = renderers->GetNextRenderer(rsit)); ++count)
+namespace
+{
+// Store the view and projection matrices of a camera, row major, in 32
+// consecutive values
+void StoreViewMatrices(vtkCamera* cam, double aspectRatio, double* matrices)
+{
+  vtkMatrix4x4* view = cam->GetModelViewTransformMatrix();
+  std::copy(view->GetData(), view->GetData() + 16, matrices);
+  vtkMatrix4x4* projection = cam->GetProjectionTransformMatrix(aspectRatio, -1.0, 1.0);
+  std::copy(projection->GetData(), projection->GetData() + 16, matrices + 16);
+}
+
+// Copy rows read from OpenGL, bottom row first, so that the top row comes first
+template <typename T>
+void FlipRows(const T* src, T* dest, int width, int height, int components)
+{
+  const size_t rowSize = static_cast<size_t>(width) * components;
+  for (int row = 0; row < height; ++row)
   {
-    aren->SetActiveCamera(Cameras[count]);
-    Cameras[count]->Delete();
+    std::copy(src + row * rowSize, src + (row + 1) * rowSize, dest + (height - 1 - row) * rowSize);
   }
+}
+}
 
-  if (this->IsRecording)
+void vtkLookingGlassInterface::GetViewMatrices(vtkCamera* camera, vtkDoubleArray* matrices)
+{
+  const int tcount = this->GetNumberOfTiles();
+  matrices->SetNumberOfComponents(32);
+  matrices->SetNumberOfTuples(tcount);
+
+  vtkNew<vtkCamera> cam;
+  const double aspectRatio = this->RenderSize[0] / static_cast<double>(this->RenderSize[1]);
+  for (int tile = 0; tile < tcount; ++tile)
   {
-    // Write out a movie frame if we are recording
-    this->WriteQuiltMovieFrame();
+    cam->DeepCopy(camera);
+    this->AdjustCamera(cam, tile);
+    this->ApplyClippingLimits(cam);
+    StoreViewMatrices(cam, aspectRatio, matrices->GetPointer(tile * 32));
   }
 }
 
-void vtkLookingGlassInterface::SaveQuilt(const char* fileName)
+bool vtkLookingGlassInterface::RenderViews(vtkOpenGLRenderWindow* rw, vtkCollection* cameras,
+  const char* directory, bool depth, vtkRendererCollection* renderers,
+  std::function<void(void)>* renderFunc)
 {
-  vtkSmartPointer<vtkPixelBufferObject> pbo = this->QuiltTexture->Download();
+  if (!renderers)
+  {
+    // If no renderers are provided, default to all on the render window
+    renderers = rw->GetRenderers();
+  }
+  if (!cameras || !directory || renderers->GetNumberOfItems() == 0)
+  {
+    vtkErrorMacro("RenderViews requires cameras, renderers and an output directory");
+    return false;
+  }
 
-  vtkNew<vtkImageData> buffer;
-  buffer->SetDimensions(this->QuiltSize[0], this->QuiltSize[1], 1);
-  buffer->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+  const int tcount = this->GetNumberOfTiles();
+  const int width = this->RenderSize[0];
+  const int height = this->RenderSize[1];
+  const unsigned int numberOfPixels = static_cast<unsigned int>(width) * height;
 
-  vtkPixelExtent ext(this->QuiltSize[0], this->QuiltSize[1]);
-  auto* srcData = pbo->MapPackedBuffer();
-  auto* destData = buffer->GetScalarPointer(0, 0, 0);
-  vtkPixelTransfer::Blit(ext, 4, VTK_UNSIGNED_CHAR, srcData, VTK_UNSIGNED_CHAR, destData);
-  pbo->UnmapPackedBuffer();
+  vtkLookingGlassViewWriter writer;
+  if (!writer.Start(directory, tcount, width, height, depth))
+  {
+    vtkErrorMacro("Unable to create the directory " << directory);
+    return false;
+  }
 
-  // Convert to 3 components.
-  // Getting rid of the alpha component eliminates the transparent background.
-  vtkNew<vtkImageData> image;
-  image->SetDimensions(this->QuiltSize[0], this->QuiltSize[1], 1);
-  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  // the views are read straight from the render target, no quilt is needed
+  vtkOpenGLFramebufferObject* renderFramebuffer = this->GetRenderFramebuffer(rw);
+
+  auto ostate = rw->GetState();
+  ostate->PushFramebufferBindings();
 
-  auto oldArray = buffer->GetPointData()->GetScalars();
-  auto newArray = image->GetPointData()->GetScalars();
-  for (int i = 0; i < 3; ++i)
+  std::vector<vtkCamera*> savedCameras;
+  this->SaveTileCameras(rw, renderers, savedCameras);
+  vtkRenderer* firstRenderer = renderers->GetFirstRenderer();
+
+  // Each view is read into a pixel buffer and only copied out once the next
+  // view has been rendered, so that the transfer does not stall rendering.
+  // A chunk is handed to the writer once its last view has been copied.
+  struct Readback
+  {
+    vtkSmartPointer<vtkPixelBufferObject> Colors;
+    vtkSmartPointer<vtkPixelBufferObject> Depth;
+    vtkLookingGlassViewWriter::Chunk* Chunk = nullptr;
+    int View = 0;
+  };
+  Readback readbacks[2];
+  for (Readback& readback : readbacks)
   {
-    newArray->CopyComponent(i, oldArray, i);
+    readback.Colors = vtkSmartPointer<vtkPixelBufferObject>::New();
+    readback.Colors->SetContext(rw);
+    readback.Depth = vtkSmartPointer<vtkPixelBufferObject>::New();
+    readback.Depth->SetContext(rw);
   }
 
-  vtkNew<vtkPNGWriter> writer;
-  writer->SetFileName(fileName);
-  writer->SetInputData(image);
-  writer->Write();
+  auto finishReadback = [&](Readback& readback) {
+    if (!readback.Chunk)
+    {
+      return;
+    }
+    const size_t offset = static_cast<size_t>(readback.View) * numberOfPixels;
+    auto colors = static_cast<const unsigned char*>(readback.Colors->MapPackedBuffer());
+    FlipRows(colors, readback.Chunk->Colors.data() + offset * 3, width, height, 3);
+    readback.Colors->UnmapPackedBuffer();
+    if (depth)
+    {
+      auto depths = static_cast<const float*>(readback.Depth->MapPackedBuffer());
+      FlipRows(depths, readback.Chunk->Depth.data() + offset, width, height, 1);
+      readback.Depth->UnmapPackedBuffer();
+    }
+    if (readback.View == tcount - 1)
+    {
+      writer.WriteChunk(readback.Chunk);
+    }
+    readback.Chunk = nullptr;
+  };
+
+  int packAlignment = 4;
+  ostate->vtkglGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+
+  int next = 0;
+  vtkCollectionSimpleIterator cit;
+  vtkObject* item;
+  int index = 0;
+  for (cameras->InitTraversal(cit); (item = cameras->GetNextItemAsObject(cit)); ++index)
+  {
+    vtkCamera* camera = vtkCamera::SafeDownCast(item);
+    if (!camera)
+    {
+      vtkErrorMacro("Item " << index << " of the cameras is not a vtkCamera");
+      continue;
+    }
+
+    // every renderer takes the same base camera
+    std::vector<vtkCamera*> baseCameras(savedCameras.size(), camera);
+    vtkLookingGlassViewWriter::Chunk* chunk = writer.TakeChunk();
+    chunk->Index = index;
+
+    for (int view = 0; view < tcount; ++view)
+    {
+      renderFramebuffer->Bind(GL_DRAW_FRAMEBUFFER);
+      ostate->vtkglViewport(0, 0, width, height);
+      ostate->vtkglScissor(0, 0, width, height);
+
+      this->SetupViewCameras(
+        renderers, baseCameras, view / (tcount - 1.0), this->AdjustCameraAspectRatio);
+      if (renderFunc)
+      {
+        (*renderFunc)();
+      }
+      else
+      {
+        renderers->Render();
+      }
+      StoreViewMatrices(firstRenderer->GetActiveCamera(), firstRenderer->GetTiledAspectRatio(),
+        chunk->Matrices.data() + view * 32);
+
+      Readback& readback = readbacks[next];
+      next = 1 - next;
+      renderFramebuffer->Bind(GL_READ_FRAMEBUFFER);
+      renderFramebuffer->ActivateReadBuffer(0);
+      ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, 1);
+      readback.Colors->Allocate(
+        VTK_UNSIGNED_CHAR, numberOfPixels, 3, vtkPixelBufferObject::PACKED_BUFFER);
+      readback.Colors->Bind(vtkPixelBufferObject::PACKED_BUFFER);
+      glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+      if (depth)
+      {
+        readback.Depth->Allocate(VTK_FLOAT, numberOfPixels, 1, vtkPixelBufferObject::PACKED_BUFFER);
+        readback.Depth->Bind(vtkPixelBufferObject::PACKED_BUFFER);
+        glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+      }
+      readback.Colors->UnBind();
+      readback.Chunk = chunk;
+      readback.View = view;
+
+      // the previous view had the whole render to transfer
+      finishReadback(readbacks[next]);
+    }
+  }
+  // the last view is still in flight
+  finishReadback(readbacks[1 - next]);
+  ostate->vtkglPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+  ostate->PopFramebufferBindings();
+  this->RestoreTileCameras(renderers, savedCameras);
+
+  if (this->ReleaseTransientTargets)
+  {
+    this->ReleaseTransientGraphicsResources(rw);
+  }
+
+  if (!writer.End())
+  {
+    vtkErrorMacro("Unable to write the views to " << directory);
+    return false;
+  }
+  return true;
 }
 
 std::string vtkLookingGlassInterface::QuiltFileSuffix() const
 {
-  std::string w = std::to_string(this->QuiltTiles[0]);
-  std::string h = std::to_string(this->QuiltTiles[1]);
-  return "_qs" + w + "x" + h;
+  return FormatQuiltFileSuffix(this->QuiltTiles);
 }
 
 void vtkLookingGlassInterface::StartRecordingQuilt(const char* fileName)
@@ -938,34 +2310,48 @@ void vtkLookingGlassInterface::StartRecordingQuilt(const char* fileName)
     return;
   }
 
-  if (!this->MovieImageBuffer)
-  {
-    this->MovieImageBuffer = vtkImageData::New();
-  }
-
   if (!this->MovieImageData)
   {
     this->MovieImageData = vtkImageData::New();
   }
 
-  if (!this->MovieWriter)
-  {
-    this->MovieWriter = MovieWriterClass::New();
-  }
-
-  auto buffer = this->MovieImageBuffer;
   auto image = this->MovieImageData;
-  auto writer = this->MovieWriter;
-
-  buffer->SetDimensions(this->QuiltSize[0], this->QuiltSize[1], 1);
-  buffer->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
 
-  image->SetDimensions(this->QuiltSize[0], this->QuiltSize[1], 1);
+  int size[2];
+  this->GetQuiltTextureSize(size);
+  image->SetDimensions(size[0], size[1], 1);
   image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
 
-  writer->SetInputData(image);
-  writer->SetFileName(fileName);
-  writer->Start();
+  if (IsQuiltSequenceFile(fileName))
+  {
+    if (!this->SequenceWriter)
+    {
+      this->SequenceWriter = vtkLookingGlassQuiltSequenceWriter::New();
+    }
+
+    auto writer = this->SequenceWriter;
+    writer->SetFileName(fileName);
+    writer->SetQuiltTiles(this->QuiltTiles);
+    writer->SetDeviceType(this->DeviceType);
+    writer->SetAspectRatio(this->AdjustCameraAspectRatio);
+    writer->SetViewAngle(this->ViewAngle);
+    if (!writer->Start())
+    {
+      return;
+    }
+  }
+  else
+  {
+    if (!this->MovieWriter)
+    {
+      this->MovieWriter = MovieWriterClass::New();
+    }
+
+    auto writer = this->MovieWriter;
+    writer->SetInputData(image);
+    writer->SetFileName(fileName);
+    writer->Start();
+  }
 
   this->IsRecording = true;
 }
@@ -976,30 +2362,35 @@ void vtkLookingGlassInterface::WriteQuiltMovieFrame()
   {
     return;
   }
-
-  auto buffer = this->MovieImageBuffer;
-  auto image = this->MovieImageData;
-  auto writer = this->MovieWriter;
-
-  vtkSmartPointer<vtkPixelBufferObject> pbo = this->QuiltTexture->Download();
-
-  vtkPixelExtent ext(this->QuiltSize[0], this->QuiltSize[1]);
-  auto* srcData = pbo->MapPackedBuffer();
-  auto* destData = buffer->GetScalarPointer(0, 0, 0);
-  vtkPixelTransfer::Blit(ext, 4, VTK_UNSIGNED_CHAR, srcData, VTK_UNSIGNED_CHAR, destData);
-  pbo->UnmapPackedBuffer();
+  vtkLookingGlassTraceScope("WriteQuiltMovieFrame");
 
   // Ogg Theora (and possibly other movie writers as well) assume the
-  // data will be 3-component. Thus, we have to convert it to 3-component
-  // or else the movie writer will not work properly.
-  auto oldArray = buffer->GetPointData()->GetScalars();
-  auto newArray = image->GetPointData()->GetScalars();
-  for (int i = 0; i < 3; ++i)
+  // data will be 3-component, which is what ReadQuilt() produces.
+  int size[2];
+  this->GetQuiltTextureSize(size);
+  this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::READBACK);
+  this->ReadQuilt(this->MovieImageData);
+  this->Statistics->StopPhase(static_cast<vtkTypeInt64>(size[0]) * size[1] * 3);
+
+  this->EncodeQuiltMovieFrame();
+}
+
+void vtkLookingGlassInterface::EncodeQuiltMovieFrame()
+{
+  vtkLookingGlassTraceScope("EncodeQuiltMovieFrame");
+  int size[2];
+  this->GetQuiltTextureSize(size);
+  const vtkTypeInt64 quiltBytes = static_cast<vtkTypeInt64>(size[0]) * size[1] * 3;
+  this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::ENCODE);
+  if (this->SequenceWriter && this->SequenceWriter->IsWriting())
   {
-    newArray->CopyComponent(i, oldArray, i);
+    this->SequenceWriter->Write(this->MovieImageData);
   }
-
-  writer->Write();
+  else
+  {
+    this->MovieWriter->Write();
+  }
+  this->Statistics->StopPhase(quiltBytes);
 }
 
 void vtkLookingGlassInterface::StopRecordingQuilt()
@@ -1010,9 +2401,268 @@ void vtkLookingGlassInterface::StopRecordingQuilt()
     return;
   }
 
-  auto writer = this->MovieWriter;
-
-  writer->End();
+  if (this->SequenceWriter && this->SequenceWriter->IsWriting())
+  {
+    this->SequenceWriter->End();
+  }
+  else
+  {
+    this->MovieWriter->End();
+  }
 
   this->IsRecording = false;
 }
+
+bool vtkLookingGlassInterface::StartPublishingQuilt(const char* name, int numberOfSlots)
+{
+  if (!this->QuiltPublisher)
+  {
+    this->QuiltPublisher = vtkLookingGlassSharedQuiltPublisher::New();
+  }
+
+  // the slots are sized for the quilt of the current device type
+  int size[2];
+  this->GetQuiltTextureSize(size);
+  auto publisher = this->QuiltPublisher;
+  publisher->SetName(name);
+  publisher->SetNumberOfSlots(numberOfSlots);
+  return publisher->Open(size[0], size[1]);
+}
+
+void vtkLookingGlassInterface::PublishQuiltFrame()
+{
+  if (!this->IsPublishingQuilt())
+  {
+    return;
+  }
+  if (!this->QuiltFramebuffer)
+  {
+    vtkErrorMacro("The quilt must be rendered before it can be published");
+    return;
+  }
+
+  auto publisher = this->QuiltPublisher;
+  publisher->SetQuiltTiles(this->QuiltTiles);
+  publisher->SetDeviceType(this->DeviceType);
+  publisher->SetAspectRatio(this->AdjustCameraAspectRatio);
+  publisher->SetViewAngle(this->ViewAngle);
+
+  int size[2];
+  this->GetQuiltTextureSize(size);
+  unsigned char* pixels = publisher->BeginFrame(size[0], size[1]);
+  if (!pixels)
+  {
+    return;
+  }
+  vtkLookingGlassTraceScope("PublishQuilt");
+  this->Statistics->StartPhase(vtkLookingGlassFrameStatistics::READBACK);
+  ReadColorBuffer(
+    this->QuiltTexture->GetContext(), this->QuiltFramebuffer, size[0], size[1], pixels);
+  this->Statistics->StopPhase(static_cast<vtkTypeInt64>(size[0]) * size[1] * 3);
+  publisher->EndFrame();
+}
+
+void vtkLookingGlassInterface::StopPublishingQuilt()
+{
+  if (this->QuiltPublisher)
+  {
+    this->QuiltPublisher->Close();
+  }
+}
+
+bool vtkLookingGlassInterface::IsPublishingQuilt() const
+{
+  return this->QuiltPublisher && this->QuiltPublisher->IsOpen();
+}
+
+bool vtkLookingGlassInterface::DrawQuiltClientFrame(vtkOpenGLRenderWindow* rw)
+{
+  if (!this->QuiltClient)
+  {
+    return false;
+  }
+
+  vtkTextureObject* quilt = this->QuiltClient->UploadFrame(rw);
+  if (!quilt)
+  {
+    return false;
+  }
+
+  const int* tiles = this->QuiltClient->GetQuiltTiles();
+  if (tiles[0] != this->QuiltTiles[0] || tiles[1] != this->QuiltTiles[1])
+  {
+    vtkErrorMacro("Received quilts of " << tiles[0] << "x" << tiles[1]
+                                        << " tiles but the device uses " << this->QuiltTiles[0]
+                                        << "x" << this->QuiltTiles[1]);
+    return false;
+  }
+
+  this->DrawLightFieldInternal(rw, quilt, this->QuiltClient->GetViewPortion());
+  return true;
+}
+
+bool vtkLookingGlassInterface::StartQuiltMoviePlayback(const char* fileName, bool loop)
+{
+  if (!this->MoviePlayer)
+  {
+    this->MoviePlayer = new vtkLookingGlassQuiltPlayer;
+  }
+  this->MoviePlayer->Stop();
+
+  if (IsQuiltSequenceFile(fileName))
+  {
+    auto reader = vtkSmartPointer<vtkLookingGlassQuiltSequenceReader>::New();
+    reader->SetFileName(fileName);
+    if (!reader->Open())
+    {
+      return false;
+    }
+
+    // Only the decode thread touches the reader from here on
+    auto nextFrame = std::make_shared<int>(0);
+    vtkLookingGlassQuiltPlayer::FrameSource source = [reader, nextFrame](vtkImageData* image) {
+      if (*nextFrame >= reader->GetNumberOfFrames())
+      {
+        return false;
+      }
+      return reader->ReadFrame((*nextFrame)++, image);
+    };
+    vtkLookingGlassQuiltPlayer::RewindFunction rewind = [nextFrame]() {
+      *nextFrame = 0;
+      return true;
+    };
+    // frames are read at random, so a slow decode jumps to the frame due now
+    vtkLookingGlassQuiltPlayer::SeekFunction seek = [reader, nextFrame, loop](long long index) {
+      long long numberOfFrames = reader->GetNumberOfFrames();
+      if (loop && numberOfFrames > 0)
+      {
+        *nextFrame = static_cast<int>(index % numberOfFrames);
+        return index;
+      }
+      index = std::min(index, numberOfFrames);
+      *nextFrame = static_cast<int>(index);
+      return index;
+    };
+
+    this->MoviePlayer->Start(source, rewind, reader->GetFrameRate(), loop, seek);
+    return true;
+  }
+
+#if VTK_MODULE_ENABLE_VTK_IOFFMPEG
+
+  auto video = vtkSmartPointer<vtkFFMPEGVideoSource>::New();
+  video->SetFileName(fileName);
+  video->Initialize();
+  if (!video->GetInitialized())
+  {
+    vtkErrorMacro("Unable to open quilt movie " << fileName);
+    return false;
+  }
+
+  // Only the decode thread touches the video source from here on
+  vtkLookingGlassQuiltPlayer::FrameSource source = [video](vtkImageData* image) {
+    video->Grab();
+    if (video->GetEndOfFile())
+    {
+      return false;
+    }
+    video->Update();
+    image->DeepCopy(video->GetOutput());
+    return true;
+  };
+  vtkLookingGlassQuiltPlayer::RewindFunction rewind = [video]() {
+    video->ReleaseSystemResources();
+    video->Initialize();
+    return video->GetInitialized() != 0;
+  };
+
+  this->MoviePlayer->Start(source, rewind, video->GetFrameRate(), loop);
+  return true;
+#else
+  (void)loop;
+  vtkErrorMacro("Playing " << fileName << " requires VTK to be built with FFMPEG");
+  return false;
+#endif
+}
+
+void vtkLookingGlassInterface::StopQuiltMoviePlayback()
+{
+  if (this->MoviePlayer)
+  {
+    this->MoviePlayer->Stop();
+  }
+}
+
+bool vtkLookingGlassInterface::IsPlayingQuiltMovie() const
+{
+  return this->MoviePlayer && this->MoviePlayer->IsPlaying();
+}
+
+int vtkLookingGlassInterface::GetNumberOfDroppedMovieFrames() const
+{
+  return this->MoviePlayer ? this->MoviePlayer->GetNumberOfDroppedFrames() : 0;
+}
+
+bool vtkLookingGlassInterface::UpdateQuiltMoviePlayback(vtkOpenGLRenderWindow* rw)
+{
+  if (!this->IsPlayingQuiltMovie())
+  {
+    return false;
+  }
+
+  vtkOpenGLFramebufferObject* renderFramebuffer;
+  vtkOpenGLFramebufferObject* quiltFramebuffer;
+  this->GetFramebuffers(rw, renderFramebuffer, quiltFramebuffer);
+
+  vtkSmartPointer<vtkImageData> frame = this->MoviePlayer->GetDueFrame();
+  if (!frame)
+  {
+    // keep showing the current frame
+    return true;
+  }
+
+  int dims[3];
+  frame->GetDimensions(dims);
+  int size[2];
+  this->GetQuiltTextureSize(size);
+  int numComponents = frame->GetNumberOfScalarComponents();
+  if (dims[0] != size[0] || dims[1] != size[1] || (numComponents != 3 && numComponents != 4) ||
+    frame->GetScalarType() != VTK_UNSIGNED_CHAR)
+  {
+    vtkErrorMacro("Movie frames of " << dims[0] << "x" << dims[1]
+                                     << " do not match the quilt size " << size[0] << "x"
+                                     << size[1] << " of device type " << this->DeviceType);
+    this->StopQuiltMoviePlayback();
+    return false;
+  }
+
+  // Copy the frame into the next buffer of the ring and let the driver
+  // transfer it to the texture asynchronously
+  vtkPixelBufferObject*& pbo = this->PlaybackBuffers[this->PlaybackBufferIndex];
+  this->PlaybackBufferIndex = (this->PlaybackBufferIndex + 1) % NumberOfPlaybackBuffers;
+  if (!pbo)
+  {
+    pbo = vtkPixelBufferObject::New();
+    pbo->SetContext(rw);
+  }
+
+  unsigned int numTuples = static_cast<unsigned int>(dims[0]) * dims[1];
+  void* data = pbo->MapUnpackedBuffer(VTK_UNSIGNED_CHAR, numTuples, numComponents);
+  memcpy(data, frame->GetScalarPointer(), static_cast<size_t>(numTuples) * numComponents);
+  pbo->UnmapUnpackedBuffer();
+  this->MoviePlayer->Recycle(frame);
+
+  pbo->Bind(vtkPixelBufferObject::UNPACKED_BUFFER);
+  this->QuiltTexture->Activate();
+  auto ostate = rw->GetState();
+  int unpackAlignment = 4;
+  ostate->vtkglGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+  ostate->vtkglPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, dims[0], dims[1], numComponents == 4 ? GL_RGBA : GL_RGB,
+    GL_UNSIGNED_BYTE, nullptr);
+  ostate->vtkglPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+  this->QuiltTexture->Deactivate();
+  pbo->UnBind();
+
+  return true;
+}
@@ -23,17 +23,29 @@
 #include "vtkDeprecation.h"
 #include "vtkObject.h"
 #include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkWrappingHints.h"               // For VTK_UNBLOCKTHREADS
 #include <map>
+#include <string>
 #include <vector>
 
 #include <functional>
 
 class vtkCamera;
+class vtkCollection;
+class vtkDoubleArray;
 class vtkGenericMovieWriter;
 class vtkImageData;
+class vtkLookingGlassFrameStatistics;
+class vtkLookingGlassQuiltClient;
+class vtkLookingGlassQuiltPlayer;
+class vtkLookingGlassResourcePool;
+class vtkLookingGlassQuiltSequenceWriter;
+class vtkLookingGlassQuiltServer;
+class vtkLookingGlassSharedQuiltPublisher;
 class vtkOpenGLFramebufferObject;
-class vtkOpenGLQuadHelper;
 class vtkOpenGLRenderWindow;
+class vtkPixelBufferObject;
+class vtkRenderer;
 class vtkRendererCollection;
 class vtkTextureObject;
 class vtkWindow;
@@ -48,7 +60,8 @@ public:
   // just a convenience method to handle the OS specific subclasses
   // in a generic manner. The deviceIndex argument specifies the
   // index of the LookingGlass device on which the window should be placed
-  // (presently supported only on macOS).
+  // (presently supported only on macOS). On Linux without a display server,
+  // an EGL or OSMesa window is created if VTK was built with either.
   static vtkOpenGLRenderWindow* CreateLookingGlassRenderWindow(int deviceIndex = 0);
 
   // Get the display posiiton for the looking glass device
@@ -96,15 +109,24 @@ public:
   // opengl context's and using the texture handle to pass between them
   void DrawLightField(vtkOpenGLRenderWindow* rw, vtkTextureObject* copyTO);
 
+  // End the frame of a quilt that is not drawn on a device, in place of
+  // DrawLightField(), so that its statistics and trace are complete.
+  void SkipLightField();
+
+  // Check if a Looking Glass device was found by Initialize().
+  bool IsDeviceConnected() const { return this->Connected; }
+
   // Get, and create if needed, framebuffers to be used for rendering and
   // constructing the quilt. These will have sizes based on the LookingGlass
-  // settings.
+  // settings. The render framebuffer is the one the next RenderQuilt()
+  // renders the tiles into.
   void GetFramebuffers(vtkOpenGLRenderWindow* rw, vtkOpenGLFramebufferObject*& renderFramebuffer,
     vtkOpenGLFramebufferObject*& quiltFramebuffer);
 
   /**
    * Release graphics resources and ask components to release their own
-   * resources.
+   * resources. The resources shared with the other interfaces rendering
+   * into the window are released with the last of them.
    * \pre w_exists: w!=0
    */
   void ReleaseGraphicsResources(vtkWindow* w);
@@ -127,6 +149,174 @@ public:
   vtkGetMacro(DeviceType, std::string);
   //@}
 
+  /**
+   * Storage formats for the quilt texture. RGBA8 is the default. RGB8 drops
+   * the unused alpha channel, which saves a quarter of the memory on drivers
+   * that store it with 3 bytes per pixel; many pad it to 4 bytes, the size
+   * of RGBA8. RGB10A2 keeps more precision for volume rendering at the same
+   * size and RGBA16F doubles the memory for high dynamic range content.
+   */
+  enum QuiltFormats
+  {
+    RGBA8 = 0,
+    RGB8,
+    RGB10A2,
+    RGBA16F
+  };
+
+  //@{
+  /**
+   * Set/Get the storage format of the quilt texture, one of the QuiltFormats.
+   * Changing it reallocates the quilt on the next render.
+   */
+  vtkSetClampMacro(QuiltFormat, int, RGBA8, RGBA16F);
+  vtkGetMacro(QuiltFormat, int);
+  //@}
+
+  //@{
+  /**
+   * When on, the quilt texture is allocated with the size of the area
+   * covered by the tiles, RenderSize * QuiltTiles, instead of the QuiltSize
+   * of the device, which may leave unused pixels on the right and top. Saved
+   * quilts and movies then have the trimmed size as well. Off by default.
+   */
+  vtkSetMacro(TrimQuiltToTiles, bool);
+  vtkGetMacro(TrimQuiltToTiles, bool);
+  vtkBooleanMacro(TrimQuiltToTiles, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the framebuffer the tiles are rendered into is released at the
+   * end of every RenderQuilt(), trading an allocation per quilt for the
+   * memory of one tile with its depth buffer. The framebuffers shared with
+   * the other interfaces rendering into the window are released as well.
+   * Off by default.
+   */
+  vtkSetMacro(ReleaseTransientTargets, bool);
+  vtkGetMacro(ReleaseTransientTargets, bool);
+  vtkBooleanMacro(ReleaseTransientTargets, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the quilt is shared with the other interfaces rendering into
+   * the same window with the same quilt size, storage format and tile size,
+   * instead of each allocating its own. Every quilt rendered then replaces
+   * the one of the other interfaces, so this is for interfaces that draw or
+   * read their quilt right after rendering it, as vtkLookingGlassPass does,
+   * which turns it on. Off by default.
+   */
+  vtkSetMacro(ShareQuilt, bool);
+  vtkGetMacro(ShareQuilt, bool);
+  vtkBooleanMacro(ShareQuilt, bool);
+  //@}
+
+  //@{
+  /**
+   * Turn on/off the collection of the CPU and GPU timings of each phase of
+   * the frames, see vtkLookingGlassFrameStatistics. A
+   * vtkLookingGlassFrameStatistics::FrameEvent is fired with the statistics
+   * as call data once each frame is drawn, or once the next quilt starts
+   * when quilts are rendered without being drawn. Off by default.
+   */
+  vtkSetMacro(CollectStatistics, bool);
+  vtkGetMacro(CollectStatistics, bool);
+  vtkBooleanMacro(CollectStatistics, bool);
+  //@}
+
+  /**
+   * Get the frame statistics collected while CollectStatistics is on.
+   */
+  vtkLookingGlassFrameStatistics* GetStatistics() { return this->Statistics; }
+
+  /**
+   * Check if the module was built with LookingGlass_ENABLE_TRACING, without
+   * which the trace capture methods do nothing and return false.
+   */
+  static bool IsTracingAvailable();
+
+  /**
+   * Capture the next frames into a trace file in the Chrome trace event
+   * format, which chrome://tracing and Perfetto open. The trace holds the
+   * spans of RenderQuilt(), of each tile, of DrawLightField() and of the
+   * recording, publishing and streaming of the quilts on the threads that
+   * ran them, the GPU spans of the tiles and of the interlacing on a track
+   * of their own, and a counter track per tile with the props rendered and
+   * the samples drawn. The file is written once `numberOfFrames` frames
+   * are done. There is one capture per process. Returns false if a capture
+   * is already running or tracing is not available.
+   */
+  bool StartTraceCapture(const char* fileName, int numberOfFrames = 10);
+
+  /**
+   * Write the trace captured so far and stop capturing. The context of the
+   * window that rendered the frames is made current to read the last GPU
+   * spans. Returns false if no trace was being captured or the file could
+   * not be written.
+   */
+  bool StopTraceCapture(vtkOpenGLRenderWindow* rw);
+
+  /**
+   * Check if a trace is being captured.
+   */
+  bool IsCapturingTrace() const;
+
+  //@{
+  /**
+   * Set/Get the number of bits of the depth buffer used to render the tiles.
+   * Defaults to 32, 24 halves the depth memory when a stencil is needed.
+   */
+  vtkSetClampMacro(RenderDepthBits, int, 16, 32);
+  vtkGetMacro(RenderDepthBits, int);
+  //@}
+
+  /**
+   * Release the graphics resources that are only needed while the tiles are
+   * rendered. The quilt texture is kept so that it can still be displayed.
+   * Nothing is released while other interfaces render into the same window,
+   * the render targets are shared with them.
+   */
+  void ReleaseTransientGraphicsResources(vtkWindow* w);
+
+  /**
+   * Get the size of the quilt texture, which is the QuiltSize or the area
+   * covered by the tiles when TrimQuiltToTiles is on.
+   */
+  void GetQuiltTextureSize(int size[2]);
+
+  /**
+   * Return an estimate in bytes of the GPU memory used by the render targets
+   * for the given device type with the current format settings, before
+   * anything is allocated. The quilt is counted with the nominal size of its
+   * pixels, 3 bytes for RGB8, so the estimate is low by a quarter of the
+   * quilt on drivers that pad RGB8 textures to 4 bytes. The tiles are
+   * counted as rendered into `rw`, with a stencil when it has one, and
+   * without a stencil when no window is given. Returns -1 for an unknown
+   * device type.
+   */
+  vtkTypeInt64 GetEstimatedGPUMemory(
+    const std::string& deviceType, vtkOpenGLRenderWindow* rw = nullptr);
+
+  /**
+   * Return an estimate in bytes of the host memory used to save or record a
+   * quilt for the given device type. Returns -1 for an unknown device type.
+   */
+  vtkTypeInt64 GetEstimatedHostMemory(const std::string& deviceType);
+
+  //@{
+  /**
+   * Get the number of render targets held besides the quilt, such as the
+   * framebuffer the tiles are rendered into, and an estimate of their size
+   * in bytes. RenderQuilt(), SaveQuiltStreamed() and SaveQuilts() share the
+   * targets of the same size, and release those the last of them did not
+   * use. The targets are shared with the other interfaces rendering into
+   * the same window, and counted once for all of them.
+   */
+  int GetNumberOfRenderTargets();
+  vtkTypeInt64 GetRenderTargetMemory();
+  //@}
+
   //@{
   /**
    * Turn on/off use of near and far clipping limits.
@@ -176,12 +366,109 @@ public:
   void RenderQuilt(vtkOpenGLRenderWindow* rw, vtkRendererCollection* renderers = nullptr,
     std::function<void(void)>* renderFunc = nullptr);
 
+  /**
+   * Read the quilt texture back into a 3 component unsigned char image,
+   * resizing the image if needed. The quilt must have been rendered.
+   */
+  VTK_UNBLOCKTHREADS void ReadQuilt(vtkImageData* image);
+
+  /**
+   * Read the quilt back with the tiles stacked on top of each other instead
+   * of laid out as in the quilt: the image is RenderSize[0] pixels wide and
+   * RenderSize[1] * NumberOfTiles pixels high, with tile 0 at the bottom.
+   * Each tile is then contiguous in memory. The image is only reallocated
+   * when its size changes. The quilt must have been rendered.
+   */
+  VTK_UNBLOCKTHREADS void ReadQuiltTiles(vtkImageData* image);
+
+  /**
+   * Get the number of quilts rendered by RenderQuilt() so far. Consumers of
+   * the quilt compare it with the value they last saw to tell whether the
+   * quilt changed since.
+   */
+  vtkGetMacro(QuiltRenderCount, vtkTypeUInt64);
+
+  /**
+   * Get the camera that the views of the quilt are derived from, for a
+   * renderer of the quilt being rendered by RenderQuilt(). Mappers use it to
+   * make decisions once per quilt rather than once per tile, and the views
+   * it gives are the ones of GetViewMatrices(). Returns nullptr outside of
+   * RenderQuilt() and for other renderers.
+   */
+  vtkCamera* GetQuiltCamera(vtkRenderer* renderer);
+
   /**
    * Save the quilt currently displayed in the render window as a PNG file.
    * The quilt can be loaded into HoloPlay Studio to run the Looking Glass
    * device in stand-alone mode.
    */
-  void SaveQuilt(const char* fileName);
+  VTK_UNBLOCKTHREADS void SaveQuilt(const char* fileName);
+
+  /**
+   * Render the quilt one row of tiles at a time and write each finished row
+   * to a PNG file, instead of assembling the whole quilt in the quilt texture
+   * first. Peak memory is bounded by a single row of tiles, so this can
+   * produce quilts larger than GL_MAX_TEXTURE_SIZE or than would fit in host
+   * memory. The `scale` argument oversamples the tiles, e.g. a scale of 2
+   * renders each tile at twice the RenderSize in each direction. The
+   * `renderers` and `renderFunc` arguments behave as in RenderQuilt().
+   */
+  VTK_UNBLOCKTHREADS void SaveQuiltStreamed(vtkOpenGLRenderWindow* rw, const char* fileName,
+    double scale = 1.0, vtkRendererCollection* renderers = nullptr,
+    std::function<void(void)>* renderFunc = nullptr);
+
+  /**
+   * Save quilts for several device types from a single pass over the scene.
+   * Targets that share the camera and tile aspect ratios share their views
+   * when the tile size of one is that of another halved a whole number of
+   * times: each distinct view is rendered once at the larger size and
+   * halved, averaging 2x2 pixels at each step, into the quilts with smaller
+   * tiles. The other targets render their views at their own tile size. The
+   * quilts are written as PNG files named
+   * `<filePrefix><deviceType><QuiltFileSuffix>.png`. The `renderers` and
+   * `renderFunc` arguments behave as in RenderQuilt().
+   */
+  VTK_UNBLOCKTHREADS void SaveQuilts(vtkOpenGLRenderWindow* rw,
+    const std::vector<std::string>& deviceTypes, const char* filePrefix,
+    vtkRendererCollection* renderers = nullptr, std::function<void(void)>* renderFunc = nullptr);
+
+  /**
+   * Render every view of the quilt for each vtkCamera in `cameras` and write
+   * them as NumPy `.npy` files to `directory`, without assembling a quilt.
+   * For the camera at index i in the collection, `views_<i>.npy` holds a
+   * views x height x width x 3 uint8 array, top row first,
+   * `matrices_<i>.npy` a views x 2 x 4 x 4 float64 array with the view and
+   * the projection matrix of each view, and with `depth`, `depth_<i>.npy` a
+   * views x height x width float32 array of window depth values. Each view
+   * is read back while the next one renders and the files of a camera are
+   * written while the next camera renders. The cameras are applied to every
+   * renderer in turn, the active cameras are restored afterwards. As in
+   * RenderQuilt(), the render window should have the RenderSize. Returns
+   * false if the files cannot be written.
+   */
+  VTK_UNBLOCKTHREADS bool RenderViews(vtkOpenGLRenderWindow* rw, vtkCollection* cameras,
+    const char* directory, bool depth = false, vtkRendererCollection* renderers = nullptr,
+    std::function<void(void)>* renderFunc = nullptr);
+
+  /**
+   * Compute the matrices that AdjustCamera() gives each view of the quilt
+   * for a base camera, with the clipping limits applied, for rendering the
+   * views with another renderer. `matrices` gets a tuple of 32 values per
+   * view, the view then the projection matrix, each row major. The
+   * projection uses the aspect ratio of the RenderSize.
+   */
+  void GetViewMatrices(vtkCamera* camera, vtkDoubleArray* matrices);
+
+  /**
+   * Set a function that is called with the size of the tiles about to be
+   * rendered when it differs from the RenderSize, and in that case again
+   * with the RenderSize when done. Render windows use this to report the
+   * tile size from GetSize() while the tiles are rendered.
+   */
+  void SetTileSizeCallback(std::function<void(int, int)> callback)
+  {
+    this->TileSizeCallback = callback;
+  }
 
   /**
    * Get the extension of the movie file that will be written if the
@@ -218,6 +505,11 @@ public:
    * The quilt can be loaded into HoloPlay Studio to run the Looking Glass
    * device in stand-alone mode, although the user may need to convert the
    * video file into a format that HoloPlay Studio can read (such as MP4).
+   *
+   * If the file name ends with ".lgq", the quilts are written to a quilt
+   * sequence file instead, see vtkLookingGlassQuiltSequenceWriter. These
+   * files are larger than movies but any frame, or any tile of a frame, can
+   * be read back without decoding the frames before it.
    */
   void StartRecordingQuilt(const char* fileName);
 
@@ -238,6 +530,98 @@ public:
    */
   void StopRecordingQuilt();
 
+  /**
+   * Start publishing every rendered quilt to other processes on this host
+   * through the shared memory segment with the given name, see
+   * vtkLookingGlassSharedQuiltPublisher. The quilt is read back from the GPU
+   * straight into the shared memory at the end of each `RenderQuilt()`.
+   * Returns false if the segment cannot be created.
+   */
+  bool StartPublishingQuilt(const char* name, int numberOfSlots = 3);
+
+  /**
+   * Publish the current quilt. This is called automatically by
+   * `RenderQuilt()` while publishing.
+   */
+  void PublishQuiltFrame();
+
+  /**
+   * Stop publishing quilts and remove the shared memory segment.
+   */
+  void StopPublishingQuilt();
+
+  /**
+   * Check if quilts are being published.
+   */
+  bool IsPublishingQuilt() const;
+
+  /**
+   * Start playing a quilt movie on the device. The movie is decoded on a
+   * background thread and, while it plays, render windows display its frames
+   * instead of rendering the scene, so pre-rendered sequences can be mixed
+   * with live rendering. Frames are shown at the movie's frame rate and
+   * frames that are due before the window renders again are dropped, so the
+   * application should render at least at that rate, for example from a
+   * repeating interactor timer. When decoding a quilt sequence file falls
+   * behind, it jumps ahead to the frame that is due, other movies are
+   * decoded frame by frame and play late instead. The movie must have the
+   * quilt size of the current device type. Returns false if the movie cannot be opened.
+   * Requires VTK to be built with FFMPEG, except for quilt sequence files
+   * ending with ".lgq" which are always supported.
+   */
+  bool StartQuiltMoviePlayback(const char* fileName, bool loop = false);
+
+  /**
+   * Stop playing the quilt movie and go back to rendering the scene.
+   */
+  void StopQuiltMoviePlayback();
+
+  /**
+   * Check if a quilt movie is being played. This becomes false once the
+   * last frame of a movie that does not loop has been shown.
+   */
+  bool IsPlayingQuiltMovie() const;
+
+  /**
+   * Upload the movie frame that is due now into the quilt texture. Returns
+   * true while a movie is playing, in which case the quilt texture holds a
+   * movie frame and should be drawn with DrawLightField() instead of
+   * rendering the quilt. Render windows call this automatically.
+   */
+  bool UpdateQuiltMoviePlayback(vtkOpenGLRenderWindow* rw);
+
+  /**
+   * Get the number of movie frames that were skipped because they became
+   * due before the window rendered again, or before they could be decoded.
+   */
+  int GetNumberOfDroppedMovieFrames() const;
+
+  //@{
+  /**
+   * Set/Get a server that every rendered quilt is sent to while a client is
+   * connected, see vtkLookingGlassQuiltServer.
+   */
+  void SetQuiltServer(vtkLookingGlassQuiltServer* server);
+  vtkGetObjectMacro(QuiltServer, vtkLookingGlassQuiltServer);
+  //@}
+
+  //@{
+  /**
+   * Set/Get a client whose received quilts are shown instead of rendering
+   * the scene, see vtkLookingGlassQuiltClient.
+   */
+  void SetQuiltClient(vtkLookingGlassQuiltClient* client);
+  vtkGetObjectMacro(QuiltClient, vtkLookingGlassQuiltClient);
+  //@}
+
+  /**
+   * Draw the latest quilt received by the quilt client. Returns false if
+   * there is no client or it did not receive a quilt yet, in which case the
+   * scene should be rendered as usual. Render windows call this
+   * automatically.
+   */
+  bool DrawQuiltClientFrame(vtkOpenGLRenderWindow* rw);
+
   using DeviceTypes = std::vector<std::pair<std::string, std::string>>;
 
   /**
@@ -245,6 +629,13 @@ public:
    */
   static DeviceTypes GetDevices();
 
+  /**
+   * Get the quilt size, the number of tiles and the aspect ratio of the
+   * views for a device type. Returns false if the device type is unknown.
+   */
+  static bool GetDeviceSettings(
+    const std::string& deviceType, int quiltSize[2], int quiltTiles[2], double& aspectRatio);
+
 protected:
   /**
    * struct to hold device specfic settings.
@@ -288,11 +679,8 @@ protected:
   /**
    * Graphics resources.
    */
-  vtkOpenGLFramebufferObject* RenderFramebuffer;
   vtkOpenGLFramebufferObject* QuiltFramebuffer;
   vtkTextureObject* QuiltTexture;
-  vtkOpenGLQuadHelper* FinalBlend;
-  vtkOpenGLQuadHelper* QuiltBlend;
 
   // with multiple LookingGlass which one to use. Defaults to the first.
   int DeviceIndex;
@@ -322,17 +710,106 @@ protected:
   // Are we recording a movie
   bool IsRecording;
 
+  // Number of quilts rendered by RenderQuilt()
+  vtkTypeUInt64 QuiltRenderCount;
+
+  // the renderers and their base cameras while RenderQuilt() renders tiles
+  vtkRendererCollection* QuiltRenderers;
+  const std::vector<vtkCamera*>* QuiltCameras;
+
   // The aspect ratio to use when adjusting the camera to render the tiles.
   // This is modifiable so that we can generate quilts for devices that have
   // a different aspect ratio than the device currently connected.
   double AdjustCameraAspectRatio;
 
+  // see the respective Set methods for descriptions
+  int QuiltFormat;
+  int AllocatedQuiltFormat;
+  bool TrimQuiltToTiles;
+  bool ReleaseTransientTargets;
+  bool ShareQuilt;
+  int RenderDepthBits;
+  bool CollectStatistics;
+  vtkLookingGlassFrameStatistics* Statistics;
+
+  // complete the statistics frame in progress, if any, and fire its event
+  void EndStatisticsFrame();
+
+  // The resources shared with the other interfaces rendering into the same
+  // window: the render graph running the passes of RenderQuilt() and of the
+  // saved quilts with the pool of their render targets, the shared quilts,
+  // and the quads drawing the quilts. The pool is acquired on first use and
+  // given back by ReleaseGraphicsResources().
+  vtkLookingGlassResourcePool* ResourcePool;
+  vtkLookingGlassResourcePool* GetResourcePool(vtkOpenGLRenderWindow* rw);
+  void ReleaseResourcePool(vtkWindow* w);
+
+  // whether the quilt texture and framebuffer are the ones of the pool
+  bool UsingSharedQuilt;
+  void ReleaseSharedQuilt(vtkWindow* w);
+
+  // allocate the storage of the quilt texture and attach it to the quilt
+  // framebuffer
+  void AllocateQuilt(
+    vtkOpenGLRenderWindow* rw, vtkTextureObject* texture, vtkOpenGLFramebufferObject* framebuffer);
+
   // For recording a movie
-  vtkImageData* MovieImageBuffer;
   vtkImageData* MovieImageData;
   vtkGenericMovieWriter* MovieWriter;
+  vtkLookingGlassQuiltSequenceWriter* SequenceWriter;
+
+  // For publishing quilts to other processes
+  vtkLookingGlassSharedQuiltPublisher* QuiltPublisher;
+
+  // For streaming quilts to and from other hosts
+  vtkLookingGlassQuiltServer* QuiltServer;
+  vtkLookingGlassQuiltClient* QuiltClient;
+
+  // For playing a movie, the decoded frames go through a ring of pixel
+  // buffers so that uploading a frame does not wait for the previous one
+  vtkLookingGlassQuiltPlayer* MoviePlayer;
+  static const int NumberOfPlaybackBuffers = 3;
+  vtkPixelBufferObject* PlaybackBuffers[NumberOfPlaybackBuffers];
+  int PlaybackBufferIndex;
+
+  // viewPortion is the part of the texture covered by the tiles, it is
+  // computed from the current settings when it is nullptr
+  void DrawLightFieldInternal(
+    vtkOpenGLRenderWindow* renWin, vtkTextureObject* tex, const float* viewPortion = nullptr);
+
+  // encode the quilt already read into MovieImageData
+  void EncodeQuiltMovieFrame();
+
+  // see SetTileSizeCallback()
+  std::function<void(int, int)> TileSizeCallback;
+
+  // Get, and create if needed, the framebuffer the tiles are rendered to.
+  // GetFramebuffers() uses it along with the quilt framebuffer.
+  vtkOpenGLFramebufferObject* GetRenderFramebuffer(vtkOpenGLRenderWindow* rw);
+
+  /**
+   * Helpers used to render tiles. SaveTileCameras() stores the active camera
+   * of each renderer and replaces it with a temporary one,
+   * SetupTileCameras() adjusts the temporary cameras for a tile, and
+   * RestoreTileCameras() puts the original cameras back.
+   */
+  void SaveTileCameras(vtkOpenGLRenderWindow* rw, vtkRendererCollection* renderers,
+    std::vector<vtkCamera*>& cameras);
+  void SetupTileCameras(
+    vtkRendererCollection* renderers, const std::vector<vtkCamera*>& cameras, int tile);
+  void SetupViewCameras(vtkRendererCollection* renderers, const std::vector<vtkCamera*>& cameras,
+    double viewFraction, double aspectRatio);
+
+  /**
+   * Adjust a camera for the view at `viewFraction` of the view cone, 0 being
+   * the leftmost view and 1 the rightmost, using the given aspect ratio.
+   * AdjustCamera() calls this with the fraction of its tile.
+   */
+  void AdjustCameraForView(vtkCamera* cam, double viewFraction, double aspectRatio);
 
-  void DrawLightFieldInternal(vtkOpenGLRenderWindow* renWin, vtkTextureObject* tex);
+  // Restrict the clipping range of a view camera when UseClippingLimits is on
+  void ApplyClippingLimits(vtkCamera* cam);
+  void RestoreTileCameras(vtkRendererCollection* renderers, std::vector<vtkCamera*>& cameras);
 
 private:
   vtkLookingGlassInterface(const vtkLookingGlassInterface&) = delete;
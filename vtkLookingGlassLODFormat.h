@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Layout of the level of detail (".lglod") files shared by
+ * vtkLookingGlassLODWriter and vtkLookingGlassLODMapper.
+ *
+ * All values are little endian. The file is made of
+ *
+ *  - a header of HeaderSize bytes, with the fields at the offsets below
+ *  - the node payloads, each starting at a multiple of PayloadAlignment so
+ *    that it can be used in place once the file is mapped:
+ *    float32[3] per point, then uint8[4] RGBA per point if the file has
+ *    colors, then int32[3] point indices per triangle if it has triangles
+ *  - the node table, one NodeEntrySize entry per node, with the fields at
+ *    the NodeOffsets below
+ *
+ * The nodes form an octree whose root is node 0. The children of a node
+ * are contiguous in the table. A node holds a simplified version of all
+ * the geometry below it, whose error, the size of the largest feature it
+ * removed, is stored with it, and the leaves hold the input geometry with
+ * an error of 0. Rendering a node replaces rendering its parent.
+ */
+
+#ifndef vtkLookingGlassLODFormat_h
+#define vtkLookingGlassLODFormat_h
+
+#include "vtkType.h"
+
+#include <cstring>
+
+namespace vtkLookingGlassLODFormat
+{
+const char Magic[8] = { 'L', 'G', 'L', 'O', 'D', '\0', '\0', '\0' };
+const vtkTypeUInt32 Version = 1;
+const vtkTypeUInt32 HeaderSize = 128;
+const vtkTypeUInt32 NodeEntrySize = 80;
+const vtkTypeUInt32 PayloadAlignment = 16;
+
+// field offsets in the header
+enum Offsets
+{
+  MagicOffset = 0,             // char[8]
+  VersionOffset = 8,           // uint32
+  HeaderSizeOffset = 12,       // uint32
+  NumberOfNodesOffset = 16,    // uint32
+  FlagsOffset = 20,            // uint32
+  BoundsOffset = 24,           // double[6]
+  NodesOffsetOffset = 72,      // uint64
+  NumberOfPointsOffset = 80,   // uint64, of the input
+  NumberOfTrianglesOffset = 88 // uint64, of the input
+};
+
+// what the payloads hold besides the points
+enum Flags
+{
+  ColorsFlag = 1,
+  TrianglesFlag = 2
+};
+
+// field offsets in a node entry
+enum NodeOffsets
+{
+  NodeBoundsOffset = 0,             // double[6]
+  NodeErrorOffset = 48,             // double
+  NodePayloadOffset = 56,           // uint64
+  NodeNumberOfPointsOffset = 64,    // uint32
+  NodeNumberOfTrianglesOffset = 68, // uint32
+  NodeFirstChildOffset = 72,        // uint32
+  NodeNumberOfChildrenOffset = 76   // uint32
+};
+
+template <typename T>
+void Put(unsigned char* buffer, vtkTypeUInt32 offset, const T& value)
+{
+  std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T Get(const unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  T value;
+  std::memcpy(&value, buffer + offset, sizeof(T));
+  return value;
+}
+
+// size in bytes of the payload of a node
+inline vtkTypeUInt64 PayloadSize(
+  vtkTypeUInt32 flags, vtkTypeUInt32 points, vtkTypeUInt32 triangles)
+{
+  vtkTypeUInt64 size = static_cast<vtkTypeUInt64>(points) * 12;
+  if (flags & ColorsFlag)
+  {
+    size += static_cast<vtkTypeUInt64>(points) * 4;
+  }
+  if (flags & TrianglesFlag)
+  {
+    size += static_cast<vtkTypeUInt64>(triangles) * 12;
+  }
+  return size;
+}
+}
+
+#endif
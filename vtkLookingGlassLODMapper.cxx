@@ -0,0 +1,659 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassLODMapper.h"
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassLODFormat.h"
+#include "vtkLookingGlassSharedMemory.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <queue>
+
+namespace format = vtkLookingGlassLODFormat;
+
+namespace
+{
+// The left, right, bottom and top planes of a view in the coordinates of
+// the actor, as a, b, c, d with the inside where a x + b y + c z + d >= 0.
+// The near and far planes are left out, the clipping range of the views is
+// only adjusted once the nodes are selected.
+using Frustum = std::array<double, 16>;
+
+void AddFrustum(const double viewProjection[16], const double model[16],
+  std::vector<Frustum>& frustums)
+{
+  double m[16];
+  vtkMatrix4x4::Multiply4x4(viewProjection, model, m);
+  Frustum frustum;
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    const int row = plane / 2;
+    const double sign = plane % 2 ? -1.0 : 1.0;
+    for (int c = 0; c < 4; ++c)
+    {
+      frustum[plane * 4 + c] = m[12 + c] + sign * m[row * 4 + c];
+    }
+  }
+  frustums.push_back(frustum);
+}
+
+// whether a box is at least partly inside one of the frustums
+bool IsVisible(const double bounds[6], const std::vector<Frustum>& frustums)
+{
+  for (const Frustum& frustum : frustums)
+  {
+    bool inside = true;
+    for (int plane = 0; plane < 4 && inside; ++plane)
+    {
+      // the corner of the box the furthest inside the plane
+      const double* p = &frustum[plane * 4];
+      const double distance = p[0] * bounds[p[0] > 0.0 ? 1 : 0] +
+        p[1] * bounds[p[1] > 0.0 ? 3 : 2] + p[2] * bounds[p[2] > 0.0 ? 5 : 4] + p[3];
+      inside = distance >= 0.0;
+    }
+    if (inside)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// the distance from a point to a box, 0 inside
+double Distance(const double point[3], const double bounds[6])
+{
+  double squared = 0.0;
+  for (int c = 0; c < 3; ++c)
+  {
+    const double below = bounds[c * 2] - point[c];
+    const double above = point[c] - bounds[c * 2 + 1];
+    const double d = std::max(std::max(below, above), 0.0);
+    squared += d * d;
+  }
+  return std::sqrt(squared);
+}
+}
+
+vtkStandardNewMacro(vtkLookingGlassLODMapper);
+vtkCxxSetObjectMacro(vtkLookingGlassLODMapper, Interface, vtkLookingGlassInterface);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassLODMapper::vtkLookingGlassLODMapper()
+  : FileName(nullptr)
+  , Interface(nullptr)
+  , PixelError(1.0)
+  , NodeBudget(256)
+  , MaximumResidentNodes(1024)
+  , SynchronousLoading(false)
+  , NumberOfRenderedNodes(0)
+  , NumberOfRenderedPrimitives(0)
+  , NumberOfSelections(0)
+  , NumberOfResidentNodes(0)
+  , File(new vtkLookingGlassSharedMemory)
+  , OpenFailed(false)
+  , Flags(0)
+  , UseCount(0)
+  , SelectedQuilt(0)
+  , QuiltSelected(false)
+  , Running(false)
+  , Loading(0)
+{
+  this->SetNumberOfInputPorts(0);
+  vtkMath::UninitializeBounds(this->FileBounds);
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassLODMapper::~vtkLookingGlassLODMapper()
+{
+  this->Close();
+  delete this->File;
+  this->SetInterface(nullptr);
+  this->SetFileName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "Interface: " << this->Interface << "\n";
+  os << indent << "PixelError: " << this->PixelError << "\n";
+  os << indent << "NodeBudget: " << this->NodeBudget << "\n";
+  os << indent << "MaximumResidentNodes: " << this->MaximumResidentNodes << "\n";
+  os << indent << "SynchronousLoading: " << this->SynchronousLoading << "\n";
+  os << indent << "NumberOfRenderedNodes: " << this->NumberOfRenderedNodes << "\n";
+  os << indent << "NumberOfRenderedPrimitives: " << this->NumberOfRenderedPrimitives << "\n";
+  os << indent << "NumberOfSelections: " << this->NumberOfSelections << "\n";
+  os << indent << "NumberOfResidentNodes: " << this->NumberOfResidentNodes << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassLODMapper::Open()
+{
+  if (!this->FileName)
+  {
+    this->Close();
+    this->OpenFileName.clear();
+    this->OpenFailed = false;
+    return false;
+  }
+  if (this->OpenFileName == this->FileName)
+  {
+    return !this->OpenFailed;
+  }
+
+  // errors are reported once per file name
+  this->Close();
+  this->OpenFileName = this->FileName;
+  this->OpenFailed = true;
+  if (!this->File->MapFile(this->FileName))
+  {
+    vtkErrorMacro("Unable to map " << this->FileName << ": "
+                                   << vtkLookingGlassSharedMemory::GetLastError());
+    return false;
+  }
+
+  const unsigned char* data = this->File->GetData();
+  const vtkTypeUInt64 size = this->File->GetSize();
+  if (size < format::HeaderSize ||
+    std::memcmp(data + format::MagicOffset, format::Magic, sizeof(format::Magic)) != 0 ||
+    format::Get<vtkTypeUInt32>(data, format::VersionOffset) != format::Version)
+  {
+    vtkErrorMacro(<< this->FileName << " is not a level of detail file");
+    this->Close();
+    return false;
+  }
+
+  const vtkTypeUInt32 numberOfNodes = format::Get<vtkTypeUInt32>(data, format::NumberOfNodesOffset);
+  const vtkTypeUInt64 nodesOffset = format::Get<vtkTypeUInt64>(data, format::NodesOffsetOffset);
+  this->Flags = format::Get<vtkTypeUInt32>(data, format::FlagsOffset);
+  bool valid = numberOfNodes > 0 && nodesOffset <= size &&
+    (size - nodesOffset) / format::NodeEntrySize >= numberOfNodes;
+  this->Nodes.resize(valid ? numberOfNodes : 0);
+  for (vtkTypeUInt32 i = 0; i < this->Nodes.size() && valid; ++i)
+  {
+    const unsigned char* entry = data + nodesOffset + i * format::NodeEntrySize;
+    Node& node = this->Nodes[i];
+    std::memcpy(node.Bounds, entry + format::NodeBoundsOffset, sizeof(node.Bounds));
+    node.Error = format::Get<double>(entry, format::NodeErrorOffset);
+    node.PayloadOffset = format::Get<vtkTypeUInt64>(entry, format::NodePayloadOffset);
+    node.NumberOfPoints = format::Get<vtkTypeUInt32>(entry, format::NodeNumberOfPointsOffset);
+    node.NumberOfTriangles =
+      format::Get<vtkTypeUInt32>(entry, format::NodeNumberOfTrianglesOffset);
+    node.FirstChild = format::Get<vtkTypeUInt32>(entry, format::NodeFirstChildOffset);
+    node.NumberOfChildren = format::Get<vtkTypeUInt32>(entry, format::NodeNumberOfChildrenOffset);
+    node.State = UNLOADED;
+    node.LastUsed = 0;
+
+    // the payloads are used in place, they must be in the file and aligned
+    const vtkTypeUInt64 payloadSize =
+      format::PayloadSize(this->Flags, node.NumberOfPoints, node.NumberOfTriangles);
+    valid = node.PayloadOffset % 4 == 0 && node.PayloadOffset <= size &&
+      size - node.PayloadOffset >= payloadSize &&
+      (node.NumberOfChildren == 0 ||
+        (node.FirstChild > i &&
+          static_cast<vtkTypeUInt64>(node.FirstChild) + node.NumberOfChildren <= numberOfNodes));
+  }
+  if (!valid)
+  {
+    vtkErrorMacro(<< this->FileName << " is truncated or corrupted");
+    this->Close();
+    return false;
+  }
+  std::memcpy(this->FileBounds, data + format::BoundsOffset, sizeof(this->FileBounds));
+
+  this->Running = true;
+  this->Thread = std::thread(&vtkLookingGlassLODMapper::Run, this);
+  this->OpenFailed = false;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::Close()
+{
+  if (this->Thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->Running = false;
+    }
+    this->Wakeup.notify_all();
+    this->Thread.join();
+  }
+
+  // the loaded nodes use the mapped file, drop them first
+  this->Requests.clear();
+  this->Loaded.clear();
+  this->Loading = 0;
+  this->Nodes.clear();
+  this->SelectedNodes.clear();
+  this->NumberOfResidentNodes = 0;
+  this->NumberOfRenderedNodes = 0;
+  this->NumberOfRenderedPrimitives = 0;
+  this->QuiltSelected = false;
+  vtkMath::UninitializeBounds(this->FileBounds);
+  this->File->Close();
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassLODMapper::GetNumberOfNodes()
+{
+  return this->Open() ? static_cast<int>(this->Nodes.size()) : 0;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassLODMapper::GetNumberOfPendingNodes()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return static_cast<int>(this->Requests.size() + this->Loaded.size()) + this->Loading;
+}
+
+//------------------------------------------------------------------------------
+double* vtkLookingGlassLODMapper::GetBounds()
+{
+  if (this->Open())
+  {
+    std::copy(this->FileBounds, this->FileBounds + 6, this->Bounds);
+  }
+  else
+  {
+    vtkMath::UninitializeBounds(this->Bounds);
+  }
+  return this->Bounds;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::Run()
+{
+  for (;;)
+  {
+    vtkTypeUInt32 index;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Wakeup.wait(lock, [this] { return !this->Running || !this->Requests.empty(); });
+      if (!this->Running)
+      {
+        return;
+      }
+      index = this->Requests.front();
+      this->Requests.pop_front();
+      ++this->Loading;
+    }
+
+    vtkSmartPointer<vtkPolyData> polyData = this->LoadNode(index);
+
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->Loaded.emplace_back(index, polyData);
+      --this->Loading;
+    }
+    this->Done.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> vtkLookingGlassLODMapper::LoadNode(vtkTypeUInt32 index)
+{
+  const Node& node = this->Nodes[index];
+  unsigned char* payload = this->File->GetData() + node.PayloadOffset;
+  const vtkIdType numberOfPoints = node.NumberOfPoints;
+  const vtkIdType numberOfTriangles = node.NumberOfTriangles;
+
+  // read every page of the node here, so that the render thread does not
+  // wait for the disk when the node is uploaded
+  const vtkTypeUInt64 size =
+    format::PayloadSize(this->Flags, node.NumberOfPoints, node.NumberOfTriangles);
+  unsigned char sum = 0;
+  for (vtkTypeUInt64 i = 0; i < size; i += 4096)
+  {
+    sum ^= payload[i];
+  }
+  volatile unsigned char touched = sum;
+  (void)touched;
+
+  // the arrays use the mapped file in place and never write to it
+  auto polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkFloatArray> coordinates;
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetArray(reinterpret_cast<float*>(payload), numberOfPoints * 3, 1);
+  vtkNew<vtkPoints> points;
+  points->SetData(coordinates);
+  polyData->SetPoints(points);
+  payload += numberOfPoints * 12;
+
+  if (this->Flags & format::ColorsFlag)
+  {
+    vtkNew<vtkUnsignedCharArray> colors;
+    colors->SetName("Colors");
+    colors->SetNumberOfComponents(4);
+    colors->SetArray(payload, numberOfPoints * 4, 1);
+    polyData->GetPointData()->SetScalars(colors);
+    payload += numberOfPoints * 4;
+  }
+
+  vtkNew<vtkTypeInt32Array> connectivity;
+  vtkNew<vtkCellArray> cells;
+  if (this->Flags & format::TrianglesFlag)
+  {
+    connectivity->SetArray(reinterpret_cast<vtkTypeInt32*>(payload), numberOfTriangles * 3, 1);
+    cells->SetData(3, connectivity);
+    polyData->SetPolys(cells);
+  }
+  else
+  {
+    connectivity->SetNumberOfValues(numberOfPoints);
+    std::iota(connectivity->GetPointer(0), connectivity->GetPointer(0) + numberOfPoints, 0);
+    cells->SetData(1, connectivity);
+    polyData->SetVerts(cells);
+  }
+  return polyData;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::CollectLoadedNodes()
+{
+  std::vector<std::pair<vtkTypeUInt32, vtkSmartPointer<vtkPolyData>>> loaded;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    loaded.swap(this->Loaded);
+  }
+  for (auto& item : loaded)
+  {
+    Node& node = this->Nodes[item.first];
+    node.Mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    node.Mapper->SetInputData(item.second);
+    node.Mapper->SetColorModeToDirectScalars();
+    node.Mapper->StaticOn();
+    node.State = RESIDENT;
+    ++this->NumberOfResidentNodes;
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::ReleaseUnusedNodes(vtkWindow* window)
+{
+  if (this->NumberOfResidentNodes <= this->MaximumResidentNodes)
+  {
+    return;
+  }
+
+  // the nodes used by the last selection are kept even above the limit
+  std::vector<std::pair<vtkTypeUInt64, vtkTypeUInt32>> unused;
+  for (vtkTypeUInt32 i = 0; i < this->Nodes.size(); ++i)
+  {
+    if (this->Nodes[i].State == RESIDENT && this->Nodes[i].LastUsed < this->UseCount)
+    {
+      unused.emplace_back(this->Nodes[i].LastUsed, i);
+    }
+  }
+  std::sort(unused.begin(), unused.end());
+  for (size_t i = 0;
+       i < unused.size() && this->NumberOfResidentNodes > this->MaximumResidentNodes; ++i)
+  {
+    Node& node = this->Nodes[unused[i].second];
+    node.Mapper->ReleaseGraphicsResources(window);
+    node.Mapper = nullptr;
+    node.State = UNLOADED;
+    --this->NumberOfResidentNodes;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassLODMapper::SelectNodes(
+  vtkRenderer* ren, vtkActor* act, vtkCamera* camera, bool quilt)
+{
+  // the frustums of the views in the coordinates of the actor, and the
+  // height in pixels of the views
+  vtkMatrix4x4* model = act->GetMatrix();
+  std::vector<Frustum> frustums;
+  double height;
+  if (quilt)
+  {
+    vtkNew<vtkDoubleArray> matrices;
+    this->Interface->GetViewMatrices(camera, matrices);
+    for (vtkIdType view = 0; view < matrices->GetNumberOfTuples(); ++view)
+    {
+      const double* matrix = matrices->GetPointer(view * 32);
+      double viewProjection[16];
+      vtkMatrix4x4::Multiply4x4(matrix + 16, matrix, viewProjection);
+      AddFrustum(viewProjection, model->GetData(), frustums);
+    }
+    int renderSize[2];
+    this->Interface->GetRenderSize(renderSize);
+    height = renderSize[1];
+  }
+  else
+  {
+    vtkMatrix4x4* viewProjection =
+      camera->GetCompositeProjectionTransformMatrix(ren->GetTiledAspectRatio(), -1, 1);
+    AddFrustum(viewProjection->GetData(), model->GetData(), frustums);
+    height = ren->GetSize()[1];
+  }
+
+  // the error of a node in pixels, from the base camera for the quilts
+  vtkNew<vtkMatrix4x4> inverse;
+  vtkMatrix4x4::Invert(model, inverse);
+  double position[4];
+  camera->GetPosition(position);
+  position[3] = 1.0;
+  double eye[4];
+  inverse->MultiplyPoint(position, eye);
+  for (int c = 0; c < 3; ++c)
+  {
+    eye[c] /= eye[3];
+  }
+  const bool parallel = camera->GetParallelProjection() != 0;
+  const double pixelsPerUnit = parallel
+    ? height / (2.0 * camera->GetParallelScale()) * std::cbrt(std::fabs(model->Determinant()))
+    : height / (2.0 * std::tan(vtkMath::RadiansFromDegrees(camera->GetViewAngle()) / 2.0));
+  auto screenError = [&](const Node& node) {
+    if (node.Error == 0.0 || parallel)
+    {
+      return node.Error * pixelsPerUnit;
+    }
+    const double distance = Distance(eye, node.Bounds);
+    return distance > 0.0 ? node.Error * pixelsPerUnit / distance : VTK_DOUBLE_MAX;
+  };
+
+  // Refine the node with the largest error first, until the errors are
+  // small enough or the budget is spent. A node is only replaced once all
+  // of its visible children are loaded, the missing ones are requested.
+  const vtkTypeUInt64 stamp = this->UseCount;
+  this->SelectedNodes.clear();
+  std::vector<std::pair<double, vtkTypeUInt32>> wanted;
+  bool missing = false;
+  Node& root = this->Nodes[0];
+  root.LastUsed = stamp;
+  if (IsVisible(root.Bounds, frustums))
+  {
+    if (root.State != RESIDENT)
+    {
+      missing = true;
+      wanted.emplace_back(VTK_DOUBLE_MAX, 0);
+    }
+    else
+    {
+      std::priority_queue<std::pair<double, vtkTypeUInt32>> open;
+      open.emplace(screenError(root), 0);
+      std::vector<vtkTypeUInt32> children;
+      while (!open.empty())
+      {
+        const std::pair<double, vtkTypeUInt32> top = open.top();
+        open.pop();
+        const Node& node = this->Nodes[top.second];
+        if (node.NumberOfChildren == 0 || top.first <= this->PixelError)
+        {
+          this->SelectedNodes.push_back(top.second);
+          continue;
+        }
+
+        children.clear();
+        bool loaded = true;
+        for (vtkTypeUInt32 i = node.FirstChild; i < node.FirstChild + node.NumberOfChildren; ++i)
+        {
+          Node& child = this->Nodes[i];
+          if (IsVisible(child.Bounds, frustums))
+          {
+            children.push_back(i);
+            child.LastUsed = stamp;
+            loaded = loaded && child.State == RESIDENT;
+          }
+        }
+        if (this->SelectedNodes.size() + open.size() + children.size() >
+          static_cast<size_t>(this->NodeBudget))
+        {
+          this->SelectedNodes.push_back(top.second);
+          continue;
+        }
+        if (!loaded)
+        {
+          missing = true;
+          for (vtkTypeUInt32 i : children)
+          {
+            if (this->Nodes[i].State == UNLOADED)
+            {
+              wanted.emplace_back(top.first, i);
+            }
+          }
+          this->SelectedNodes.push_back(top.second);
+          continue;
+        }
+        for (vtkTypeUInt32 i : children)
+        {
+          open.emplace(screenError(this->Nodes[i]), i);
+        }
+      }
+    }
+  }
+
+  // the requests of the previous selection that were not started are
+  // replaced, the nodes covering the most pixels are loaded first
+  std::stable_sort(wanted.begin(), wanted.end(),
+    [](const std::pair<double, vtkTypeUInt32>& a, const std::pair<double, vtkTypeUInt32>& b) {
+      return a.first > b.first;
+    });
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    for (vtkTypeUInt32 i : this->Requests)
+    {
+      this->Nodes[i].State = UNLOADED;
+    }
+    this->Requests.clear();
+    for (const auto& item : wanted)
+    {
+      this->Nodes[item.second].State = REQUESTED;
+      this->Requests.push_back(item.second);
+    }
+  }
+  if (!wanted.empty())
+  {
+    this->Wakeup.notify_one();
+  }
+
+  this->NumberOfRenderedNodes = static_cast<int>(this->SelectedNodes.size());
+  this->NumberOfRenderedPrimitives = 0;
+  for (vtkTypeUInt32 i : this->SelectedNodes)
+  {
+    const Node& node = this->Nodes[i];
+    this->NumberOfRenderedPrimitives +=
+      (this->Flags & format::TrianglesFlag) ? node.NumberOfTriangles : node.NumberOfPoints;
+  }
+  return missing;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::UpdateNodes(
+  vtkRenderer* ren, vtkActor* act, vtkCamera* camera, bool quilt)
+{
+  ++this->UseCount;
+  ++this->NumberOfSelections;
+  while (this->SelectNodes(ren, act, camera, quilt) && this->SynchronousLoading)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Done.wait(lock, [this] { return this->Requests.empty() && this->Loading == 0; });
+    }
+    this->CollectLoadedNodes();
+  }
+  this->ReleaseUnusedNodes(ren->GetRenderWindow());
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::Render(vtkRenderer* ren, vtkActor* act)
+{
+  if (!this->Open())
+  {
+    return;
+  }
+  this->CollectLoadedNodes();
+
+  // within a quilt the nodes are selected by its first tile, for all views
+  vtkCamera* quiltCamera = this->Interface ? this->Interface->GetQuiltCamera(ren) : nullptr;
+  if (!quiltCamera)
+  {
+    this->QuiltSelected = false;
+    this->UpdateNodes(ren, act, ren->GetActiveCamera(), false);
+  }
+  else if (!this->QuiltSelected ||
+    this->SelectedQuilt != this->Interface->GetQuiltRenderCount())
+  {
+    this->UpdateNodes(ren, act, quiltCamera, true);
+    this->QuiltSelected = true;
+    this->SelectedQuilt = this->Interface->GetQuiltRenderCount();
+  }
+
+  const bool colors = this->ScalarVisibility && (this->Flags & format::ColorsFlag);
+  for (vtkTypeUInt32 i : this->SelectedNodes)
+  {
+    vtkPolyDataMapper* mapper = this->Nodes[i].Mapper;
+    if (mapper)
+    {
+      mapper->SetClippingPlanes(this->ClippingPlanes);
+      mapper->SetScalarVisibility(colors);
+      mapper->Render(ren, act);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODMapper::ReleaseGraphicsResources(vtkWindow* window)
+{
+  for (Node& node : this->Nodes)
+  {
+    if (node.Mapper)
+    {
+      node.Mapper->ReleaseGraphicsResources(window);
+    }
+  }
+}
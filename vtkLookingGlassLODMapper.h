@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassLODMapper
+ * @brief   Render a level of detail file larger than memory in quilts.
+ *
+ * Renders the ".lglod" files written by vtkLookingGlassLODWriter. The file
+ * is mapped in memory, and only the nodes needed for the current view are
+ * read: starting from the root, the node whose error covers the most pixels
+ * is replaced by its children until every node is below PixelError pixels,
+ * or until drawing more nodes would exceed the NodeBudget, which holds the
+ * frame time.
+ *
+ * When the interface of the Looking Glass window or pass is set, the nodes
+ * are selected once per quilt rather than once per tile: a node is kept if
+ * it is in any of the views of GetViewMatrices(), and its error is measured
+ * in tiles of the RenderSize. Every tile then draws the same nodes, which
+ * are uploaded to the GPU once. Outside of RenderQuilt(), as when saving
+ * streamed quilts or rendering views, the nodes are selected for each
+ * render from the active camera.
+ *
+ * Nodes are read on a background thread, the render draws their parent in
+ * the meantime. The nodes that were not used for the longest time are
+ * released once more than MaximumResidentNodes are loaded.
+ *
+ * Unsigned char RGBA colors of the file are drawn when ScalarVisibility is
+ * on, the other settings of the mapper do not apply.
+ *
+ * @sa
+ * vtkLookingGlassLODWriter vtkLookingGlassInterface
+ */
+
+#ifndef vtkLookingGlassLODMapper_h
+#define vtkLookingGlassLODMapper_h
+
+#include "vtkMapper.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkSmartPointer.h"                // For vtkSmartPointer
+
+#include <condition_variable> // For std::condition_variable
+#include <deque>              // For std::deque
+#include <mutex>              // For std::mutex
+#include <string>             // For std::string
+#include <thread>             // For std::thread
+#include <utility>            // For std::pair
+#include <vector>             // For std::vector
+
+class vtkCamera;
+class vtkLookingGlassInterface;
+class vtkLookingGlassSharedMemory;
+class vtkPolyData;
+class vtkPolyDataMapper;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassLODMapper : public vtkMapper
+{
+public:
+  static vtkLookingGlassLODMapper* New();
+  vtkTypeMacro(vtkLookingGlassLODMapper, vtkMapper);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the name of the file to render.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the interface rendering the quilts, to select the nodes once
+   * per quilt for all of its views.
+   */
+  void SetInterface(vtkLookingGlassInterface* lgInterface);
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the error in pixels below which a node is not refined. Default
+   * is 1.
+   */
+  vtkSetClampMacro(PixelError, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(PixelError, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the largest number of nodes drawn per frame. Default is 256.
+   */
+  vtkSetClampMacro(NodeBudget, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NodeBudget, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of loaded nodes above which the least recently used
+   * ones are released. Default is 1024.
+   */
+  vtkSetClampMacro(MaximumResidentNodes, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumResidentNodes, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get whether a render waits for the nodes it needs instead of
+   * drawing their parents, for offline rendering. Default is off.
+   */
+  vtkSetMacro(SynchronousLoading, bool);
+  vtkGetMacro(SynchronousLoading, bool);
+  vtkBooleanMacro(SynchronousLoading, bool);
+  //@}
+
+  /**
+   * Get the number of nodes of the file, or 0 if it cannot be read.
+   */
+  int GetNumberOfNodes();
+
+  //@{
+  /**
+   * Get the number of nodes, and of points or triangles, drawn by the last
+   * render, and how many times the nodes were selected so far.
+   */
+  vtkGetMacro(NumberOfRenderedNodes, int);
+  vtkGetMacro(NumberOfRenderedPrimitives, vtkIdType);
+  vtkGetMacro(NumberOfSelections, vtkTypeUInt64);
+  //@}
+
+  //@{
+  /**
+   * Get the number of nodes loaded, and waiting to be loaded.
+   */
+  vtkGetMacro(NumberOfResidentNodes, int);
+  int GetNumberOfPendingNodes();
+  //@}
+
+  void Render(vtkRenderer* ren, vtkActor* act) override;
+  void ReleaseGraphicsResources(vtkWindow* window) override;
+  bool GetIsOpaque() override { return true; }
+
+  //@{
+  /**
+   * The bounds of the whole file.
+   */
+  double* GetBounds() override;
+  using Superclass::GetBounds;
+  //@}
+
+protected:
+  vtkLookingGlassLODMapper();
+  ~vtkLookingGlassLODMapper() override;
+
+  // map the file and start the loading thread if the file name changed
+  bool Open();
+  void Close();
+
+  // select the nodes to draw, returns true if nodes were requested
+  bool SelectNodes(vtkRenderer* ren, vtkActor* act, vtkCamera* camera, bool quilt);
+  void UpdateNodes(vtkRenderer* ren, vtkActor* act, vtkCamera* camera, bool quilt);
+
+  // take the nodes read by the thread, and release the ones not used
+  void CollectLoadedNodes();
+  void ReleaseUnusedNodes(vtkWindow* window);
+
+  // the body of the loading thread
+  void Run();
+  vtkSmartPointer<vtkPolyData> LoadNode(vtkTypeUInt32 index);
+
+  char* FileName;
+  vtkLookingGlassInterface* Interface;
+  double PixelError;
+  int NodeBudget;
+  int MaximumResidentNodes;
+  bool SynchronousLoading;
+
+  int NumberOfRenderedNodes;
+  vtkIdType NumberOfRenderedPrimitives;
+  vtkTypeUInt64 NumberOfSelections;
+  int NumberOfResidentNodes;
+
+  enum NodeStates
+  {
+    UNLOADED,
+    REQUESTED,
+    RESIDENT
+  };
+
+  struct Node
+  {
+    double Bounds[6];
+    double Error;
+    vtkTypeUInt64 PayloadOffset;
+    vtkTypeUInt32 NumberOfPoints;
+    vtkTypeUInt32 NumberOfTriangles;
+    vtkTypeUInt32 FirstChild;
+    vtkTypeUInt32 NumberOfChildren;
+    // only used by the render thread
+    int State;
+    vtkTypeUInt64 LastUsed;
+    vtkSmartPointer<vtkPolyDataMapper> Mapper;
+  };
+
+  vtkLookingGlassSharedMemory* File;
+  std::string OpenFileName;
+  bool OpenFailed;
+  vtkTypeUInt32 Flags;
+  double FileBounds[6];
+  std::vector<Node> Nodes;
+  std::vector<vtkTypeUInt32> SelectedNodes;
+  vtkTypeUInt64 UseCount;
+  vtkTypeUInt64 SelectedQuilt;
+  bool QuiltSelected;
+
+  // shared with the loading thread
+  std::thread Thread;
+  std::mutex Mutex;
+  std::condition_variable Wakeup;
+  std::condition_variable Done;
+  bool Running;
+  std::deque<vtkTypeUInt32> Requests;
+  int Loading;
+  std::vector<std::pair<vtkTypeUInt32, vtkSmartPointer<vtkPolyData>>> Loaded;
+
+private:
+  vtkLookingGlassLODMapper(const vtkLookingGlassLODMapper&) = delete;
+  void operator=(const vtkLookingGlassLODMapper&) = delete;
+};
+
+#endif
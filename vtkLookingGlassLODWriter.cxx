@@ -0,0 +1,531 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassLODWriter.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
+#include "vtkLookingGlassLODFormat.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTriangleFilter.h"
+#include "vtkUnsignedCharArray.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace format = vtkLookingGlassLODFormat;
+
+namespace
+{
+// the input, with the points as floats and the colors as RGBA
+struct Geometry
+{
+  std::vector<float> Points;
+  std::vector<unsigned char> Colors;
+  std::vector<vtkIdType> Triangles;
+  bool HasTriangles = false;
+};
+
+// a node waiting to be built, with the input points, or triangles, below it
+struct PendingNode
+{
+  vtkTypeUInt32 Index;
+  int Depth;
+  double Cube[6];
+  std::vector<vtkIdType> Ids;
+};
+
+struct NodeEntry
+{
+  double Bounds[6];
+  double Error;
+  vtkTypeUInt64 PayloadOffset;
+  vtkTypeUInt32 NumberOfPoints;
+  vtkTypeUInt32 NumberOfTriangles;
+  vtkTypeUInt32 FirstChild;
+  vtkTypeUInt32 NumberOfChildren;
+};
+
+// the geometry of a node as written to the file
+struct Payload
+{
+  std::vector<float> Points;
+  std::vector<unsigned char> Colors;
+  std::vector<vtkTypeInt32> Triangles;
+};
+
+// the input points used by the ids of a node, each once
+void GetVertices(const Geometry& geometry, const std::vector<vtkIdType>& ids,
+  std::vector<vtkIdType>& vertices)
+{
+  if (!geometry.HasTriangles)
+  {
+    vertices = ids;
+    return;
+  }
+  vertices.clear();
+  for (vtkIdType triangle : ids)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      vertices.push_back(geometry.Triangles[triangle * 3 + k]);
+    }
+  }
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+}
+
+// the geometry of a leaf, the input itself
+void MakeLeaf(const Geometry& geometry, const std::vector<vtkIdType>& ids, Payload& payload)
+{
+  std::vector<vtkIdType> vertices;
+  GetVertices(geometry, ids, vertices);
+  std::unordered_map<vtkIdType, vtkTypeInt32> local;
+  for (vtkIdType vertex : vertices)
+  {
+    local.emplace(vertex, static_cast<vtkTypeInt32>(local.size()));
+    payload.Points.insert(payload.Points.end(), &geometry.Points[vertex * 3],
+      &geometry.Points[vertex * 3] + 3);
+    if (!geometry.Colors.empty())
+    {
+      payload.Colors.insert(payload.Colors.end(), &geometry.Colors[vertex * 4],
+        &geometry.Colors[vertex * 4] + 4);
+    }
+  }
+  if (geometry.HasTriangles)
+  {
+    for (vtkIdType triangle : ids)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        payload.Triangles.push_back(local[geometry.Triangles[triangle * 3 + k]]);
+      }
+    }
+  }
+}
+
+// The geometry of an inner node: the points that fall in the same cell of
+// a grid over the node are merged into their average, and the triangles
+// left with less than 3 distinct points are dropped. The grid is made
+// coarser until the node is small enough. Returns the diagonal of the
+// cells, the largest feature that may have been removed.
+double Simplify(const Geometry& geometry, const std::vector<vtkIdType>& ids, const double cube[6],
+  int maximumPrimitives, Payload& payload)
+{
+  std::vector<vtkIdType> vertices;
+  GetVertices(geometry, ids, vertices);
+
+  const double size = std::max(cube[1] - cube[0], 1e-30);
+  // a surface has about twice as many triangles as points
+  const double points = geometry.HasTriangles ? maximumPrimitives / 2.0 : maximumPrimitives;
+  int grid = static_cast<int>(std::sqrt(points));
+  grid = std::max(grid, 2);
+  std::vector<vtkTypeInt32> clusterOfVertex(vertices.size());
+  for (;;)
+  {
+    const double cellSize = size / grid;
+    std::unordered_map<vtkTypeUInt64, vtkTypeInt32> clusters;
+    std::vector<double> sums;
+    std::vector<double> colorSums;
+    std::vector<int> counts;
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+      const float* p = &geometry.Points[vertices[i] * 3];
+      vtkTypeUInt64 key = 0;
+      for (int c = 2; c >= 0; --c)
+      {
+        int cell = static_cast<int>((p[c] - cube[c * 2]) / cellSize);
+        key = key * grid + std::min(std::max(cell, 0), grid - 1);
+      }
+      auto inserted = clusters.emplace(key, static_cast<vtkTypeInt32>(counts.size()));
+      if (inserted.second)
+      {
+        sums.resize(sums.size() + 3, 0.0);
+        colorSums.resize(colorSums.size() + 4, 0.0);
+        counts.push_back(0);
+      }
+      const vtkTypeInt32 cluster = inserted.first->second;
+      clusterOfVertex[i] = cluster;
+      ++counts[cluster];
+      for (int c = 0; c < 3; ++c)
+      {
+        sums[cluster * 3 + c] += p[c];
+      }
+      if (!geometry.Colors.empty())
+      {
+        for (int c = 0; c < 4; ++c)
+        {
+          colorSums[cluster * 4 + c] += geometry.Colors[vertices[i] * 4 + c];
+        }
+      }
+    }
+
+    payload.Triangles.clear();
+    if (geometry.HasTriangles)
+    {
+      std::set<std::array<vtkTypeInt32, 3>> kept;
+      for (vtkIdType triangle : ids)
+      {
+        std::array<vtkTypeInt32, 3> corners;
+        for (int k = 0; k < 3; ++k)
+        {
+          const vtkIdType vertex = geometry.Triangles[triangle * 3 + k];
+          const size_t i =
+            std::lower_bound(vertices.begin(), vertices.end(), vertex) - vertices.begin();
+          corners[k] = clusterOfVertex[i];
+        }
+        if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2])
+        {
+          continue;
+        }
+        // keep one of the triangles merged into the same corners
+        std::array<vtkTypeInt32, 3> sorted = corners;
+        std::sort(sorted.begin(), sorted.end());
+        if (kept.insert(sorted).second)
+        {
+          payload.Triangles.insert(payload.Triangles.end(), corners.begin(), corners.end());
+        }
+      }
+    }
+
+    const size_t primitives =
+      geometry.HasTriangles ? payload.Triangles.size() / 3 : counts.size();
+    if (primitives <= static_cast<size_t>(maximumPrimitives) || grid <= 2)
+    {
+      payload.Points.resize(counts.size() * 3);
+      payload.Colors.resize(geometry.Colors.empty() ? 0 : counts.size() * 4);
+      for (size_t cluster = 0; cluster < counts.size(); ++cluster)
+      {
+        for (int c = 0; c < 3; ++c)
+        {
+          payload.Points[cluster * 3 + c] =
+            static_cast<float>(sums[cluster * 3 + c] / counts[cluster]);
+        }
+        for (size_t c = 0; c < 4 && !payload.Colors.empty(); ++c)
+        {
+          payload.Colors[cluster * 4 + c] =
+            static_cast<unsigned char>(colorSums[cluster * 4 + c] / counts[cluster] + 0.5);
+        }
+      }
+      return cellSize * std::sqrt(3.0);
+    }
+    grid = std::max(2, grid * 3 / 4);
+  }
+}
+
+// the bounds of the input points or triangles of a node
+void ComputeBounds(const Geometry& geometry, const std::vector<vtkIdType>& ids, double bounds[6])
+{
+  std::vector<vtkIdType> vertices;
+  GetVertices(geometry, ids, vertices);
+  for (int c = 0; c < 3; ++c)
+  {
+    bounds[c * 2] = VTK_DOUBLE_MAX;
+    bounds[c * 2 + 1] = VTK_DOUBLE_MIN;
+  }
+  for (vtkIdType vertex : vertices)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      const double value = geometry.Points[vertex * 3 + c];
+      bounds[c * 2] = std::min(bounds[c * 2], value);
+      bounds[c * 2 + 1] = std::max(bounds[c * 2 + 1], value);
+    }
+  }
+}
+
+// the center of a point or a triangle
+void GetCenter(const Geometry& geometry, vtkIdType id, double center[3])
+{
+  if (!geometry.HasTriangles)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      center[c] = geometry.Points[id * 3 + c];
+    }
+    return;
+  }
+  for (int c = 0; c < 3; ++c)
+  {
+    center[c] = 0.0;
+    for (int k = 0; k < 3; ++k)
+    {
+      center[c] += geometry.Points[geometry.Triangles[id * 3 + k] * 3 + c] / 3.0;
+    }
+  }
+}
+}
+
+vtkStandardNewMacro(vtkLookingGlassLODWriter);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassLODWriter::vtkLookingGlassLODWriter()
+  : FileName(nullptr)
+  , MaximumPrimitivesPerNode(32768)
+  , MaximumDepth(16)
+  , NumberOfNodes(0)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassLODWriter::~vtkLookingGlassLODWriter()
+{
+  this->SetFileName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassLODWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "MaximumPrimitivesPerNode: " << this->MaximumPrimitivesPerNode << "\n";
+  os << indent << "MaximumDepth: " << this->MaximumDepth << "\n";
+  os << indent << "NumberOfNodes: " << this->NumberOfNodes << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassLODWriter::Write(vtkPolyData* input)
+{
+  this->NumberOfNodes = 0;
+  if (!this->FileName)
+  {
+    vtkErrorMacro("No file name set");
+    return false;
+  }
+  if (!input || input->GetNumberOfPoints() == 0)
+  {
+    vtkErrorMacro("The input has no points");
+    return false;
+  }
+
+  // surfaces are made of triangles only, the triangle filter keeps the
+  // points as they are
+  vtkSmartPointer<vtkPolyData> source = input;
+  Geometry geometry;
+  if (input->GetNumberOfPolys() > 0 || input->GetNumberOfStrips() > 0)
+  {
+    vtkNew<vtkTriangleFilter> triangulate;
+    triangulate->PassVertsOff();
+    triangulate->PassLinesOff();
+    triangulate->SetInputData(input);
+    triangulate->Update();
+    source = triangulate->GetOutput();
+    geometry.HasTriangles = true;
+
+    auto cells = vtk::TakeSmartPointer(source->GetPolys()->NewIterator());
+    for (cells->GoToFirstCell(); !cells->IsDoneWithTraversal(); cells->GoToNextCell())
+    {
+      vtkIdType npts;
+      const vtkIdType* pts;
+      cells->GetCurrentCell(npts, pts);
+      if (npts == 3)
+      {
+        geometry.Triangles.insert(geometry.Triangles.end(), pts, pts + 3);
+      }
+    }
+  }
+
+  const vtkIdType numberOfPoints = source->GetNumberOfPoints();
+  geometry.Points.resize(numberOfPoints * 3);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+  {
+    double p[3];
+    source->GetPoint(i, p);
+    for (int c = 0; c < 3; ++c)
+    {
+      geometry.Points[i * 3 + c] = static_cast<float>(p[c]);
+    }
+  }
+  vtkUnsignedCharArray* scalars =
+    vtkArrayDownCast<vtkUnsignedCharArray>(source->GetPointData()->GetScalars());
+  if (scalars && (scalars->GetNumberOfComponents() == 3 || scalars->GetNumberOfComponents() == 4))
+  {
+    const int components = scalars->GetNumberOfComponents();
+    geometry.Colors.resize(numberOfPoints * 4, 255);
+    for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+      for (int c = 0; c < components; ++c)
+      {
+        geometry.Colors[i * 4 + c] = scalars->GetValue(i * components + c);
+      }
+    }
+  }
+
+  vtkTypeUInt32 flags = 0;
+  flags |= geometry.Colors.empty() ? 0 : format::ColorsFlag;
+  flags |= geometry.HasTriangles ? format::TrianglesFlag : 0;
+
+  FILE* file = vtksys::SystemTools::Fopen(this->FileName, "wb");
+  if (!file)
+  {
+    vtkErrorMacro("Unable to open " << this->FileName << " for writing");
+    return false;
+  }
+  vtkTypeUInt64 offset = 0;
+  bool ok = true;
+  auto write = [&](const void* data, size_t size) {
+    ok = ok && (size == 0 || fwrite(data, 1, size, file) == size);
+    offset += size;
+  };
+  auto align = [&]() {
+    const unsigned char zeros[format::PayloadAlignment] = {};
+    write(zeros, (format::PayloadAlignment - offset % format::PayloadAlignment) %
+        format::PayloadAlignment);
+  };
+
+  unsigned char header[format::HeaderSize] = {};
+  write(header, sizeof(header));
+
+  // the octree is built breadth first, so that the children of a node get
+  // contiguous entries, with cubic nodes around the input
+  double bounds[6];
+  input->GetBounds(bounds);
+  double half = 0.0;
+  for (int c = 0; c < 3; ++c)
+  {
+    half = std::max(half, (bounds[c * 2 + 1] - bounds[c * 2]) / 2.0);
+  }
+  half = half > 0.0 ? half * 1.0001 : 0.5;
+  PendingNode root;
+  root.Index = 0;
+  root.Depth = 0;
+  for (int c = 0; c < 3; ++c)
+  {
+    const double center = (bounds[c * 2] + bounds[c * 2 + 1]) / 2.0;
+    root.Cube[c * 2] = center - half;
+    root.Cube[c * 2 + 1] = center + half;
+  }
+  root.Ids.resize(geometry.HasTriangles ? geometry.Triangles.size() / 3 : numberOfPoints);
+  std::iota(root.Ids.begin(), root.Ids.end(), 0);
+
+  std::vector<NodeEntry> entries(1);
+  std::deque<PendingNode> queue;
+  queue.push_back(std::move(root));
+  while (!queue.empty() && ok)
+  {
+    PendingNode node = std::move(queue.front());
+    queue.pop_front();
+
+    Payload payload;
+    NodeEntry entry = {};
+    const bool leaf = node.Ids.size() <= static_cast<size_t>(this->MaximumPrimitivesPerNode) ||
+      node.Depth >= this->MaximumDepth;
+    if (leaf)
+    {
+      MakeLeaf(geometry, node.Ids, payload);
+    }
+    else
+    {
+      entry.Error =
+        Simplify(geometry, node.Ids, node.Cube, this->MaximumPrimitivesPerNode, payload);
+    }
+    ComputeBounds(geometry, node.Ids, entry.Bounds);
+
+    align();
+    entry.PayloadOffset = offset;
+    entry.NumberOfPoints = static_cast<vtkTypeUInt32>(payload.Points.size() / 3);
+    entry.NumberOfTriangles = static_cast<vtkTypeUInt32>(payload.Triangles.size() / 3);
+    write(payload.Points.data(), payload.Points.size() * sizeof(float));
+    write(payload.Colors.data(), payload.Colors.size());
+    write(payload.Triangles.data(), payload.Triangles.size() * sizeof(vtkTypeInt32));
+
+    if (!leaf)
+    {
+      // the points, or the triangles by their center, go to their octant
+      std::vector<vtkIdType> octants[8];
+      for (vtkIdType id : node.Ids)
+      {
+        double center[3];
+        GetCenter(geometry, id, center);
+        int octant = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+          octant |= center[c] >= (node.Cube[c * 2] + node.Cube[c * 2 + 1]) / 2.0 ? 1 << c : 0;
+        }
+        octants[octant].push_back(id);
+      }
+      node.Ids = std::vector<vtkIdType>();
+
+      entry.FirstChild = static_cast<vtkTypeUInt32>(entries.size());
+      for (int octant = 0; octant < 8; ++octant)
+      {
+        if (octants[octant].empty())
+        {
+          continue;
+        }
+        PendingNode child;
+        child.Index = static_cast<vtkTypeUInt32>(entries.size());
+        child.Depth = node.Depth + 1;
+        for (int c = 0; c < 3; ++c)
+        {
+          const double middle = (node.Cube[c * 2] + node.Cube[c * 2 + 1]) / 2.0;
+          const bool upper = (octant >> c) & 1;
+          child.Cube[c * 2] = upper ? middle : node.Cube[c * 2];
+          child.Cube[c * 2 + 1] = upper ? node.Cube[c * 2 + 1] : middle;
+        }
+        child.Ids.swap(octants[octant]);
+        entries.emplace_back();
+        queue.push_back(std::move(child));
+        ++entry.NumberOfChildren;
+      }
+    }
+    entries[node.Index] = entry;
+  }
+
+  align();
+  const vtkTypeUInt64 nodesOffset = offset;
+  for (const NodeEntry& entry : entries)
+  {
+    unsigned char buffer[format::NodeEntrySize] = {};
+    std::memcpy(buffer + format::NodeBoundsOffset, entry.Bounds, sizeof(entry.Bounds));
+    format::Put(buffer, format::NodeErrorOffset, entry.Error);
+    format::Put(buffer, format::NodePayloadOffset, entry.PayloadOffset);
+    format::Put(buffer, format::NodeNumberOfPointsOffset, entry.NumberOfPoints);
+    format::Put(buffer, format::NodeNumberOfTrianglesOffset, entry.NumberOfTriangles);
+    format::Put(buffer, format::NodeFirstChildOffset, entry.FirstChild);
+    format::Put(buffer, format::NodeNumberOfChildrenOffset, entry.NumberOfChildren);
+    write(buffer, sizeof(buffer));
+  }
+
+  std::memcpy(header + format::MagicOffset, format::Magic, sizeof(format::Magic));
+  format::Put(header, format::VersionOffset, format::Version);
+  format::Put(header, format::HeaderSizeOffset, format::HeaderSize);
+  format::Put(header, format::NumberOfNodesOffset, static_cast<vtkTypeUInt32>(entries.size()));
+  format::Put(header, format::FlagsOffset, flags);
+  std::memcpy(header + format::BoundsOffset, bounds, sizeof(bounds));
+  format::Put(header, format::NodesOffsetOffset, nodesOffset);
+  format::Put(header, format::NumberOfPointsOffset, static_cast<vtkTypeUInt64>(numberOfPoints));
+  format::Put(header, format::NumberOfTrianglesOffset,
+    static_cast<vtkTypeUInt64>(geometry.Triangles.size() / 3));
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 &&
+    fwrite(header, 1, sizeof(header), file) == sizeof(header);
+  ok = fclose(file) == 0 && ok;
+  if (!ok)
+  {
+    vtkErrorMacro("Unable to write " << this->FileName);
+    return false;
+  }
+
+  this->NumberOfNodes = static_cast<int>(entries.size());
+  return true;
+}
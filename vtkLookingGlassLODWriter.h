@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassLODWriter
+ * @brief   Build the level of detail file rendered by vtkLookingGlassLODMapper.
+ *
+ * Splits a point cloud or a surface into an octree of nodes of at most
+ * MaximumPrimitivesPerNode points, or triangles for surfaces, and writes it
+ * to a ".lglod" file. Each inner node stores a simplified version of the
+ * geometry below it, made by merging the points that fall in the same cell
+ * of a grid fine enough to stay within the node size, so that a coarse
+ * view of the whole dataset is a few nodes away from the root.
+ *
+ * Surfaces are triangulated first and triangles go to the node holding
+ * their center. Unsigned char RGB or RGBA point scalars are kept as colors,
+ * and averaged by the simplification.
+ *
+ * The input must fit in memory while the file is built, the file itself is
+ * then rendered without loading it as a whole.
+ *
+ * @sa
+ * vtkLookingGlassLODMapper
+ */
+
+#ifndef vtkLookingGlassLODWriter_h
+#define vtkLookingGlassLODWriter_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+class vtkPolyData;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassLODWriter : public vtkObject
+{
+public:
+  static vtkLookingGlassLODWriter* New();
+  vtkTypeMacro(vtkLookingGlassLODWriter, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the name of the file to write.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the largest number of points, or triangles for surfaces, of a
+   * node. Nodes are the unit of loading and culling, and a few hundred of
+   * them are typically drawn per frame. Default is 32768.
+   */
+  vtkSetClampMacro(MaximumPrimitivesPerNode, int, 64, VTK_INT_MAX);
+  vtkGetMacro(MaximumPrimitivesPerNode, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the depth below which nodes are not split anymore, whatever
+   * their size. Default is 16.
+   */
+  vtkSetClampMacro(MaximumDepth, int, 0, 32);
+  vtkGetMacro(MaximumDepth, int);
+  //@}
+
+  /**
+   * Build the octree of the input and write it. Returns false if the input
+   * is empty or the file cannot be written.
+   */
+  bool Write(vtkPolyData* input);
+
+  /**
+   * Get the number of nodes of the last file written.
+   */
+  vtkGetMacro(NumberOfNodes, int);
+
+protected:
+  vtkLookingGlassLODWriter();
+  ~vtkLookingGlassLODWriter() override;
+
+  char* FileName;
+  int MaximumPrimitivesPerNode;
+  int MaximumDepth;
+  int NumberOfNodes;
+
+private:
+  vtkLookingGlassLODWriter(const vtkLookingGlassLODWriter&) = delete;
+  void operator=(const vtkLookingGlassLODWriter&) = delete;
+};
+
+#endif
@@ -32,6 +32,9 @@ vtkLookingGlassPass::vtkLookingGlassPass()
 {
   this->Interface = vtkLookingGlassInterface::New();
   this->Interface->Initialize();
+  // each quilt is drawn as soon as it is rendered, so the passes of the
+  // renderers of a window can render into the same quilt
+  this->Interface->ShareQuiltOn();
 }
 
 //------------------------------------------------------------------------------
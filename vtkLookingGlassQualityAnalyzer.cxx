@@ -0,0 +1,402 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQualityAnalyzer.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassQuiltResampler.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkSMPTools.h"
+#include "vtkWindowToImageFilter.h"
+
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+vtkStandardNewMacro(vtkLookingGlassQualityAnalyzer);
+vtkCxxSetObjectMacro(vtkLookingGlassQualityAnalyzer, RenderWindow, vtkRenderWindow);
+vtkCxxSetObjectMacro(vtkLookingGlassQualityAnalyzer, Interface, vtkLookingGlassInterface);
+
+const double vtkLookingGlassQualityAnalyzer::MaximumPSNR = 100.0;
+
+namespace
+{
+double ComputePSNR(const unsigned char* a, const unsigned char* b, vtkIdType count)
+{
+  double sum = 0.0;
+  for (vtkIdType i = 0; i < count; ++i)
+  {
+    const double d = static_cast<double>(a[i]) - b[i];
+    sum += d * d;
+  }
+  if (sum == 0.0 || count == 0)
+  {
+    return vtkLookingGlassQualityAnalyzer::MaximumPSNR;
+  }
+  return std::min(
+    10.0 * std::log10(255.0 * 255.0 * count / sum), vtkLookingGlassQualityAnalyzer::MaximumPSNR);
+}
+
+// the mean SSIM of the luma of two RGB images over 8x8 windows, 4 pixels
+// apart, with the constants of Wang et al.
+double ComputeSSIM(const unsigned char* a, const unsigned char* b, int width, int height)
+{
+  std::vector<float> la(static_cast<size_t>(width) * height);
+  std::vector<float> lb(la.size());
+  for (size_t i = 0; i < la.size(); ++i)
+  {
+    la[i] = 0.299f * a[3 * i] + 0.587f * a[3 * i + 1] + 0.114f * a[3 * i + 2];
+    lb[i] = 0.299f * b[3 * i] + 0.587f * b[3 * i + 1] + 0.114f * b[3 * i + 2];
+  }
+
+  const double c1 = (0.01 * 255.0) * (0.01 * 255.0);
+  const double c2 = (0.03 * 255.0) * (0.03 * 255.0);
+  const int window[2] = { std::min(8, width), std::min(8, height) };
+  double total = 0.0;
+  int count = 0;
+  for (int y = 0; y + window[1] <= height; y += 4)
+  {
+    for (int x = 0; x + window[0] <= width; x += 4)
+    {
+      double sa = 0.0, sb = 0.0, saa = 0.0, sbb = 0.0, sab = 0.0;
+      for (int j = y; j < y + window[1]; ++j)
+      {
+        for (int i = x; i < x + window[0]; ++i)
+        {
+          const double va = la[static_cast<size_t>(j) * width + i];
+          const double vb = lb[static_cast<size_t>(j) * width + i];
+          sa += va;
+          sb += vb;
+          saa += va * va;
+          sbb += vb * vb;
+          sab += va * vb;
+        }
+      }
+      const double n = window[0] * window[1];
+      const double ma = sa / n;
+      const double mb = sb / n;
+      const double va = saa / n - ma * ma;
+      const double vb = sbb / n - mb * mb;
+      const double cov = sab / n - ma * mb;
+      total += ((2.0 * ma * mb + c1) * (2.0 * cov + c2)) /
+        ((ma * ma + mb * mb + c1) * (va + vb + c2));
+      ++count;
+    }
+  }
+  return count ? total / count : 1.0;
+}
+
+// moves the tiles between the quilt layout and the stacked layout of
+// ReadQuiltTiles(), tile 0 at the bottom left or bottom
+void CopyTiles(vtkImageData* input, vtkImageData* output, const int tiles[2], const int size[2],
+  bool toQuilt)
+{
+  const int count = tiles[0] * tiles[1];
+  const int quiltWidth = tiles[0] * size[0];
+  if (toQuilt)
+  {
+    output->SetDimensions(quiltWidth, tiles[1] * size[1], 1);
+  }
+  else
+  {
+    output->SetDimensions(size[0], size[1] * count, 1);
+  }
+  output->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+
+  const auto in = static_cast<const unsigned char*>(input->GetScalarPointer());
+  auto out = static_cast<unsigned char*>(output->GetScalarPointer());
+  const size_t rowBytes = static_cast<size_t>(size[0]) * 3;
+  for (int tile = 0; tile < count; ++tile)
+  {
+    const int x = (tile % tiles[0]) * size[0];
+    const int y = (tile / tiles[0]) * size[1];
+    for (int row = 0; row < size[1]; ++row)
+    {
+      const size_t quilt = (static_cast<size_t>(y + row) * quiltWidth + x) * 3;
+      const size_t stacked = (static_cast<size_t>(tile) * size[1] + row) * rowBytes;
+      if (toQuilt)
+      {
+        std::memcpy(out + quilt, in + stacked, rowBytes);
+      }
+      else
+      {
+        std::memcpy(out + stacked, in + quilt, rowBytes);
+      }
+    }
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQualityAnalyzer::vtkLookingGlassQualityAnalyzer()
+  : RenderWindow(nullptr)
+  , Interface(nullptr)
+  , NumberOfFrames(5)
+  , TilePSNR(vtkDoubleArray::New())
+  , TileSSIM(vtkDoubleArray::New())
+  , MeanPSNR(0.0)
+  , MinimumPSNR(0.0)
+  , MeanSSIM(0.0)
+  , MinimumSSIM(0.0)
+  , InterlacedPSNR(0.0)
+  , InterlacedSSIM(0.0)
+  , InterlacedMaximumDifference(0)
+  , InterlacedDifference(vtkImageData::New())
+  , ReferenceFrameTime(0.0)
+  , CandidateFrameTime(0.0)
+  , Reference{ vtkImageData::New(), vtkImageData::New(), { 0, 0 }, { 0, 0 }, false }
+  , Candidate{ vtkImageData::New(), vtkImageData::New(), { 0, 0 }, { 0, 0 }, false }
+{
+  this->TilePSNR->SetName("PSNR");
+  this->TileSSIM->SetName("SSIM");
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQualityAnalyzer::~vtkLookingGlassQualityAnalyzer()
+{
+  this->SetRenderWindow(nullptr);
+  this->SetInterface(nullptr);
+  this->TilePSNR->Delete();
+  this->TileSSIM->Delete();
+  this->InterlacedDifference->Delete();
+  for (Capture* capture : { &this->Reference, &this->Candidate })
+  {
+    capture->Tiles->Delete();
+    capture->Interlaced->Delete();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQualityAnalyzer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Interface: " << this->Interface << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+  os << indent << "MeanPSNR: " << this->MeanPSNR << "\n";
+  os << indent << "MinimumPSNR: " << this->MinimumPSNR << "\n";
+  os << indent << "MeanSSIM: " << this->MeanSSIM << "\n";
+  os << indent << "MinimumSSIM: " << this->MinimumSSIM << "\n";
+  os << indent << "InterlacedPSNR: " << this->InterlacedPSNR << "\n";
+  os << indent << "InterlacedSSIM: " << this->InterlacedSSIM << "\n";
+  os << indent << "InterlacedMaximumDifference: " << this->InterlacedMaximumDifference << "\n";
+  os << indent << "ReferenceFrameTime: " << this->ReferenceFrameTime << "\n";
+  os << indent << "CandidateFrameTime: " << this->CandidateFrameTime << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQualityAnalyzer::CaptureReference()
+{
+  this->Candidate.Valid = false;
+  return this->Render(this->Reference, this->ReferenceFrameTime);
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQualityAnalyzer::CaptureCandidate()
+{
+  if (!this->Reference.Valid)
+  {
+    vtkErrorMacro("The reference must be captured first");
+    return false;
+  }
+  if (!this->Render(this->Candidate, this->CandidateFrameTime))
+  {
+    return false;
+  }
+  this->Compare();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassQualityAnalyzer::GetSpeedup() const
+{
+  return this->CandidateFrameTime > 0.0 ? this->ReferenceFrameTime / this->CandidateFrameTime
+                                        : 0.0;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQualityAnalyzer::Render(Capture& capture, double& frameTime)
+{
+  capture.Valid = false;
+  if (!this->RenderWindow || !this->Interface)
+  {
+    vtkErrorMacro("A render window and an interface are required");
+    return false;
+  }
+
+  // the first frame compiles shaders and allocates the framebuffers
+  double total = 0.0;
+  for (int i = 0; i < this->NumberOfFrames; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    this->RenderWindow->Render();
+    this->RenderWindow->WaitForCompletion();
+    if (i > 0)
+    {
+      total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+  }
+  frameTime = total / (this->NumberOfFrames - 1);
+
+  vtkNew<vtkWindowToImageFilter> grabber;
+  grabber->SetInput(this->RenderWindow);
+  grabber->ShouldRerenderOff();
+  grabber->Update();
+  capture.Interlaced->DeepCopy(grabber->GetOutput());
+
+  this->RenderWindow->MakeCurrent();
+  this->Interface->ReadQuiltTiles(capture.Tiles);
+  this->Interface->GetQuiltTiles(capture.QuiltTiles);
+  this->Interface->GetRenderSize(capture.RenderSize);
+  capture.Valid = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQualityAnalyzer::Compare()
+{
+  const Capture& reference = this->Reference;
+  vtkImageData* candidateTiles = this->Candidate.Tiles;
+  vtkNew<vtkImageData> resampledTiles;
+  if (!std::equal(reference.QuiltTiles, reference.QuiltTiles + 2, this->Candidate.QuiltTiles) ||
+    !std::equal(reference.RenderSize, reference.RenderSize + 2, this->Candidate.RenderSize))
+  {
+    // bring the candidate to the layout of the reference
+    vtkNew<vtkImageData> quilt;
+    CopyTiles(
+      this->Candidate.Tiles, quilt, this->Candidate.QuiltTiles, this->Candidate.RenderSize, true);
+    vtkNew<vtkLookingGlassQuiltResampler> resampler;
+    resampler->SetInputData(quilt);
+    resampler->SetInputTiles(this->Candidate.QuiltTiles);
+    resampler->SetOutputTiles(reference.QuiltTiles);
+    resampler->SetOutputTileSize(reference.RenderSize);
+    resampler->Update();
+    CopyTiles(resampler->GetOutput(), resampledTiles, reference.QuiltTiles, reference.RenderSize,
+      false);
+    candidateTiles = resampledTiles;
+  }
+
+  const int count = reference.QuiltTiles[0] * reference.QuiltTiles[1];
+  const int width = reference.RenderSize[0];
+  const int height = reference.RenderSize[1];
+  const vtkIdType tileValues = static_cast<vtkIdType>(width) * height * 3;
+  const auto a = static_cast<const unsigned char*>(reference.Tiles->GetScalarPointer());
+  const auto b = static_cast<const unsigned char*>(candidateTiles->GetScalarPointer());
+  this->TilePSNR->SetNumberOfValues(count);
+  this->TileSSIM->SetNumberOfValues(count);
+  vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      const unsigned char* ta = a + tile * tileValues;
+      const unsigned char* tb = b + tile * tileValues;
+      this->TilePSNR->SetValue(tile, ComputePSNR(ta, tb, tileValues));
+      this->TileSSIM->SetValue(tile, ComputeSSIM(ta, tb, width, height));
+    }
+  });
+
+  this->MeanPSNR = this->MeanSSIM = 0.0;
+  this->MinimumPSNR = vtkLookingGlassQualityAnalyzer::MaximumPSNR;
+  this->MinimumSSIM = 1.0;
+  for (int tile = 0; tile < count; ++tile)
+  {
+    this->MeanPSNR += this->TilePSNR->GetValue(tile) / count;
+    this->MeanSSIM += this->TileSSIM->GetValue(tile) / count;
+    this->MinimumPSNR = std::min(this->MinimumPSNR, this->TilePSNR->GetValue(tile));
+    this->MinimumSSIM = std::min(this->MinimumSSIM, this->TileSSIM->GetValue(tile));
+  }
+
+  // the interlaced outputs
+  vtkImageData* ia = reference.Interlaced;
+  vtkImageData* ib = this->Candidate.Interlaced;
+  this->InterlacedPSNR = this->InterlacedSSIM = 0.0;
+  this->InterlacedMaximumDifference = 0;
+  this->InterlacedDifference->Initialize();
+  const int* dims = ia->GetDimensions();
+  if (!std::equal(dims, dims + 3, ib->GetDimensions()) ||
+    ia->GetNumberOfScalarComponents() != 3 || ib->GetNumberOfScalarComponents() != 3)
+  {
+    vtkWarningMacro("The interlaced outputs have different sizes and are not compared");
+    return;
+  }
+
+  const vtkIdType values = static_cast<vtkIdType>(dims[0]) * dims[1] * 3;
+  const auto pa = static_cast<const unsigned char*>(ia->GetScalarPointer());
+  const auto pb = static_cast<const unsigned char*>(ib->GetScalarPointer());
+  this->InterlacedPSNR = ComputePSNR(pa, pb, values);
+  this->InterlacedSSIM = ComputeSSIM(pa, pb, dims[0], dims[1]);
+  this->InterlacedDifference->SetDimensions(dims[0], dims[1], 1);
+  this->InterlacedDifference->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  auto diff = static_cast<unsigned char*>(this->InterlacedDifference->GetScalarPointer());
+  for (vtkIdType i = 0; i < values; ++i)
+  {
+    diff[i] = static_cast<unsigned char>(std::abs(static_cast<int>(pa[i]) - pb[i]));
+    this->InterlacedMaximumDifference = std::max<int>(this->InterlacedMaximumDifference, diff[i]);
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQualityAnalyzer::WriteResults(const char* fileName)
+{
+  if (!fileName || !this->Candidate.Valid)
+  {
+    vtkErrorMacro("A file name and a comparison are required");
+    return false;
+  }
+
+  Json::Value results;
+  for (const Capture* capture : { &this->Reference, &this->Candidate })
+  {
+    Json::Value& layout = results[capture == &this->Reference ? "reference" : "candidate"];
+    layout["quiltTiles"].append(capture->QuiltTiles[0]);
+    layout["quiltTiles"].append(capture->QuiltTiles[1]);
+    layout["renderSize"].append(capture->RenderSize[0]);
+    layout["renderSize"].append(capture->RenderSize[1]);
+    layout["frameMs"] = (capture == &this->Reference ? this->ReferenceFrameTime
+                                                     : this->CandidateFrameTime) *
+      1000.0;
+  }
+  results["speedup"] = this->GetSpeedup();
+  results["meanPSNR"] = this->MeanPSNR;
+  results["minimumPSNR"] = this->MinimumPSNR;
+  results["meanSSIM"] = this->MeanSSIM;
+  results["minimumSSIM"] = this->MinimumSSIM;
+  results["interlacedPSNR"] = this->InterlacedPSNR;
+  results["interlacedSSIM"] = this->InterlacedSSIM;
+  results["interlacedMaximumDifference"] = this->InterlacedMaximumDifference;
+  results["tiles"] = Json::arrayValue;
+  for (vtkIdType tile = 0; tile < this->TilePSNR->GetNumberOfValues(); ++tile)
+  {
+    Json::Value entry;
+    entry["psnr"] = this->TilePSNR->GetValue(tile);
+    entry["ssim"] = this->TileSSIM->GetValue(tile);
+    results["tiles"].append(entry);
+  }
+
+  vtksys::ofstream file(fileName);
+  if (!file)
+  {
+    vtkErrorMacro("Unable to create " << fileName);
+    return false;
+  }
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  file << Json::writeString(builder, results) << "\n";
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQualityAnalyzer
+ * @brief   Measure what a faster quilt setting costs in image quality.
+ *
+ * Captures the quilt, the interlaced output and the frame time of a render
+ * window twice: once with the reference settings and once with a candidate
+ * setting that trades quality for speed, such as fewer views, smaller
+ * tiles or coarser levels of detail. The scene and the camera must be the
+ * same for both captures, only the rendering settings or the interface
+ * should change in between.
+ *
+ * The candidate quilt is resampled to the tile layout of the reference
+ * with vtkLookingGlassQuiltResampler when they differ, then each tile is
+ * compared with its reference: the PSNR over the RGB values, capped at
+ * MaximumPSNR for identical tiles, and the SSIM of the luma over 8x8
+ * windows. The interlaced outputs, what the device shows, are compared the
+ * same way when the window size did not change, and their absolute
+ * difference is kept as an image.
+ *
+ * Each capture renders NumberOfFrames frames and times all but the first,
+ * up to the completion of the rendering on the GPU.
+ *
+ * @sa
+ * vtkLookingGlassQuiltResampler vtkLookingGlassFrameStatistics
+ */
+
+#ifndef vtkLookingGlassQualityAnalyzer_h
+#define vtkLookingGlassQualityAnalyzer_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+class vtkDoubleArray;
+class vtkImageData;
+class vtkLookingGlassInterface;
+class vtkRenderWindow;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQualityAnalyzer : public vtkObject
+{
+public:
+  static vtkLookingGlassQualityAnalyzer* New();
+  vtkTypeMacro(vtkLookingGlassQualityAnalyzer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * The PSNR reported for identical images, in dB.
+   */
+  static const double MaximumPSNR;
+
+  //@{
+  /**
+   * Set/Get the window to render, and the interface rendering its quilts:
+   * the one of a Looking Glass render window or of its vtkLookingGlassPass.
+   * The interface may be changed between the captures.
+   */
+  void SetRenderWindow(vtkRenderWindow* renderWindow);
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+  void SetInterface(vtkLookingGlassInterface* lgInterface);
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of frames rendered by each capture. The first one
+   * is not timed. Default is 5.
+   */
+  vtkSetClampMacro(NumberOfFrames, int, 2, VTK_INT_MAX);
+  vtkGetMacro(NumberOfFrames, int);
+  //@}
+
+  /**
+   * Render and capture the reference. Returns false if the window or the
+   * interface is missing.
+   */
+  bool CaptureReference();
+
+  /**
+   * Render and capture the candidate, then compare it with the reference.
+   * Returns false if the window or the interface is missing or if there is
+   * no reference.
+   */
+  bool CaptureCandidate();
+
+  //@{
+  /**
+   * Get the PSNR in dB and the SSIM of each tile of the reference layout,
+   * and their mean and minimum over the tiles.
+   */
+  vtkDoubleArray* GetTilePSNR() { return this->TilePSNR; }
+  vtkDoubleArray* GetTileSSIM() { return this->TileSSIM; }
+  vtkGetMacro(MeanPSNR, double);
+  vtkGetMacro(MinimumPSNR, double);
+  vtkGetMacro(MeanSSIM, double);
+  vtkGetMacro(MinimumSSIM, double);
+  //@}
+
+  //@{
+  /**
+   * Get the PSNR, the SSIM and the largest absolute difference of the
+   * interlaced outputs, and the absolute difference image. They are zero,
+   * and the image empty, if the outputs have different sizes.
+   */
+  vtkGetMacro(InterlacedPSNR, double);
+  vtkGetMacro(InterlacedSSIM, double);
+  vtkGetMacro(InterlacedMaximumDifference, int);
+  vtkImageData* GetInterlacedDifference() { return this->InterlacedDifference; }
+  //@}
+
+  //@{
+  /**
+   * Get the average frame times of the captures in seconds, and how many
+   * times faster the candidate renders.
+   */
+  vtkGetMacro(ReferenceFrameTime, double);
+  vtkGetMacro(CandidateFrameTime, double);
+  double GetSpeedup() const;
+  //@}
+
+  /**
+   * Write the results of the last comparison as JSON.
+   */
+  bool WriteResults(const char* fileName);
+
+protected:
+  vtkLookingGlassQualityAnalyzer();
+  ~vtkLookingGlassQualityAnalyzer() override;
+
+  vtkRenderWindow* RenderWindow;
+  vtkLookingGlassInterface* Interface;
+  int NumberOfFrames;
+
+  vtkDoubleArray* TilePSNR;
+  vtkDoubleArray* TileSSIM;
+  double MeanPSNR;
+  double MinimumPSNR;
+  double MeanSSIM;
+  double MinimumSSIM;
+  double InterlacedPSNR;
+  double InterlacedSSIM;
+  int InterlacedMaximumDifference;
+  vtkImageData* InterlacedDifference;
+  double ReferenceFrameTime;
+  double CandidateFrameTime;
+
+private:
+  vtkLookingGlassQualityAnalyzer(const vtkLookingGlassQualityAnalyzer&) = delete;
+  void operator=(const vtkLookingGlassQualityAnalyzer&) = delete;
+
+  // the tiles stacked on top of each other as by ReadQuiltTiles(), the
+  // interlaced output and the layout of one capture
+  struct Capture
+  {
+    vtkImageData* Tiles;
+    vtkImageData* Interlaced;
+    int QuiltTiles[2];
+    int RenderSize[2];
+    bool Valid;
+  };
+
+  bool Render(Capture& capture, double& frameTime);
+  void Compare();
+
+  Capture Reference;
+  Capture Candidate;
+};
+
+#endif
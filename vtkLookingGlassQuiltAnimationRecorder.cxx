@@ -0,0 +1,361 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltAnimationRecorder.h"
+
+#include "vtkCamera.h"
+#include "vtkCameraInterpolator.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassQuiltSequenceReader.h"
+#include "vtkLookingGlassQuiltSequenceWriter.h"
+#include "vtkLookingGlassTimeSeriesSource.h"
+#include "vtkLookingGlassTrace.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+#include "vtkSmartPointer.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+vtkStandardNewMacro(vtkLookingGlassQuiltAnimationRecorder);
+vtkCxxSetObjectMacro(vtkLookingGlassQuiltAnimationRecorder, RenderWindow, vtkRenderWindow);
+vtkCxxSetObjectMacro(vtkLookingGlassQuiltAnimationRecorder, Interface, vtkLookingGlassInterface);
+vtkCxxSetObjectMacro(vtkLookingGlassQuiltAnimationRecorder, CameraPath, vtkCameraInterpolator);
+vtkCxxSetObjectMacro(vtkLookingGlassQuiltAnimationRecorder, Camera, vtkCamera);
+vtkCxxSetObjectMacro(
+  vtkLookingGlassQuiltAnimationRecorder, TimeSeries, vtkLookingGlassTimeSeriesSource);
+
+namespace
+{
+// Hands the rendered quilts to the encoding thread. The quilts go around
+// between a free list and a queue of quilts to write, so rendering waits
+// when the encoder falls behind by more than the number of quilts.
+class QuiltQueue
+{
+public:
+  explicit QuiltQueue(int numberOfQuilts)
+  {
+    for (int i = 0; i < numberOfQuilts; ++i)
+    {
+      this->Free.push_back(vtkSmartPointer<vtkImageData>::New());
+    }
+  }
+
+  vtkSmartPointer<vtkImageData> TakeFree()
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->Condition.wait(lock, [this] { return !this->Free.empty(); });
+    auto quilt = this->Free.front();
+    this->Free.pop_front();
+    return quilt;
+  }
+
+  void Release(vtkSmartPointer<vtkImageData> quilt)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Free.push_back(quilt);
+    this->Condition.notify_all();
+  }
+
+  // a null quilt tells the encoder that there are no more
+  void Push(vtkSmartPointer<vtkImageData> quilt)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Ready.push_back(quilt);
+    vtkLookingGlassTraceCounter("Encoder queue", "quilts", this->Ready.size());
+    this->Condition.notify_all();
+  }
+
+  vtkSmartPointer<vtkImageData> Pop()
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->Condition.wait(lock, [this] { return !this->Ready.empty(); });
+    auto quilt = this->Ready.front();
+    this->Ready.pop_front();
+    vtkLookingGlassTraceCounter("Encoder queue", "quilts", this->Ready.size());
+    return quilt;
+  }
+
+private:
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::deque<vtkSmartPointer<vtkImageData>> Free;
+  std::deque<vtkSmartPointer<vtkImageData>> Ready;
+};
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltAnimationRecorder::vtkLookingGlassQuiltAnimationRecorder()
+  : RenderWindow(nullptr)
+  , Interface(nullptr)
+  , CameraPath(nullptr)
+  , Camera(nullptr)
+  , TimeSeries(nullptr)
+  , NumberOfFrames(60)
+  , FrameRate(30.0)
+  , FileName(nullptr)
+  , SegmentSize(30)
+  , WorkerIndex(0)
+  , NumberOfWorkers(1)
+  , RemoveSegments(true)
+  , NumberOfSegmentsRecorded(0)
+  , NumberOfSegmentsSkipped(0)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltAnimationRecorder::~vtkLookingGlassQuiltAnimationRecorder()
+{
+  this->SetRenderWindow(nullptr);
+  this->SetInterface(nullptr);
+  this->SetCameraPath(nullptr);
+  this->SetCamera(nullptr);
+  this->SetTimeSeries(nullptr);
+  this->SetFileName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltAnimationRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Interface: " << this->Interface << "\n";
+  os << indent << "CameraPath: " << this->CameraPath << "\n";
+  os << indent << "Camera: " << this->Camera << "\n";
+  os << indent << "TimeSeries: " << this->TimeSeries << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+  os << indent << "FrameRate: " << this->FrameRate << "\n";
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "SegmentSize: " << this->SegmentSize << "\n";
+  os << indent << "WorkerIndex: " << this->WorkerIndex << "\n";
+  os << indent << "NumberOfWorkers: " << this->NumberOfWorkers << "\n";
+  os << indent << "RemoveSegments: " << this->RemoveSegments << "\n";
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltAnimationRecorder::GetNumberOfSegments() const
+{
+  return (this->NumberOfFrames + this->SegmentSize - 1) / this->SegmentSize;
+}
+
+//------------------------------------------------------------------------------
+std::string vtkLookingGlassQuiltAnimationRecorder::GetSegmentFileName(int segment) const
+{
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".segment%05d", segment);
+  return std::string(this->FileName ? this->FileName : "") + suffix;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltAnimationRecorder::IsSegmentComplete(int segment) const
+{
+  const std::string fileName = this->GetSegmentFileName(segment);
+  if (!vtksys::SystemTools::FileExists(fileName, true))
+  {
+    return false;
+  }
+
+  const int first = segment * this->SegmentSize;
+  const int frames = std::min(this->SegmentSize, this->NumberOfFrames - first);
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->SetFileName(fileName.c_str());
+  return reader->Open() && reader->GetNumberOfFrames() == frames;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltAnimationRecorder::Record()
+{
+  this->NumberOfSegmentsRecorded = 0;
+  this->NumberOfSegmentsSkipped = 0;
+  if (!this->RenderWindow || !this->Interface || !this->FileName)
+  {
+    vtkErrorMacro("A render window, an interface and a file name are required");
+    return false;
+  }
+  if (!this->CameraPath || this->CameraPath->GetNumberOfCameras() < 1)
+  {
+    vtkErrorMacro("The camera path has no keyframes");
+    return false;
+  }
+
+  vtkCamera* camera = this->Camera;
+  if (!camera)
+  {
+    vtkRenderer* renderer = this->RenderWindow->GetRenderers()->GetFirstRenderer();
+    if (!renderer)
+    {
+      vtkErrorMacro("The render window has no renderer");
+      return false;
+    }
+    camera = renderer->GetActiveCamera();
+  }
+
+  const int numberOfSegments = this->GetNumberOfSegments();
+  for (int s = this->WorkerIndex; s < numberOfSegments; s += this->NumberOfWorkers)
+  {
+    if (this->IsSegmentComplete(s))
+    {
+      ++this->NumberOfSegmentsSkipped;
+      continue;
+    }
+    if (!this->RecordSegment(s, camera))
+    {
+      return false;
+    }
+    ++this->NumberOfSegmentsRecorded;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltAnimationRecorder::RecordSegment(int segment, vtkCamera* camera)
+{
+  const int first = segment * this->SegmentSize;
+  const int last = std::min(first + this->SegmentSize, this->NumberOfFrames);
+  if (this->TimeSeries)
+  {
+    // the first frames load while the writer starts
+    this->TimeSeries->Prefetch(first);
+    this->TimeSeries->SetFrame(first);
+  }
+
+  const std::string fileName = this->GetSegmentFileName(segment);
+  const std::string partialName = fileName + ".partial";
+  vtkNew<vtkLookingGlassQuiltSequenceWriter> writer;
+  writer->SetFileName(partialName.c_str());
+  writer->SetQuiltTiles(this->Interface->GetQuiltTiles());
+  writer->SetDeviceType(this->Interface->GetDeviceType());
+  writer->SetAspectRatio(this->Interface->GetAdjustCameraAspectRatio());
+  writer->SetViewAngle(this->Interface->GetViewAngle());
+  writer->SetFrameRate(this->FrameRate);
+  if (!writer->Start())
+  {
+    return false;
+  }
+
+  // the encoder writes a quilt while the next one is set up and rendered
+  QuiltQueue queue(2);
+  bool encoded = true;
+  std::thread encoder([&]() {
+    vtkLookingGlassTraceThreadName("Quilt encoder");
+    while (vtkSmartPointer<vtkImageData> quilt = queue.Pop())
+    {
+      vtkLookingGlassTraceScope("EncodeQuilt");
+      encoded = encoded && writer->Write(quilt);
+      queue.Release(quilt);
+    }
+  });
+
+  const double t0 = this->CameraPath->GetMinimumT();
+  const double t1 = this->CameraPath->GetMaximumT();
+  for (int frame = first; frame < last; ++frame)
+  {
+    const double t = this->NumberOfFrames > 1
+      ? t0 + (t1 - t0) * frame / static_cast<double>(this->NumberOfFrames - 1)
+      : t0;
+    this->CameraPath->InterpolateCamera(t, camera);
+    if (this->FrameCallback)
+    {
+      this->FrameCallback(frame);
+    }
+    this->RenderWindow->Render();
+
+    // Render() returns once the tiles are submitted. Moving to the next
+    // frame of the series here waits for its data, if it is still being
+    // loaded, while the GPU renders them, and the readback below waits for
+    // the GPU while the next frame is ready to upload.
+    if (this->TimeSeries && frame + 1 < last)
+    {
+      vtkLookingGlassTraceScope("NextTimeStep");
+      this->TimeSeries->SetFrame(frame + 1);
+      this->TimeSeries->Update();
+    }
+
+    vtkSmartPointer<vtkImageData> quilt = queue.TakeFree();
+    this->Interface->ReadQuilt(quilt);
+    queue.Push(quilt);
+  }
+  queue.Push(nullptr);
+  encoder.join();
+
+  // only a complete segment gets its final name, replacing any stale one
+  vtksys::SystemTools::RemoveFile(fileName);
+  if (!writer->End() || !encoded || !vtksys::SystemTools::RenameFile(partialName, fileName))
+  {
+    vtkErrorMacro("Unable to write segment " << fileName);
+    vtksys::SystemTools::RemoveFile(partialName);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltAnimationRecorder::ConcatenateSegments()
+{
+  if (!this->FileName)
+  {
+    vtkErrorMacro("No file name set");
+    return false;
+  }
+
+  const int numberOfSegments = this->GetNumberOfSegments();
+  for (int s = 0; s < numberOfSegments; ++s)
+  {
+    if (!this->IsSegmentComplete(s))
+    {
+      vtkErrorMacro("Segment " << this->GetSegmentFileName(s) << " is missing or incomplete");
+      return false;
+    }
+  }
+
+  // the settings come from the segments, the interface may not be set up
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->SetFileName(this->GetSegmentFileName(0).c_str());
+  if (!reader->Open())
+  {
+    return false;
+  }
+  vtkNew<vtkLookingGlassQuiltSequenceWriter> writer;
+  writer->SetFileName(this->FileName);
+  writer->SetQuiltTiles(reader->GetQuiltTiles());
+  writer->SetDeviceType(reader->GetDeviceType());
+  writer->SetAspectRatio(reader->GetAspectRatio());
+  writer->SetViewAngle(reader->GetViewAngle());
+  writer->SetFrameRate(reader->GetFrameRate());
+  reader->Close();
+
+  bool ok = writer->Start();
+  for (int s = 0; ok && s < numberOfSegments; ++s)
+  {
+    ok = writer->AppendSequence(this->GetSegmentFileName(s).c_str());
+  }
+  ok = writer->End() && ok;
+  if (!ok)
+  {
+    return false;
+  }
+
+  for (int s = 0; this->RemoveSegments && s < numberOfSegments; ++s)
+  {
+    vtksys::SystemTools::RemoveFile(this->GetSegmentFileName(s));
+  }
+  return true;
+}
@@ -0,0 +1,236 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltAnimationRecorder
+ * @brief   Record a quilt sequence along a camera path.
+ *
+ * The recorder moves the camera along the keyframes of a
+ * vtkCameraInterpolator, renders a quilt for each of NumberOfFrames frames
+ * and writes them to a quilt sequence (".lgq") file. Each frame is encoded
+ * on a separate thread while the next one is set up and rendered.
+ *
+ * The frames are recorded in segments of SegmentSize frames, each written
+ * to its own file named by GetSegmentFileName(). A segment file only
+ * appears once the segment is complete, and Record() skips the segments
+ * that are already there, so a recording that was interrupted resumes
+ * from where it stopped.
+ *
+ * Long recordings can be split between processes, or machines sharing a
+ * file system, that each set up the same scene and recorder with their own
+ * WorkerIndex out of NumberOfWorkers. Each worker records every
+ * NumberOfWorkers-th segment. Once all workers are done, one of them calls
+ * ConcatenateSegments() to join the segments into FileName without
+ * decoding them again:
+ *
+ * \code{.py}
+ * recorder.SetWorkerIndex(index)
+ * recorder.SetNumberOfWorkers(count)
+ * recorder.Record()
+ * # ... once every worker returned from Record()
+ * recorder.ConcatenateSegments()
+ * \endcode
+ *
+ * To record time-varying data, render the output of a
+ * vtkLookingGlassTimeSeriesSource and set it with SetTimeSeries(). The
+ * recorder shows frame N of the series in quilt N, and moves the source to
+ * the next frame as soon as a quilt is submitted, while the GPU renders its
+ * tiles, rather than between the quilts.
+ *
+ * @sa
+ * vtkLookingGlassQuiltSequenceWriter vtkCameraInterpolator
+ * vtkLookingGlassTimeSeriesSource
+ */
+
+#ifndef vtkLookingGlassQuiltAnimationRecorder_h
+#define vtkLookingGlassQuiltAnimationRecorder_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <functional> // For std::function
+#include <string>     // For std::string
+
+class vtkCamera;
+class vtkCameraInterpolator;
+class vtkLookingGlassInterface;
+class vtkLookingGlassTimeSeriesSource;
+class vtkRenderWindow;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltAnimationRecorder : public vtkObject
+{
+public:
+  static vtkLookingGlassQuiltAnimationRecorder* New();
+  vtkTypeMacro(vtkLookingGlassQuiltAnimationRecorder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the window that renders the quilts, and the interface that
+   * holds them. This is the window of a Looking Glass render window, or the
+   * interface of the vtkLookingGlassPass used by the window.
+   */
+  void SetRenderWindow(vtkRenderWindow* renderWindow);
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+  void SetInterface(vtkLookingGlassInterface* lgInterface);
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the camera keyframes. The path is sampled uniformly between
+   * its first and last keyframe times.
+   */
+  void SetCameraPath(vtkCameraInterpolator* path);
+  vtkGetObjectMacro(CameraPath, vtkCameraInterpolator);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the camera moved along the path. Defaults to nullptr, the
+   * active camera of the first renderer of the window.
+   */
+  void SetCamera(vtkCamera* camera);
+  vtkGetObjectMacro(Camera, vtkCamera);
+  //@}
+
+  /**
+   * Set a function called with the frame number before each frame is
+   * rendered, after the camera was moved. Use it to animate the rest of the
+   * scene. It must only depend on the frame number, as the frames of a
+   * worker are not contiguous and may be recorded again after a crash.
+   */
+  void SetFrameCallback(std::function<void(int)> callback) { this->FrameCallback = callback; }
+
+  //@{
+  /**
+   * Set/Get the source of the time-varying data of the scene. Its frame
+   * follows the recorded frame, and its upcoming frames are loaded ahead.
+   */
+  void SetTimeSeries(vtkLookingGlassTimeSeriesSource* source);
+  vtkGetObjectMacro(TimeSeries, vtkLookingGlassTimeSeriesSource);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of frames to record. Default is 60.
+   */
+  vtkSetClampMacro(NumberOfFrames, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfFrames, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the playback rate in frames per second. Default is 30.
+   */
+  vtkSetMacro(FrameRate, double);
+  vtkGetMacro(FrameRate, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the name of the quilt sequence file to write.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of frames in a segment. Smaller segments lose less
+   * work to a crash and balance the workers better. Default is 30.
+   */
+  vtkSetClampMacro(SegmentSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(SegmentSize, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get which of the NumberOfWorkers workers this recorder is.
+   * Defaults to worker 0 of 1.
+   */
+  vtkSetClampMacro(WorkerIndex, int, 0, VTK_INT_MAX);
+  vtkGetMacro(WorkerIndex, int);
+  vtkSetClampMacro(NumberOfWorkers, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfWorkers, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get if ConcatenateSegments() deletes the segment files once they
+   * are joined. On by default.
+   */
+  vtkSetMacro(RemoveSegments, bool);
+  vtkGetMacro(RemoveSegments, bool);
+  vtkBooleanMacro(RemoveSegments, bool);
+  //@}
+
+  /**
+   * Get the number of segments of the recording.
+   */
+  int GetNumberOfSegments() const;
+
+  /**
+   * Get the name of the file of a segment.
+   */
+  std::string GetSegmentFileName(int segment) const;
+
+  /**
+   * Check if the file of a segment holds all of its frames.
+   */
+  bool IsSegmentComplete(int segment) const;
+
+  /**
+   * Record the segments of this worker that are not complete yet. Returns
+   * false if a segment could not be written.
+   */
+  bool Record();
+
+  /**
+   * Get the number of segments the last Record() wrote and skipped
+   * because they were complete.
+   */
+  vtkGetMacro(NumberOfSegmentsRecorded, int);
+  vtkGetMacro(NumberOfSegmentsSkipped, int);
+
+  /**
+   * Join the segments into FileName. Returns false if a segment is missing.
+   */
+  bool ConcatenateSegments();
+
+protected:
+  vtkLookingGlassQuiltAnimationRecorder();
+  ~vtkLookingGlassQuiltAnimationRecorder() override;
+
+  bool RecordSegment(int segment, vtkCamera* camera);
+
+  vtkRenderWindow* RenderWindow;
+  vtkLookingGlassInterface* Interface;
+  vtkCameraInterpolator* CameraPath;
+  vtkCamera* Camera;
+  std::function<void(int)> FrameCallback;
+  vtkLookingGlassTimeSeriesSource* TimeSeries;
+  int NumberOfFrames;
+  double FrameRate;
+  char* FileName;
+  int SegmentSize;
+  int WorkerIndex;
+  int NumberOfWorkers;
+  bool RemoveSegments;
+  int NumberOfSegmentsRecorded;
+  int NumberOfSegmentsSkipped;
+
+private:
+  vtkLookingGlassQuiltAnimationRecorder(const vtkLookingGlassQuiltAnimationRecorder&) = delete;
+  void operator=(const vtkLookingGlassQuiltAnimationRecorder&) = delete;
+};
+
+#endif
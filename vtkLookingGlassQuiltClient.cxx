@@ -0,0 +1,265 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltClient.h"
+
+#include "vtkClientSocket.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltStreamProtocol.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkOpenGLState.h"
+#include "vtkTextureObject.h"
+
+#include "vtk_glad.h"
+#include "vtk_lz4.h"
+
+#include <cstring>
+
+namespace protocol = vtkLookingGlassQuiltStreamProtocol;
+
+namespace
+{
+// larger frames are taken for a corrupted stream, an 8K quilt is 200 MB
+const vtkTypeInt64 MaximumFrameSize = 1LL << 30;
+}
+
+vtkStandardNewMacro(vtkLookingGlassQuiltClient);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltClient::vtkLookingGlassQuiltClient()
+  : Socket(nullptr)
+  , Frame(vtkImageData::New())
+  , Texture(nullptr)
+  , FrameId(0)
+  , SendTime(0)
+  , Scale(1)
+  , Acknowledged(true)
+  , Uploaded(true)
+{
+  this->QuiltTiles[0] = 0;
+  this->QuiltTiles[1] = 0;
+  this->ViewPortion[0] = 1.0f;
+  this->ViewPortion[1] = 1.0f;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltClient::~vtkLookingGlassQuiltClient()
+{
+  this->Disconnect();
+  this->Frame->Delete();
+  if (this->Texture)
+  {
+    this->Texture->Delete();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltClient::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Connected: " << this->IsConnected() << "\n";
+  os << indent << "FrameId: " << this->FrameId << "\n";
+  os << indent << "QuiltTiles: " << this->QuiltTiles[0] << "x" << this->QuiltTiles[1] << "\n";
+  os << indent << "Scale: " << this->Scale << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltClient::Connect(const char* hostName, int port)
+{
+  this->Disconnect();
+  this->Socket = vtkClientSocket::New();
+  if (this->Socket->ConnectToServer(hostName, port) != 0)
+  {
+    vtkErrorMacro("Unable to connect to " << hostName << ":" << port);
+    this->Socket->Delete();
+    this->Socket = nullptr;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltClient::Disconnect()
+{
+  if (this->Socket)
+  {
+    this->Socket->CloseSocket();
+    this->Socket->Delete();
+    this->Socket = nullptr;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltClient::IsConnected() const
+{
+  return this->Socket && this->Socket->GetConnected();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltClient::ReceiveFrame(double timeout)
+{
+  if (!this->IsConnected())
+  {
+    return false;
+  }
+
+  int descriptor = this->Socket->GetSocketDescriptor();
+  int selected = -1;
+  if (vtkSocket::SelectSockets(
+        &descriptor, 1, static_cast<unsigned long>(timeout * 1000.0), &selected) != 1)
+  {
+    return false;
+  }
+
+  unsigned char header[protocol::FrameHeaderSize];
+  if (this->Socket->Receive(header, protocol::FrameHeaderSize) !=
+      static_cast<int>(protocol::FrameHeaderSize) ||
+    protocol::Get<vtkTypeUInt32>(header, protocol::FrameMagicOffset) != protocol::FrameMagic)
+  {
+    this->Disconnect();
+    return false;
+  }
+
+  const int width = protocol::Get<vtkTypeInt32>(header, protocol::SizeOffset);
+  const int height = protocol::Get<vtkTypeInt32>(header, protocol::SizeOffset + 4);
+  const vtkTypeUInt32 codec = protocol::Get<vtkTypeUInt32>(header, protocol::CodecOffset);
+  const vtkTypeUInt32 payloadBytes =
+    protocol::Get<vtkTypeUInt32>(header, protocol::PayloadSizeOffset);
+  const vtkTypeInt64 frameBytes = static_cast<vtkTypeInt64>(width) * height * 3;
+  if (width <= 0 || height <= 0 || frameBytes > MaximumFrameSize ||
+    payloadBytes > static_cast<vtkTypeUInt32>(LZ4_compressBound(static_cast<int>(frameBytes))))
+  {
+    vtkErrorMacro("Frame of " << width << "x" << height << " in " << payloadBytes
+                              << " bytes refused");
+    this->Disconnect();
+    return false;
+  }
+
+  // both sizes fit in an int from here on
+  const int bytes = static_cast<int>(frameBytes);
+  const int payloadSize = static_cast<int>(payloadBytes);
+  this->Payload.resize(payloadSize);
+  if (payloadSize > 0 && this->Socket->Receive(this->Payload.data(), payloadSize) != payloadSize)
+  {
+    this->Disconnect();
+    return false;
+  }
+
+  int* dims = this->Frame->GetDimensions();
+  if (dims[0] != width || dims[1] != height || this->Frame->GetNumberOfScalarComponents() != 3)
+  {
+    this->Frame->SetDimensions(width, height, 1);
+    this->Frame->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  }
+  char* pixels = static_cast<char*>(this->Frame->GetScalarPointer());
+  bool decoded = false;
+  if (codec == protocol::LZ4Codec)
+  {
+    decoded = LZ4_decompress_safe(this->Payload.data(), pixels, payloadSize, bytes) == bytes;
+  }
+  else if (codec == protocol::RawCodec && payloadSize == bytes)
+  {
+    std::memcpy(pixels, this->Payload.data(), bytes);
+    decoded = true;
+  }
+  if (!decoded)
+  {
+    vtkErrorMacro("Received a corrupt frame");
+    this->Disconnect();
+    return false;
+  }
+
+  this->FrameId = protocol::Get<vtkTypeUInt64>(header, protocol::FrameIdOffset);
+  this->SendTime = protocol::Get<vtkTypeInt64>(header, protocol::SendTimeOffset);
+  this->QuiltTiles[0] = protocol::Get<vtkTypeInt32>(header, protocol::QuiltTilesOffset);
+  this->QuiltTiles[1] = protocol::Get<vtkTypeInt32>(header, protocol::QuiltTilesOffset + 4);
+  this->Scale = protocol::Get<vtkTypeInt32>(header, protocol::ScaleOffset);
+  this->ViewPortion[0] = protocol::Get<float>(header, protocol::ViewPortionOffset);
+  this->ViewPortion[1] = protocol::Get<float>(header, protocol::ViewPortionOffset + 4);
+  this->Frame->Modified();
+  this->Acknowledged = false;
+  this->Uploaded = false;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltClient::Acknowledge()
+{
+  if (this->Acknowledged || !this->IsConnected())
+  {
+    return false;
+  }
+
+  unsigned char ack[protocol::AckSize] = {};
+  protocol::Put(ack, protocol::AckMagicOffset, protocol::AckMagic);
+  protocol::Put(ack, protocol::AckFrameIdOffset, this->FrameId);
+  protocol::Put(ack, protocol::AckSendTimeOffset, this->SendTime);
+  this->Acknowledged = true;
+  return this->Socket->Send(ack, protocol::AckSize) != 0;
+}
+
+//------------------------------------------------------------------------------
+vtkTextureObject* vtkLookingGlassQuiltClient::UploadFrame(vtkOpenGLRenderWindow* rw)
+{
+  if (this->FrameId == 0)
+  {
+    return nullptr;
+  }
+
+  if (!this->Texture)
+  {
+    this->Texture = vtkTextureObject::New();
+    this->Texture->SetMinificationFilter(vtkTextureObject::Linear);
+    this->Texture->SetMagnificationFilter(vtkTextureObject::Linear);
+    this->Texture->SetWrapS(vtkTextureObject::ClampToEdge);
+    this->Texture->SetWrapT(vtkTextureObject::ClampToEdge);
+  }
+  this->Texture->SetContext(rw);
+
+  if (!this->Uploaded)
+  {
+    int* dims = this->Frame->GetDimensions();
+    auto ostate = rw->GetState();
+    int unpackAlignment = 4;
+    ostate->vtkglGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    ostate->vtkglPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (!this->Texture->GetHandle() ||
+      this->Texture->GetWidth() != static_cast<unsigned int>(dims[0]) ||
+      this->Texture->GetHeight() != static_cast<unsigned int>(dims[1]))
+    {
+      this->Texture->Create2DFromRaw(
+        dims[0], dims[1], 3, VTK_UNSIGNED_CHAR, this->Frame->GetScalarPointer());
+    }
+    else
+    {
+      this->Texture->Bind();
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, dims[0], dims[1], GL_RGB, GL_UNSIGNED_BYTE,
+        this->Frame->GetScalarPointer());
+    }
+    ostate->vtkglPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+    this->Uploaded = true;
+  }
+
+  this->Acknowledge();
+  return this->Texture;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltClient::ReleaseGraphicsResources(vtkWindow* w)
+{
+  if (this->Texture)
+  {
+    this->Texture->ReleaseGraphicsResources(w);
+  }
+  // the frame has to be uploaded again into a new texture
+  this->Uploaded = false;
+}
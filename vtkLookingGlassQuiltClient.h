@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltClient
+ * @brief   Receive quilts from a vtkLookingGlassQuiltServer.
+ *
+ * The client receives the quilts rendered by a server and acknowledges them
+ * once they are displayed. To show them on the device, give the client to
+ * vtkLookingGlassInterface::SetQuiltClient() and render the Looking Glass
+ * window whenever ReceiveFrame() returns true: the window then draws the
+ * latest received quilt instead of rendering its scene.
+ *
+ * @sa
+ * vtkLookingGlassQuiltServer
+ */
+
+#ifndef vtkLookingGlassQuiltClient_h
+#define vtkLookingGlassQuiltClient_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <vector> // For std::vector
+
+class vtkClientSocket;
+class vtkImageData;
+class vtkOpenGLRenderWindow;
+class vtkTextureObject;
+class vtkWindow;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltClient : public vtkObject
+{
+public:
+  static vtkLookingGlassQuiltClient* New();
+  vtkTypeMacro(vtkLookingGlassQuiltClient, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Connect to a server. Returns false if the connection failed.
+   */
+  bool Connect(const char* hostName, int port);
+
+  /**
+   * Close the connection.
+   */
+  void Disconnect();
+
+  /**
+   * Check if the client is connected.
+   */
+  bool IsConnected() const;
+
+  /**
+   * Wait up to `timeout` seconds for the next frame and decode it. Returns
+   * false if no frame arrived or the server disconnected.
+   */
+  bool ReceiveFrame(double timeout);
+
+  /**
+   * Tell the server that the last received frame is displayed. This is done
+   * by UploadFrame(), call it directly when the frames are consumed in
+   * another way.
+   */
+  bool Acknowledge();
+
+  /**
+   * Get the last received quilt, possibly shrunk by the server.
+   */
+  vtkImageData* GetFrame() { return this->Frame; }
+
+  //@{
+  /**
+   * Get the metadata of the last received frame.
+   */
+  vtkGetMacro(FrameId, vtkTypeUInt64);
+  vtkGetVector2Macro(QuiltTiles, int);
+  vtkGetVector2Macro(ViewPortion, float);
+  vtkGetMacro(Scale, int);
+  //@}
+
+  /**
+   * Upload the last received frame into a texture of the given window,
+   * acknowledge it and return the texture. Returns nullptr if no frame
+   * was received yet.
+   */
+  vtkTextureObject* UploadFrame(vtkOpenGLRenderWindow* rw);
+
+  /**
+   * Release the texture.
+   */
+  void ReleaseGraphicsResources(vtkWindow* w);
+
+protected:
+  vtkLookingGlassQuiltClient();
+  ~vtkLookingGlassQuiltClient() override;
+
+  vtkClientSocket* Socket;
+  vtkImageData* Frame;
+  vtkTextureObject* Texture;
+  vtkTypeUInt64 FrameId;
+  vtkTypeInt64 SendTime;
+  int QuiltTiles[2];
+  float ViewPortion[2];
+  int Scale;
+  bool Acknowledged;
+  bool Uploaded;
+  std::vector<char> Payload;
+
+private:
+  vtkLookingGlassQuiltClient(const vtkLookingGlassQuiltClient&) = delete;
+  void operator=(const vtkLookingGlassQuiltClient&) = delete;
+};
+
+#endif
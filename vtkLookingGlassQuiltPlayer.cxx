@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltPlayer.h"
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltPlayer::~vtkLookingGlassQuiltPlayer()
+{
+  this->Stop();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltPlayer::Start(
+  FrameSource source, RewindFunction rewind, double frameRate, bool loop, SeekFunction seek)
+{
+  this->Stop();
+
+  this->Source = source;
+  this->Rewind = rewind;
+  this->Seek = seek;
+  this->FrameRate = frameRate > 0.0 ? frameRate : 30.0;
+  this->Loop = loop;
+  this->EndOfMovie = false;
+  this->NextDecodeIndex = 0;
+  this->DroppedFrames = 0;
+  this->StartTime = std::chrono::steady_clock::now();
+
+  this->Running = true;
+  this->Thread = std::thread(&vtkLookingGlassQuiltPlayer::DecodeLoop, this);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltPlayer::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Running = false;
+  }
+  this->Wakeup.notify_all();
+  if (this->Thread.joinable())
+  {
+    this->Thread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  for (auto& frame : this->Queue)
+  {
+    this->FreeImages.push_back(frame.Image);
+  }
+  this->Queue.clear();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltPlayer::IsPlaying() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Running && !(this->EndOfMovie && this->Queue.empty());
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltPlayer::DecodeLoop()
+{
+  while (true)
+  {
+    vtkSmartPointer<vtkImageData> image;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Wakeup.wait(lock, [this]() {
+        return !this->Running || (!this->EndOfMovie && this->Queue.size() < QueueLength);
+      });
+      if (!this->Running)
+      {
+        return;
+      }
+      if (!this->FreeImages.empty())
+      {
+        image = this->FreeImages.back();
+        this->FreeImages.pop_back();
+      }
+    }
+
+    // the frames that would already be late once decoded are skipped, only
+    // this thread changes the decode index
+    long long dueIndex = this->GetDueIndex();
+    if (this->Seek && dueIndex > this->NextDecodeIndex)
+    {
+      long long index = this->Seek(dueIndex);
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->DroppedFrames += static_cast<int>(index - this->NextDecodeIndex);
+      this->NextDecodeIndex = index;
+    }
+
+    if (!image)
+    {
+      image = vtkSmartPointer<vtkImageData>::New();
+    }
+
+    // decode outside of the lock, this is the slow part
+    bool decoded = this->Source(image);
+    if (!decoded && this->Loop && this->Rewind && this->Rewind())
+    {
+      decoded = this->Source(image);
+    }
+
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (decoded)
+    {
+      this->Queue.push_back({ image, this->NextDecodeIndex++ });
+    }
+    else
+    {
+      this->FreeImages.push_back(image);
+      this->EndOfMovie = true;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+long long vtkLookingGlassQuiltPlayer::GetDueIndex() const
+{
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->StartTime);
+  return static_cast<long long>(elapsed.count() * this->FrameRate);
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vtkLookingGlassQuiltPlayer::GetDueFrame()
+{
+  long long dueIndex = this->GetDueIndex();
+
+  vtkSmartPointer<vtkImageData> due;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    while (!this->Queue.empty() && this->Queue.front().Index <= dueIndex)
+    {
+      if (due)
+      {
+        // decoded in time but never shown, the display fell behind
+        this->FreeImages.push_back(due);
+        ++this->DroppedFrames;
+      }
+      due = this->Queue.front().Image;
+      this->Queue.pop_front();
+    }
+  }
+  this->Wakeup.notify_all();
+
+  return due;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltPlayer::Recycle(vtkImageData* frame)
+{
+  if (!frame)
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->FreeImages.size() < QueueLength)
+  {
+    this->FreeImages.push_back(frame);
+  }
+}
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltPlayer
+ * @brief   Decode quilt frames on a background thread for playback.
+ *
+ * This is a helper for vtkLookingGlassInterface. It runs a frame source on
+ * its own thread, keeps a few decoded frames queued ahead of the display,
+ * and hands out the most recent frame that is due at a given time. Frames
+ * are dropped when either side falls behind the movie's clock: a slow
+ * display skips the queued frames it did not pick up in time, and when
+ * decoding is too slow a source that can seek jumps to the frame due now.
+ * A source without a seek function decodes every frame and plays late
+ * instead. It does not touch OpenGL, uploading the frames is left to the
+ * caller.
+ */
+
+#ifndef vtkLookingGlassQuiltPlayer_h
+#define vtkLookingGlassQuiltPlayer_h
+
+#include "vtkImageData.h"
+#include "vtkSmartPointer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class vtkLookingGlassQuiltPlayer
+{
+public:
+  // Decode the next frame into the provided image, return false at the end
+  // of the movie.
+  using FrameSource = std::function<bool(vtkImageData*)>;
+
+  // Go back to the first frame, return false if it is not possible.
+  using RewindFunction = std::function<bool()>;
+
+  // Make the frame source decode the frame with the given index next,
+  // counted from the start of the playback across loops. Return the index
+  // of the frame it will decode, which is less past the end of the movie.
+  using SeekFunction = std::function<long long(long long)>;
+
+  vtkLookingGlassQuiltPlayer() = default;
+  ~vtkLookingGlassQuiltPlayer();
+
+  // Start decoding frames at `frameRate` frames per second, the first frame
+  // is due right away. Any previous playback is stopped. Without `seek`
+  // every frame is decoded even when decoding falls behind.
+  void Start(FrameSource source, RewindFunction rewind, double frameRate, bool loop,
+    SeekFunction seek = nullptr);
+
+  // Stop the decode thread and drop the queued frames.
+  void Stop();
+
+  // True until Stop() is called or the last frame of a non looping movie
+  // has been handed out.
+  bool IsPlaying() const;
+
+  // Return the most recent frame that is due at the current time, or
+  // nullptr if the frame on display is still current. Queued frames that
+  // became due before the returned one are dropped, so a slow display skips
+  // frames instead of falling behind the movie's clock. Once the caller is
+  // done with a frame it should give it back with Recycle().
+  vtkSmartPointer<vtkImageData> GetDueFrame();
+
+  // Give a frame back so that its memory is reused for decoding.
+  void Recycle(vtkImageData* frame);
+
+  int GetNumberOfDroppedFrames() const { return this->DroppedFrames; }
+  double GetFrameRate() const { return this->FrameRate; }
+
+  // Number of decoded frames kept ahead of the display.
+  static const size_t QueueLength = 4;
+
+private:
+  void DecodeLoop();
+
+  // Index of the frame due at the current time.
+  long long GetDueIndex() const;
+
+  struct Frame
+  {
+    vtkSmartPointer<vtkImageData> Image;
+    long long Index;
+  };
+
+  FrameSource Source;
+  RewindFunction Rewind;
+  SeekFunction Seek;
+  double FrameRate = 30.0;
+  bool Loop = false;
+
+  std::thread Thread;
+  mutable std::mutex Mutex;
+  std::condition_variable Wakeup;
+  std::deque<Frame> Queue;
+  std::vector<vtkSmartPointer<vtkImageData>> FreeImages;
+  std::atomic<bool> Running{ false };
+  bool EndOfMovie = false;
+  long long NextDecodeIndex = 0;
+  std::chrono::steady_clock::time_point StartTime;
+  std::atomic<int> DroppedFrames{ 0 };
+};
+
+#endif
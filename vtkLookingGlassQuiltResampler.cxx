@@ -0,0 +1,268 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltResampler.h"
+
+#include "vtkDataSetAttributes.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+vtkStandardNewMacro(vtkLookingGlassQuiltResampler);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltResampler::vtkLookingGlassQuiltResampler()
+  : InputAspectRatio(0.0)
+  , OutputAspectRatio(0.0)
+{
+  this->InputTiles[0] = 5;
+  this->InputTiles[1] = 9;
+  this->OutputTiles[0] = 5;
+  this->OutputTiles[1] = 9;
+  this->OutputTileSize[0] = 819;
+  this->OutputTileSize[1] = 455;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltResampler::~vtkLookingGlassQuiltResampler() = default;
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltResampler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "InputTiles: " << this->InputTiles[0] << "x" << this->InputTiles[1] << "\n";
+  os << indent << "InputAspectRatio: " << this->InputAspectRatio << "\n";
+  os << indent << "OutputTiles: " << this->OutputTiles[0] << "x" << this->OutputTiles[1] << "\n";
+  os << indent << "OutputTileSize: " << this->OutputTileSize[0] << "x" << this->OutputTileSize[1]
+     << "\n";
+  os << indent << "OutputAspectRatio: " << this->OutputAspectRatio << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltResampler::SetOutputDeviceType(const std::string& deviceType)
+{
+  int quiltSize[2];
+  int quiltTiles[2];
+  double aspectRatio;
+  if (!vtkLookingGlassInterface::GetDeviceSettings(deviceType, quiltSize, quiltTiles, aspectRatio))
+  {
+    vtkErrorMacro("Unrecognized device type: '" << deviceType << "'");
+    return false;
+  }
+
+  this->SetOutputTiles(quiltTiles);
+  this->SetOutputTileSize(quiltSize[0] / quiltTiles[0], quiltSize[1] / quiltTiles[1]);
+  this->SetOutputAspectRatio(aspectRatio);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltResampler::ParseQuiltFileSuffix(const char* fileName, int tiles[2])
+{
+  if (!fileName)
+  {
+    return false;
+  }
+
+  // use the last occurrence, directories may contain the pattern too
+  const char* suffix = nullptr;
+  for (const char* pos = std::strstr(fileName, "_qs"); pos; pos = std::strstr(pos + 1, "_qs"))
+  {
+    suffix = pos;
+  }
+  if (!suffix)
+  {
+    return false;
+  }
+
+  int columns = 0;
+  int rows = 0;
+  if (std::sscanf(suffix, "_qs%dx%d", &columns, &rows) != 2 || columns < 1 || rows < 1)
+  {
+    return false;
+  }
+
+  tiles[0] = columns;
+  tiles[1] = rows;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltResampler::RequestInformation(
+  vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  int extent[6] = { 0, this->OutputTiles[0] * this->OutputTileSize[0] - 1, 0,
+    this->OutputTiles[1] * this->OutputTileSize[1] - 1, 0, 0 };
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+
+  int numComponents = 3;
+  vtkInformation* scalarInfo = vtkDataObject::GetActiveFieldInformation(
+    inInfo, vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
+  if (scalarInfo && scalarInfo->Has(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS()))
+  {
+    numComponents = scalarInfo->Get(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS());
+  }
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, numComponents);
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltResampler::RequestUpdateExtent(
+  vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector*)
+{
+  // every output tile may need any input tile, always ask for the whole quilt
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltResampler::RequestData(
+  vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkImageData* output = vtkImageData::GetData(outputVector);
+
+  if (!input || !input->GetPointData()->GetScalars() ||
+    input->GetScalarType() != VTK_UNSIGNED_CHAR)
+  {
+    vtkErrorMacro("The input quilt must have unsigned char scalars");
+    return 0;
+  }
+
+  const int numComponents = input->GetNumberOfScalarComponents();
+  if (numComponents != 3 && numComponents != 4)
+  {
+    vtkErrorMacro("The input quilt must have 3 or 4 components, not " << numComponents);
+    return 0;
+  }
+
+  int inDims[3];
+  input->GetDimensions(inDims);
+  const int inTileSize[2] = { inDims[0] / this->InputTiles[0], inDims[1] / this->InputTiles[1] };
+  const int outTileSize[2] = { this->OutputTileSize[0], this->OutputTileSize[1] };
+  if (inTileSize[0] < 1 || inTileSize[1] < 1 || outTileSize[0] < 1 || outTileSize[1] < 1 ||
+    this->OutputTiles[0] < 1 || this->OutputTiles[1] < 1)
+  {
+    vtkErrorMacro("Invalid tile layout");
+    return 0;
+  }
+
+  output->SetExtent(0, this->OutputTiles[0] * outTileSize[0] - 1, 0,
+    this->OutputTiles[1] * outTileSize[1] - 1, 0, 0);
+  output->AllocateScalars(VTK_UNSIGNED_CHAR, numComponents);
+
+  // the part of each input view that is kept, centered on the view
+  double crop[4] = { 0.0, 0.0, static_cast<double>(inTileSize[0]),
+    static_cast<double>(inTileSize[1]) };
+  if (this->InputAspectRatio > 0.0 && this->OutputAspectRatio > 0.0)
+  {
+    double ratio = this->OutputAspectRatio / this->InputAspectRatio;
+    if (ratio < 1.0)
+    {
+      crop[2] = inTileSize[0] * ratio;
+      crop[0] = (inTileSize[0] - crop[2]) * 0.5;
+    }
+    else
+    {
+      crop[3] = inTileSize[1] / ratio;
+      crop[1] = (inTileSize[1] - crop[3]) * 0.5;
+    }
+  }
+
+  const unsigned char* inPtr = static_cast<unsigned char*>(input->GetScalarPointer());
+  unsigned char* outPtr = static_cast<unsigned char*>(output->GetScalarPointer());
+  const vtkIdType inRowStride = static_cast<vtkIdType>(inDims[0]) * numComponents;
+  const vtkIdType outRowStride =
+    static_cast<vtkIdType>(this->OutputTiles[0]) * outTileSize[0] * numComponents;
+  const int numInViews = this->InputTiles[0] * this->InputTiles[1];
+  const int numOutViews = this->OutputTiles[0] * this->OutputTiles[1];
+  const int inColumns = this->InputTiles[0];
+  const int outColumns = this->OutputTiles[0];
+
+  // bilinear lookup of one component in an input view
+  auto sample = [&](int view, double x, double y, int c) {
+    const int x0Tile = (view % inColumns) * inTileSize[0];
+    const int y0Tile = (view / inColumns) * inTileSize[1];
+    x = std::min(std::max(x, 0.0), inTileSize[0] - 1.0);
+    y = std::min(std::max(y, 0.0), inTileSize[1] - 1.0);
+    const int x0 = static_cast<int>(x);
+    const int y0 = static_cast<int>(y);
+    const int x1 = std::min(x0 + 1, inTileSize[0] - 1);
+    const int y1 = std::min(y0 + 1, inTileSize[1] - 1);
+    const double fx = x - x0;
+    const double fy = y - y0;
+    auto at = [&](int px, int py) {
+      return static_cast<double>(
+        inPtr[(y0Tile + py) * inRowStride + static_cast<vtkIdType>(x0Tile + px) * numComponents +
+          c]);
+    };
+    return (at(x0, y0) * (1.0 - fx) + at(x1, y0) * fx) * (1.0 - fy) +
+      (at(x0, y1) * (1.0 - fx) + at(x1, y1) * fx) * fy;
+  };
+
+  vtkSMPTools::For(0, numOutViews, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType outView = begin; outView < end; ++outView)
+    {
+      // position of this view in the view cone, mapped onto the input views
+      double pos = numOutViews > 1
+        ? static_cast<double>(outView) / (numOutViews - 1) * (numInViews - 1)
+        : 0.5 * (numInViews - 1);
+      int view0 = std::min(static_cast<int>(pos), numInViews - 1);
+      int view1 = std::min(view0 + 1, numInViews - 1);
+      double weight = pos - view0;
+
+      const int outX0 = static_cast<int>(outView % outColumns) * outTileSize[0];
+      const int outY0 = static_cast<int>(outView / outColumns) * outTileSize[1];
+      for (int y = 0; y < outTileSize[1]; ++y)
+      {
+        double inY = crop[1] + (y + 0.5) * crop[3] / outTileSize[1] - 0.5;
+        unsigned char* row = outPtr + (outY0 + y) * outRowStride +
+          static_cast<vtkIdType>(outX0) * numComponents;
+        for (int x = 0; x < outTileSize[0]; ++x)
+        {
+          double inX = crop[0] + (x + 0.5) * crop[2] / outTileSize[0] - 0.5;
+          for (int c = 0; c < numComponents; ++c)
+          {
+            double value = sample(view0, inX, inY, c);
+            if (weight > 0.0)
+            {
+              value = value * (1.0 - weight) + sample(view1, inX, inY, c) * weight;
+            }
+            row[x * numComponents + c] = static_cast<unsigned char>(value + 0.5);
+          }
+        }
+      }
+    }
+  });
+
+  return 1;
+}
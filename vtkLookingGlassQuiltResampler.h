@@ -0,0 +1,124 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltResampler
+ * @brief   Convert a quilt image from one tile layout to another.
+ *
+ * This filter takes an existing quilt image, such as one loaded from a
+ * "_qs5x9" PNG file or a frame of a quilt movie, and produces a quilt with
+ * a different number of tiles, tile size and view aspect ratio. Output views
+ * that fall between two input views are linearly interpolated from their
+ * neighbors, and every view is bilinearly resampled to the output tile size.
+ * The tiles are processed in parallel with vtkSMPTools, so no GPU is needed.
+ *
+ * The input must have unsigned char scalars with 3 or 4 components. Movies
+ * can be converted by running the filter on each frame in turn.
+ *
+ * @sa
+ * vtkLookingGlassInterface
+ */
+
+#ifndef vtkLookingGlassQuiltResampler_h
+#define vtkLookingGlassQuiltResampler_h
+
+#include "vtkImageAlgorithm.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <string> // For std::string
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltResampler : public vtkImageAlgorithm
+{
+public:
+  static vtkLookingGlassQuiltResampler* New();
+  vtkTypeMacro(vtkLookingGlassQuiltResampler, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the number of tiles of the input quilt in X and Y.
+   * Default is 5x9.
+   */
+  vtkSetVector2Macro(InputTiles, int);
+  vtkGetVector2Macro(InputTiles, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the aspect ratio of the views stored in the input quilt. This
+   * may differ from the aspect ratio of the tiles in pixels. When both this
+   * and the OutputAspectRatio are set, the input views are cropped around
+   * their center to the output aspect ratio. Default is 0, no cropping.
+   */
+  vtkSetMacro(InputAspectRatio, double);
+  vtkGetMacro(InputAspectRatio, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of tiles of the output quilt in X and Y.
+   * Default is 5x9.
+   */
+  vtkSetVector2Macro(OutputTiles, int);
+  vtkGetVector2Macro(OutputTiles, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the size in pixels of each tile of the output quilt.
+   * Default is 819x455, the tile size of the "large" device.
+   */
+  vtkSetVector2Macro(OutputTileSize, int);
+  vtkGetVector2Macro(OutputTileSize, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the aspect ratio of the views in the output quilt.
+   * Default is 0, no cropping.
+   */
+  vtkSetMacro(OutputAspectRatio, double);
+  vtkGetMacro(OutputAspectRatio, double);
+  //@}
+
+  /**
+   * Set the output tiles, tile size and aspect ratio from the settings of a
+   * Looking Glass device type such as "portrait" or "32_gen3_l". Returns
+   * false if the device type is unknown.
+   */
+  bool SetOutputDeviceType(const std::string& deviceType);
+
+  /**
+   * Parse the tile layout from a quilt file name, such as "quilt_qs5x9.png".
+   * Returns false if the name does not contain a valid "_qsWxH" suffix.
+   */
+  static bool ParseQuiltFileSuffix(const char* fileName, int tiles[2]);
+
+protected:
+  vtkLookingGlassQuiltResampler();
+  ~vtkLookingGlassQuiltResampler() override;
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  int InputTiles[2];
+  double InputAspectRatio;
+  int OutputTiles[2];
+  int OutputTileSize[2];
+  double OutputAspectRatio;
+
+private:
+  vtkLookingGlassQuiltResampler(const vtkLookingGlassQuiltResampler&) = delete;
+  void operator=(const vtkLookingGlassQuiltResampler&) = delete;
+};
+
+#endif
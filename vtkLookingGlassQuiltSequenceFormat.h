@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Layout of the quilt sequence (".lgq") files shared by
+ * vtkLookingGlassQuiltSequenceWriter and vtkLookingGlassQuiltSequenceReader.
+ *
+ * All values are little endian. The file is made of
+ *
+ *  - a header of HeaderSize bytes, with the fields at the offsets below
+ *  - the tile chunks, frame after frame, tile after tile within a frame.
+ *    A decoded tile holds the RGB pixels of the tile, bottom row first.
+ *  - the index, one ChunkEntrySize entry per chunk in the same order:
+ *    uint64 file offset, uint32 size in bytes, uint32 codec
+ *
+ * A DisparityLZ4Codec chunk starts with an int16 disparity and holds the
+ * LZ4 compressed difference between the tile and the previous tile of the
+ * same frame shifted by that many pixels. Decoding it requires the previous
+ * tile, so a frame is decoded as runs of tiles that start at a tile with
+ * another codec.
+ */
+
+#ifndef vtkLookingGlassQuiltSequenceFormat_h
+#define vtkLookingGlassQuiltSequenceFormat_h
+
+#include "vtkType.h"
+
+#include <cstring>
+
+namespace vtkLookingGlassQuiltSequenceFormat
+{
+const char Magic[8] = { 'L', 'G', 'Q', 'U', 'I', 'L', 'T', '\0' };
+const vtkTypeUInt32 Version = 2;
+const vtkTypeUInt32 HeaderSize = 256;
+const vtkTypeUInt32 ChunkEntrySize = 16;
+const vtkTypeUInt32 DeviceTypeLength = 64;
+
+// field offsets in the header
+enum Offsets
+{
+  MagicOffset = 0,               // char[8]
+  VersionOffset = 8,             // uint32
+  HeaderSizeOffset = 12,         // uint32
+  QuiltSizeOffset = 16,          // int32[2]
+  QuiltTilesOffset = 24,         // int32[2]
+  TileSizeOffset = 32,           // int32[2]
+  NumberOfComponentsOffset = 40, // int32
+  CompressionOffset = 44,        // uint32
+  AspectRatioOffset = 48,        // double
+  ViewAngleOffset = 56,          // double
+  FrameRateOffset = 64,          // double
+  NumberOfFramesOffset = 72,     // uint64
+  IndexOffsetOffset = 80,        // uint64
+  DeviceTypeOffset = 88          // char[DeviceTypeLength]
+};
+
+// how a chunk is encoded
+enum Codecs
+{
+  RawCodec = 0,
+  LZ4Codec = 1,
+  DisparityLZ4Codec = 2 // since version 2
+};
+
+// size of the disparity stored before the residual of a DisparityLZ4Codec chunk
+const vtkTypeUInt32 DisparitySize = 2;
+
+template <typename T>
+void Put(unsigned char* buffer, vtkTypeUInt32 offset, const T& value)
+{
+  std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T Get(const unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  T value;
+  std::memcpy(&value, buffer + offset, sizeof(T));
+  return value;
+}
+
+// the pixel of the reference tile that predicts pixel x of a tile, the
+// reference is shifted by the disparity and its border columns repeated
+inline int PredictorColumn(int x, int disparity, int width)
+{
+  int column = x + disparity;
+  return column < 0 ? 0 : (column >= width ? width - 1 : column);
+}
+
+// residual = tile - shifted reference, for tightly packed RGB tiles
+inline void SubtractPrediction(const unsigned char* reference, const unsigned char* tile,
+  unsigned char* residual, int width, int height, int disparity)
+{
+  for (int y = 0; y < height; ++y)
+  {
+    const size_t row = static_cast<size_t>(y) * width * 3;
+    for (int x = 0; x < width; ++x)
+    {
+      const size_t i = row + x * 3;
+      const size_t j = row + PredictorColumn(x, disparity, width) * 3;
+      residual[i] = static_cast<unsigned char>(tile[i] - reference[j]);
+      residual[i + 1] = static_cast<unsigned char>(tile[i + 1] - reference[j + 1]);
+      residual[i + 2] = static_cast<unsigned char>(tile[i + 2] - reference[j + 2]);
+    }
+  }
+}
+
+// tile = residual + shifted reference, in place
+inline void AddPrediction(
+  const unsigned char* reference, unsigned char* tile, int width, int height, int disparity)
+{
+  for (int y = 0; y < height; ++y)
+  {
+    const size_t row = static_cast<size_t>(y) * width * 3;
+    for (int x = 0; x < width; ++x)
+    {
+      const size_t i = row + x * 3;
+      const size_t j = row + PredictorColumn(x, disparity, width) * 3;
+      tile[i] = static_cast<unsigned char>(tile[i] + reference[j]);
+      tile[i + 1] = static_cast<unsigned char>(tile[i + 1] + reference[j + 1]);
+      tile[i + 2] = static_cast<unsigned char>(tile[i + 2] + reference[j + 2]);
+    }
+  }
+}
+}
+
+#endif
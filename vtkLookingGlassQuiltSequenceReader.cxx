@@ -0,0 +1,396 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltSequenceReader.h"
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltSequenceFormat.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include "vtk_lz4.h"
+#include <vtksys/Encoding.hxx>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace format = vtkLookingGlassQuiltSequenceFormat;
+
+vtkStandardNewMacro(vtkLookingGlassQuiltSequenceReader);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltSequenceReader::vtkLookingGlassQuiltSequenceReader()
+  : FileName(nullptr)
+  , NumberOfFrames(0)
+  , AspectRatio(0.0)
+  , ViewAngle(0.0)
+  , FrameRate(0.0)
+  , Data(nullptr)
+  , DataSize(0)
+  , ChunkIndex(nullptr)
+  , MappingHandle(nullptr)
+{
+  for (int i = 0; i < 2; ++i)
+  {
+    this->QuiltSize[i] = 0;
+    this->QuiltTiles[i] = 0;
+    this->TileSize[i] = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltSequenceReader::~vtkLookingGlassQuiltSequenceReader()
+{
+  this->Close();
+  this->SetFileName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltSequenceReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "QuiltSize: " << this->QuiltSize[0] << "x" << this->QuiltSize[1] << "\n";
+  os << indent << "QuiltTiles: " << this->QuiltTiles[0] << "x" << this->QuiltTiles[1] << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+  os << indent << "DeviceType: " << this->DeviceType << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceReader::Open()
+{
+  this->Close();
+  if (!this->FileName)
+  {
+    vtkErrorMacro("No file name set");
+    return false;
+  }
+
+#ifdef _WIN32
+  HANDLE file = CreateFileW(vtksys::Encoding::ToWide(this->FileName).c_str(), GENERIC_READ,
+    FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    vtkErrorMacro("Unable to open " << this->FileName);
+    return false;
+  }
+  LARGE_INTEGER size;
+  GetFileSizeEx(file, &size);
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping)
+  {
+    vtkErrorMacro("Unable to map " << this->FileName);
+    return false;
+  }
+  this->Data =
+    static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  this->MappingHandle = mapping;
+  this->DataSize = static_cast<vtkTypeUInt64>(size.QuadPart);
+#else
+  int fd = open(this->FileName, O_RDONLY);
+  if (fd < 0)
+  {
+    vtkErrorMacro("Unable to open " << this->FileName);
+    return false;
+  }
+  struct stat info;
+  fstat(fd, &info);
+  void* data = info.st_size > 0
+    ? mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0)
+    : MAP_FAILED;
+  close(fd);
+  this->Data = data == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(data);
+  this->DataSize = static_cast<vtkTypeUInt64>(info.st_size);
+#endif
+
+  vtkTypeUInt32 version = this->Data && this->DataSize >= format::HeaderSize
+    ? format::Get<vtkTypeUInt32>(this->Data, format::VersionOffset)
+    : 0;
+  if (!this->Data || this->DataSize < format::HeaderSize ||
+    std::memcmp(this->Data, format::Magic, sizeof(format::Magic)) != 0 || version == 0 ||
+    version > format::Version)
+  {
+    vtkErrorMacro(<< this->FileName << " is not a quilt sequence file");
+    this->Close();
+    return false;
+  }
+
+  const unsigned char* header = this->Data;
+  bool valid = true;
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkTypeUInt32 step = static_cast<vtkTypeUInt32>(i * sizeof(vtkTypeInt32));
+    this->QuiltSize[i] = format::Get<vtkTypeInt32>(header, format::QuiltSizeOffset + step);
+    this->QuiltTiles[i] = format::Get<vtkTypeInt32>(header, format::QuiltTilesOffset + step);
+    this->TileSize[i] = format::Get<vtkTypeInt32>(header, format::TileSizeOffset + step);
+    // the writer splits the quilt into tiles of this size, so they fit in it
+    valid = valid && this->QuiltTiles[i] > 0 && this->TileSize[i] > 0 &&
+      this->QuiltSize[i] / this->QuiltTiles[i] == this->TileSize[i];
+  }
+  this->AspectRatio = format::Get<double>(header, format::AspectRatioOffset);
+  this->ViewAngle = format::Get<double>(header, format::ViewAngleOffset);
+  this->FrameRate = format::Get<double>(header, format::FrameRateOffset);
+  vtkTypeUInt64 numberOfFrames = format::Get<vtkTypeUInt64>(header, format::NumberOfFramesOffset);
+  const char* deviceType = reinterpret_cast<const char*>(header + format::DeviceTypeOffset);
+  this->DeviceType.assign(deviceType, strnlen(deviceType, format::DeviceTypeLength));
+
+  // tiles are decoded with LZ4, which counts their bytes in an int
+  const vtkTypeInt64 numberOfTiles =
+    valid ? static_cast<vtkTypeInt64>(this->QuiltTiles[0]) * this->QuiltTiles[1] : 0;
+  const vtkTypeInt64 tileBytes =
+    valid ? static_cast<vtkTypeInt64>(this->TileSize[0]) * this->TileSize[1] * 3 : 0;
+  if (!valid || numberOfTiles > VTK_INT_MAX || tileBytes > VTK_INT_MAX ||
+    numberOfFrames > static_cast<vtkTypeUInt64>(VTK_INT_MAX))
+  {
+    vtkErrorMacro(<< this->FileName << " has a corrupt header");
+    this->Close();
+    return false;
+  }
+  this->NumberOfFrames = static_cast<int>(numberOfFrames);
+
+  // the index must lie within the file, compared without overflowing
+  vtkTypeUInt64 indexOffset = format::Get<vtkTypeUInt64>(header, format::IndexOffsetOffset);
+  if (indexOffset == 0 || indexOffset > this->DataSize ||
+    numberOfFrames > (this->DataSize - indexOffset) / format::ChunkEntrySize /
+        static_cast<vtkTypeUInt64>(numberOfTiles))
+  {
+    // End() was never called on the writer
+    vtkErrorMacro(<< this->FileName << " is incomplete");
+    this->Close();
+    return false;
+  }
+  this->ChunkIndex = this->Data + indexOffset;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltSequenceReader::Close()
+{
+  if (this->Data)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(this->Data);
+#else
+    munmap(const_cast<unsigned char*>(this->Data), static_cast<size_t>(this->DataSize));
+#endif
+  }
+#ifdef _WIN32
+  if (this->MappingHandle)
+  {
+    CloseHandle(static_cast<HANDLE>(this->MappingHandle));
+  }
+#endif
+  this->Data = nullptr;
+  this->DataSize = 0;
+  this->ChunkIndex = nullptr;
+  this->MappingHandle = nullptr;
+  this->NumberOfFrames = 0;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt32 vtkLookingGlassQuiltSequenceReader::GetChunkCodec(int frame, int tile) const
+{
+  const int numberOfTiles = this->QuiltTiles[0] * this->QuiltTiles[1];
+  const unsigned char* entry = this->ChunkIndex +
+    (static_cast<vtkTypeUInt64>(frame) * numberOfTiles + tile) * format::ChunkEntrySize;
+  return format::Get<vtkTypeUInt32>(entry, 12);
+}
+
+//------------------------------------------------------------------------------
+const unsigned char* vtkLookingGlassQuiltSequenceReader::GetChunk(
+  int frame, int tile, vtkTypeUInt32& size, vtkTypeUInt32& codec) const
+{
+  const int numberOfTiles = this->QuiltTiles[0] * this->QuiltTiles[1];
+  if (!this->Data || frame < 0 || frame >= this->NumberOfFrames || tile < 0 ||
+    tile >= numberOfTiles)
+  {
+    return nullptr;
+  }
+
+  const unsigned char* entry = this->ChunkIndex +
+    (static_cast<vtkTypeUInt64>(frame) * numberOfTiles + tile) * format::ChunkEntrySize;
+  vtkTypeUInt64 offset = format::Get<vtkTypeUInt64>(entry, 0);
+  size = format::Get<vtkTypeUInt32>(entry, 8);
+  codec = format::Get<vtkTypeUInt32>(entry, 12);
+  return offset <= this->DataSize && size <= this->DataSize - offset ? this->Data + offset
+                                                                     : nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceReader::DecodeChunk(
+  int frame, int tile, const unsigned char* reference, unsigned char* pixels)
+{
+  vtkTypeUInt32 size;
+  vtkTypeUInt32 codec;
+  const unsigned char* chunk = this->GetChunk(frame, tile, size, codec);
+  if (!chunk)
+  {
+    return false;
+  }
+
+  const int tileBytes = this->TileSize[0] * this->TileSize[1] * 3;
+  switch (codec)
+  {
+    case format::RawCodec:
+      if (size != static_cast<vtkTypeUInt32>(tileBytes))
+      {
+        return false;
+      }
+      std::memcpy(pixels, chunk, tileBytes);
+      return true;
+    case format::LZ4Codec:
+      return LZ4_decompress_safe(reinterpret_cast<const char*>(chunk),
+               reinterpret_cast<char*>(pixels), static_cast<int>(size), tileBytes) == tileBytes;
+    case format::DisparityLZ4Codec:
+    {
+      if (!reference || size < format::DisparitySize)
+      {
+        return false;
+      }
+      int disparity = format::Get<vtkTypeInt16>(chunk, 0);
+      if (LZ4_decompress_safe(reinterpret_cast<const char*>(chunk + format::DisparitySize),
+            reinterpret_cast<char*>(pixels), static_cast<int>(size - format::DisparitySize),
+            tileBytes) != tileBytes)
+      {
+        return false;
+      }
+      format::AddPrediction(reference, pixels, this->TileSize[0], this->TileSize[1], disparity);
+      return true;
+    }
+    default:
+      vtkErrorMacro("Unknown chunk codec " << codec);
+      return false;
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltSequenceReader::CopyTile(
+  const unsigned char* pixels, unsigned char* dest, vtkIdType rowStride) const
+{
+  const size_t tileRowBytes = static_cast<size_t>(this->TileSize[0]) * 3;
+  for (int y = 0; y < this->TileSize[1]; ++y)
+  {
+    std::memcpy(dest + y * rowStride, pixels + y * tileRowBytes, tileRowBytes);
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceReader::ReadTile(
+  int frame, int tile, unsigned char* dest, vtkIdType rowStride)
+{
+  const int numberOfTiles = this->QuiltTiles[0] * this->QuiltTiles[1];
+  if (!this->Data || frame < 0 || frame >= this->NumberOfFrames || tile < 0 ||
+    tile >= numberOfTiles)
+  {
+    return false;
+  }
+
+  // walk back to the start of the run of predicted tiles
+  int first = tile;
+  while (first > 0 && this->GetChunkCodec(frame, first) == format::DisparityLZ4Codec)
+  {
+    --first;
+  }
+
+  const size_t tileBytes = static_cast<size_t>(this->TileSize[0]) * this->TileSize[1] * 3;
+  std::vector<unsigned char> buffers[2];
+  buffers[0].resize(tileBytes);
+  buffers[1].resize(first < tile ? tileBytes : 0);
+  const unsigned char* reference = nullptr;
+  for (int t = first; t <= tile; ++t)
+  {
+    unsigned char* pixels = buffers[(t - first) % 2].data();
+    if (!this->DecodeChunk(frame, t, reference, pixels))
+    {
+      return false;
+    }
+    reference = pixels;
+  }
+
+  this->CopyTile(reference, dest, rowStride);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceReader::ReadFrame(int frame, vtkImageData* quilt)
+{
+  if (!this->Data || frame < 0 || frame >= this->NumberOfFrames)
+  {
+    vtkErrorMacro("Frame " << frame << " is not available");
+    return false;
+  }
+
+  int* dims = quilt->GetDimensions();
+  if (dims[0] != this->QuiltSize[0] || dims[1] != this->QuiltSize[1] ||
+    quilt->GetNumberOfScalarComponents() != 3 || quilt->GetScalarType() != VTK_UNSIGNED_CHAR)
+  {
+    quilt->SetDimensions(this->QuiltSize[0], this->QuiltSize[1], 1);
+    quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  }
+
+  // runs of predicted tiles are decoded in order, the runs in parallel
+  const int numberOfTiles = this->QuiltTiles[0] * this->QuiltTiles[1];
+  std::vector<int> runs;
+  for (int t = 0; t < numberOfTiles; ++t)
+  {
+    if (t == 0 || this->GetChunkCodec(frame, t) != format::DisparityLZ4Codec)
+    {
+      runs.push_back(t);
+    }
+  }
+  runs.push_back(numberOfTiles);
+
+  unsigned char* pixels = static_cast<unsigned char*>(quilt->GetScalarPointer());
+  const vtkIdType rowStride = static_cast<vtkIdType>(this->QuiltSize[0]) * 3;
+  const int columns = this->QuiltTiles[0];
+  const size_t tileBytes = static_cast<size_t>(this->TileSize[0]) * this->TileSize[1] * 3;
+  std::atomic<bool> ok(true);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(runs.size()) - 1, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<unsigned char> buffers[2] = { std::vector<unsigned char>(tileBytes),
+      std::vector<unsigned char>(tileBytes) };
+    for (vtkIdType run = begin; run < end; ++run)
+    {
+      const unsigned char* reference = nullptr;
+      for (int t = runs[run]; t < runs[run + 1]; ++t)
+      {
+        unsigned char* tilePixels = buffers[t % 2].data();
+        if (!this->DecodeChunk(frame, t, reference, tilePixels))
+        {
+          ok = false;
+          break;
+        }
+        unsigned char* dest = pixels +
+          static_cast<vtkIdType>(t / columns) * this->TileSize[1] * rowStride +
+          static_cast<vtkIdType>(t % columns) * this->TileSize[0] * 3;
+        this->CopyTile(tilePixels, dest, rowStride);
+        reference = tilePixels;
+      }
+    }
+  });
+
+  if (!ok)
+  {
+    vtkErrorMacro("Corrupt data in frame " << frame << " of " << this->FileName);
+  }
+  return ok;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltSequenceReader
+ * @brief   Random access to the quilts of a quilt sequence file.
+ *
+ * The file is memory mapped when it is opened, so reading a frame or a
+ * single tile only touches the chunks involved and no frame depends on
+ * another. This makes scrubbing through a recorded sequence or switching
+ * slides in a kiosk fast enough for 8K quilts.
+ *
+ * @sa
+ * vtkLookingGlassQuiltSequenceWriter
+ */
+
+#ifndef vtkLookingGlassQuiltSequenceReader_h
+#define vtkLookingGlassQuiltSequenceReader_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <string> // For std::string
+
+class vtkImageData;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltSequenceReader : public vtkObject
+{
+public:
+  static vtkLookingGlassQuiltSequenceReader* New();
+  vtkTypeMacro(vtkLookingGlassQuiltSequenceReader, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the name of the file to read.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  /**
+   * Map the file and read its header. Returns false if the file cannot be
+   * opened, is not a quilt sequence, or its header does not describe a
+   * layout and index that fit in the file.
+   */
+  bool Open();
+
+  /**
+   * Unmap the file.
+   */
+  void Close();
+
+  /**
+   * Check if a file is open.
+   */
+  bool IsOpen() const { return this->Data != nullptr; }
+
+  //@{
+  /**
+   * Get the settings stored in the header. Valid once the file is open.
+   */
+  vtkGetVector2Macro(QuiltSize, int);
+  vtkGetVector2Macro(QuiltTiles, int);
+  vtkGetVector2Macro(TileSize, int);
+  vtkGetMacro(NumberOfFrames, int);
+  vtkGetMacro(AspectRatio, double);
+  vtkGetMacro(ViewAngle, double);
+  vtkGetMacro(FrameRate, double);
+  std::string GetDeviceType() const { return this->DeviceType; }
+  //@}
+
+  /**
+   * Decode a whole frame into an image of QuiltSize with 3 unsigned char
+   * components. The tiles are decoded in parallel.
+   */
+  bool ReadFrame(int frame, vtkImageData* quilt);
+
+  /**
+   * Decode one tile of a frame into `dest`, whose rows are `rowStride` bytes
+   * apart. Tiles are stored with RGB components, bottom row first. Tiles that
+   * are predicted from the previous view are decoded along with the tiles
+   * they depend on.
+   */
+  bool ReadTile(int frame, int tile, unsigned char* dest, vtkIdType rowStride);
+
+  /**
+   * Get the encoded chunk of a tile as stored in the file, with its size and
+   * codec. Returns nullptr if the chunk lies outside of the file. The
+   * pointer is valid until the file is closed.
+   */
+  const unsigned char* GetChunk(
+    int frame, int tile, vtkTypeUInt32& size, vtkTypeUInt32& codec) const;
+
+protected:
+  vtkLookingGlassQuiltSequenceReader();
+  ~vtkLookingGlassQuiltSequenceReader() override;
+
+  // decode a chunk into a tightly packed tile, reference is the previous
+  // tile of the frame for predicted chunks
+  bool DecodeChunk(int frame, int tile, const unsigned char* reference, unsigned char* pixels);
+
+  // the codec of a chunk
+  vtkTypeUInt32 GetChunkCodec(int frame, int tile) const;
+
+  // copy a tightly packed tile into rows that are rowStride bytes apart
+  void CopyTile(const unsigned char* pixels, unsigned char* dest, vtkIdType rowStride) const;
+
+  char* FileName;
+  int QuiltSize[2];
+  int QuiltTiles[2];
+  int TileSize[2];
+  int NumberOfFrames;
+  double AspectRatio;
+  double ViewAngle;
+  double FrameRate;
+  std::string DeviceType;
+
+  // the mapped file
+  const unsigned char* Data;
+  vtkTypeUInt64 DataSize;
+  const unsigned char* ChunkIndex;
+  void* MappingHandle;
+
+private:
+  vtkLookingGlassQuiltSequenceReader(const vtkLookingGlassQuiltSequenceReader&) = delete;
+  void operator=(const vtkLookingGlassQuiltSequenceReader&) = delete;
+};
+
+#endif
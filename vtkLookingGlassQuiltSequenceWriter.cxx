@@ -0,0 +1,400 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltSequenceWriter.h"
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltSequenceFormat.h"
+#include "vtkLookingGlassQuiltSequenceReader.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include "vtk_lz4.h"
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace format = vtkLookingGlassQuiltSequenceFormat;
+
+namespace
+{
+// The horizontal shift of the reference tile that best predicts a tile, by
+// sum of absolute differences of the green channel over a subset of rows.
+// Only the columns that are predicted by the reference for every candidate
+// shift are compared, so that no candidate is favored by the border.
+int FindDisparity(const unsigned char* reference, const unsigned char* tile, int width,
+  int height, int maxDisparity)
+{
+  const int rowStep = std::max(1, height / 32);
+  const int x0 = maxDisparity;
+  const int x1 = width - maxDisparity;
+  int best = 0;
+  vtkTypeUInt64 bestCost = std::numeric_limits<vtkTypeUInt64>::max();
+  for (int d = -maxDisparity; d <= maxDisparity && x0 < x1; ++d)
+  {
+    vtkTypeUInt64 cost = 0;
+    for (int y = 0; y < height; y += rowStep)
+    {
+      const unsigned char* row = tile + static_cast<size_t>(y) * width * 3 + 1;
+      const unsigned char* ref = reference + static_cast<size_t>(y) * width * 3 + 1;
+      for (int x = x0; x < x1; ++x)
+      {
+        int diff = row[x * 3] - ref[(x + d) * 3];
+        cost += diff < 0 ? -diff : diff;
+      }
+    }
+    // prefer the smallest shift on ties, it is the common case of flat areas
+    if (cost < bestCost || (cost == bestCost && std::abs(d) < std::abs(best)))
+    {
+      bestCost = cost;
+      best = d;
+    }
+  }
+  return best;
+}
+}
+
+vtkStandardNewMacro(vtkLookingGlassQuiltSequenceWriter);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltSequenceWriter::vtkLookingGlassQuiltSequenceWriter()
+  : FileName(nullptr)
+  , AspectRatio(1.777)
+  , ViewAngle(30.0)
+  , FrameRate(30.0)
+  , Compression(DISPARITY_LZ4)
+  , MaximumDisparity(32)
+  , ViewGroupSize(9)
+  , NumberOfFrames(0)
+  , File(nullptr)
+  , Offset(0)
+{
+  this->QuiltTiles[0] = 5;
+  this->QuiltTiles[1] = 9;
+  this->QuiltSize[0] = 0;
+  this->QuiltSize[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltSequenceWriter::~vtkLookingGlassQuiltSequenceWriter()
+{
+  if (this->File)
+  {
+    this->End();
+  }
+  this->SetFileName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltSequenceWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "QuiltTiles: " << this->QuiltTiles[0] << "x" << this->QuiltTiles[1] << "\n";
+  os << indent << "DeviceType: " << this->DeviceType << "\n";
+  os << indent << "AspectRatio: " << this->AspectRatio << "\n";
+  os << indent << "ViewAngle: " << this->ViewAngle << "\n";
+  os << indent << "FrameRate: " << this->FrameRate << "\n";
+  os << indent << "Compression: " << this->Compression << "\n";
+  os << indent << "MaximumDisparity: " << this->MaximumDisparity << "\n";
+  os << indent << "ViewGroupSize: " << this->ViewGroupSize << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceWriter::Start()
+{
+  if (this->File)
+  {
+    vtkErrorMacro("Start() called while already writing");
+    return false;
+  }
+  if (!this->FileName)
+  {
+    vtkErrorMacro("No file name set");
+    return false;
+  }
+
+  this->File = vtksys::SystemTools::Fopen(this->FileName, "wb");
+  if (!this->File)
+  {
+    vtkErrorMacro("Unable to open " << this->FileName << " for writing");
+    return false;
+  }
+
+  this->QuiltSize[0] = 0;
+  this->QuiltSize[1] = 0;
+  this->NumberOfFrames = 0;
+  this->Index.clear();
+
+  // the header is written again with the final values by End()
+  if (!this->WriteHeader())
+  {
+    return false;
+  }
+  this->Offset = format::HeaderSize;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceWriter::WriteHeader()
+{
+  unsigned char header[format::HeaderSize] = {};
+  std::memcpy(header + format::MagicOffset, format::Magic, sizeof(format::Magic));
+  format::Put(header, format::VersionOffset, format::Version);
+  format::Put(header, format::HeaderSizeOffset, format::HeaderSize);
+  int tileSize[2] = { 0, 0 };
+  if (this->QuiltSize[0] > 0)
+  {
+    tileSize[0] = this->QuiltSize[0] / this->QuiltTiles[0];
+    tileSize[1] = this->QuiltSize[1] / this->QuiltTiles[1];
+  }
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkTypeUInt32 step = static_cast<vtkTypeUInt32>(i * sizeof(vtkTypeInt32));
+    format::Put(header, format::QuiltSizeOffset + step, vtkTypeInt32(this->QuiltSize[i]));
+    format::Put(header, format::QuiltTilesOffset + step, vtkTypeInt32(this->QuiltTiles[i]));
+    format::Put(header, format::TileSizeOffset + step, vtkTypeInt32(tileSize[i]));
+  }
+  format::Put(header, format::NumberOfComponentsOffset, vtkTypeInt32(3));
+  format::Put(header, format::CompressionOffset, vtkTypeUInt32(this->Compression));
+  format::Put(header, format::AspectRatioOffset, this->AspectRatio);
+  format::Put(header, format::ViewAngleOffset, this->ViewAngle);
+  format::Put(header, format::FrameRateOffset, this->FrameRate);
+  format::Put(header, format::NumberOfFramesOffset, vtkTypeUInt64(this->NumberOfFrames));
+  format::Put(header, format::IndexOffsetOffset, vtkTypeUInt64(0));
+  std::strncpy(reinterpret_cast<char*>(header + format::DeviceTypeOffset),
+    this->DeviceType.c_str(), format::DeviceTypeLength - 1);
+
+  if (fwrite(header, 1, format::HeaderSize, this->File) != format::HeaderSize)
+  {
+    vtkErrorMacro("Unable to write the header of " << this->FileName);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceWriter::Write(vtkImageData* quilt)
+{
+  if (!this->File)
+  {
+    vtkErrorMacro("Start() must be called before Write()");
+    return false;
+  }
+  if (!quilt || quilt->GetScalarType() != VTK_UNSIGNED_CHAR ||
+    quilt->GetNumberOfScalarComponents() != 3)
+  {
+    vtkErrorMacro("Quilts must have 3 unsigned char components");
+    return false;
+  }
+
+  int dims[3];
+  quilt->GetDimensions(dims);
+  if (this->NumberOfFrames == 0)
+  {
+    this->QuiltSize[0] = dims[0];
+    this->QuiltSize[1] = dims[1];
+  }
+  else if (dims[0] != this->QuiltSize[0] || dims[1] != this->QuiltSize[1])
+  {
+    vtkErrorMacro("All quilts of a sequence must have the same size");
+    return false;
+  }
+
+  const int tileSize[2] = { dims[0] / this->QuiltTiles[0], dims[1] / this->QuiltTiles[1] };
+  const int numberOfTiles = this->QuiltTiles[0] * this->QuiltTiles[1];
+  const size_t tileRowBytes = static_cast<size_t>(tileSize[0]) * 3;
+  const size_t tileBytes = tileRowBytes * tileSize[1];
+  const size_t quiltRowBytes = static_cast<size_t>(dims[0]) * 3;
+  const unsigned char* pixels = static_cast<unsigned char*>(quilt->GetScalarPointer());
+  const int compression = this->Compression;
+  const int columns = this->QuiltTiles[0];
+  const int groupSize = this->ViewGroupSize;
+  const int maxDisparity = this->MaximumDisparity;
+
+  // gather the tiles, predicted tiles need their reference tile as a whole
+  std::vector<std::vector<unsigned char>> tiles(numberOfTiles);
+  vtkSMPTools::For(0, numberOfTiles, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType t = begin; t < end; ++t)
+    {
+      const size_t x0 = static_cast<size_t>(t % columns) * tileRowBytes;
+      const size_t y0 = static_cast<size_t>(t / columns) * tileSize[1];
+      tiles[t].resize(tileBytes);
+      for (int y = 0; y < tileSize[1]; ++y)
+      {
+        std::memcpy(
+          tiles[t].data() + y * tileRowBytes, pixels + (y0 + y) * quiltRowBytes + x0, tileRowBytes);
+      }
+    }
+  });
+
+  // compress the tiles in parallel, they only read the original pixels
+  std::vector<std::vector<char>> chunks(numberOfTiles);
+  std::vector<vtkTypeUInt32> codecs(numberOfTiles, format::RawCodec);
+  vtkSMPTools::For(0, numberOfTiles, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<unsigned char> residual;
+    for (vtkIdType t = begin; t < end; ++t)
+    {
+      const std::vector<unsigned char>& tile = tiles[t];
+      std::vector<char>& chunk = chunks[t];
+      if (compression == NONE)
+      {
+        chunk.assign(tile.begin(), tile.end());
+        continue;
+      }
+
+      const int bound = LZ4_compressBound(static_cast<int>(tileBytes));
+      chunk.resize(bound);
+      int size = LZ4_compress_default(reinterpret_cast<const char*>(tile.data()), chunk.data(),
+        static_cast<int>(tileBytes), bound);
+      vtkTypeUInt32 codec = format::LZ4Codec;
+
+      if (compression == DISPARITY_LZ4 && t % groupSize != 0)
+      {
+        const int disparity = FindDisparity(tiles[t - 1].data(), tile.data(), tileSize[0],
+          tileSize[1], std::min(maxDisparity, tileSize[0] - 1));
+        residual.resize(tileBytes);
+        format::SubtractPrediction(
+          tiles[t - 1].data(), tile.data(), residual.data(), tileSize[0], tileSize[1], disparity);
+
+        std::vector<char> predicted(format::DisparitySize + bound);
+        format::Put(reinterpret_cast<unsigned char*>(predicted.data()), 0,
+          static_cast<vtkTypeInt16>(disparity));
+        int residualSize = LZ4_compress_default(reinterpret_cast<const char*>(residual.data()),
+          predicted.data() + format::DisparitySize, static_cast<int>(tileBytes), bound);
+        if (residualSize > 0 &&
+          (size <= 0 || residualSize + static_cast<int>(format::DisparitySize) < size))
+        {
+          size = residualSize + format::DisparitySize;
+          chunk.swap(predicted);
+          codec = format::DisparityLZ4Codec;
+        }
+      }
+
+      if (size > 0 && static_cast<size_t>(size) < tileBytes)
+      {
+        chunk.resize(size);
+        codecs[t] = codec;
+        continue;
+      }
+      // incompressible tiles are stored as they are
+      chunk.assign(tile.begin(), tile.end());
+    }
+  });
+
+  for (int t = 0; t < numberOfTiles; ++t)
+  {
+    const std::vector<char>& chunk = chunks[t];
+    if (fwrite(chunk.data(), 1, chunk.size(), this->File) != chunk.size())
+    {
+      vtkErrorMacro("Unable to write to " << this->FileName);
+      return false;
+    }
+    this->Index.push_back({ this->Offset, static_cast<vtkTypeUInt32>(chunk.size()), codecs[t] });
+    this->Offset += chunk.size();
+  }
+
+  ++this->NumberOfFrames;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceWriter::AppendSequence(const char* fileName)
+{
+  if (!this->File)
+  {
+    vtkErrorMacro("Start() must be called before AppendSequence()");
+    return false;
+  }
+
+  vtkNew<vtkLookingGlassQuiltSequenceReader> reader;
+  reader->SetFileName(fileName);
+  if (!reader->Open())
+  {
+    return false;
+  }
+
+  int* size = reader->GetQuiltSize();
+  int* tiles = reader->GetQuiltTiles();
+  const int frames = reader->GetNumberOfFrames();
+  if (tiles[0] != this->QuiltTiles[0] || tiles[1] != this->QuiltTiles[1] ||
+    (this->NumberOfFrames > 0 && frames > 0 &&
+      (size[0] != this->QuiltSize[0] || size[1] != this->QuiltSize[1])))
+  {
+    vtkErrorMacro(<< fileName << " does not have the quilt size and tiles of " << this->FileName);
+    return false;
+  }
+
+  // the chunks do not depend on other frames, they are copied as they are
+  const int numberOfTiles = tiles[0] * tiles[1];
+  for (int f = 0; f < frames; ++f)
+  {
+    for (int t = 0; t < numberOfTiles; ++t)
+    {
+      vtkTypeUInt32 chunkSize;
+      vtkTypeUInt32 codec;
+      const unsigned char* chunk = reader->GetChunk(f, t, chunkSize, codec);
+      if (!chunk || fwrite(chunk, 1, chunkSize, this->File) != chunkSize)
+      {
+        vtkErrorMacro("Unable to append " << fileName << " to " << this->FileName);
+        return false;
+      }
+      this->Index.push_back({ this->Offset, chunkSize, codec });
+      this->Offset += chunkSize;
+    }
+
+    if (this->NumberOfFrames == 0)
+    {
+      this->QuiltSize[0] = size[0];
+      this->QuiltSize[1] = size[1];
+    }
+    ++this->NumberOfFrames;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltSequenceWriter::End()
+{
+  if (!this->File)
+  {
+    return false;
+  }
+
+  bool ok = true;
+  vtkTypeUInt64 indexOffset = this->Offset;
+  for (const auto& chunk : this->Index)
+  {
+    unsigned char entry[format::ChunkEntrySize];
+    format::Put(entry, 0, chunk.Offset);
+    format::Put(entry, 8, chunk.Size);
+    format::Put(entry, 12, chunk.Codec);
+    ok = ok && fwrite(entry, 1, format::ChunkEntrySize, this->File) == format::ChunkEntrySize;
+  }
+
+  // rewrite the header now that the size, frame count and index are known
+  ok = ok && fseek(this->File, 0, SEEK_SET) == 0 && this->WriteHeader();
+  ok = ok && fseek(this->File, format::IndexOffsetOffset, SEEK_SET) == 0 &&
+    fwrite(&indexOffset, sizeof(indexOffset), 1, this->File) == 1;
+  ok = (fclose(this->File) == 0) && ok;
+  this->File = nullptr;
+  this->Index.clear();
+
+  if (!ok)
+  {
+    vtkErrorMacro("Error while finishing " << this->FileName);
+  }
+  return ok;
+}
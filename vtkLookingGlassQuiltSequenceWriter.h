@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltSequenceWriter
+ * @brief   Write quilts to a random access quilt sequence file.
+ *
+ * A quilt sequence file (".lgq") stores a series of quilts so that any
+ * frame, or any tile of a frame, can be read back without decoding the
+ * frames before it. The file starts with a header holding the device
+ * settings and the tile layout, followed by one independently compressed
+ * chunk per tile and frame, and ends with an index of the chunks.
+ *
+ * Use it like a movie writer: set the file name and settings, call Start(),
+ * Write() each quilt and End() to write the index.
+ *
+ * @sa
+ * vtkLookingGlassQuiltSequenceReader
+ */
+
+#ifndef vtkLookingGlassQuiltSequenceWriter_h
+#define vtkLookingGlassQuiltSequenceWriter_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <cstdio>  // For FILE
+#include <string>  // For std::string
+#include <vector>  // For std::vector
+
+class vtkImageData;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltSequenceWriter : public vtkObject
+{
+public:
+  static vtkLookingGlassQuiltSequenceWriter* New();
+  vtkTypeMacro(vtkLookingGlassQuiltSequenceWriter, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * How the tile chunks are stored. DISPARITY_LZ4 predicts each tile from
+   * the previous view shifted horizontally by the disparity that matches it
+   * best, and compresses the difference with LZ4. Neighboring views of a
+   * quilt differ mostly by such a shift, so this usually makes the files
+   * several times smaller than LZ4 alone, at the cost of decoding a run of
+   * tiles to read a single one. It is lossless like the others.
+   */
+  enum Compressions
+  {
+    NONE = 0,
+    LZ4 = 1,
+    DISPARITY_LZ4 = 2
+  };
+
+  //@{
+  /**
+   * Set/Get the name of the file to write.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of tiles of the quilts in X and Y. Default is 5x9.
+   */
+  vtkSetVector2Macro(QuiltTiles, int);
+  vtkGetVector2Macro(QuiltTiles, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the device type the quilts were rendered for, the aspect ratio
+   * of the views and the view cone in degrees. These are stored in the
+   * header for the reader.
+   */
+  vtkSetMacro(DeviceType, std::string);
+  vtkGetMacro(DeviceType, std::string);
+  vtkSetMacro(AspectRatio, double);
+  vtkGetMacro(AspectRatio, double);
+  vtkSetMacro(ViewAngle, double);
+  vtkGetMacro(ViewAngle, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the playback rate in frames per second. Default is 30.
+   */
+  vtkSetMacro(FrameRate, double);
+  vtkGetMacro(FrameRate, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the compression of the tile chunks. Default is DISPARITY_LZ4.
+   */
+  vtkSetClampMacro(Compression, int, NONE, DISPARITY_LZ4);
+  vtkGetMacro(Compression, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the largest disparity in pixels searched for when predicting a
+   * tile from the previous one with DISPARITY_LZ4. Default is 32.
+   */
+  vtkSetClampMacro(MaximumDisparity, int, 0, 1024);
+  vtkGetMacro(MaximumDisparity, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of tiles in a run of predicted tiles with
+   * DISPARITY_LZ4. The first tile of each run is compressed on its own, so
+   * smaller runs make single tiles faster to read and let more threads
+   * decode a frame, while larger runs compress better. Default is 9.
+   */
+  vtkSetClampMacro(ViewGroupSize, int, 1, 1024);
+  vtkGetMacro(ViewGroupSize, int);
+  //@}
+
+  /**
+   * Open the file and write the header. The quilt size is taken from the
+   * first frame.
+   */
+  bool Start();
+
+  /**
+   * Append a quilt to the file. The quilt must have 3 unsigned char
+   * components and the same size for every frame.
+   */
+  bool Write(vtkImageData* quilt);
+
+  /**
+   * Append all the frames of another quilt sequence file, copying their
+   * chunks without decoding them. The quilts of both must have the same
+   * size and tiles. This is how sequences recorded in pieces are joined.
+   */
+  bool AppendSequence(const char* fileName);
+
+  /**
+   * Write the chunk index and close the file.
+   */
+  bool End();
+
+  /**
+   * Check if Start() has been called without a matching End().
+   */
+  bool IsWriting() const { return this->File != nullptr; }
+
+  /**
+   * Get the number of frames written so far.
+   */
+  vtkGetMacro(NumberOfFrames, int);
+
+protected:
+  vtkLookingGlassQuiltSequenceWriter();
+  ~vtkLookingGlassQuiltSequenceWriter() override;
+
+  bool WriteHeader();
+
+  char* FileName;
+  int QuiltTiles[2];
+  std::string DeviceType;
+  double AspectRatio;
+  double ViewAngle;
+  double FrameRate;
+  int Compression;
+  int MaximumDisparity;
+  int ViewGroupSize;
+  int NumberOfFrames;
+
+  FILE* File;
+  int QuiltSize[2];
+  vtkTypeUInt64 Offset;
+
+  struct Chunk
+  {
+    vtkTypeUInt64 Offset;
+    vtkTypeUInt32 Size;
+    vtkTypeUInt32 Codec;
+  };
+  std::vector<Chunk> Index;
+
+private:
+  vtkLookingGlassQuiltSequenceWriter(const vtkLookingGlassQuiltSequenceWriter&) = delete;
+  void operator=(const vtkLookingGlassQuiltSequenceWriter&) = delete;
+};
+
+#endif
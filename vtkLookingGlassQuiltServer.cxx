@@ -0,0 +1,470 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltServer.h"
+
+#include "vtkClientSocket.h"
+#include "vtkImageData.h"
+#include "vtkLookingGlassQuiltStreamProtocol.h"
+#include "vtkObjectFactory.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+
+#include "vtk_lz4.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#define VTK_SHUT_RDWR SD_BOTH
+#else
+#include <sys/socket.h>
+#define VTK_SHUT_RDWR SHUT_RDWR
+#endif
+
+namespace protocol = vtkLookingGlassQuiltStreamProtocol;
+
+vtkStandardNewMacro(vtkLookingGlassQuiltServer);
+
+namespace
+{
+vtkTypeInt64 Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+// average blocks of scale x scale pixels, dropping partial blocks
+void Shrink(const unsigned char* in, int width, int height, int scale, unsigned char* out)
+{
+  const int outWidth = width / scale;
+  const int outHeight = height / scale;
+  const int area = scale * scale;
+  for (int y = 0; y < outHeight; ++y)
+  {
+    for (int x = 0; x < outWidth; ++x)
+    {
+      int sum[3] = { 0, 0, 0 };
+      for (int j = 0; j < scale; ++j)
+      {
+        const unsigned char* row =
+          in + (static_cast<size_t>(y * scale + j) * width + x * scale) * 3;
+        for (int i = 0; i < scale * 3; i += 3)
+        {
+          sum[0] += row[i];
+          sum[1] += row[i + 1];
+          sum[2] += row[i + 2];
+        }
+      }
+      unsigned char* pixel = out + (static_cast<size_t>(y) * outWidth + x) * 3;
+      for (int c = 0; c < 3; ++c)
+      {
+        pixel[c] = static_cast<unsigned char>((sum[c] + area / 2) / area);
+      }
+    }
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltServer::vtkLookingGlassQuiltServer()
+  : MaximumFramesInFlight(2)
+  , TargetLatency(0.1)
+  , MaximumScale(4)
+  , Compress(true)
+  , ServerSocket(nullptr)
+  , Socket(nullptr)
+  , Running(false)
+  , Pending(nullptr)
+  , FramesInFlight(0)
+  , FramesSent(0)
+  , FramesSkipped(0)
+  , Scale(1)
+  , LastLatency(0.0)
+  , AcksSinceScaleChange(0)
+{
+  this->QuiltTiles[0] = 5;
+  this->QuiltTiles[1] = 9;
+  this->ViewPortion[0] = 1.0f;
+  this->ViewPortion[1] = 1.0f;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltServer::~vtkLookingGlassQuiltServer()
+{
+  this->Close();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltServer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumFramesInFlight: " << this->MaximumFramesInFlight << "\n";
+  os << indent << "TargetLatency: " << this->TargetLatency << "\n";
+  os << indent << "MaximumScale: " << this->MaximumScale << "\n";
+  os << indent << "Compress: " << this->Compress << "\n";
+  os << indent << "QuiltTiles: " << this->QuiltTiles[0] << "x" << this->QuiltTiles[1] << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltServer::Listen(int port)
+{
+  this->Close();
+  this->ServerSocket = vtkServerSocket::New();
+  if (this->ServerSocket->CreateServer(port) != 0)
+  {
+    vtkErrorMacro("Unable to listen on port " << port);
+    this->ServerSocket->Delete();
+    this->ServerSocket = nullptr;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltServer::GetPort() const
+{
+  return this->ServerSocket ? this->ServerSocket->GetServerPort() : 0;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltServer::WaitForClient(double timeout)
+{
+  if (!this->ServerSocket || this->IsConnected())
+  {
+    return this->IsConnected();
+  }
+
+  vtkClientSocket* socket =
+    this->ServerSocket->WaitForConnection(static_cast<unsigned long>(timeout * 1000.0));
+  if (!socket)
+  {
+    return false;
+  }
+
+  if (this->Thread.joinable())
+  {
+    // the previous client went away
+    this->Thread.join();
+  }
+  if (this->Socket)
+  {
+    this->Socket->Delete();
+  }
+  this->Socket = socket;
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->Pending)
+  {
+    // queued for the previous client
+    this->Pending->Delete();
+    this->Pending = nullptr;
+  }
+  this->Running = true;
+  this->FramesInFlight = 0;
+  this->Scale = 1;
+  this->AcksSinceScaleChange = 0;
+  this->LastLatency = 0.0;
+  this->RecentLatencies.clear();
+  this->Thread = std::thread(&vtkLookingGlassQuiltServer::Run, this);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltServer::IsConnected() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Running;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltServer::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Running = false;
+    if (this->Pending)
+    {
+      this->Pending->Delete();
+      this->Pending = nullptr;
+    }
+  }
+  if (this->Socket)
+  {
+    // wake the sending thread up if it is blocked sending to a client that
+    // does not read
+    shutdown(this->Socket->GetSocketDescriptor(), VTK_SHUT_RDWR);
+  }
+  if (this->Thread.joinable())
+  {
+    this->Thread.join();
+  }
+  if (this->Socket)
+  {
+    this->Socket->CloseSocket();
+    this->Socket->Delete();
+    this->Socket = nullptr;
+  }
+  if (this->ServerSocket)
+  {
+    this->ServerSocket->CloseSocket();
+    this->ServerSocket->Delete();
+    this->ServerSocket = nullptr;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltServer::SendQuilt(vtkImageData* quilt)
+{
+  if (!quilt || quilt->GetScalarType() != VTK_UNSIGNED_CHAR ||
+    quilt->GetNumberOfScalarComponents() != 3)
+  {
+    vtkErrorMacro("Quilts must have 3 unsigned char components");
+    return false;
+  }
+  if (!this->IsConnected())
+  {
+    return false;
+  }
+
+  // copy outside of the lock, the sending thread may be busy compressing
+  vtkImageData* copy = vtkImageData::New();
+  copy->DeepCopy(quilt);
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->Pending)
+  {
+    // the client is behind, only the newest quilt is worth sending
+    this->Pending->Delete();
+    ++this->FramesSkipped;
+  }
+  this->Pending = copy;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltServer::Run()
+{
+  while (true)
+  {
+    // waiting for acknowledgements also paces the loop
+    if (!this->ReceiveAcks(1))
+    {
+      break;
+    }
+
+    vtkSmartPointer<vtkImageData> quilt;
+    int scale = 1;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (!this->Running)
+      {
+        return;
+      }
+      if (this->Pending && this->FramesInFlight < this->MaximumFramesInFlight)
+      {
+        quilt.TakeReference(this->Pending);
+        this->Pending = nullptr;
+        scale = this->Scale;
+        ++this->FramesInFlight;
+      }
+    }
+
+    if (quilt && !this->SendFrame(quilt, scale))
+    {
+      break;
+    }
+  }
+
+  // the client disconnected
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Running = false;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltServer::SendFrame(vtkImageData* quilt, int scale)
+{
+  int* dims = quilt->GetDimensions();
+  const unsigned char* pixels = static_cast<unsigned char*>(quilt->GetScalarPointer());
+  int size[2] = { dims[0], dims[1] };
+  std::vector<unsigned char> shrunk;
+  if (scale > 1)
+  {
+    size[0] = dims[0] / scale;
+    size[1] = dims[1] / scale;
+    shrunk.resize(static_cast<size_t>(size[0]) * size[1] * 3);
+    Shrink(pixels, dims[0], dims[1], scale, shrunk.data());
+    pixels = shrunk.data();
+  }
+
+  const int bytes = size[0] * size[1] * 3;
+  std::vector<char> compressed;
+  vtkTypeUInt32 codec = protocol::RawCodec;
+  const void* payload = pixels;
+  int payloadSize = bytes;
+  if (this->Compress)
+  {
+    compressed.resize(LZ4_compressBound(bytes));
+    int compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(pixels),
+      compressed.data(), bytes, static_cast<int>(compressed.size()));
+    if (compressedSize > 0 && compressedSize < bytes)
+    {
+      codec = protocol::LZ4Codec;
+      payload = compressed.data();
+      payloadSize = compressedSize;
+    }
+  }
+
+  unsigned char header[protocol::FrameHeaderSize] = {};
+  vtkTypeUInt64 frame;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    frame = ++this->FramesSent;
+  }
+  protocol::Put(header, protocol::FrameMagicOffset, protocol::FrameMagic);
+  protocol::Put(header, protocol::CodecOffset, codec);
+  protocol::Put(header, protocol::FrameIdOffset, frame);
+  protocol::Put(header, protocol::SendTimeOffset, Now());
+  protocol::Put(header, protocol::SizeOffset, vtkTypeInt32(size[0]));
+  protocol::Put(header, protocol::SizeOffset + 4, vtkTypeInt32(size[1]));
+  protocol::Put(header, protocol::QuiltTilesOffset, vtkTypeInt32(this->QuiltTiles[0]));
+  protocol::Put(header, protocol::QuiltTilesOffset + 4, vtkTypeInt32(this->QuiltTiles[1]));
+  protocol::Put(header, protocol::ScaleOffset, vtkTypeInt32(scale));
+  protocol::Put(header, protocol::PayloadSizeOffset, vtkTypeUInt32(payloadSize));
+  protocol::Put(header, protocol::ViewPortionOffset, this->ViewPortion[0]);
+  protocol::Put(header, protocol::ViewPortionOffset + 4, this->ViewPortion[1]);
+
+  return this->Socket->Send(header, protocol::FrameHeaderSize) &&
+    this->Socket->Send(payload, payloadSize);
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassQuiltServer::ReceiveAcks(unsigned long timeout)
+{
+  int descriptor = this->Socket->GetSocketDescriptor();
+  int selected = -1;
+  int result;
+  while ((result = vtkSocket::SelectSockets(&descriptor, 1, timeout, &selected)) == 1)
+  {
+    unsigned char ack[protocol::AckSize];
+    if (this->Socket->Receive(ack, protocol::AckSize) != static_cast<int>(protocol::AckSize) ||
+      protocol::Get<vtkTypeUInt32>(ack, protocol::AckMagicOffset) != protocol::AckMagic)
+    {
+      return false;
+    }
+
+    const vtkTypeUInt64 frame = protocol::Get<vtkTypeUInt64>(ack, protocol::AckFrameIdOffset);
+    const double latency =
+      (Now() - protocol::Get<vtkTypeInt64>(ack, protocol::AckSendTimeOffset)) * 1e-9;
+
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->FramesInFlight = std::max(0, this->FramesInFlight - 1);
+    this->LastLatency = latency;
+    this->Latencies.emplace_back(frame, latency);
+    if (this->Latencies.size() > 1000)
+    {
+      // nobody collects them
+      this->Latencies.erase(this->Latencies.begin());
+    }
+    this->RecentLatencies.push_back(latency);
+    if (this->RecentLatencies.size() > 30)
+    {
+      this->RecentLatencies.pop_front();
+    }
+    this->AdaptScale();
+
+    // drain whatever else arrived without waiting
+    timeout = 0;
+  }
+  return result == 0;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltServer::AdaptScale()
+{
+  // let a few frames go through at the current scale before judging it
+  if (++this->AcksSinceScaleChange < 10)
+  {
+    return;
+  }
+
+  const double average =
+    std::accumulate(this->RecentLatencies.begin(), this->RecentLatencies.end(), 0.0) /
+    this->RecentLatencies.size();
+  int scale = this->Scale;
+  if (average > this->TargetLatency && scale < this->MaximumScale)
+  {
+    scale = std::min(scale * 2, this->MaximumScale);
+  }
+  else if (average < this->TargetLatency / 3.0 && scale > 1)
+  {
+    scale /= 2;
+  }
+
+  if (scale != this->Scale)
+  {
+    this->Scale = scale;
+    this->AcksSinceScaleChange = 0;
+    this->RecentLatencies.clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkLookingGlassQuiltServer::GetNumberOfFramesSent()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->FramesSent;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkLookingGlassQuiltServer::GetNumberOfFramesSkipped()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->FramesSkipped;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltServer::GetCurrentScale()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Scale;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassQuiltServer::GetLastLatency()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->LastLatency;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassQuiltServer::GetAverageLatency()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->RecentLatencies.empty())
+  {
+    return 0.0;
+  }
+  return std::accumulate(this->RecentLatencies.begin(), this->RecentLatencies.end(), 0.0) /
+    this->RecentLatencies.size();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltServer::GetFrameLatencies(
+  std::vector<std::pair<vtkTypeUInt64, double>>& latencies)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  latencies.swap(this->Latencies);
+  this->Latencies.clear();
+}
@@ -0,0 +1,205 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltServer
+ * @brief   Stream rendered quilts to a vtkLookingGlassQuiltClient.
+ *
+ * This lets a powerful machine render the quilts while a lightweight
+ * machine that drives the Looking Glass only interlaces them. Quilts handed
+ * to SendQuilt() are compressed and sent by a background thread, so the
+ * render loop never waits for the network:
+ *
+ *  - at most MaximumFramesInFlight frames are sent without being
+ *    acknowledged by the client, newer quilts replace a quilt that is still
+ *    waiting to be sent, and the replaced quilts count as skipped frames
+ *  - the client acknowledges each frame once it is displayed, which gives
+ *    the end-to-end latency of every frame
+ *  - when the latency grows above TargetLatency the quilts are shrunk by a
+ *    factor of 2, up to MaximumScale, and grown back once the latency is
+ *    low again, which adapts the bit rate to the link
+ *
+ * Give the server to vtkLookingGlassInterface::SetQuiltServer() to send
+ * every rendered quilt, or call SendQuilt() directly.
+ *
+ * @sa
+ * vtkLookingGlassQuiltClient
+ */
+
+#ifndef vtkLookingGlassQuiltServer_h
+#define vtkLookingGlassQuiltServer_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <deque>   // For std::deque
+#include <mutex>   // For std::mutex
+#include <thread>  // For std::thread
+#include <utility> // For std::pair
+#include <vector>  // For std::vector
+
+class vtkClientSocket;
+class vtkImageData;
+class vtkServerSocket;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltServer : public vtkObject
+{
+public:
+  static vtkLookingGlassQuiltServer* New();
+  vtkTypeMacro(vtkLookingGlassQuiltServer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Listen for a client on the given port, 0 picks a free port. Returns
+   * false if the port cannot be opened.
+   */
+  bool Listen(int port);
+
+  /**
+   * Get the port the server listens on.
+   */
+  int GetPort() const;
+
+  /**
+   * Wait up to `timeout` seconds for a client to connect, and start sending
+   * it the quilts. Returns false if no client connected.
+   */
+  bool WaitForClient(double timeout);
+
+  /**
+   * Check if a client is connected.
+   */
+  bool IsConnected() const;
+
+  /**
+   * Disconnect the client and stop listening.
+   */
+  void Close();
+
+  //@{
+  /**
+   * Set/Get the number of frames that may be sent before the client
+   * acknowledged them. Default is 2.
+   */
+  vtkSetClampMacro(MaximumFramesInFlight, int, 1, 16);
+  vtkGetMacro(MaximumFramesInFlight, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the latency in seconds above which the quilts are shrunk.
+   * Default is 0.1.
+   */
+  vtkSetMacro(TargetLatency, double);
+  vtkGetMacro(TargetLatency, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the largest factor the quilts may be shrunk by, 1 disables the
+   * adaptation. Default is 4.
+   */
+  vtkSetClampMacro(MaximumScale, int, 1, 8);
+  vtkGetMacro(MaximumScale, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get whether the quilts are compressed with LZ4. Default is on.
+   */
+  vtkSetMacro(Compress, bool);
+  vtkGetMacro(Compress, bool);
+  vtkBooleanMacro(Compress, bool);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the tile layout sent with the quilts, and the part of the quilt
+   * covered by the tiles, see vtkLookingGlassInterface::DrawLightField().
+   */
+  vtkSetVector2Macro(QuiltTiles, int);
+  vtkGetVector2Macro(QuiltTiles, int);
+  vtkSetVector2Macro(ViewPortion, float);
+  vtkGetVector2Macro(ViewPortion, float);
+  //@}
+
+  /**
+   * Queue a quilt with 3 unsigned char components for sending. The quilt is
+   * copied. Returns false if no client is connected.
+   */
+  bool SendQuilt(vtkImageData* quilt);
+
+  /**
+   * Get the number of frames sent, and skipped because the client was
+   * behind.
+   */
+  vtkTypeUInt64 GetNumberOfFramesSent();
+  vtkTypeUInt64 GetNumberOfFramesSkipped();
+
+  /**
+   * Get the factor the quilts are currently shrunk by.
+   */
+  int GetCurrentScale();
+
+  /**
+   * Get the end-to-end latency in seconds of the last acknowledged frame,
+   * and the average over the last frames. 0 until a frame is acknowledged.
+   */
+  double GetLastLatency();
+  double GetAverageLatency();
+
+  /**
+   * Move the latency of each frame acknowledged since the last call into
+   * `latencies`, as pairs of frame number and latency in seconds. Only the
+   * last 1000 are kept between calls.
+   */
+  void GetFrameLatencies(std::vector<std::pair<vtkTypeUInt64, double>>& latencies);
+
+protected:
+  vtkLookingGlassQuiltServer();
+  ~vtkLookingGlassQuiltServer() override;
+
+  // the body of the sending thread
+  void Run();
+  bool SendFrame(vtkImageData* quilt, int scale);
+  bool ReceiveAcks(unsigned long timeout);
+  void AdaptScale();
+
+  int MaximumFramesInFlight;
+  double TargetLatency;
+  int MaximumScale;
+  bool Compress;
+  int QuiltTiles[2];
+  float ViewPortion[2];
+
+  vtkServerSocket* ServerSocket;
+  vtkClientSocket* Socket;
+  std::thread Thread;
+
+  // shared with the sending thread
+  mutable std::mutex Mutex;
+  bool Running;
+  vtkImageData* Pending;
+  int FramesInFlight;
+  vtkTypeUInt64 FramesSent;
+  vtkTypeUInt64 FramesSkipped;
+  int Scale;
+  double LastLatency;
+  std::deque<double> RecentLatencies;
+  std::vector<std::pair<vtkTypeUInt64, double>> Latencies;
+  int AcksSinceScaleChange;
+
+private:
+  vtkLookingGlassQuiltServer(const vtkLookingGlassQuiltServer&) = delete;
+  void operator=(const vtkLookingGlassQuiltServer&) = delete;
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassQuiltSource.h"
+
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+
+vtkStandardNewMacro(vtkLookingGlassQuiltSource);
+vtkCxxSetObjectMacro(vtkLookingGlassQuiltSource, Interface, vtkLookingGlassInterface);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltSource::vtkLookingGlassQuiltSource()
+  : Interface(nullptr)
+  , Layout(QUILT)
+  , QuiltNumber(0)
+  , LastRenderCount(0)
+  , Pixels(vtkUnsignedCharArray::New())
+{
+  this->SetNumberOfInputPorts(0);
+  this->Pixels->SetName("Quilt");
+  this->Pixels->SetNumberOfComponents(3);
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassQuiltSource::~vtkLookingGlassQuiltSource()
+{
+  this->SetInterface(nullptr);
+  this->Pixels->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltSource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Interface: " << this->Interface << "\n";
+  os << indent << "Layout: " << (this->Layout == TILES ? "Tiles" : "Quilt") << "\n";
+  os << indent << "QuiltNumber: " << this->QuiltNumber << "\n";
+}
+
+//------------------------------------------------------------------------------
+vtkMTimeType vtkLookingGlassQuiltSource::GetMTime()
+{
+  vtkMTimeType mtime = this->Superclass::GetMTime();
+  if (!this->Interface)
+  {
+    return mtime;
+  }
+
+  // the first time a new quilt is seen marks when it became available, so
+  // that updates between renders do not read the same quilt again
+  vtkTypeUInt64 count = this->Interface->GetQuiltRenderCount();
+  if (count != this->LastRenderCount)
+  {
+    this->LastRenderCount = count;
+    this->RenderTime.Modified();
+  }
+  return std::max(mtime, this->RenderTime.GetMTime());
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassQuiltSource::GetOutputSize(int size[2])
+{
+  if (this->Layout == TILES)
+  {
+    this->Interface->GetRenderSize(size);
+    size[1] *= this->Interface->GetNumberOfTiles();
+  }
+  else
+  {
+    this->Interface->GetQuiltTextureSize(size);
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltSource::RequestInformation(
+  vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector)
+{
+  if (!this->Interface)
+  {
+    vtkErrorMacro("No interface is set");
+    return 0;
+  }
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  int size[2];
+  this->GetOutputSize(size);
+  int extent[6] = { 0, size[0] - 1, 0, size[1] - 1, 0, 0 };
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 3);
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassQuiltSource::RequestData(
+  vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector)
+{
+  vtkImageData* output = vtkImageData::GetData(outputVector);
+
+  if (this->Interface->GetQuiltRenderCount() == 0)
+  {
+    vtkErrorMacro("The quilt must be rendered before it can be read");
+    return 0;
+  }
+
+  // the pipeline clears the output before each update, give it the same
+  // scalars again so that the quilt is read over the previous one
+  int size[2];
+  this->GetOutputSize(size);
+  output->SetExtent(0, size[0] - 1, 0, size[1] - 1, 0, 0);
+  const vtkIdType numberOfPixels = static_cast<vtkIdType>(size[0]) * size[1];
+  if (this->Pixels->GetNumberOfTuples() != numberOfPixels)
+  {
+    this->Pixels->SetNumberOfTuples(numberOfPixels);
+  }
+  output->GetPointData()->SetScalars(this->Pixels);
+
+  if (this->Layout == TILES)
+  {
+    this->Interface->ReadQuiltTiles(output);
+  }
+  else
+  {
+    this->Interface->ReadQuilt(output);
+  }
+  this->Pixels->Modified();
+  this->QuiltNumber = this->Interface->GetQuiltRenderCount();
+
+  return 1;
+}
@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassQuiltSource
+ * @brief   Produce the last rendered quilt as a pipeline source.
+ *
+ * The output is a 3 component unsigned char image read back from the quilt
+ * texture of a vtkLookingGlassInterface, straight into the output scalars
+ * without an intermediate RGBA copy. The source is only modified when the
+ * interface renders a new quilt, so updating the pipeline between renders
+ * does not read the quilt again. Update() must be called after rendering,
+ * from the thread that renders, while the render window's context is
+ * current.
+ *
+ * The output scalars are kept from one update to the next and overwritten
+ * in place, unless the quilt size changes. Arrays that wrap them, such as
+ * NumPy arrays from vtkmodules.numpy_interface, see each new quilt without
+ * a copy.
+ *
+ * With the Layout set to TILES, the tiles are stacked on top of each other
+ * in the output so that each one is contiguous, and the scalars can be
+ * viewed as an array of NumberOfTiles x height x width x 3.
+ * vtkmodules.lookingglass.quilt_array() returns such views.
+ *
+ * @sa
+ * vtkLookingGlassInterface
+ */
+
+#ifndef vtkLookingGlassQuiltSource_h
+#define vtkLookingGlassQuiltSource_h
+
+#include "vtkImageAlgorithm.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+class vtkLookingGlassInterface;
+class vtkUnsignedCharArray;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassQuiltSource : public vtkImageAlgorithm
+{
+public:
+  static vtkLookingGlassQuiltSource* New();
+  vtkTypeMacro(vtkLookingGlassQuiltSource, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the interface whose quilt is read.
+   */
+  void SetInterface(vtkLookingGlassInterface*);
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+  //@}
+
+  /**
+   * Layouts of the output image.
+   */
+  enum Layouts
+  {
+    QUILT = 0,
+    TILES
+  };
+
+  //@{
+  /**
+   * Set/Get the layout of the output image. QUILT, the default, produces the
+   * quilt texture as it is. TILES stacks the tiles vertically, tile 0 at the
+   * bottom, see vtkLookingGlassInterface::ReadQuiltTiles().
+   */
+  vtkSetClampMacro(Layout, int, QUILT, TILES);
+  vtkGetMacro(Layout, int);
+  void SetLayoutToQuilt() { this->SetLayout(QUILT); }
+  void SetLayoutToTiles() { this->SetLayout(TILES); }
+  //@}
+
+  /**
+   * Get the number of the quilt held by the output, as counted by
+   * vtkLookingGlassInterface::GetQuiltRenderCount(), or 0 before the first
+   * update.
+   */
+  vtkGetMacro(QuiltNumber, vtkTypeUInt64);
+
+  /**
+   * The modification time includes the last quilt rendered by the interface.
+   */
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkLookingGlassQuiltSource();
+  ~vtkLookingGlassQuiltSource() override;
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  // the size of the output for the current layout
+  void GetOutputSize(int size[2]);
+
+  vtkLookingGlassInterface* Interface;
+  int Layout;
+  vtkTypeUInt64 QuiltNumber;
+
+  // the render count seen by GetMTime() and when it was first seen
+  vtkTypeUInt64 LastRenderCount;
+  vtkTimeStamp RenderTime;
+
+  // the output scalars, reused from one update to the next
+  vtkUnsignedCharArray* Pixels;
+
+private:
+  vtkLookingGlassQuiltSource(const vtkLookingGlassQuiltSource&) = delete;
+  void operator=(const vtkLookingGlassQuiltSource&) = delete;
+};
+
+#endif
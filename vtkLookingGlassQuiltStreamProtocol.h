@@ -0,0 +1,82 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Messages exchanged by vtkLookingGlassQuiltServer and
+ * vtkLookingGlassQuiltClient. All values are little endian.
+ *
+ * The server sends a FrameHeaderSize byte frame header, with the fields at
+ * the Frame offsets, followed by PayloadSize bytes of RGB pixels, bottom
+ * row first, encoded with the given codec.
+ *
+ * Once a frame is displayed, the client sends back an AckSize byte
+ * acknowledgement with the fields at the Ack offsets. It echoes the send
+ * time of the frame, so the server measures the latency on its own clock.
+ */
+
+#ifndef vtkLookingGlassQuiltStreamProtocol_h
+#define vtkLookingGlassQuiltStreamProtocol_h
+
+#include "vtkType.h"
+
+#include <cstring>
+
+namespace vtkLookingGlassQuiltStreamProtocol
+{
+const vtkTypeUInt32 FrameMagic = 0x46514c47; // "GLQF"
+const vtkTypeUInt32 AckMagic = 0x41514c47;   // "GLQA"
+const vtkTypeUInt32 FrameHeaderSize = 64;
+const vtkTypeUInt32 AckSize = 24;
+
+// field offsets in the frame header
+enum Frame
+{
+  FrameMagicOffset = 0,   // uint32
+  CodecOffset = 4,        // uint32
+  FrameIdOffset = 8,      // uint64
+  SendTimeOffset = 16,    // int64, nanoseconds on the server clock
+  SizeOffset = 24,        // int32[2], size of the encoded image
+  QuiltTilesOffset = 32,  // int32[2]
+  ScaleOffset = 40,       // int32, the image is the quilt shrunk by this factor
+  PayloadSizeOffset = 44, // uint32
+  ViewPortionOffset = 48  // float[2], part of the image covered by the tiles
+};
+
+// field offsets in the acknowledgement
+enum Ack
+{
+  AckMagicOffset = 0,     // uint32
+  AckFrameIdOffset = 8,   // uint64
+  AckSendTimeOffset = 16  // int64, echo of the frame send time
+};
+
+enum Codecs
+{
+  RawCodec = 0,
+  LZ4Codec = 1
+};
+
+template <typename T>
+void Put(unsigned char* buffer, vtkTypeUInt32 offset, const T& value)
+{
+  std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T Get(const unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  T value;
+  std::memcpy(&value, buffer + offset, sizeof(T));
+  return value;
+}
+}
+
+#endif
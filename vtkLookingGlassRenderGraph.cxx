@@ -0,0 +1,463 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassRenderGraph.h"
+
+#include "vtkOpenGLFramebufferObject.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkOpenGLState.h"
+
+#include <algorithm>
+#include <initializer_list>
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassRenderGraph::TargetDescription::operator==(
+  const TargetDescription& other) const
+{
+  return this->Size[0] == other.Size[0] && this->Size[1] == other.Size[1] &&
+    this->DepthBits == other.DepthBits && this->Samples == other.Samples &&
+    this->Stencil == other.Stencil;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassRenderGraph::~vtkLookingGlassRenderGraph()
+{
+  this->ReleaseGraphicsResources(nullptr);
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassRenderGraph::CreateTarget(
+  const std::string& name, const TargetDescription& description)
+{
+  Resource resource;
+  resource.Name = name;
+  resource.Transient = true;
+  resource.Description = description;
+  this->Resources.push_back(resource);
+  return static_cast<int>(this->Resources.size()) - 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassRenderGraph::ImportTarget(
+  const std::string& name, vtkOpenGLFramebufferObject* framebuffer)
+{
+  Resource resource;
+  resource.Name = name;
+  resource.Framebuffer = framebuffer;
+  this->Resources.push_back(resource);
+  return static_cast<int>(this->Resources.size()) - 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassRenderGraph::CreateResource(const std::string& name)
+{
+  Resource resource;
+  resource.Name = name;
+  this->Resources.push_back(resource);
+  return static_cast<int>(this->Resources.size()) - 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassRenderGraph::MarkOutput(int resource)
+{
+  this->Resources[resource].Output = true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassRenderGraph::AddPass(const std::string& name, PassKind kind,
+  const std::vector<int>& reads, const std::vector<int>& writes, std::function<void()> execute)
+{
+  Pass pass;
+  pass.Name = name;
+  pass.Kind = kind;
+  pass.Reads = reads;
+  pass.Writes = writes;
+  pass.Execute = execute;
+  this->Passes.push_back(pass);
+}
+
+//------------------------------------------------------------------------------
+vtkOpenGLFramebufferObject* vtkLookingGlassRenderGraph::GetFramebuffer(int resource) const
+{
+  const Resource& r = this->Resources[resource];
+  if (r.Transient)
+  {
+    return r.PoolIndex >= 0 ? this->Pool[r.PoolIndex].Framebuffer.GetPointer() : nullptr;
+  }
+  return r.Framebuffer;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassRenderGraph::Execute(vtkOpenGLRenderWindow* rw)
+{
+  ++this->ExecutionCount;
+  this->ExecutedPasses.clear();
+  this->NumberOfCulledPasses = 0;
+  const size_t numberOfPasses = this->Passes.size();
+  const size_t numberOfResources = this->Resources.size();
+
+  // Passes are added in a valid order, a resource is read as written by the
+  // passes added before, so every dependency points to a later pass. A pass
+  // depends on the last pass that wrote what it reads or writes, and on the
+  // passes that read what it overwrites.
+  std::vector<std::vector<size_t>> successors(numberOfPasses);
+  std::vector<int> lastWriter(numberOfResources, -1);
+  std::vector<std::vector<size_t>> readers(numberOfResources);
+  auto addDependency = [&](int from, size_t to) {
+    if (from >= 0 && static_cast<size_t>(from) != to)
+    {
+      successors[from].push_back(to);
+    }
+  };
+  for (size_t p = 0; p < numberOfPasses; ++p)
+  {
+    for (int r : this->Passes[p].Reads)
+    {
+      addDependency(lastWriter[r], p);
+      readers[r].push_back(p);
+    }
+    for (int r : this->Passes[p].Writes)
+    {
+      addDependency(lastWriter[r], p);
+      for (size_t reader : readers[r])
+      {
+        addDependency(static_cast<int>(reader), p);
+      }
+      readers[r].clear();
+      lastWriter[r] = static_cast<int>(p);
+    }
+  }
+
+  // Keep the passes that write an output or a resource read by a kept pass.
+  // A pass that writes a resource without reading it replaces its content,
+  // the passes that wrote it before are only needed for their other writes.
+  std::vector<bool> needed(numberOfResources, false);
+  for (size_t r = 0; r < numberOfResources; ++r)
+  {
+    needed[r] = this->Resources[r].Output;
+  }
+  std::vector<bool> kept(numberOfPasses, false);
+  for (size_t p = numberOfPasses; p-- > 0;)
+  {
+    const Pass& pass = this->Passes[p];
+    kept[p] = std::any_of(pass.Writes.begin(), pass.Writes.end(), [&](int r) { return needed[r]; });
+    if (!kept[p])
+    {
+      ++this->NumberOfCulledPasses;
+      continue;
+    }
+    for (int r : pass.Writes)
+    {
+      needed[r] = false;
+    }
+    for (int r : pass.Reads)
+    {
+      needed[r] = true;
+    }
+  }
+
+  // the resources each kept pass uses, and how many kept passes use them
+  std::vector<std::vector<int>> uses(numberOfPasses);
+  std::vector<int> users(numberOfResources, 0);
+  std::vector<int> pending(numberOfPasses, 0);
+  for (size_t p = 0; p < numberOfPasses; ++p)
+  {
+    if (!kept[p])
+    {
+      continue;
+    }
+    for (const std::vector<int>* list : { &this->Passes[p].Reads, &this->Passes[p].Writes })
+    {
+      for (int r : *list)
+      {
+        if (std::find(uses[p].begin(), uses[p].end(), r) == uses[p].end())
+        {
+          uses[p].push_back(r);
+          ++users[r];
+        }
+      }
+    }
+    for (size_t next : successors[p])
+    {
+      ++pending[next];
+    }
+  }
+
+  // Order the kept passes. Among the ready passes, the ones that finish a
+  // target already in use come first, so that its framebuffer is free
+  // before the next target needs one, then the ones of the lowest kind, in
+  // the order they were added otherwise.
+  std::vector<bool> started(numberOfResources, false);
+  auto finishesTarget = [&](size_t p) {
+    return std::any_of(uses[p].begin(), uses[p].end(), [&](int r) {
+      return this->Resources[r].Transient && started[r] && users[r] == 1;
+    });
+  };
+  std::vector<size_t> order;
+  std::vector<bool> scheduled(numberOfPasses, false);
+  for (;;)
+  {
+    int best = -1;
+    bool bestFinishes = false;
+    for (size_t p = 0; p < numberOfPasses; ++p)
+    {
+      if (!kept[p] || scheduled[p] || pending[p] != 0)
+      {
+        continue;
+      }
+      const bool finishes = finishesTarget(p);
+      if (best < 0 || (finishes && !bestFinishes) ||
+        (finishes == bestFinishes && this->Passes[p].Kind < this->Passes[best].Kind))
+      {
+        best = static_cast<int>(p);
+        bestFinishes = finishes;
+      }
+    }
+    if (best < 0)
+    {
+      break;
+    }
+    scheduled[best] = true;
+    order.push_back(best);
+    for (int r : uses[best])
+    {
+      started[r] = true;
+      --users[r];
+    }
+    for (size_t next : successors[best])
+    {
+      --pending[next];
+    }
+  }
+
+  // the first and last use of each transient target
+  std::vector<int> firstUse(numberOfResources, -1);
+  std::vector<int> lastUse(numberOfResources, -1);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    for (int r : uses[order[i]])
+    {
+      if (firstUse[r] < 0)
+      {
+        firstUse[r] = static_cast<int>(i);
+      }
+      lastUse[r] = static_cast<int>(i);
+    }
+  }
+
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    Pass& pass = this->Passes[order[i]];
+
+    // the targets first used here take a free framebuffer of the pool
+    for (size_t r = 0; r < numberOfResources; ++r)
+    {
+      if (this->Resources[r].Transient && firstUse[r] == static_cast<int>(i))
+      {
+        std::vector<TargetDescription> later;
+        for (size_t l = 0; l < numberOfResources; ++l)
+        {
+          if (this->Resources[l].Transient && firstUse[l] > static_cast<int>(i))
+          {
+            later.push_back(this->Resources[l].Description);
+          }
+        }
+        Resource& target = this->Resources[r];
+        target.PoolIndex = this->AcquireEntry(rw, target.Description, later);
+      }
+    }
+
+    pass.Execute();
+    this->ExecutedPasses.push_back(pass.Name);
+
+    // and give it back after their last use
+    for (size_t r = 0; r < numberOfResources; ++r)
+    {
+      if (this->Resources[r].Transient && lastUse[r] == static_cast<int>(i))
+      {
+        this->Pool[this->Resources[r].PoolIndex].Busy = false;
+        this->Resources[r].PoolIndex = -1;
+      }
+    }
+  }
+
+  // keep the framebuffers used recently for the next executions, a
+  // reservation lasts one execution
+  for (PoolEntry& entry : this->Pool)
+  {
+    if (entry.Framebuffer && this->IsExpired(entry) && !entry.Reserved)
+    {
+      entry.Framebuffer->ReleaseGraphicsResources(rw);
+      entry.Framebuffer = nullptr;
+    }
+    entry.Reserved = false;
+  }
+  this->Pool.erase(std::remove_if(this->Pool.begin(), this->Pool.end(),
+                     [](const PoolEntry& entry) { return !entry.Framebuffer; }),
+    this->Pool.end());
+
+  this->Passes.clear();
+  this->Resources.clear();
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassRenderGraph::AcquireEntry(vtkOpenGLRenderWindow* rw,
+  const TargetDescription& description, const std::vector<TargetDescription>& pending)
+{
+  for (size_t e = 0; e < this->Pool.size(); ++e)
+  {
+    PoolEntry& entry = this->Pool[e];
+    if (entry.Framebuffer && !entry.Busy && entry.Description == description)
+    {
+      entry.Busy = true;
+      entry.Reserved = false;
+      entry.LastExecution = this->ExecutionCount;
+      return static_cast<int>(e);
+    }
+  }
+
+  // Nothing fits, free the memory that the rest of the execution cannot
+  // use before allocating, but not the framebuffers the other users of the
+  // graph are about to need again. The entries are emptied rather than
+  // removed, the busy ones are referred to by index.
+  int slot = -1;
+  for (size_t e = 0; e < this->Pool.size(); ++e)
+  {
+    PoolEntry& entry = this->Pool[e];
+    if (entry.Framebuffer && !entry.Busy && !entry.Reserved &&
+      (entry.LastExecution == this->ExecutionCount || this->IsExpired(entry)) &&
+      std::find(pending.begin(), pending.end(), entry.Description) == pending.end())
+    {
+      entry.Framebuffer->ReleaseGraphicsResources(rw);
+      entry.Framebuffer = nullptr;
+    }
+    if (!entry.Framebuffer && slot < 0)
+    {
+      slot = static_cast<int>(e);
+    }
+  }
+  if (slot < 0)
+  {
+    this->Pool.emplace_back();
+    slot = static_cast<int>(this->Pool.size()) - 1;
+  }
+
+  PoolEntry& entry = this->Pool[slot];
+  entry.Description = description;
+  entry.Busy = true;
+  entry.Reserved = false;
+  entry.LastExecution = this->ExecutionCount;
+  this->Allocate(rw, entry);
+  return slot;
+}
+
+//------------------------------------------------------------------------------
+vtkOpenGLFramebufferObject* vtkLookingGlassRenderGraph::GetPooledFramebuffer(
+  vtkOpenGLRenderWindow* rw, const TargetDescription& description)
+{
+  // the first compatible entry, which is the one AcquireEntry() finds
+  for (PoolEntry& entry : this->Pool)
+  {
+    if (entry.Framebuffer && entry.Description == description)
+    {
+      entry.Reserved = true;
+      return entry.Framebuffer;
+    }
+  }
+
+  this->Pool.emplace_back();
+  PoolEntry& entry = this->Pool.back();
+  entry.Description = description;
+  entry.Reserved = true;
+  this->Allocate(rw, entry);
+  return entry.Framebuffer;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassRenderGraph::Allocate(vtkOpenGLRenderWindow* rw, PoolEntry& entry)
+{
+  const TargetDescription& description = entry.Description;
+  auto ostate = rw->GetState();
+  ostate->PushFramebufferBindings();
+  entry.Framebuffer = vtkSmartPointer<vtkOpenGLFramebufferObject>::New();
+  entry.Framebuffer->SetContext(rw);
+  entry.Framebuffer->Bind();
+  entry.Framebuffer->PopulateFramebuffer(description.Size[0], description.Size[1],
+    true,                 // textures
+    1, VTK_UNSIGNED_CHAR, // 1 color buffer uchar
+    description.DepthBits > 0, description.DepthBits > 0 ? description.DepthBits : 24,
+    description.Samples, description.Stencil);
+  ostate->PopFramebufferBindings();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassRenderGraph::IsExpired(const PoolEntry& entry) const
+{
+  return this->ExecutionCount - entry.LastExecution >=
+    static_cast<vtkTypeUInt64>(this->RetainedExecutions);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassRenderGraph::ReleaseGraphicsResources(vtkWindow* w)
+{
+  for (PoolEntry& entry : this->Pool)
+  {
+    if (entry.Framebuffer && w)
+    {
+      entry.Framebuffer->ReleaseGraphicsResources(w);
+    }
+  }
+  this->Pool.clear();
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassRenderGraph::GetNumberOfTargets() const
+{
+  return static_cast<int>(std::count_if(this->Pool.begin(), this->Pool.end(),
+    [](const PoolEntry& entry) { return entry.Framebuffer != nullptr; }));
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkLookingGlassRenderGraph::GetTargetBytes(const TargetDescription& description)
+{
+  // color plus depth, with the stencil packed into the depth buffer when
+  // present: 32 bit depth takes 8 bytes with a stencil and 4 without, 24 bit
+  // depth always 4, 16 bit depth 2 unless it becomes 24 bit for a stencil
+  vtkTypeInt64 depthBytes = 0;
+  if (description.DepthBits > 24)
+  {
+    depthBytes = description.Stencil ? 8 : 4;
+  }
+  else if (description.DepthBits > 16)
+  {
+    depthBytes = 4;
+  }
+  else if (description.DepthBits > 0)
+  {
+    depthBytes = description.Stencil ? 4 : 2;
+  }
+  return static_cast<vtkTypeInt64>(description.Size[0]) * description.Size[1] *
+    (4 + depthBytes) * std::max(description.Samples, 1);
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkLookingGlassRenderGraph::GetTargetMemory() const
+{
+  vtkTypeInt64 bytes = 0;
+  for (const PoolEntry& entry : this->Pool)
+  {
+    if (entry.Framebuffer)
+    {
+      bytes += GetTargetBytes(entry.Description);
+    }
+  }
+  return bytes;
+}
@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassRenderGraph
+ * @brief   Run the passes of a frame in the order of their dependencies.
+ *
+ * This is a helper for vtkLookingGlassInterface. A frame is described as
+ * passes that read and write resources: render targets created for the
+ * frame only, framebuffers owned by the caller, and resources outside of
+ * the GPU such as an image read back, which only order the passes.
+ * Execute() then
+ *
+ * - orders the passes so that every pass runs after the passes whose
+ *   results it reads, and before the passes that overwrite what it reads.
+ *   The passes that finish with a target run as soon as they can, so that
+ *   its framebuffer is free for the next target. Otherwise the GPU work is
+ *   submitted before the readbacks and the readbacks before the work on
+ *   the host, so that the CPU waits for the GPU only once,
+ * - culls the passes whose results are not used by an output,
+ * - gives the render targets created for the frame framebuffers of a pool,
+ *   two targets with the same description sharing a framebuffer when their
+ *   uses do not overlap.
+ *
+ * OpenGL has no placed resources, so targets are shared whole, between
+ * targets of the same description. The pool is kept from one execution to
+ * the next, the framebuffers that none of the last RetainedExecutions
+ * executions used are released.
+ */
+
+#ifndef vtkLookingGlassRenderGraph_h
+#define vtkLookingGlassRenderGraph_h
+
+#include "vtkSmartPointer.h"
+#include "vtkType.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+class vtkOpenGLFramebufferObject;
+class vtkOpenGLRenderWindow;
+class vtkWindow;
+
+class vtkLookingGlassRenderGraph
+{
+public:
+  // The layout of a render target, targets with equal descriptions are
+  // interchangeable. They have one unsigned char color texture.
+  struct TargetDescription
+  {
+    int Size[2] = { 0, 0 };
+    // 0 for a target without depth buffer
+    int DepthBits = 0;
+    int Samples = 0;
+    bool Stencil = false;
+
+    bool operator==(const TargetDescription& other) const;
+  };
+
+  // What a pass does, which decides the order of the passes that are ready.
+  enum PassKind
+  {
+    GPU,
+    READBACK,
+    HOST
+  };
+
+  vtkLookingGlassRenderGraph() = default;
+  ~vtkLookingGlassRenderGraph();
+
+  // Add a render target for the next execution only, return its resource.
+  int CreateTarget(const std::string& name, const TargetDescription& description);
+
+  // Add a framebuffer owned by the caller, return its resource.
+  int ImportTarget(const std::string& name, vtkOpenGLFramebufferObject* framebuffer);
+
+  // Add a resource outside of the GPU, return it.
+  int CreateResource(const std::string& name);
+
+  // Mark a resource as used after the execution, the passes writing it are
+  // never culled.
+  void MarkOutput(int resource);
+
+  // Add a pass. A resource is read as written by the passes added before.
+  void AddPass(const std::string& name, PassKind kind, const std::vector<int>& reads,
+    const std::vector<int>& writes, std::function<void()> execute);
+
+  // Order, cull and run the passes added since the last execution, then
+  // forget them.
+  void Execute(vtkOpenGLRenderWindow* rw);
+
+  // The framebuffer of a target, valid while the passes using it run.
+  vtkOpenGLFramebufferObject* GetFramebuffer(int resource) const;
+
+  // The framebuffer of the pool the next execution gives to the first
+  // target with this description, for the callers that need it before.
+  vtkOpenGLFramebufferObject* GetPooledFramebuffer(
+    vtkOpenGLRenderWindow* rw, const TargetDescription& description);
+
+  // Keep the framebuffers used by one of the last `count` executions, for
+  // a graph shared by `count` users that execute in turn. Default is 1.
+  void SetRetainedExecutions(int count) { this->RetainedExecutions = std::max(count, 1); }
+
+  // Release the framebuffers of the pool.
+  void ReleaseGraphicsResources(vtkWindow* w);
+
+  // The passes run by the last execution, in order, and how many were
+  // culled.
+  const std::vector<std::string>& GetExecutedPasses() const { return this->ExecutedPasses; }
+  int GetNumberOfCulledPasses() const { return this->NumberOfCulledPasses; }
+
+  // The framebuffers in the pool and their estimated size in bytes.
+  int GetNumberOfTargets() const;
+  vtkTypeInt64 GetTargetMemory() const;
+
+  // The estimated size in bytes of a target with this description.
+  static vtkTypeInt64 GetTargetBytes(const TargetDescription& description);
+
+private:
+  struct Resource
+  {
+    std::string Name;
+    // a target created for the execution, or imported
+    bool Transient = false;
+    TargetDescription Description;
+    vtkOpenGLFramebufferObject* Framebuffer = nullptr;
+    bool Output = false;
+    // the pool entry of a transient target while it is in use
+    int PoolIndex = -1;
+  };
+
+  struct Pass
+  {
+    std::string Name;
+    PassKind Kind;
+    std::vector<int> Reads;
+    std::vector<int> Writes;
+    std::function<void()> Execute;
+  };
+
+  struct PoolEntry
+  {
+    TargetDescription Description;
+    vtkSmartPointer<vtkOpenGLFramebufferObject> Framebuffer;
+    bool Busy = false;
+    // handed out by GetPooledFramebuffer() for the next execution
+    bool Reserved = false;
+    vtkTypeUInt64 LastExecution = 0;
+  };
+
+  // a free pool entry for a transient target, allocated when none is
+  // compatible, after releasing the free entries that none of the `pending`
+  // targets can use
+  int AcquireEntry(vtkOpenGLRenderWindow* rw, const TargetDescription& description,
+    const std::vector<TargetDescription>& pending);
+
+  void Allocate(vtkOpenGLRenderWindow* rw, PoolEntry& entry);
+
+  // whether an entry was used by none of the last RetainedExecutions
+  bool IsExpired(const PoolEntry& entry) const;
+
+  std::vector<Resource> Resources;
+  std::vector<Pass> Passes;
+  std::vector<PoolEntry> Pool;
+  vtkTypeUInt64 ExecutionCount = 0;
+  int RetainedExecutions = 1;
+  std::vector<std::string> ExecutedPasses;
+  int NumberOfCulledPasses = 0;
+};
+
+#endif
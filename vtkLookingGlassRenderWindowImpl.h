@@ -34,6 +34,10 @@ void className::InitializeInterface()
   }
 
   this->Interface->Initialize();
+  this->Interface->SetTileSizeCallback([this](int width, int height) {
+    this->Size[0] = width;
+    this->Size[1] = height;
+  });
   this->Interface->GetDisplaySize(this->Size[0], this->Size[1]);
   this->Interface->GetDisplayPosition(this->Position[0], this->Position[1]);
   this->BordersOff();
@@ -56,6 +60,13 @@ void className::ReleaseGraphicsResources(vtkWindow* renWin)
   this->Superclass::ReleaseGraphicsResources(renWin);
 }
 
+//------------------------------------------------------------------------------
+// Only overridden to release the Python GIL while rendering
+void className::Render()
+{
+  this->Superclass::Render();
+}
+
 //------------------------------------------------------------------------------
 // We override this method to render the tiles required by the looking glass
 // display then render the resulting lightfield to the window
@@ -63,6 +74,19 @@ void className::DoStereoRender()
 {
   this->StereoUpdate();
 
+  if (this->Interface->UpdateQuiltMoviePlayback(this))
+  {
+    // a quilt movie is playing, show its current frame instead of the scene
+    this->Interface->DrawLightField(this);
+    return;
+  }
+
+  if (this->Interface->DrawQuiltClientFrame(this))
+  {
+    // the quilts are rendered by a remote server
+    return;
+  }
+
   int renderSize[2];
   this->Interface->GetRenderSize(renderSize);
 
@@ -77,6 +101,15 @@ void className::DoStereoRender()
   this->Size[0] = origSize[0];
   this->Size[1] = origSize[1];
 
+#ifdef vtkLookingGlassHeadless
+  if (!this->Interface->IsDeviceConnected())
+  {
+    // nothing to show the light field on, the quilt is only saved or sent
+    this->Interface->SkipLightField();
+    return;
+  }
+#endif
+
   this->Interface->DrawLightField(this);
 }
 
@@ -106,6 +139,36 @@ void className::SaveQuilt(const char* fileName)
   this->Interface->SaveQuilt(fileName);
 }
 
+//------------------------------------------------------------------------------
+void className::SaveQuiltStreamed(const char* fileName, double scale)
+{
+  this->MakeCurrent();
+
+  int origSize[2] = { this->Size[0], this->Size[1] };
+  this->InStereoRender = true;
+
+  this->Interface->SaveQuiltStreamed(this, fileName, scale);
+
+  this->InStereoRender = false;
+  this->Size[0] = origSize[0];
+  this->Size[1] = origSize[1];
+}
+
+//------------------------------------------------------------------------------
+void className::SaveQuilts(const std::vector<std::string>& deviceTypes, const char* filePrefix)
+{
+  this->MakeCurrent();
+
+  int origSize[2] = { this->Size[0], this->Size[1] };
+  this->InStereoRender = true;
+
+  this->Interface->SaveQuilts(this, deviceTypes, filePrefix);
+
+  this->InStereoRender = false;
+  this->Size[0] = origSize[0];
+  this->Size[1] = origSize[1];
+}
+
 //------------------------------------------------------------------------------
 void className::StartRecordingQuilt(const char* fileName)
 {
@@ -118,6 +181,36 @@ void className::StopRecordingQuilt()
   this->Interface->StopRecordingQuilt();
 }
 
+//------------------------------------------------------------------------------
+bool className::StartPublishingQuilt(const char* name)
+{
+  return this->Interface->StartPublishingQuilt(name);
+}
+
+//------------------------------------------------------------------------------
+void className::StopPublishingQuilt()
+{
+  this->Interface->StopPublishingQuilt();
+}
+
+//------------------------------------------------------------------------------
+bool className::StartQuiltMoviePlayback(const char* fileName, bool loop)
+{
+  return this->Interface->StartQuiltMoviePlayback(fileName, loop);
+}
+
+//------------------------------------------------------------------------------
+void className::StopQuiltMoviePlayback()
+{
+  this->Interface->StopQuiltMoviePlayback();
+}
+
+//------------------------------------------------------------------------------
+bool className::IsPlayingQuiltMovie() const
+{
+  return this->Interface->IsPlayingQuiltMovie();
+}
+
 //------------------------------------------------------------------------------
 const char* className::MovieFileExtension()
 {
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassResourcePool.h"
+
+#include "vtkOpenGLFramebufferObject.h"
+#include "vtkOpenGLQuadHelper.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkTextureObject.h"
+
+#include <tuple>
+
+namespace
+{
+// the pools in use, rendering happens on one thread at a time
+std::map<vtkOpenGLRenderWindow*, vtkLookingGlassResourcePool*>& GetPools()
+{
+  static std::map<vtkOpenGLRenderWindow*, vtkLookingGlassResourcePool*> pools;
+  return pools;
+}
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassResourcePool::QuiltKey::operator<(const QuiltKey& other) const
+{
+  return std::tie(this->Size[0], this->Size[1], this->Format, this->TileSize[0],
+           this->TileSize[1]) < std::tie(other.Size[0], other.Size[1], other.Format,
+                                  other.TileSize[0], other.TileSize[1]);
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassResourcePool::vtkLookingGlassResourcePool(vtkOpenGLRenderWindow* rw)
+  : Window(rw)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassResourcePool::~vtkLookingGlassResourcePool() = default;
+
+//------------------------------------------------------------------------------
+vtkLookingGlassResourcePool* vtkLookingGlassResourcePool::Acquire(vtkOpenGLRenderWindow* rw)
+{
+  vtkLookingGlassResourcePool*& pool = GetPools()[rw];
+  if (!pool)
+  {
+    pool = new vtkLookingGlassResourcePool(rw);
+  }
+  ++pool->NumberOfUsers;
+
+  // the users render in turn, each keeps its render targets until its
+  // next quilt
+  pool->RenderGraph.SetRetainedExecutions(pool->NumberOfUsers);
+  return pool;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassResourcePool::Release(vtkWindow* w)
+{
+  if (--this->NumberOfUsers > 0)
+  {
+    this->RenderGraph.SetRetainedExecutions(this->NumberOfUsers);
+    return;
+  }
+
+  GetPools().erase(this->Window);
+  this->ReleaseGraphicsResources(w);
+  delete this;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassResourcePool::AcquireQuilt(const void* user, const QuiltKey& key,
+  const QuiltAllocator& allocate, vtkTextureObject*& texture,
+  vtkOpenGLFramebufferObject*& framebuffer)
+{
+  Quilt& quilt = this->Quilts[key];
+  if (quilt.Users.count(user) == 0)
+  {
+    this->ReleaseQuilt(user, this->Window);
+    quilt.Users.insert(user);
+  }
+  if (!quilt.Framebuffer)
+  {
+    quilt.Texture = vtkSmartPointer<vtkTextureObject>::New();
+    quilt.Framebuffer = vtkSmartPointer<vtkOpenGLFramebufferObject>::New();
+    allocate(quilt.Texture, quilt.Framebuffer);
+  }
+  texture = quilt.Texture;
+  framebuffer = quilt.Framebuffer;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassResourcePool::ReleaseQuilt(const void* user, vtkWindow* w)
+{
+  for (auto it = this->Quilts.begin(); it != this->Quilts.end();)
+  {
+    Quilt& quilt = it->second;
+    if (quilt.Users.erase(user) == 0 || !quilt.Users.empty())
+    {
+      ++it;
+      continue;
+    }
+    if (w && quilt.Framebuffer)
+    {
+      quilt.Texture->ReleaseGraphicsResources(w);
+      quilt.Framebuffer->ReleaseGraphicsResources(w);
+    }
+    it = this->Quilts.erase(it);
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkOpenGLQuadHelper* vtkLookingGlassResourcePool::GetQuad(
+  const std::string& name, const std::function<vtkOpenGLQuadHelper*()>& create)
+{
+  std::unique_ptr<vtkOpenGLQuadHelper>& quad = this->Quads[name];
+  if (!quad)
+  {
+    quad.reset(create());
+  }
+  return quad.get();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassResourcePool::ReleaseGraphicsResources(vtkWindow* w)
+{
+  this->RenderGraph.ReleaseGraphicsResources(w);
+  for (auto& entry : this->Quilts)
+  {
+    if (w && entry.second.Framebuffer)
+    {
+      entry.second.Texture->ReleaseGraphicsResources(w);
+      entry.second.Framebuffer->ReleaseGraphicsResources(w);
+    }
+  }
+  this->Quilts.clear();
+  for (auto& entry : this->Quads)
+  {
+    if (w)
+    {
+      entry.second->ReleaseGraphicsResources(w);
+    }
+  }
+  this->Quads.clear();
+}
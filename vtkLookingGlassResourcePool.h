@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassResourcePool
+ * @brief   The graphics resources of the interfaces rendering into a window.
+ *
+ * This is a helper for vtkLookingGlassInterface. Every interface rendering
+ * into a window uses the pool of that window, which holds
+ *
+ * - the render graph of the interfaces, so that they share the pool of
+ *   render targets: the tiles of interfaces with the same render size are
+ *   rendered into the same framebuffer,
+ * - the quilts of the interfaces that share theirs, one per quilt size,
+ *   storage format and tile size,
+ * - the full screen quads that draw the quilts, with their shader programs.
+ *
+ * The users of the pool and of each quilt are counted. A quilt is released
+ * once its last user gives it back, everything else once the last interface
+ * gives the pool back from its ReleaseGraphicsResources().
+ *
+ * Pools are kept per window, the interfaces rendering into two windows that
+ * share a context do not share their resources.
+ */
+
+#ifndef vtkLookingGlassResourcePool_h
+#define vtkLookingGlassResourcePool_h
+
+#include "vtkLookingGlassRenderGraph.h"
+#include "vtkSmartPointer.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+class vtkOpenGLFramebufferObject;
+class vtkOpenGLQuadHelper;
+class vtkOpenGLRenderWindow;
+class vtkTextureObject;
+class vtkWindow;
+
+class vtkLookingGlassResourcePool
+{
+public:
+  // The layout of a quilt, quilts are only shared between interfaces whose
+  // tiles have the same place in them.
+  struct QuiltKey
+  {
+    int Size[2];
+    int Format;
+    int TileSize[2];
+
+    bool operator<(const QuiltKey& other) const;
+  };
+
+  // Allocates the storage of a new quilt texture and attaches it to a new
+  // quilt framebuffer.
+  using QuiltAllocator = std::function<void(vtkTextureObject*, vtkOpenGLFramebufferObject*)>;
+
+  // The pool of a window, created for its first user. Every call is
+  // matched by a call to Release().
+  static vtkLookingGlassResourcePool* Acquire(vtkOpenGLRenderWindow* rw);
+
+  // Give the pool back. The last user releases its resources and deletes
+  // it, `w` is null when the context is gone.
+  void Release(vtkWindow* w);
+
+  vtkOpenGLRenderWindow* GetWindow() const { return this->Window; }
+  int GetNumberOfUsers() const { return this->NumberOfUsers; }
+
+  // The render graph of the users, and the pool of its render targets.
+  vtkLookingGlassRenderGraph* GetRenderGraph() { return &this->RenderGraph; }
+
+  // The quilt with the given layout, allocated for its first user. A user
+  // holds one quilt at a time, the one it held before is given back.
+  void AcquireQuilt(const void* user, const QuiltKey& key, const QuiltAllocator& allocate,
+    vtkTextureObject*& texture, vtkOpenGLFramebufferObject*& framebuffer);
+
+  // Give back the quilt of a user, which is released if it was its last
+  // user.
+  void ReleaseQuilt(const void* user, vtkWindow* w);
+
+  // The number of quilts held.
+  int GetNumberOfQuilts() const { return static_cast<int>(this->Quilts.size()); }
+
+  // The full screen quad with the given name, created for its first user.
+  vtkOpenGLQuadHelper* GetQuad(
+    const std::string& name, const std::function<vtkOpenGLQuadHelper*()>& create);
+
+private:
+  vtkLookingGlassResourcePool(vtkOpenGLRenderWindow* rw);
+  ~vtkLookingGlassResourcePool();
+
+  struct Quilt
+  {
+    vtkSmartPointer<vtkTextureObject> Texture;
+    vtkSmartPointer<vtkOpenGLFramebufferObject> Framebuffer;
+    std::set<const void*> Users;
+  };
+
+  void ReleaseGraphicsResources(vtkWindow* w);
+
+  vtkOpenGLRenderWindow* Window;
+  int NumberOfUsers = 0;
+  vtkLookingGlassRenderGraph RenderGraph;
+  std::map<QuiltKey, Quilt> Quilts;
+  std::map<std::string, std::unique_ptr<vtkOpenGLQuadHelper>> Quads;
+};
+
+#endif
@@ -0,0 +1,568 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSceneHost.h"
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkClientSocket.h"
+#include "vtkDataArray.h"
+#include "vtkLookingGlassSceneProtocol.h"
+#include "vtkMatrix4x4.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+#include "vtkServerSocket.h"
+
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <string>
+
+namespace protocol = vtkLookingGlassSceneProtocol;
+
+vtkStandardNewMacro(vtkLookingGlassSceneHost);
+
+namespace
+{
+// larger messages are taken for a corrupted stream
+const vtkTypeUInt64 MaximumPayloadSize = 1ULL << 31;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSceneHost::vtkLookingGlassSceneHost()
+  : ServerSocket(nullptr)
+  , Socket(nullptr)
+  , Renderer(nullptr)
+  , NumberOfSteps(0)
+  , LastStepBytes(0)
+  , NumberOfCacheHits(0)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSceneHost::~vtkLookingGlassSceneHost()
+{
+  this->Close();
+  this->SetRenderer(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneHost::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Connected: " << this->IsConnected() << "\n";
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "NumberOfSteps: " << this->NumberOfSteps << "\n";
+  os << indent << "NumberOfActors: " << this->Actors.size() << "\n";
+  os << indent << "NumberOfCachedArrays: " << this->Arrays.size() << "\n";
+  os << indent << "NumberOfCacheHits: " << this->NumberOfCacheHits << "\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneHost::SetRenderer(vtkRenderer* renderer)
+{
+  if (this->Renderer == renderer)
+  {
+    return;
+  }
+  // the replicated actors move to the new renderer
+  for (const auto& entry : this->Actors)
+  {
+    if (this->Renderer)
+    {
+      this->Renderer->RemoveActor(entry.second.Actor);
+    }
+    if (renderer)
+    {
+      renderer->AddActor(entry.second.Actor);
+    }
+  }
+  if (this->Renderer)
+  {
+    this->Renderer->UnRegister(this);
+  }
+  this->Renderer = renderer;
+  if (this->Renderer)
+  {
+    this->Renderer->Register(this);
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::Listen(int port)
+{
+  this->Close();
+  this->ServerSocket = vtkServerSocket::New();
+  if (this->ServerSocket->CreateServer(port) != 0)
+  {
+    vtkErrorMacro("Unable to listen on port " << port);
+    this->ServerSocket->Delete();
+    this->ServerSocket = nullptr;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassSceneHost::GetPort() const
+{
+  return this->ServerSocket ? this->ServerSocket->GetServerPort() : 0;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::WaitForClient(double timeout)
+{
+  if (!this->ServerSocket || this->IsConnected())
+  {
+    return this->IsConnected();
+  }
+
+  vtkClientSocket* socket =
+    this->ServerSocket->WaitForConnection(static_cast<unsigned long>(timeout * 1000.0));
+  if (!socket)
+  {
+    return false;
+  }
+
+  // a new replicator sends everything again
+  if (this->Socket)
+  {
+    this->Socket->Delete();
+  }
+  this->Socket = socket;
+  this->RemoveActors();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::IsConnected() const
+{
+  return this->Socket && this->Socket->GetConnected();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneHost::Close()
+{
+  if (this->Socket)
+  {
+    this->Socket->CloseSocket();
+    this->Socket->Delete();
+    this->Socket = nullptr;
+  }
+  if (this->ServerSocket)
+  {
+    this->ServerSocket->CloseSocket();
+    this->ServerSocket->Delete();
+    this->ServerSocket = nullptr;
+  }
+  this->RemoveActors();
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkLookingGlassSceneHost::GetCachedBytes() const
+{
+  vtkTypeUInt64 bytes = 0;
+  for (const auto& entry : this->Arrays)
+  {
+    bytes += static_cast<vtkTypeUInt64>(entry.second->GetNumberOfValues()) *
+      entry.second->GetDataTypeSize();
+  }
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::ReceiveStep(double timeout)
+{
+  if (!this->IsConnected())
+  {
+    return false;
+  }
+
+  int descriptor = this->Socket->GetSocketDescriptor();
+  int selected = -1;
+  if (vtkSocket::SelectSockets(
+        &descriptor, 1, static_cast<unsigned long>(timeout * 1000.0), &selected) != 1)
+  {
+    return false;
+  }
+
+  vtkTypeUInt64 bytes = 0;
+  vtkTypeUInt32 type = 0;
+  while (type != protocol::EndStepMessage)
+  {
+    if (!this->ReceiveMessage(type) || !this->ApplyMessage(type))
+    {
+      // the replicator went away or the stream is broken, its scene goes too
+      this->Socket->CloseSocket();
+      this->RemoveActors();
+      return false;
+    }
+    bytes += protocol::MessageHeaderSize + this->Payload.size();
+  }
+
+  this->PruneArrays();
+  if (this->Renderer)
+  {
+    this->Renderer->ResetCameraClippingRange();
+  }
+  ++this->NumberOfSteps;
+  this->LastStepBytes = bytes;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::ReceiveMessage(vtkTypeUInt32& type)
+{
+  unsigned char header[protocol::MessageHeaderSize];
+  if (this->Socket->Receive(header, protocol::MessageHeaderSize) !=
+      static_cast<int>(protocol::MessageHeaderSize) ||
+    protocol::Get<vtkTypeUInt32>(header, protocol::MagicOffset) != protocol::Magic)
+  {
+    return false;
+  }
+
+  type = protocol::Get<vtkTypeUInt32>(header, protocol::TypeOffset);
+  const vtkTypeUInt64 size = protocol::Get<vtkTypeUInt64>(header, protocol::PayloadSizeOffset);
+  if (size > MaximumPayloadSize)
+  {
+    vtkErrorMacro("Message of " << size << " bytes refused");
+    return false;
+  }
+  this->Payload.resize(static_cast<size_t>(size));
+  return size == 0 ||
+    this->Socket->Receive(this->Payload.data(), static_cast<int>(size)) == static_cast<int>(size);
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::ApplyMessage(vtkTypeUInt32 type)
+{
+  const unsigned char* payload = this->Payload.data();
+  const size_t size = this->Payload.size();
+  const size_t idSize = sizeof(vtkTypeUInt64);
+  switch (type)
+  {
+    case protocol::CameraMessage:
+    {
+      if (size != protocol::CameraValues * sizeof(double))
+      {
+        break;
+      }
+      double values[protocol::CameraValues];
+      std::memcpy(values, payload, sizeof(values));
+      if (this->Renderer)
+      {
+        vtkCamera* camera = this->Renderer->GetActiveCamera();
+        camera->SetPosition(values);
+        camera->SetFocalPoint(values + 3);
+        camera->SetViewUp(values + 6);
+        camera->SetViewAngle(values[9]);
+        camera->SetParallelScale(values[10]);
+        camera->SetParallelProjection(values[11] != 0.0);
+      }
+      return true;
+    }
+
+    case protocol::ActorTransformMessage:
+    {
+      if (size != idSize + 16 * sizeof(double))
+      {
+        break;
+      }
+      double elements[16];
+      std::memcpy(elements, payload + idSize, sizeof(elements));
+      vtkNew<vtkMatrix4x4> matrix;
+      matrix->DeepCopy(elements);
+      this->GetActor(protocol::Get<vtkTypeUInt64>(payload, 0)).Actor->SetUserMatrix(matrix);
+      return true;
+    }
+
+    case protocol::ActorPropertyMessage:
+    {
+      if (size != idSize + protocol::PropertyValues * sizeof(double))
+      {
+        break;
+      }
+      double values[protocol::PropertyValues];
+      std::memcpy(values, payload + idSize, sizeof(values));
+      vtkActor* actor = this->GetActor(protocol::Get<vtkTypeUInt64>(payload, 0)).Actor;
+      vtkProperty* property = actor->GetProperty();
+      property->SetColor(values);
+      property->SetOpacity(values[3]);
+      property->SetAmbient(values[4]);
+      property->SetDiffuse(values[5]);
+      property->SetSpecular(values[6]);
+      property->SetSpecularPower(values[7]);
+      property->SetPointSize(values[8]);
+      property->SetLineWidth(values[9]);
+      property->SetRepresentation(static_cast<int>(values[10]));
+      actor->SetVisibility(values[11] != 0.0);
+      actor->GetMapper()->SetScalarVisibility(values[12] != 0.0);
+      actor->GetMapper()->SetScalarRange(values + 13);
+      return true;
+    }
+
+    case protocol::ActorDataMessage:
+    {
+      if (size < protocol::ActorDataHeaderSize)
+      {
+        break;
+      }
+      return this->ApplyData(this->GetActor(protocol::Get<vtkTypeUInt64>(payload, 0)));
+    }
+
+    case protocol::RemoveActorMessage:
+    {
+      if (size != idSize)
+      {
+        break;
+      }
+      auto found = this->Actors.find(protocol::Get<vtkTypeUInt64>(payload, 0));
+      if (found != this->Actors.end())
+      {
+        if (this->Renderer)
+        {
+          this->Renderer->RemoveActor(found->second.Actor);
+        }
+        this->Actors.erase(found);
+      }
+      return true;
+    }
+
+    case protocol::ArrayChunkMessage:
+    {
+      if (size < protocol::ArrayChunkHeaderSize)
+      {
+        break;
+      }
+      const auto hash = protocol::Get<vtkTypeUInt64>(payload, protocol::ChunkHashOffset);
+      const auto total = protocol::Get<vtkTypeUInt64>(payload, protocol::ChunkTotalSizeOffset);
+      const auto offset = protocol::Get<vtkTypeUInt64>(payload, protocol::ChunkOffsetOffset);
+      const size_t chunk = size - protocol::ArrayChunkHeaderSize;
+      if (total > MaximumPayloadSize || offset + chunk > total)
+      {
+        break;
+      }
+      std::vector<unsigned char>& bytes = this->PendingArrays[hash];
+      bytes.resize(static_cast<size_t>(total));
+      if (chunk)
+      {
+        std::memcpy(bytes.data() + offset, payload + protocol::ArrayChunkHeaderSize, chunk);
+      }
+      return true;
+    }
+
+    case protocol::EndStepMessage:
+      return true;
+
+    default:
+      break;
+  }
+
+  vtkErrorMacro("Invalid message of type " << type << " and " << size << " bytes");
+  return false;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSceneHost::ActorState& vtkLookingGlassSceneHost::GetActor(vtkTypeUInt64 id)
+{
+  ActorState& state = this->Actors[id];
+  if (!state.Actor)
+  {
+    vtkNew<vtkPolyDataMapper> mapper;
+    state.Actor = vtkSmartPointer<vtkActor>::New();
+    state.Actor->SetMapper(mapper);
+    if (this->Renderer)
+    {
+      this->Renderer->AddActor(state.Actor);
+    }
+  }
+  return state;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneHost::ApplyData(ActorState& state)
+{
+  const unsigned char* payload = this->Payload.data();
+  const size_t size = this->Payload.size();
+  const vtkTypeUInt32 numberOfArrays = protocol::Get<vtkTypeUInt32>(payload, 8);
+
+  vtkNew<vtkPolyData> data;
+  vtkDataArray* cells[8] = {};
+  std::vector<vtkTypeUInt64> arrays;
+  size_t offset = protocol::ActorDataHeaderSize;
+  for (vtkTypeUInt32 i = 0; i < numberOfArrays; ++i)
+  {
+    if (offset + protocol::ArrayEntrySize > size)
+    {
+      return false;
+    }
+    const unsigned char* entry = payload + offset;
+    const vtkTypeUInt32 nameLength =
+      protocol::Get<vtkTypeUInt32>(entry, protocol::EntryNameLengthOffset);
+    offset += protocol::ArrayEntrySize + nameLength;
+    if (offset > size)
+    {
+      return false;
+    }
+    std::string name(reinterpret_cast<const char*>(entry) + protocol::ArrayEntrySize, nameLength);
+    vtkDataArray* array = this->GetArray(entry, name.empty() ? nullptr : name.c_str());
+    if (!array)
+    {
+      return false;
+    }
+    arrays.push_back(protocol::Get<vtkTypeUInt64>(entry, protocol::EntryHashOffset));
+
+    const vtkTypeUInt32 role = protocol::Get<vtkTypeUInt32>(entry, protocol::EntryRoleOffset);
+    const int attribute = protocol::Get<vtkTypeInt32>(entry, protocol::EntryAttributeOffset);
+    if (role == protocol::PointsRole)
+    {
+      vtkNew<vtkPoints> points;
+      points->SetData(array);
+      data->SetPoints(points);
+    }
+    else if (role <= protocol::StripsConnectivityRole)
+    {
+      cells[role - protocol::VertsOffsetsRole] = array;
+    }
+    else if (role == protocol::PointDataRole || role == protocol::CellDataRole)
+    {
+      vtkDataSetAttributes* attributes = role == protocol::PointDataRole
+        ? static_cast<vtkDataSetAttributes*>(data->GetPointData())
+        : data->GetCellData();
+      const int index = attributes->AddArray(array);
+      if (attribute >= 0)
+      {
+        attributes->SetActiveAttribute(index, attribute);
+      }
+    }
+  }
+
+  for (int i = 0; i < 4; ++i)
+  {
+    if (!cells[2 * i] || !cells[2 * i + 1])
+    {
+      continue;
+    }
+    vtkNew<vtkCellArray> cellArray;
+    if (!cellArray->SetData(cells[2 * i], cells[2 * i + 1]))
+    {
+      vtkErrorMacro("Unsupported cell array types");
+      return false;
+    }
+    switch (i)
+    {
+      case 0:
+        data->SetVerts(cellArray);
+        break;
+      case 1:
+        data->SetLines(cellArray);
+        break;
+      case 2:
+        data->SetPolys(cellArray);
+        break;
+      default:
+        data->SetStrips(cellArray);
+        break;
+    }
+  }
+
+  vtkPolyDataMapper::SafeDownCast(state.Actor->GetMapper())->SetInputData(data);
+  state.Arrays.swap(arrays);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkDataArray* vtkLookingGlassSceneHost::GetArray(const unsigned char* entry, const char* name)
+{
+  const auto hash = protocol::Get<vtkTypeUInt64>(entry, protocol::EntryHashOffset);
+  auto cached = this->Arrays.find(hash);
+  if (cached != this->Arrays.end())
+  {
+    ++this->NumberOfCacheHits;
+    return cached->second;
+  }
+
+  auto pending = this->PendingArrays.find(hash);
+  if (pending == this->PendingArrays.end())
+  {
+    vtkErrorMacro("Array " << hash << " was never received");
+    return nullptr;
+  }
+
+  const int dataType = protocol::Get<vtkTypeInt32>(entry, protocol::EntryDataTypeOffset);
+  const int components = protocol::Get<vtkTypeInt32>(entry, protocol::EntryComponentsOffset);
+  const auto tuples = protocol::Get<vtkTypeUInt64>(entry, protocol::EntryTuplesOffset);
+  vtkSmartPointer<vtkDataArray> array;
+  array.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  if (!array || components < 1)
+  {
+    vtkErrorMacro("Array " << hash << " has an unsupported type " << dataType);
+    return nullptr;
+  }
+  array->SetNumberOfComponents(components);
+  array->SetNumberOfTuples(static_cast<vtkIdType>(tuples));
+  const size_t bytes = static_cast<size_t>(array->GetNumberOfValues()) * array->GetDataTypeSize();
+  if (bytes != pending->second.size())
+  {
+    vtkErrorMacro("Array " << hash << " has " << pending->second.size() << " bytes instead of "
+                           << bytes);
+    return nullptr;
+  }
+  if (bytes)
+  {
+    std::memcpy(array->GetVoidPointer(0), pending->second.data(), bytes);
+  }
+  array->SetName(name);
+
+  this->PendingArrays.erase(pending);
+  this->Arrays[hash] = array;
+  return array;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneHost::RemoveActors()
+{
+  if (this->Renderer)
+  {
+    for (const auto& entry : this->Actors)
+    {
+      this->Renderer->RemoveActor(entry.second.Actor);
+    }
+  }
+  this->Actors.clear();
+  this->Arrays.clear();
+  this->PendingArrays.clear();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneHost::PruneArrays()
+{
+  // the replicator forgets the same arrays at the end of its step
+  std::set<vtkTypeUInt64> used;
+  for (const auto& entry : this->Actors)
+  {
+    used.insert(entry.second.Arrays.begin(), entry.second.Arrays.end());
+  }
+  for (auto it = this->Arrays.begin(); it != this->Arrays.end();)
+  {
+    it = used.count(it->first) ? std::next(it) : this->Arrays.erase(it);
+  }
+  this->PendingArrays.clear();
+}
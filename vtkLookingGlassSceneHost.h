@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSceneHost
+ * @brief   Rebuild the scene sent by a vtkLookingGlassSceneReplicator.
+ *
+ * The host runs on the machine that drives the Looking Glass. It applies
+ * the changes sent by a replicator to its renderer, which is usually the
+ * renderer of a Looking Glass render window, so the quilts are rendered
+ * locally and only the scene changes cross the network:
+ *
+ * \code{.cpp}
+ * host->Listen(port);
+ * host->SetRenderer(renderer);
+ * host->WaitForClient(60.0);
+ * while (host->IsConnected())
+ * {
+ *   if (host->ReceiveStep(0.1))
+ *   {
+ *     renderWindow->Render();
+ *   }
+ * }
+ * \endcode
+ *
+ * Received arrays are cached by the hash of their contents, and the poly
+ * data of all the actors share the cached arrays. An array is dropped from
+ * the cache once no actor uses it at the end of a step.
+ *
+ * @sa
+ * vtkLookingGlassSceneReplicator
+ */
+
+#ifndef vtkLookingGlassSceneHost_h
+#define vtkLookingGlassSceneHost_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkSmartPointer.h"                // For vtkSmartPointer
+
+#include <map>    // For std::map
+#include <vector> // For std::vector
+
+class vtkActor;
+class vtkClientSocket;
+class vtkDataArray;
+class vtkRenderer;
+class vtkServerSocket;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassSceneHost : public vtkObject
+{
+public:
+  static vtkLookingGlassSceneHost* New();
+  vtkTypeMacro(vtkLookingGlassSceneHost, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Listen for a replicator on the given port, 0 picks a free port.
+   * Returns false if the port could not be opened.
+   */
+  bool Listen(int port);
+
+  /**
+   * Get the port the host listens on.
+   */
+  int GetPort() const;
+
+  /**
+   * Wait up to `timeout` seconds for a replicator to connect.
+   */
+  bool WaitForClient(double timeout);
+
+  /**
+   * Check if a replicator is connected.
+   */
+  bool IsConnected() const;
+
+  /**
+   * Close the connection and stop listening. The replicated actors are
+   * removed from the renderer.
+   */
+  void Close();
+
+  //@{
+  /**
+   * Set/Get the renderer in which the scene is rebuilt.
+   */
+  void SetRenderer(vtkRenderer* renderer);
+  vtkGetObjectMacro(Renderer, vtkRenderer);
+  //@}
+
+  /**
+   * Wait up to `timeout` seconds for the next step and apply it to the
+   * renderer. Once a step started, this waits for all of it. Returns true
+   * if a step was applied and the scene should be rendered.
+   */
+  bool ReceiveStep(double timeout);
+
+  //@{
+  /**
+   * Get the number of steps applied and the number of bytes received by
+   * the last one.
+   */
+  vtkGetMacro(NumberOfSteps, vtkTypeUInt64);
+  vtkGetMacro(LastStepBytes, vtkTypeUInt64);
+  //@}
+
+  //@{
+  /**
+   * Get the number of arrays in the cache and their total size in bytes,
+   * and how many times an actor used an array that was already cached.
+   */
+  int GetNumberOfCachedArrays() const { return static_cast<int>(this->Arrays.size()); }
+  vtkTypeUInt64 GetCachedBytes() const;
+  vtkGetMacro(NumberOfCacheHits, vtkTypeUInt64);
+  //@}
+
+protected:
+  vtkLookingGlassSceneHost();
+  ~vtkLookingGlassSceneHost() override;
+
+  struct ActorState
+  {
+    vtkSmartPointer<vtkActor> Actor;
+    std::vector<vtkTypeUInt64> Arrays;
+  };
+
+  bool ReceiveMessage(vtkTypeUInt32& type);
+  bool ApplyMessage(vtkTypeUInt32 type);
+  ActorState& GetActor(vtkTypeUInt64 id);
+  bool ApplyData(ActorState& state);
+  vtkDataArray* GetArray(const unsigned char* entry, const char* name);
+  void RemoveActors();
+  void PruneArrays();
+
+  vtkServerSocket* ServerSocket;
+  vtkClientSocket* Socket;
+  vtkRenderer* Renderer;
+  vtkTypeUInt64 NumberOfSteps;
+  vtkTypeUInt64 LastStepBytes;
+  vtkTypeUInt64 NumberOfCacheHits;
+  std::vector<unsigned char> Payload;
+  std::map<vtkTypeUInt64, ActorState> Actors;
+  std::map<vtkTypeUInt64, vtkSmartPointer<vtkDataArray>> Arrays;
+  // arrays being received, they get a type once an actor uses them
+  std::map<vtkTypeUInt64, std::vector<unsigned char>> PendingArrays;
+
+private:
+  vtkLookingGlassSceneHost(const vtkLookingGlassSceneHost&) = delete;
+  void operator=(const vtkLookingGlassSceneHost&) = delete;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Messages sent by vtkLookingGlassSceneReplicator to
+ * vtkLookingGlassSceneHost. All values are little endian.
+ *
+ * Each message is a MessageHeaderSize byte header, with the fields at the
+ * Header offsets, followed by PayloadSize bytes laid out as described
+ * next to its type. An interaction step is any number of messages ending
+ * with an EndStepMessage, after which the host renders.
+ *
+ * Array contents are sent once, in ArrayChunkMessages, and then referred
+ * to by their hash. Both sides forget an array when no actor refers to it
+ * at the end of a step, so the host cache never needs to answer back.
+ */
+
+#ifndef vtkLookingGlassSceneProtocol_h
+#define vtkLookingGlassSceneProtocol_h
+
+#include "vtkType.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace vtkLookingGlassSceneProtocol
+{
+const vtkTypeUInt32 Magic = 0x53514c47; // "GLQS"
+const vtkTypeUInt32 MessageHeaderSize = 16;
+
+// field offsets in the message header
+enum Header
+{
+  MagicOffset = 0,      // uint32
+  TypeOffset = 4,       // uint32
+  PayloadSizeOffset = 8 // uint64
+};
+
+enum MessageType
+{
+  // double[CameraValues]: position, focal point, view up, view angle,
+  // parallel scale and parallel projection
+  CameraMessage = 1,
+  // uint64 actor id, double[16] actor matrix, row major
+  ActorTransformMessage = 2,
+  // uint64 actor id, double[PropertyValues]: color, opacity, ambient,
+  // diffuse, specular, specular power, point size, line width,
+  // representation, visibility, scalar visibility and scalar range
+  ActorPropertyMessage = 3,
+  // uint64 actor id, uint32 number of arrays, uint32 padding, then for each
+  // array an ArrayEntrySize byte entry followed by its name
+  ActorDataMessage = 4,
+  // uint64 actor id
+  RemoveActorMessage = 5,
+  // ArrayChunkHeaderSize bytes with the ArrayChunk fields, then the bytes
+  ArrayChunkMessage = 6,
+  // uint64 step number
+  EndStepMessage = 7
+};
+
+const int CameraValues = 12;
+const int PropertyValues = 15;
+const vtkTypeUInt32 ActorDataHeaderSize = 16;
+const vtkTypeUInt32 ArrayEntrySize = 40;
+const vtkTypeUInt32 ArrayChunkHeaderSize = 24;
+
+// field offsets in the array entries of an ActorDataMessage
+enum ArrayEntry
+{
+  EntryHashOffset = 0,        // uint64
+  EntryTuplesOffset = 8,      // uint64
+  EntryRoleOffset = 16,       // uint32, one of ArrayRole
+  EntryDataTypeOffset = 20,   // int32, VTK data type
+  EntryComponentsOffset = 24, // int32
+  EntryAttributeOffset = 28,  // int32, vtkDataSetAttributes type or -1
+  EntryNameLengthOffset = 32  // uint32
+};
+
+// field offsets in the header of an ArrayChunkMessage
+enum ArrayChunk
+{
+  ChunkHashOffset = 0,      // uint64
+  ChunkTotalSizeOffset = 8, // uint64, size of the whole array in bytes
+  ChunkOffsetOffset = 16    // uint64, where the chunk goes in the array
+};
+
+// what an array is to the poly data of an actor
+enum ArrayRole
+{
+  PointsRole = 0,
+  VertsOffsetsRole = 1,
+  VertsConnectivityRole = 2,
+  LinesOffsetsRole = 3,
+  LinesConnectivityRole = 4,
+  PolysOffsetsRole = 5,
+  PolysConnectivityRole = 6,
+  StripsOffsetsRole = 7,
+  StripsConnectivityRole = 8,
+  PointDataRole = 9,
+  CellDataRole = 10
+};
+
+/**
+ * Hash array contents, eight bytes at a time. This only has to tell arrays
+ * apart within one session, not resist collisions made on purpose.
+ */
+inline vtkTypeUInt64 Hash(
+  const void* data, std::size_t size, vtkTypeUInt64 hash = 14695981039346656037ULL)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  const vtkTypeUInt64 prime = 1099511628211ULL;
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+  {
+    vtkTypeUInt64 word;
+    std::memcpy(&word, bytes + i, 8);
+    hash = (hash ^ word) * prime;
+    hash ^= hash >> 29;
+  }
+  for (; i < size; ++i)
+  {
+    hash = (hash ^ bytes[i]) * prime;
+  }
+  return hash;
+}
+
+template <typename T>
+void Put(unsigned char* buffer, vtkTypeUInt32 offset, const T& value)
+{
+  std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T Get(const unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  T value;
+  std::memcpy(&value, buffer + offset, sizeof(T));
+  return value;
+}
+}
+
+#endif
@@ -0,0 +1,390 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSceneReplicator.h"
+
+#include "vtkActor.h"
+#include "vtkActorCollection.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkClientSocket.h"
+#include "vtkDataArray.h"
+#include "vtkLookingGlassSceneProtocol.h"
+#include "vtkMatrix4x4.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace protocol = vtkLookingGlassSceneProtocol;
+
+vtkStandardNewMacro(vtkLookingGlassSceneReplicator);
+vtkCxxSetObjectMacro(vtkLookingGlassSceneReplicator, Renderer, vtkRenderer);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSceneReplicator::vtkLookingGlassSceneReplicator()
+  : Socket(nullptr)
+  , Renderer(nullptr)
+  , ChunkSize(1 << 20)
+  , LastStepBytes(0)
+  , TotalBytes(0)
+  , NumberOfSteps(0)
+  , NumberOfArraysSent(0)
+  , NumberOfArraysReused(0)
+  , NextActorId(0)
+  , SendFailed(false)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSceneReplicator::~vtkLookingGlassSceneReplicator()
+{
+  this->Disconnect();
+  this->SetRenderer(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneReplicator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Connected: " << this->IsConnected() << "\n";
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "ChunkSize: " << this->ChunkSize << "\n";
+  os << indent << "NumberOfSteps: " << this->NumberOfSteps << "\n";
+  os << indent << "TotalBytes: " << this->TotalBytes << "\n";
+  os << indent << "NumberOfArraysSent: " << this->NumberOfArraysSent << "\n";
+  os << indent << "NumberOfArraysReused: " << this->NumberOfArraysReused << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneReplicator::Connect(const char* hostName, int port)
+{
+  this->Disconnect();
+  this->Socket = vtkClientSocket::New();
+  if (this->Socket->ConnectToServer(hostName, port) != 0)
+  {
+    vtkErrorMacro("Unable to connect to " << hostName << ":" << port);
+    this->Socket->Delete();
+    this->Socket = nullptr;
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneReplicator::Disconnect()
+{
+  if (this->Socket)
+  {
+    this->Socket->CloseSocket();
+    this->Socket->Delete();
+    this->Socket = nullptr;
+  }
+
+  // a new host starts from scratch
+  this->Camera.clear();
+  this->Actors.clear();
+  this->HostArrays.clear();
+  this->Buffer.clear();
+  this->SendFailed = false;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneReplicator::IsConnected() const
+{
+  return this->Socket && this->Socket->GetConnected();
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSceneReplicator::GetAverageStepBytes() const
+{
+  return this->NumberOfSteps ? static_cast<double>(this->TotalBytes) / this->NumberOfSteps : 0.0;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneReplicator::SendStep()
+{
+  if (!this->IsConnected() || !this->Renderer)
+  {
+    vtkErrorMacro("A connection and a renderer are required to send a step");
+    return false;
+  }
+
+  const vtkTypeUInt64 bytesBefore = this->TotalBytes;
+  this->SendCamera();
+
+  std::set<vtkActor*> current;
+  vtkActorCollection* actors = this->Renderer->GetActors();
+  vtkCollectionSimpleIterator it;
+  actors->InitTraversal(it);
+  while (vtkActor* actor = actors->GetNextActor(it))
+  {
+    if (!vtkPolyDataMapper::SafeDownCast(actor->GetMapper()))
+    {
+      continue;
+    }
+    current.insert(actor);
+    ActorState& state = this->Actors[actor];
+    if (!state.Id)
+    {
+      state.Actor = actor;
+      state.Id = ++this->NextActorId;
+    }
+    this->SendActor(actor, state);
+  }
+
+  // actors removed from the renderer
+  for (auto iter = this->Actors.begin(); iter != this->Actors.end();)
+  {
+    if (current.count(iter->first))
+    {
+      ++iter;
+      continue;
+    }
+    this->Append(protocol::RemoveActorMessage, &iter->second.Id, sizeof(vtkTypeUInt64));
+    iter = this->Actors.erase(iter);
+  }
+
+  // the host drops the arrays that no actor uses anymore, do the same
+  this->HostArrays.clear();
+  for (const auto& entry : this->Actors)
+  {
+    this->HostArrays.insert(entry.second.Arrays.begin(), entry.second.Arrays.end());
+  }
+
+  vtkTypeUInt64 step = this->NumberOfSteps + 1;
+  this->Append(protocol::EndStepMessage, &step, sizeof(step));
+  if (!this->Flush())
+  {
+    vtkErrorMacro("Unable to send the scene changes, disconnecting");
+    this->Disconnect();
+    return false;
+  }
+
+  this->NumberOfSteps = step;
+  this->LastStepBytes = this->TotalBytes - bytesBefore;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneReplicator::SendCamera()
+{
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+  std::vector<double> values(protocol::CameraValues);
+  camera->GetPosition(&values[0]);
+  camera->GetFocalPoint(&values[3]);
+  camera->GetViewUp(&values[6]);
+  values[9] = camera->GetViewAngle();
+  values[10] = camera->GetParallelScale();
+  values[11] = camera->GetParallelProjection();
+  if (values != this->Camera)
+  {
+    this->Append(protocol::CameraMessage, values.data(), values.size() * sizeof(double));
+    this->Camera.swap(values);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneReplicator::SendActor(vtkActor* actor, ActorState& state)
+{
+  // data first, a new actor has to be created before it is moved around
+  vtkPolyDataMapper* mapper = vtkPolyDataMapper::SafeDownCast(actor->GetMapper());
+  mapper->Update();
+  vtkPolyData* data = mapper->GetInput();
+  if (data && (data != state.Data || data->GetMTime() != state.DataTime))
+  {
+    this->SendData(state, data);
+    state.Data = data;
+    state.DataTime = data->GetMTime();
+  }
+
+  vtkMatrix4x4* matrix = actor->GetMatrix();
+  std::vector<double> elements(matrix->GetData(), matrix->GetData() + 16);
+  if (elements != state.Matrix)
+  {
+    this->Append(protocol::ActorTransformMessage, &state.Id, sizeof(vtkTypeUInt64),
+      elements.data(), elements.size() * sizeof(double));
+    state.Matrix.swap(elements);
+  }
+
+  vtkProperty* property = actor->GetProperty();
+  std::vector<double> values(protocol::PropertyValues);
+  property->GetColor(&values[0]);
+  values[3] = property->GetOpacity();
+  values[4] = property->GetAmbient();
+  values[5] = property->GetDiffuse();
+  values[6] = property->GetSpecular();
+  values[7] = property->GetSpecularPower();
+  values[8] = property->GetPointSize();
+  values[9] = property->GetLineWidth();
+  values[10] = property->GetRepresentation();
+  values[11] = actor->GetVisibility();
+  values[12] = mapper->GetScalarVisibility();
+  mapper->GetScalarRange(&values[13]);
+  if (values != state.Property)
+  {
+    this->Append(protocol::ActorPropertyMessage, &state.Id, sizeof(vtkTypeUInt64), values.data(),
+      values.size() * sizeof(double));
+    state.Property.swap(values);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneReplicator::SendData(ActorState& state, vtkPolyData* data)
+{
+  struct Entry
+  {
+    vtkDataArray* Array;
+    vtkTypeUInt32 Role;
+    int Attribute;
+  };
+  std::vector<Entry> entries;
+  if (data->GetPoints())
+  {
+    entries.push_back({ data->GetPoints()->GetData(), protocol::PointsRole, -1 });
+  }
+  vtkCellArray* cells[4] = { data->GetVerts(), data->GetLines(), data->GetPolys(),
+    data->GetStrips() };
+  for (vtkTypeUInt32 i = 0; i < 4; ++i)
+  {
+    if (cells[i] && cells[i]->GetNumberOfCells() > 0)
+    {
+      entries.push_back({ cells[i]->GetOffsetsArray(), protocol::VertsOffsetsRole + 2 * i, -1 });
+      entries.push_back(
+        { cells[i]->GetConnectivityArray(), protocol::VertsConnectivityRole + 2 * i, -1 });
+    }
+  }
+  vtkDataSetAttributes* attributes[2] = { data->GetPointData(), data->GetCellData() };
+  for (int i = 0; i < 2; ++i)
+  {
+    for (int j = 0; j < attributes[i]->GetNumberOfArrays(); ++j)
+    {
+      if (vtkDataArray* array = attributes[i]->GetArray(j))
+      {
+        entries.push_back({ array, i == 0 ? protocol::PointDataRole : protocol::CellDataRole,
+          attributes[i]->IsArrayAnAttribute(j) });
+      }
+    }
+  }
+
+  std::vector<unsigned char> message(protocol::ActorDataHeaderSize);
+  protocol::Put(message.data(), 0, state.Id);
+  protocol::Put(message.data(), 8, static_cast<vtkTypeUInt32>(entries.size()));
+  state.Arrays.clear();
+  for (const Entry& entry : entries)
+  {
+    vtkTypeUInt64 hash = this->SendArray(entry.Array);
+    state.Arrays.push_back(hash);
+
+    std::string name = entry.Array->GetName() ? entry.Array->GetName() : "";
+    size_t offset = message.size();
+    message.resize(offset + protocol::ArrayEntrySize + name.size());
+    unsigned char* field = message.data() + offset;
+    protocol::Put(field, protocol::EntryHashOffset, hash);
+    protocol::Put(field, protocol::EntryTuplesOffset,
+      static_cast<vtkTypeUInt64>(entry.Array->GetNumberOfTuples()));
+    protocol::Put(field, protocol::EntryRoleOffset, entry.Role);
+    protocol::Put(field, protocol::EntryDataTypeOffset,
+      static_cast<vtkTypeInt32>(entry.Array->GetDataType()));
+    protocol::Put(field, protocol::EntryComponentsOffset,
+      static_cast<vtkTypeInt32>(entry.Array->GetNumberOfComponents()));
+    protocol::Put(
+      field, protocol::EntryAttributeOffset, static_cast<vtkTypeInt32>(entry.Attribute));
+    protocol::Put(
+      field, protocol::EntryNameLengthOffset, static_cast<vtkTypeUInt32>(name.size()));
+    std::copy(name.begin(), name.end(), field + protocol::ArrayEntrySize);
+  }
+  this->Append(protocol::ActorDataMessage, message.data(), message.size());
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkLookingGlassSceneReplicator::SendArray(vtkDataArray* array)
+{
+  // the layout and name are part of the hash, the host shares the array itself
+  const std::string name = array->GetName() ? array->GetName() : "";
+  const int layout[2] = { array->GetDataType(), array->GetNumberOfComponents() };
+  vtkTypeUInt64 hash = protocol::Hash(name.data(), name.size());
+  hash = protocol::Hash(layout, sizeof(layout), hash);
+
+  const size_t size = static_cast<size_t>(array->GetNumberOfValues()) * array->GetDataTypeSize();
+  const unsigned char* bytes =
+    size ? static_cast<const unsigned char*>(array->GetVoidPointer(0)) : nullptr;
+  hash = protocol::Hash(bytes, size, hash);
+
+  if (this->HostArrays.count(hash))
+  {
+    ++this->NumberOfArraysReused;
+    return hash;
+  }
+
+  unsigned char header[protocol::ArrayChunkHeaderSize];
+  protocol::Put(header, protocol::ChunkHashOffset, hash);
+  protocol::Put(header, protocol::ChunkTotalSizeOffset, static_cast<vtkTypeUInt64>(size));
+  size_t offset = 0;
+  do
+  {
+    const size_t chunk = std::min(size - offset, static_cast<size_t>(this->ChunkSize));
+    protocol::Put(header, protocol::ChunkOffsetOffset, static_cast<vtkTypeUInt64>(offset));
+    this->Append(protocol::ArrayChunkMessage, header, sizeof(header), bytes + offset, chunk);
+    offset += chunk;
+  } while (offset < size);
+
+  this->HostArrays.insert(hash);
+  ++this->NumberOfArraysSent;
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSceneReplicator::Append(
+  vtkTypeUInt32 type, const void* data, size_t size, const void* extra, size_t extraSize)
+{
+  unsigned char header[protocol::MessageHeaderSize];
+  protocol::Put(header, protocol::MagicOffset, protocol::Magic);
+  protocol::Put(header, protocol::TypeOffset, type);
+  protocol::Put(
+    header, protocol::PayloadSizeOffset, static_cast<vtkTypeUInt64>(size + extraSize));
+
+  this->Buffer.insert(this->Buffer.end(), header, header + sizeof(header));
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  this->Buffer.insert(this->Buffer.end(), bytes, bytes + size);
+  if (extraSize)
+  {
+    bytes = static_cast<const unsigned char*>(extra);
+    this->Buffer.insert(this->Buffer.end(), bytes, bytes + extraSize);
+  }
+
+  // keep the buffer around the chunk size for large data
+  if (this->Buffer.size() >= static_cast<size_t>(this->ChunkSize))
+  {
+    this->Flush();
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSceneReplicator::Flush()
+{
+  if (!this->SendFailed && !this->Buffer.empty())
+  {
+    this->SendFailed =
+      !this->Socket->Send(this->Buffer.data(), static_cast<int>(this->Buffer.size()));
+    this->TotalBytes += this->Buffer.size();
+  }
+  this->Buffer.clear();
+  return !this->SendFailed;
+}
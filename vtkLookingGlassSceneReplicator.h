@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSceneReplicator
+ * @brief   Send the changes made to a scene to a vtkLookingGlassSceneHost.
+ *
+ * Streaming rendered quilts takes a lot of bandwidth. Instead, the
+ * replicator mirrors a renderer of the application on a render host that
+ * drives the Looking Glass, and the host renders the quilts itself.
+ *
+ * Each call to SendStep() compares the renderer with what was sent before
+ * and only sends what changed: the camera, the actor transforms, the actor
+ * properties, and the poly data of actors whose input was modified. Data
+ * arrays are sent in chunks of ChunkSize bytes and identified by a hash of
+ * their contents, so arrays shared by several actors, or left unchanged by
+ * an edit of their poly data, are only sent once.
+ *
+ * Only actors with a vtkPolyDataMapper are replicated. Their lookup tables
+ * and textures are not, the host uses its defaults.
+ *
+ * @sa
+ * vtkLookingGlassSceneHost
+ */
+
+#ifndef vtkLookingGlassSceneReplicator_h
+#define vtkLookingGlassSceneReplicator_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkSmartPointer.h"                // For vtkSmartPointer
+
+#include <map>    // For std::map
+#include <set>    // For std::set
+#include <vector> // For std::vector
+
+class vtkActor;
+class vtkClientSocket;
+class vtkDataArray;
+class vtkPolyData;
+class vtkRenderer;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassSceneReplicator : public vtkObject
+{
+public:
+  static vtkLookingGlassSceneReplicator* New();
+  vtkTypeMacro(vtkLookingGlassSceneReplicator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Connect to a host. Returns false if the connection failed.
+   */
+  bool Connect(const char* hostName, int port);
+
+  /**
+   * Close the connection and forget what was sent.
+   */
+  void Disconnect();
+
+  /**
+   * Check if the replicator is connected.
+   */
+  bool IsConnected() const;
+
+  //@{
+  /**
+   * Set/Get the renderer to replicate.
+   */
+  void SetRenderer(vtkRenderer* renderer);
+  vtkGetObjectMacro(Renderer, vtkRenderer);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the largest number of array bytes sent in one message.
+   * Default is 1 MiB.
+   */
+  vtkSetClampMacro(ChunkSize, int, 1024, VTK_INT_MAX);
+  vtkGetMacro(ChunkSize, int);
+  //@}
+
+  /**
+   * Send what changed in the renderer since the last step, then tell the
+   * host to render. Call it once per interaction step, typically from a
+   * render or interaction observer. Returns false if sending failed.
+   */
+  bool SendStep();
+
+  //@{
+  /**
+   * Get the number of bytes sent by the last step and by all the steps,
+   * headers included, and the number of steps sent.
+   */
+  vtkGetMacro(LastStepBytes, vtkTypeUInt64);
+  vtkGetMacro(TotalBytes, vtkTypeUInt64);
+  vtkGetMacro(NumberOfSteps, vtkTypeUInt64);
+  //@}
+
+  /**
+   * Get the average number of bytes sent per step.
+   */
+  double GetAverageStepBytes() const;
+
+  //@{
+  /**
+   * Get the number of arrays sent, and the number of arrays that the host
+   * already had and were only referred to.
+   */
+  vtkGetMacro(NumberOfArraysSent, vtkTypeUInt64);
+  vtkGetMacro(NumberOfArraysReused, vtkTypeUInt64);
+  //@}
+
+protected:
+  vtkLookingGlassSceneReplicator();
+  ~vtkLookingGlassSceneReplicator() override;
+
+  struct ActorState
+  {
+    vtkSmartPointer<vtkActor> Actor;
+    vtkTypeUInt64 Id = 0;
+    std::vector<double> Matrix;
+    std::vector<double> Property;
+    // only compared to the mapper input, never dereferenced
+    vtkPolyData* Data = nullptr;
+    vtkMTimeType DataTime = 0;
+    std::vector<vtkTypeUInt64> Arrays;
+  };
+
+  void SendCamera();
+  void SendActor(vtkActor* actor, ActorState& state);
+  void SendData(ActorState& state, vtkPolyData* data);
+  vtkTypeUInt64 SendArray(vtkDataArray* array);
+  void Append(vtkTypeUInt32 type, const void* data, size_t size, const void* extra = nullptr,
+    size_t extraSize = 0);
+  bool Flush();
+
+  vtkClientSocket* Socket;
+  vtkRenderer* Renderer;
+  int ChunkSize;
+  vtkTypeUInt64 LastStepBytes;
+  vtkTypeUInt64 TotalBytes;
+  vtkTypeUInt64 NumberOfSteps;
+  vtkTypeUInt64 NumberOfArraysSent;
+  vtkTypeUInt64 NumberOfArraysReused;
+  vtkTypeUInt64 NextActorId;
+  bool SendFailed;
+  std::vector<unsigned char> Buffer;
+  std::vector<double> Camera;
+  std::map<vtkActor*, ActorState> Actors;
+  std::set<vtkTypeUInt64> HostArrays;
+
+private:
+  vtkLookingGlassSceneReplicator(const vtkLookingGlassSceneReplicator&) = delete;
+  void operator=(const vtkLookingGlassSceneReplicator&) = delete;
+};
+
+#endif
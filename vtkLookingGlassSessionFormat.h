@@ -0,0 +1,185 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * The session logs written by vtkLookingGlassSessionRecorder and replayed
+ * by vtkLookingGlassSessionPlayer.
+ *
+ * A log is a text file with one JSON object per line, each with a "type":
+ *
+ *  - "session", first: "version", "device" settings, "windowSize", and
+ *    "props", the number of props of each renderer of the window.
+ *  - "interaction": "event" is "start" or "end", "time" in seconds since
+ *    the start of the recording.
+ *  - "prop": "id", "visible" and, for 3D props, "transform" (PropValues).
+ *  - "property": "id" of an actor and "values" (PropertyValues).
+ *  - "data": "id" of a prop whose mapper input was modified, with its
+ *    number of "points" and "cells".
+ *  - "frame": "index", "time", and "cameras", CameraValues per renderer.
+ *  - "end", last: "frames" and "time".
+ *
+ * The changes of the props are written just before the frame that first
+ * rendered them. Props are numbered by renderer, in the order of their
+ * view props, so a log only replays against the same scene.
+ */
+
+#ifndef vtkLookingGlassSessionFormat_h
+#define vtkLookingGlassSessionFormat_h
+
+#include "vtkAbstractVolumeMapper.h"
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkDataObject.h"
+#include "vtkMapper.h"
+#include "vtkProp3D.h"
+#include "vtkPropCollection.h"
+#include "vtkProperty.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+#include "vtkVolume.h"
+
+#include <vector>
+
+namespace vtkLookingGlassSessionFormat
+{
+const int Version = 1;
+
+// position, focal point, view up, view angle, parallel scale and parallel
+// projection, as in vtkLookingGlassSceneProtocol
+const int CameraValues = 12;
+
+// position, orientation, scale and origin
+const int PropValues = 12;
+
+// color, opacity, ambient, diffuse, specular, specular power, point size,
+// line width, representation, scalar visibility and scalar range
+const int PropertyValues = 14;
+
+// the renderers of a window and their props, in log order
+inline void GetScene(vtkRenderWindow* window, std::vector<vtkRenderer*>& renderers,
+  std::vector<vtkProp*>& props, std::vector<int>& counts)
+{
+  renderers.clear();
+  props.clear();
+  counts.clear();
+  vtkCollectionSimpleIterator rit;
+  window->GetRenderers()->InitTraversal(rit);
+  while (vtkRenderer* renderer = window->GetRenderers()->GetNextRenderer(rit))
+  {
+    renderers.push_back(renderer);
+    int count = 0;
+    vtkCollectionSimpleIterator pit;
+    vtkPropCollection* viewProps = renderer->GetViewProps();
+    viewProps->InitTraversal(pit);
+    while (vtkProp* prop = viewProps->GetNextProp(pit))
+    {
+      props.push_back(prop);
+      ++count;
+    }
+    counts.push_back(count);
+  }
+}
+
+inline void GetCamera(vtkCamera* camera, double* values)
+{
+  camera->GetPosition(values);
+  camera->GetFocalPoint(values + 3);
+  camera->GetViewUp(values + 6);
+  values[9] = camera->GetViewAngle();
+  values[10] = camera->GetParallelScale();
+  values[11] = camera->GetParallelProjection();
+}
+
+inline void SetCamera(vtkCamera* camera, const double* values)
+{
+  camera->SetPosition(values);
+  camera->SetFocalPoint(values + 3);
+  camera->SetViewUp(values + 6);
+  camera->SetViewAngle(values[9]);
+  camera->SetParallelScale(values[10]);
+  camera->SetParallelProjection(values[11] != 0.0);
+}
+
+inline void GetProp(vtkProp3D* prop, double* values)
+{
+  prop->GetPosition(values);
+  prop->GetOrientation(values + 3);
+  prop->GetScale(values + 6);
+  prop->GetOrigin(values + 9);
+}
+
+inline void SetProp(vtkProp3D* prop, const double* values)
+{
+  prop->SetPosition(values);
+  prop->SetOrientation(values + 3);
+  prop->SetScale(values + 6);
+  prop->SetOrigin(values + 9);
+}
+
+inline void GetProperty(vtkActor* actor, double* values)
+{
+  vtkProperty* property = actor->GetProperty();
+  property->GetColor(values);
+  values[3] = property->GetOpacity();
+  values[4] = property->GetAmbient();
+  values[5] = property->GetDiffuse();
+  values[6] = property->GetSpecular();
+  values[7] = property->GetSpecularPower();
+  values[8] = property->GetPointSize();
+  values[9] = property->GetLineWidth();
+  values[10] = property->GetRepresentation();
+  vtkMapper* mapper = actor->GetMapper();
+  values[11] = mapper ? mapper->GetScalarVisibility() : 0.0;
+  values[12] = mapper ? mapper->GetScalarRange()[0] : 0.0;
+  values[13] = mapper ? mapper->GetScalarRange()[1] : 1.0;
+}
+
+inline void SetProperty(vtkActor* actor, const double* values)
+{
+  vtkProperty* property = actor->GetProperty();
+  property->SetColor(values[0], values[1], values[2]);
+  property->SetOpacity(values[3]);
+  property->SetAmbient(values[4]);
+  property->SetDiffuse(values[5]);
+  property->SetSpecular(values[6]);
+  property->SetSpecularPower(values[7]);
+  property->SetPointSize(values[8]);
+  property->SetLineWidth(values[9]);
+  property->SetRepresentation(static_cast<int>(values[10]));
+  if (vtkMapper* mapper = actor->GetMapper())
+  {
+    mapper->SetScalarVisibility(values[11] != 0.0);
+    mapper->SetScalarRange(values[12], values[13]);
+  }
+}
+
+// the input of the mapper of an actor or a volume, if any
+inline vtkDataObject* GetData(vtkProp* prop)
+{
+  vtkAlgorithm* mapper = nullptr;
+  if (vtkActor* actor = vtkActor::SafeDownCast(prop))
+  {
+    mapper = actor->GetMapper();
+  }
+  else if (vtkVolume* volume = vtkVolume::SafeDownCast(prop))
+  {
+    mapper = volume->GetMapper();
+  }
+  if (!mapper || mapper->GetNumberOfInputConnections(0) < 1)
+  {
+    return nullptr;
+  }
+  return mapper->GetInputDataObject(0, 0);
+}
+}
+
+#endif
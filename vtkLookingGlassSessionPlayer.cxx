@@ -0,0 +1,390 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSessionPlayer.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkLookingGlassFrameStatistics.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassSessionFormat.h"
+#include "vtkObjectFactory.h"
+
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace format = vtkLookingGlassSessionFormat;
+
+vtkStandardNewMacro(vtkLookingGlassSessionPlayer);
+vtkCxxSetObjectMacro(vtkLookingGlassSessionPlayer, RenderWindow, vtkRenderWindow);
+vtkCxxSetObjectMacro(vtkLookingGlassSessionPlayer, Interface, vtkLookingGlassInterface);
+
+namespace
+{
+// reads count numbers from a JSON array, false if it does not have them
+bool FromJson(const Json::Value& array, double* values, int count)
+{
+  if (!array.isArray() || static_cast<int>(array.size()) != count)
+  {
+    return false;
+  }
+  for (int i = 0; i < count; ++i)
+  {
+    values[i] = array[i].asDouble();
+  }
+  return true;
+}
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSessionPlayer::vtkLookingGlassSessionPlayer()
+  : RenderWindow(nullptr)
+  , Interface(nullptr)
+  , FileName(nullptr)
+  , RealTime(false)
+  , InteractiveUpdateRate(15.0)
+  , StillUpdateRate(0.0001)
+  , FrameTimes(vtkDoubleArray::New())
+  , NumberOfInteractiveFrames(0)
+  , RecordedDuration(0.0)
+{
+  this->FrameTimes->SetName("FrameTimes");
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSessionPlayer::~vtkLookingGlassSessionPlayer()
+{
+  this->SetRenderWindow(nullptr);
+  this->SetInterface(nullptr);
+  this->SetFileName(nullptr);
+  this->FrameTimes->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionPlayer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Interface: " << this->Interface << "\n";
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "RealTime: " << this->RealTime << "\n";
+  os << indent << "InteractiveUpdateRate: " << this->InteractiveUpdateRate << "\n";
+  os << indent << "StillUpdateRate: " << this->StillUpdateRate << "\n";
+  os << indent << "NumberOfFrames: " << this->GetNumberOfFrames() << "\n";
+  os << indent << "NumberOfInteractiveFrames: " << this->NumberOfInteractiveFrames << "\n";
+  os << indent << "RecordedDuration: " << this->RecordedDuration << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSessionPlayer::Replay()
+{
+  this->FrameTimes->Reset();
+  this->Interactive.clear();
+  this->NumberOfInteractiveFrames = 0;
+  this->RecordedDuration = 0.0;
+
+  if (!this->RenderWindow || !this->FileName)
+  {
+    vtkErrorMacro("A render window and a file name are required");
+    return false;
+  }
+
+  // read the whole log first so reading does not count in the frame times
+  vtksys::ifstream file(this->FileName);
+  if (!file)
+  {
+    vtkErrorMacro("Unable to open " << this->FileName);
+    return false;
+  }
+  std::vector<Json::Value> lines;
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+  std::string text;
+  int frames = 0;
+  while (std::getline(file, text))
+  {
+    if (text.empty())
+    {
+      continue;
+    }
+    Json::Value line;
+    std::string errors;
+    if (!reader->parse(text.data(), text.data() + text.size(), &line, &errors) ||
+      !line.isObject())
+    {
+      vtkErrorMacro("Invalid line " << lines.size() + 1 << " in " << this->FileName << ": "
+                                    << errors);
+      return false;
+    }
+    frames += line["type"].asString() == "frame" ? 1 : 0;
+    lines.push_back(line);
+  }
+
+  if (lines.empty() || lines[0]["type"].asString() != "session")
+  {
+    vtkErrorMacro(<< this->FileName << " is not a session log");
+    return false;
+  }
+  const Json::Value& header = lines[0];
+  if (header["version"].asInt() > format::Version)
+  {
+    vtkErrorMacro(<< this->FileName << " has an unsupported version "
+                  << header["version"].asInt());
+    return false;
+  }
+
+  std::vector<vtkRenderer*> renderers;
+  std::vector<vtkProp*> props;
+  std::vector<int> counts;
+  format::GetScene(this->RenderWindow, renderers, props, counts);
+  const Json::Value& recordedCounts = header["props"];
+  bool match = recordedCounts.isArray() && recordedCounts.size() == counts.size();
+  for (Json::ArrayIndex i = 0; match && i < recordedCounts.size(); ++i)
+  {
+    match = recordedCounts[i].asInt() == counts[i];
+  }
+  if (!match)
+  {
+    vtkErrorMacro("The scene of the window does not match the one of " << this->FileName);
+    return false;
+  }
+
+  vtkLookingGlassFrameStatistics* stats = nullptr;
+  if (vtkLookingGlassInterface* lg = this->Interface)
+  {
+    const Json::Value& device = header["device"];
+    if (!device.isObject() || device["type"].asString() != lg->GetDeviceType() ||
+      device["quiltTiles"][0].asInt() != lg->GetQuiltTiles()[0] ||
+      device["quiltTiles"][1].asInt() != lg->GetQuiltTiles()[1] ||
+      device["renderSize"][0].asInt() != lg->GetRenderSize()[0] ||
+      device["renderSize"][1].asInt() != lg->GetRenderSize()[1])
+    {
+      vtkWarningMacro("The session was recorded with other device settings, the frame times "
+                      "will not be comparable");
+    }
+    lg->CollectStatisticsOn();
+    stats = lg->GetStatistics();
+    stats->SetWindowSize(std::max(frames, 1));
+    stats->Reset();
+  }
+
+  const double updateRate = this->RenderWindow->GetDesiredUpdateRate();
+  this->RenderWindow->SetDesiredUpdateRate(this->StillUpdateRate);
+  this->FrameTimes->Allocate(frames);
+  this->Interactive.reserve(frames);
+
+  bool interacting = false;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t l = 1; l < lines.size(); ++l)
+  {
+    const Json::Value& line = lines[l];
+    const std::string type = line["type"].asString();
+    const int id = line["id"].asInt();
+    vtkProp* prop = id >= 0 && id < static_cast<int>(props.size()) ? props[id] : nullptr;
+
+    if (type == "interaction")
+    {
+      interacting = line["event"].asString() == "start";
+      this->RenderWindow->SetDesiredUpdateRate(
+        interacting ? this->InteractiveUpdateRate : this->StillUpdateRate);
+    }
+    else if (type == "prop" && prop)
+    {
+      prop->SetVisibility(line["visible"].asBool());
+      double values[format::PropValues];
+      vtkProp3D* prop3D = vtkProp3D::SafeDownCast(prop);
+      if (prop3D && FromJson(line["transform"], values, format::PropValues))
+      {
+        format::SetProp(prop3D, values);
+      }
+    }
+    else if (type == "property" && prop)
+    {
+      double values[format::PropertyValues];
+      vtkActor* actor = vtkActor::SafeDownCast(prop);
+      if (actor && FromJson(line["values"], values, format::PropertyValues))
+      {
+        format::SetProperty(actor, values);
+      }
+    }
+    else if (type == "data" && prop)
+    {
+      if (vtkDataObject* data = format::GetData(prop))
+      {
+        data->Modified();
+      }
+    }
+    else if (type == "frame")
+    {
+      const Json::Value& cameras = line["cameras"];
+      for (Json::ArrayIndex i = 0; i < cameras.size() && i < renderers.size(); ++i)
+      {
+        double values[format::CameraValues];
+        if (FromJson(cameras[i], values, format::CameraValues))
+        {
+          format::SetCamera(renderers[i]->GetActiveCamera(), values);
+          renderers[i]->ResetCameraClippingRange();
+        }
+      }
+
+      if (this->RealTime)
+      {
+        std::this_thread::sleep_until(
+          start + std::chrono::duration<double>(line["time"].asDouble()));
+      }
+
+      const auto frameStart = std::chrono::steady_clock::now();
+      this->RenderWindow->Render();
+      this->RenderWindow->WaitForCompletion();
+      const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+
+      this->FrameTimes->InsertNextValue(seconds);
+      this->Interactive.push_back(interacting);
+      this->NumberOfInteractiveFrames += interacting ? 1 : 0;
+    }
+    else if (type == "end")
+    {
+      this->RecordedDuration = line["time"].asDouble();
+    }
+  }
+
+  this->RenderWindow->SetDesiredUpdateRate(updateRate);
+  if (stats)
+  {
+    // flush the GPU timings of the last frames
+    this->RenderWindow->Render();
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassSessionPlayer::GetNumberOfFrames() const
+{
+  return static_cast<int>(this->FrameTimes->GetNumberOfTuples());
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionPlayer::GetTotalTime() const
+{
+  double total = 0.0;
+  for (vtkIdType i = 0; i < this->FrameTimes->GetNumberOfTuples(); ++i)
+  {
+    total += this->FrameTimes->GetValue(i);
+  }
+  return total;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionPlayer::GetAverageFrameTime() const
+{
+  const int frames = this->GetNumberOfFrames();
+  return frames ? this->GetTotalTime() / frames : 0.0;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionPlayer::GetFrameTimePercentile(double percentile) const
+{
+  const vtkIdType frames = this->FrameTimes->GetNumberOfTuples();
+  if (!frames)
+  {
+    return 0.0;
+  }
+  std::vector<double> times(
+    this->FrameTimes->GetPointer(0), this->FrameTimes->GetPointer(0) + frames);
+  std::sort(times.begin(), times.end());
+  const double rank = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * (frames - 1);
+  return times[static_cast<size_t>(rank + 0.5)];
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionPlayer::AverageFrameTime(bool interactive) const
+{
+  double total = 0.0;
+  int count = 0;
+  for (size_t i = 0; i < this->Interactive.size(); ++i)
+  {
+    if (this->Interactive[i] == interactive)
+    {
+      total += this->FrameTimes->GetValue(static_cast<vtkIdType>(i));
+      ++count;
+    }
+  }
+  return count ? total / count : 0.0;
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionPlayer::GetAverageInteractiveFrameTime() const
+{
+  return this->AverageFrameTime(true);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionPlayer::GetAverageStillFrameTime() const
+{
+  return this->AverageFrameTime(false);
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSessionPlayer::WriteResults(const char* fileName)
+{
+  if (!fileName)
+  {
+    vtkErrorMacro("A file name is required");
+    return false;
+  }
+
+  Json::Value results;
+  results["session"] = this->FileName ? this->FileName : "";
+  results["frames"] = this->GetNumberOfFrames();
+  results["interactiveFrames"] = this->NumberOfInteractiveFrames;
+  results["recordedSeconds"] = this->RecordedDuration;
+  results["replaySeconds"] = this->GetTotalTime();
+  results["frameMs"] = this->GetAverageFrameTime() * 1000.0;
+  results["frameMsP50"] = this->GetFrameTimePercentile(50.0) * 1000.0;
+  results["frameMsP95"] = this->GetFrameTimePercentile(95.0) * 1000.0;
+  results["frameMsMax"] = this->GetFrameTimePercentile(100.0) * 1000.0;
+  results["interactiveFrameMs"] = this->GetAverageInteractiveFrameTime() * 1000.0;
+  results["stillFrameMs"] = this->GetAverageStillFrameTime() * 1000.0;
+  results["frameTimesMs"] = Json::arrayValue;
+  for (vtkIdType i = 0; i < this->FrameTimes->GetNumberOfTuples(); ++i)
+  {
+    results["frameTimesMs"].append(this->FrameTimes->GetValue(i) * 1000.0);
+  }
+
+  vtkLookingGlassInterface* lg = this->Interface;
+  if (lg && lg->GetCollectStatistics())
+  {
+    vtkLookingGlassFrameStatistics* stats = lg->GetStatistics();
+    Json::Value& phases = results["phases"];
+    for (int phase = 0; phase < vtkLookingGlassFrameStatistics::NUMBER_OF_PHASES; ++phase)
+    {
+      Json::Value& entry = phases[vtkLookingGlassFrameStatistics::GetPhaseName(phase)];
+      entry["cpuMs"] = stats->GetAverageCPUTime(phase);
+      entry["gpuMs"] = stats->GetAverageGPUTime(phase);
+    }
+  }
+
+  vtksys::ofstream file(fileName);
+  if (!file)
+  {
+    vtkErrorMacro("Unable to create " << fileName);
+    return false;
+  }
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  file << Json::writeString(builder, results) << "\n";
+  return static_cast<bool>(file);
+}
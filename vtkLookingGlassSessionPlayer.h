@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSessionPlayer
+ * @brief   Replay a recorded session and time its frames.
+ *
+ * Replays a log written by vtkLookingGlassSessionRecorder against the
+ * window it was recorded from, or one set up with the same scene, and
+ * measures how long each frame takes to render, up to the completion of
+ * the rendering on the GPU. Before each frame the recorded changes are
+ * applied to the props, the modified data is marked modified again so the
+ * mappers upload it, and the cameras are set. During the recorded
+ * interactions the desired update rate of the window is raised, as the
+ * interactor does, so the level of detail props behave as they did.
+ *
+ * The frames are rendered as fast as possible unless RealTime is on. If an
+ * interface is set, its frame statistics are collected over the replay and
+ * added to the results, and a warning is given if its device settings
+ * differ from the recorded ones. WriteResults saves the results as JSON to
+ * compare builds.
+ *
+ * @sa
+ * vtkLookingGlassSessionRecorder
+ */
+
+#ifndef vtkLookingGlassSessionPlayer_h
+#define vtkLookingGlassSessionPlayer_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <vector> // For std::vector
+
+class vtkDoubleArray;
+class vtkLookingGlassInterface;
+class vtkRenderWindow;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassSessionPlayer : public vtkObject
+{
+public:
+  static vtkLookingGlassSessionPlayer* New();
+  vtkTypeMacro(vtkLookingGlassSessionPlayer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the window the session is replayed in, and optionally the
+   * interface of its Looking Glass rendering.
+   */
+  void SetRenderWindow(vtkRenderWindow* renderWindow);
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+  void SetInterface(vtkLookingGlassInterface* lgInterface);
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the name of the log to replay.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  //@{
+  /**
+   * Set/Get whether the frames are rendered at the times they were
+   * recorded instead of as fast as possible. Defaults to false.
+   */
+  vtkSetMacro(RealTime, bool);
+  vtkGetMacro(RealTime, bool);
+  vtkBooleanMacro(RealTime, bool);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the desired update rates of the window during and outside the
+   * recorded interactions. Default to those of vtkRenderWindowInteractor.
+   */
+  vtkSetClampMacro(InteractiveUpdateRate, double, 0.0001, VTK_FLOAT_MAX);
+  vtkGetMacro(InteractiveUpdateRate, double);
+  vtkSetClampMacro(StillUpdateRate, double, 0.0001, VTK_FLOAT_MAX);
+  vtkGetMacro(StillUpdateRate, double);
+  //@}
+
+  /**
+   * Replay the session. Returns false if the log cannot be read or does not
+   * match the scene of the window.
+   */
+  bool Replay();
+
+  //@{
+  /**
+   * Get the results of the last replay. The frame times are in seconds,
+   * one per frame, and so is the recorded duration of the session.
+   */
+  vtkDoubleArray* GetFrameTimes() { return this->FrameTimes; }
+  int GetNumberOfFrames() const;
+  vtkGetMacro(NumberOfInteractiveFrames, int);
+  vtkGetMacro(RecordedDuration, double);
+  double GetTotalTime() const;
+  double GetAverageFrameTime() const;
+  double GetFrameTimePercentile(double percentile) const;
+  double GetAverageInteractiveFrameTime() const;
+  double GetAverageStillFrameTime() const;
+  //@}
+
+  /**
+   * Write the results of the last replay as JSON.
+   */
+  bool WriteResults(const char* fileName);
+
+protected:
+  vtkLookingGlassSessionPlayer();
+  ~vtkLookingGlassSessionPlayer() override;
+
+  vtkRenderWindow* RenderWindow;
+  vtkLookingGlassInterface* Interface;
+  char* FileName;
+  bool RealTime;
+  double InteractiveUpdateRate;
+  double StillUpdateRate;
+
+  vtkDoubleArray* FrameTimes;
+  int NumberOfInteractiveFrames;
+  double RecordedDuration;
+
+private:
+  vtkLookingGlassSessionPlayer(const vtkLookingGlassSessionPlayer&) = delete;
+  void operator=(const vtkLookingGlassSessionPlayer&) = delete;
+
+  double AverageFrameTime(bool interactive) const;
+
+  // whether each frame was rendered during an interaction
+  std::vector<bool> Interactive;
+};
+
+#endif
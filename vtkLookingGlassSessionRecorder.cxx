@@ -0,0 +1,367 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSessionRecorder.h"
+
+#include "vtkCallbackCommand.h"
+#include "vtkDataSet.h"
+#include "vtkInteractorObserver.h"
+#include "vtkLookingGlassInterface.h"
+#include "vtkLookingGlassSessionFormat.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindowInteractor.h"
+
+#include "vtk_jsoncpp.h"
+#include <vtksys/FStream.hxx>
+
+namespace format = vtkLookingGlassSessionFormat;
+
+vtkStandardNewMacro(vtkLookingGlassSessionRecorder);
+vtkCxxSetObjectMacro(vtkLookingGlassSessionRecorder, Interface, vtkLookingGlassInterface);
+
+namespace
+{
+Json::Value ToJson(const double* values, int count)
+{
+  Json::Value array(Json::arrayValue);
+  for (int i = 0; i < count; ++i)
+  {
+    array.append(values[i]);
+  }
+  return array;
+}
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSessionRecorder::vtkLookingGlassSessionRecorder()
+  : RenderWindow(nullptr)
+  , Interface(nullptr)
+  , Interactor(nullptr)
+  , FileName(nullptr)
+  , NumberOfFrames(0)
+  , FrameObserver(vtkCallbackCommand::New())
+  , InteractionObserver(vtkCallbackCommand::New())
+  , InteractorStyle(nullptr)
+  , FrameTag(0)
+  , InteractionTags{ 0, 0 }
+{
+  this->FrameObserver->SetCallback(&vtkLookingGlassSessionRecorder::FrameCallback);
+  this->FrameObserver->SetClientData(this);
+  this->InteractionObserver->SetCallback(&vtkLookingGlassSessionRecorder::InteractionCallback);
+  this->InteractionObserver->SetClientData(this);
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSessionRecorder::~vtkLookingGlassSessionRecorder()
+{
+  this->Stop();
+  this->SetRenderWindow(nullptr);
+  this->SetInterface(nullptr);
+  this->SetInteractor(nullptr);
+  this->SetFileName(nullptr);
+  this->FrameObserver->Delete();
+  this->InteractionObserver->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "RenderWindow: " << this->RenderWindow << "\n";
+  os << indent << "Interface: " << this->Interface << "\n";
+  os << indent << "Interactor: " << this->Interactor << "\n";
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::SetRenderWindow(vtkRenderWindow* renderWindow)
+{
+  if (renderWindow == this->RenderWindow)
+  {
+    return;
+  }
+  if (this->IsRecording())
+  {
+    vtkErrorMacro("The window cannot change while recording");
+    return;
+  }
+  vtkSetObjectBodyMacro(RenderWindow, vtkRenderWindow, renderWindow);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::SetInteractor(vtkRenderWindowInteractor* interactor)
+{
+  if (interactor == this->Interactor)
+  {
+    return;
+  }
+  if (this->IsRecording())
+  {
+    vtkErrorMacro("The interactor cannot change while recording");
+    return;
+  }
+  vtkSetObjectBodyMacro(Interactor, vtkRenderWindowInteractor, interactor);
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassSessionRecorder::GetTime() const
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - this->StartTime)
+    .count();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSessionRecorder::Start()
+{
+  this->Stop();
+  if (!this->RenderWindow || !this->FileName)
+  {
+    vtkErrorMacro("A render window and a file name are required");
+    return false;
+  }
+
+  std::unique_ptr<vtksys::ofstream> file(new vtksys::ofstream(this->FileName));
+  if (!*file)
+  {
+    vtkErrorMacro("Unable to create " << this->FileName);
+    return false;
+  }
+  this->Stream = std::move(file);
+  this->StartTime = std::chrono::steady_clock::now();
+  this->NumberOfFrames = 0;
+
+  std::vector<vtkProp*> props;
+  std::vector<int> counts;
+  format::GetScene(this->RenderWindow, this->Renderers, props, counts);
+  this->Props.clear();
+  for (vtkProp* prop : props)
+  {
+    this->Props.push_back({ prop, false, {}, {}, nullptr, 0 });
+  }
+  this->WriteHeader();
+
+  // the initial state of every prop goes before the first frame
+  for (size_t i = 0; i < this->Props.size(); ++i)
+  {
+    this->WriteChanges(this->Props[i], static_cast<int>(i), true);
+  }
+
+  this->FrameTag = this->RenderWindow->AddObserver(vtkCommand::EndEvent, this->FrameObserver);
+  this->InteractorStyle = this->Interactor ? this->Interactor->GetInteractorStyle() : nullptr;
+  if (this->InteractorStyle)
+  {
+    this->InteractorStyle->Register(this);
+    this->InteractionTags[0] = this->InteractorStyle->AddObserver(
+      vtkCommand::StartInteractionEvent, this->InteractionObserver);
+    this->InteractionTags[1] = this->InteractorStyle->AddObserver(
+      vtkCommand::EndInteractionEvent, this->InteractionObserver);
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::Stop()
+{
+  if (!this->IsRecording())
+  {
+    return;
+  }
+
+  this->RenderWindow->RemoveObserver(this->FrameTag);
+  if (this->InteractorStyle)
+  {
+    this->InteractorStyle->RemoveObserver(this->InteractionTags[0]);
+    this->InteractorStyle->RemoveObserver(this->InteractionTags[1]);
+    this->InteractorStyle->UnRegister(this);
+    this->InteractorStyle = nullptr;
+  }
+
+  Json::Value end;
+  end["type"] = "end";
+  end["frames"] = this->NumberOfFrames;
+  end["time"] = this->GetTime();
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  this->WriteLine(Json::writeString(builder, end));
+
+  this->Stream.reset();
+  this->Renderers.clear();
+  this->Props.clear();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::WriteLine(const std::string& line)
+{
+  *this->Stream << line << "\n";
+  if (!*this->Stream)
+  {
+    vtkErrorMacro("Unable to write to " << this->FileName);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::WriteHeader()
+{
+  Json::Value header;
+  header["type"] = "session";
+  header["version"] = format::Version;
+  const int* size = this->RenderWindow->GetSize();
+  header["windowSize"].append(size[0]);
+  header["windowSize"].append(size[1]);
+  header["props"] = Json::arrayValue;
+  for (const auto& renderer : this->Renderers)
+  {
+    header["props"].append(renderer->GetViewProps()->GetNumberOfItems());
+  }
+
+  if (vtkLookingGlassInterface* lg = this->Interface)
+  {
+    Json::Value& device = header["device"];
+    device["type"] = lg->GetDeviceType();
+    device["quiltTiles"].append(lg->GetQuiltTiles()[0]);
+    device["quiltTiles"].append(lg->GetQuiltTiles()[1]);
+    device["renderSize"].append(lg->GetRenderSize()[0]);
+    device["renderSize"].append(lg->GetRenderSize()[1]);
+    device["viewAngle"] = lg->GetViewAngle();
+    device["aspectRatio"] = lg->GetAdjustCameraAspectRatio();
+    device["useClippingLimits"] = lg->GetUseClippingLimits();
+    device["nearClippingLimit"] = lg->GetNearClippingLimit();
+    device["farClippingLimit"] = lg->GetFarClippingLimit();
+    device["quiltFormat"] = lg->GetQuiltFormat();
+    device["renderDepthBits"] = lg->GetRenderDepthBits();
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  this->WriteLine(Json::writeString(builder, header));
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::WriteChanges(PropState& state, int id, bool force)
+{
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  builder["precision"] = 17;
+
+  vtkProp* prop = state.Prop;
+  std::vector<double> transform;
+  if (vtkProp3D* prop3D = vtkProp3D::SafeDownCast(prop))
+  {
+    transform.resize(format::PropValues);
+    format::GetProp(prop3D, transform.data());
+  }
+  const bool visible = prop->GetVisibility() != 0;
+  if (force || visible != state.Visible || transform != state.Transform)
+  {
+    Json::Value line;
+    line["type"] = "prop";
+    line["id"] = id;
+    line["visible"] = visible;
+    if (!transform.empty())
+    {
+      line["transform"] = ToJson(transform.data(), format::PropValues);
+    }
+    this->WriteLine(Json::writeString(builder, line));
+    state.Visible = visible;
+    state.Transform.swap(transform);
+  }
+
+  if (vtkActor* actor = vtkActor::SafeDownCast(prop))
+  {
+    std::vector<double> values(format::PropertyValues);
+    format::GetProperty(actor, values.data());
+    if (force || values != state.Property)
+    {
+      Json::Value line;
+      line["type"] = "property";
+      line["id"] = id;
+      line["values"] = ToJson(values.data(), format::PropertyValues);
+      this->WriteLine(Json::writeString(builder, line));
+      state.Property.swap(values);
+    }
+  }
+
+  // the first state of the data is the one the replay starts from
+  vtkDataObject* data = format::GetData(prop);
+  if (data && (data != state.Data || data->GetMTime() != state.DataTime))
+  {
+    if (!force)
+    {
+      Json::Value line;
+      line["type"] = "data";
+      line["id"] = id;
+      vtkDataSet* dataSet = vtkDataSet::SafeDownCast(data);
+      line["points"] = static_cast<Json::Int64>(dataSet ? dataSet->GetNumberOfPoints() : 0);
+      line["cells"] = static_cast<Json::Int64>(dataSet ? dataSet->GetNumberOfCells() : 0);
+      this->WriteLine(Json::writeString(builder, line));
+    }
+    state.Data = data;
+    state.DataTime = data->GetMTime();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::WriteFrame()
+{
+  for (size_t i = 0; i < this->Props.size(); ++i)
+  {
+    this->WriteChanges(this->Props[i], static_cast<int>(i), false);
+  }
+
+  Json::Value frame;
+  frame["type"] = "frame";
+  frame["index"] = this->NumberOfFrames;
+  frame["time"] = this->GetTime();
+  frame["cameras"] = Json::arrayValue;
+  for (vtkRenderer* renderer : this->Renderers)
+  {
+    double values[format::CameraValues];
+    format::GetCamera(renderer->GetActiveCamera(), values);
+    frame["cameras"].append(ToJson(values, format::CameraValues));
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  builder["precision"] = 17;
+  this->WriteLine(Json::writeString(builder, frame));
+  ++this->NumberOfFrames;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::FrameCallback(
+  vtkObject*, unsigned long, void* clientData, void*)
+{
+  auto self = static_cast<vtkLookingGlassSessionRecorder*>(clientData);
+  if (self->IsRecording())
+  {
+    self->WriteFrame();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSessionRecorder::InteractionCallback(
+  vtkObject*, unsigned long event, void* clientData, void*)
+{
+  auto self = static_cast<vtkLookingGlassSessionRecorder*>(clientData);
+  if (!self->IsRecording())
+  {
+    return;
+  }
+
+  Json::Value line;
+  line["type"] = "interaction";
+  line["event"] = event == vtkCommand::StartInteractionEvent ? "start" : "end";
+  line["time"] = self->GetTime();
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  self->WriteLine(Json::writeString(builder, line));
+}
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSessionRecorder
+ * @brief   Log an interactive session so it can be replayed for timing.
+ *
+ * While recording, every render of the window adds a frame to the log
+ * with the camera of each renderer. Before a frame, the log gets the
+ * changes made since the previous one: the visibility and placement of
+ * the props, the properties of the actors, and the modification of the
+ * data they render. The start and end of the interactions of the
+ * interactor style, if an interactor is set, are logged as they happen,
+ * and the log starts with the device settings of the interface.
+ *
+ * The changes are found by comparing the scene with its state at the
+ * previous frame, so the props must not be added or removed while
+ * recording. Changes to user matrices and transforms are not logged.
+ *
+ * vtkLookingGlassSessionPlayer replays a log against the same scene and
+ * measures how long each frame takes.
+ *
+ * @sa
+ * vtkLookingGlassSessionPlayer
+ */
+
+#ifndef vtkLookingGlassSessionRecorder_h
+#define vtkLookingGlassSessionRecorder_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <chrono> // For std::chrono
+#include <memory> // For std::unique_ptr
+#include <string> // For std::string
+#include <vector> // For std::vector
+
+class vtkCallbackCommand;
+class vtkDataObject;
+class vtkLookingGlassInterface;
+class vtkProp;
+class vtkRenderWindow;
+class vtkRenderWindowInteractor;
+class vtkRenderer;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassSessionRecorder : public vtkObject
+{
+public:
+  static vtkLookingGlassSessionRecorder* New();
+  vtkTypeMacro(vtkLookingGlassSessionRecorder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the window whose renders are recorded, and the interface
+   * whose device settings start the log. The interface is optional, it is
+   * the one of a Looking Glass render window or of its vtkLookingGlassPass.
+   */
+  void SetRenderWindow(vtkRenderWindow* renderWindow);
+  vtkGetObjectMacro(RenderWindow, vtkRenderWindow);
+  void SetInterface(vtkLookingGlassInterface* lgInterface);
+  vtkGetObjectMacro(Interface, vtkLookingGlassInterface);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the interactor whose style reports the start and end of the
+   * interactions. Optional.
+   */
+  void SetInteractor(vtkRenderWindowInteractor* interactor);
+  vtkGetObjectMacro(Interactor, vtkRenderWindowInteractor);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the name of the log file.
+   */
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+  //@}
+
+  /**
+   * Start recording, overwriting the log file. Returns false if the file
+   * cannot be created or no window is set.
+   */
+  bool Start();
+
+  /**
+   * Stop recording and close the log.
+   */
+  void Stop();
+
+  /**
+   * Check if a session is being recorded.
+   */
+  bool IsRecording() const { return this->Stream != nullptr; }
+
+  /**
+   * Get the number of frames recorded so far.
+   */
+  vtkGetMacro(NumberOfFrames, int);
+
+protected:
+  vtkLookingGlassSessionRecorder();
+  ~vtkLookingGlassSessionRecorder() override;
+
+  vtkRenderWindow* RenderWindow;
+  vtkLookingGlassInterface* Interface;
+  vtkRenderWindowInteractor* Interactor;
+  char* FileName;
+  int NumberOfFrames;
+
+private:
+  vtkLookingGlassSessionRecorder(const vtkLookingGlassSessionRecorder&) = delete;
+  void operator=(const vtkLookingGlassSessionRecorder&) = delete;
+
+  // the state of a prop at the last frame
+  struct PropState
+  {
+    vtkProp* Prop;
+    bool Visible;
+    std::vector<double> Transform;
+    std::vector<double> Property;
+    vtkDataObject* Data;
+    vtkMTimeType DataTime;
+  };
+
+  static void FrameCallback(vtkObject*, unsigned long, void*, void*);
+  static void InteractionCallback(vtkObject*, unsigned long, void*, void*);
+  void WriteHeader();
+  void WriteFrame();
+  void WriteChanges(PropState& state, int id, bool force);
+  void WriteLine(const std::string& line);
+  double GetTime() const;
+
+  std::unique_ptr<std::ostream> Stream;
+  std::chrono::steady_clock::time_point StartTime;
+  std::vector<vtkRenderer*> Renderers;
+  std::vector<PropState> Props;
+  vtkCallbackCommand* FrameObserver;
+  vtkCallbackCommand* InteractionObserver;
+  vtkObject* InteractorStyle;
+  unsigned long FrameTag;
+  unsigned long InteractionTags[2];
+};
+
+#endif
@@ -0,0 +1,243 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSharedMemory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// POSIX names start with a single slash, Windows names must not contain one
+std::string SystemName(const std::string& name)
+{
+  std::string result = name;
+  while (!result.empty() && result[0] == '/')
+  {
+    result.erase(0, 1);
+  }
+#ifdef _WIN32
+  return result;
+#else
+  return "/" + result;
+#endif
+}
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedMemory::Create(const std::string& name, size_t size)
+{
+  this->Close();
+  std::string systemName = SystemName(name);
+
+#ifdef _WIN32
+  unsigned long long size64 = size;
+  HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+    static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xffffffff),
+    systemName.c_str());
+  if (!mapping)
+  {
+    return false;
+  }
+  void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (!data)
+  {
+    CloseHandle(mapping);
+    return false;
+  }
+  this->Handle = mapping;
+#else
+  // a segment left behind by a crashed process would have the wrong size
+  shm_unlink(systemName.c_str());
+  int fd = shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    return false;
+  }
+  void* data = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+  {
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    shm_unlink(systemName.c_str());
+    return false;
+  }
+#endif
+
+  this->Name = systemName;
+  this->Data = static_cast<unsigned char*>(data);
+  this->Size = size;
+  this->Owner = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedMemory::Open(const std::string& name)
+{
+  this->Close();
+  std::string systemName = SystemName(name);
+
+#ifdef _WIN32
+  HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, systemName.c_str());
+  if (!mapping)
+  {
+    return false;
+  }
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  MEMORY_BASIC_INFORMATION info;
+  if (!data || VirtualQuery(data, &info, sizeof(info)) == 0)
+  {
+    if (data)
+    {
+      UnmapViewOfFile(data);
+    }
+    CloseHandle(mapping);
+    return false;
+  }
+  this->Handle = mapping;
+  size_t size = info.RegionSize;
+#else
+  int fd = shm_open(systemName.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  void* data = MAP_FAILED;
+  size_t size = 0;
+  if (fstat(fd, &info) == 0 && info.st_size > 0)
+  {
+    size = static_cast<size_t>(info.st_size);
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+#endif
+
+  this->Name = systemName;
+  this->Data = static_cast<unsigned char*>(data);
+  this->Size = size;
+  this->Owner = false;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedMemory::MapFile(const std::string& fileName)
+{
+  this->Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  HANDLE mapping = nullptr;
+  if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+  {
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  }
+  void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!data)
+  {
+    if (mapping)
+    {
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return false;
+  }
+  this->Handle = mapping;
+  this->FileHandle = file;
+  size_t size = static_cast<size_t>(fileSize.QuadPart);
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  void* data = MAP_FAILED;
+  size_t size = 0;
+  if (fstat(fd, &info) == 0 && info.st_size > 0)
+  {
+    size = static_cast<size_t>(info.st_size);
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+#endif
+
+  this->Name.clear();
+  this->Data = static_cast<unsigned char*>(data);
+  this->Size = size;
+  this->Owner = false;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSharedMemory::Close()
+{
+  if (!this->Data)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(this->Data);
+  CloseHandle(static_cast<HANDLE>(this->Handle));
+  if (this->FileHandle)
+  {
+    CloseHandle(static_cast<HANDLE>(this->FileHandle));
+  }
+#else
+  munmap(this->Data, this->Size);
+  if (this->Owner)
+  {
+    shm_unlink(this->Name.c_str());
+  }
+#endif
+
+  this->Data = nullptr;
+  this->Size = 0;
+  this->Owner = false;
+  this->Handle = nullptr;
+  this->FileHandle = nullptr;
+}
+
+//------------------------------------------------------------------------------
+std::string vtkLookingGlassSharedMemory::GetLastError()
+{
+#ifdef _WIN32
+  return "error " + std::to_string(::GetLastError());
+#else
+  return std::strerror(errno);
+#endif
+}
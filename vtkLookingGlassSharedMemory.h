@@ -0,0 +1,79 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSharedMemory
+ * @brief   A named shared memory segment.
+ *
+ * This is a helper for vtkLookingGlassSharedQuiltPublisher and
+ * vtkLookingGlassSharedQuiltReader. It uses POSIX shared memory, or named
+ * file mappings on Windows. The segment created by a process is removed
+ * when that process closes it, processes that opened it keep their mapping
+ * until they close it as well.
+ *
+ * It also maps files for reading, for vtkLookingGlassLODMapper.
+ */
+
+#ifndef vtkLookingGlassSharedMemory_h
+#define vtkLookingGlassSharedMemory_h
+
+#include <cstddef>
+#include <string>
+
+class vtkLookingGlassSharedMemory
+{
+public:
+  vtkLookingGlassSharedMemory() = default;
+  ~vtkLookingGlassSharedMemory() { this->Close(); }
+
+  /**
+   * Create a segment of the given size that can be read and written,
+   * replacing any segment left with the same name by a process that died.
+   */
+  bool Create(const std::string& name, size_t size);
+
+  /**
+   * Map an existing segment for reading.
+   */
+  bool Open(const std::string& name);
+
+  /**
+   * Map a whole file for reading. Its pages are read from the disk when
+   * they are first touched.
+   */
+  bool MapFile(const std::string& fileName);
+
+  /**
+   * Unmap the segment, and remove it if it was created by Create().
+   */
+  void Close();
+
+  unsigned char* GetData() const { return this->Data; }
+  size_t GetSize() const { return this->Size; }
+
+  /**
+   * Get the last system error as text, for error messages.
+   */
+  static std::string GetLastError();
+
+private:
+  vtkLookingGlassSharedMemory(const vtkLookingGlassSharedMemory&) = delete;
+  void operator=(const vtkLookingGlassSharedMemory&) = delete;
+
+  std::string Name;
+  unsigned char* Data = nullptr;
+  size_t Size = 0;
+  bool Owner = false;
+  void* Handle = nullptr;
+  void* FileHandle = nullptr;
+};
+
+#endif
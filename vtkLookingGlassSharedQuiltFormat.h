@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Layout of the shared memory segment written by
+ * vtkLookingGlassSharedQuiltPublisher and read by
+ * vtkLookingGlassSharedQuiltReader and vtkmodules.lookingglass.
+ *
+ * All values are in native byte order. The segment is made of
+ *
+ *  - a header of HeaderSize bytes, with the fields at the Header offsets
+ *  - NumberOfSlots slots of SlotStride bytes, each made of SlotHeaderSize
+ *    bytes of metadata at the Slot offsets followed by the RGB pixels of the
+ *    quilt, bottom row first
+ *
+ * Frame n (counting from 1) is written to slot (n - 1) % NumberOfSlots. The
+ * slot sequence number is odd while the slot is written and even otherwise,
+ * a reader copies a slot and then checks that the sequence number is even
+ * and did not change. LatestFrame is updated once a slot is complete.
+ */
+
+#ifndef vtkLookingGlassSharedQuiltFormat_h
+#define vtkLookingGlassSharedQuiltFormat_h
+
+#include "vtkType.h"
+
+#include <atomic>
+#include <cstring>
+
+namespace vtkLookingGlassSharedQuiltFormat
+{
+const char Magic[8] = { 'L', 'G', 'S', 'H', 'A', 'R', 'E', '\0' };
+const vtkTypeUInt32 Version = 1;
+const vtkTypeUInt32 HeaderSize = 256;
+const vtkTypeUInt32 SlotHeaderSize = 128;
+const vtkTypeUInt32 DeviceTypeLength = 64;
+
+// field offsets in the header
+enum Header
+{
+  MagicOffset = 0,          // char[8]
+  VersionOffset = 8,        // uint32
+  HeaderSizeOffset = 12,    // uint32
+  NumberOfSlotsOffset = 16, // uint32
+  SlotCapacityOffset = 24,  // uint64, bytes of pixels a slot can hold
+  SlotStrideOffset = 32,    // uint64
+  LatestFrameOffset = 40,   // atomic uint64, 0 until a frame is published
+  WriterProcessOffset = 48, // int64
+  ClosedOffset = 56         // uint32, 1 once the publisher stopped
+};
+
+// field offsets in the header of a slot
+enum Slot
+{
+  SequenceOffset = 0,     // atomic uint64
+  FrameOffset = 8,        // uint64
+  TimestampOffset = 16,   // int64, nanoseconds since the epoch
+  QuiltSizeOffset = 24,   // int32[2]
+  QuiltTilesOffset = 32,  // int32[2]
+  ComponentsOffset = 40,  // int32
+  AspectRatioOffset = 48, // double
+  ViewAngleOffset = 56,   // double
+  DeviceTypeOffset = 64   // char[DeviceTypeLength]
+};
+
+// the atomic fields are shared with other processes, so they must not need a lock
+static_assert(sizeof(std::atomic<vtkTypeUInt64>) == sizeof(vtkTypeUInt64),
+  "64 bit atomics must be plain 64 bit integers");
+
+inline std::atomic<vtkTypeUInt64>& AtomicAt(unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  return *reinterpret_cast<std::atomic<vtkTypeUInt64>*>(buffer + offset);
+}
+
+inline const std::atomic<vtkTypeUInt64>& AtomicAt(const unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  return *reinterpret_cast<const std::atomic<vtkTypeUInt64>*>(buffer + offset);
+}
+
+template <typename T>
+void Put(unsigned char* buffer, vtkTypeUInt32 offset, const T& value)
+{
+  std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T Get(const unsigned char* buffer, vtkTypeUInt32 offset)
+{
+  T value;
+  std::memcpy(&value, buffer + offset, sizeof(T));
+  return value;
+}
+}
+
+#endif
@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSharedQuiltPublisher.h"
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassSharedMemory.h"
+#include "vtkLookingGlassSharedQuiltFormat.h"
+#include "vtkObjectFactory.h"
+
+#include <vtksys/SystemInformation.hxx>
+
+#include <chrono>
+#include <cstring>
+
+namespace format = vtkLookingGlassSharedQuiltFormat;
+
+vtkStandardNewMacro(vtkLookingGlassSharedQuiltPublisher);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSharedQuiltPublisher::vtkLookingGlassSharedQuiltPublisher()
+  : Name(nullptr)
+  , NumberOfSlots(3)
+  , AspectRatio(1.777)
+  , ViewAngle(30.0)
+  , Memory(new vtkLookingGlassSharedMemory)
+  , SlotCapacity(0)
+  , SlotStride(0)
+  , NumberOfFrames(0)
+  , CurrentSlot(nullptr)
+{
+  this->QuiltTiles[0] = 5;
+  this->QuiltTiles[1] = 9;
+  this->CurrentSize[0] = 0;
+  this->CurrentSize[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSharedQuiltPublisher::~vtkLookingGlassSharedQuiltPublisher()
+{
+  this->Close();
+  delete this->Memory;
+  this->SetName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSharedQuiltPublisher::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Name: " << (this->Name ? this->Name : "(none)") << "\n";
+  os << indent << "NumberOfSlots: " << this->NumberOfSlots << "\n";
+  os << indent << "QuiltTiles: " << this->QuiltTiles[0] << "x" << this->QuiltTiles[1] << "\n";
+  os << indent << "DeviceType: " << this->DeviceType << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltPublisher::IsOpen() const
+{
+  return this->Memory->GetData() != nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltPublisher::Open(int maximumWidth, int maximumHeight)
+{
+  this->Close();
+  if (!this->Name || !*this->Name)
+  {
+    vtkErrorMacro("No shared memory name set");
+    return false;
+  }
+
+  // keep the pixels of every slot aligned for fast copies
+  this->SlotCapacity = static_cast<vtkTypeUInt64>(maximumWidth) * maximumHeight * 3;
+  this->SlotStride = (format::SlotHeaderSize + this->SlotCapacity + 63) / 64 * 64;
+  const vtkTypeUInt64 size = format::HeaderSize + this->SlotStride * this->NumberOfSlots;
+  if (!this->Memory->Create(this->Name, static_cast<size_t>(size)))
+  {
+    vtkErrorMacro("Unable to create shared memory "
+      << this->Name << ": " << vtkLookingGlassSharedMemory::GetLastError());
+    return false;
+  }
+
+  unsigned char* header = this->Memory->GetData();
+  std::memset(header, 0, format::HeaderSize);
+  format::Put(header, format::VersionOffset, format::Version);
+  format::Put(header, format::HeaderSizeOffset, format::HeaderSize);
+  format::Put(header, format::NumberOfSlotsOffset, vtkTypeUInt32(this->NumberOfSlots));
+  format::Put(header, format::SlotCapacityOffset, this->SlotCapacity);
+  format::Put(header, format::SlotStrideOffset, this->SlotStride);
+  format::Put(
+    header, format::WriterProcessOffset, vtkTypeInt64(vtksys::SystemInformation::GetProcessId()));
+  for (int i = 0; i < this->NumberOfSlots; ++i)
+  {
+    std::memset(header + format::HeaderSize + i * this->SlotStride, 0, format::SlotHeaderSize);
+  }
+
+  // readers check the magic last, once everything else is in place
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header + format::MagicOffset, format::Magic, sizeof(format::Magic));
+
+  this->NumberOfFrames = 0;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSharedQuiltPublisher::Close()
+{
+  if (!this->IsOpen())
+  {
+    return;
+  }
+  if (this->CurrentSlot)
+  {
+    this->EndFrame();
+  }
+
+  // readers that still have the segment mapped see that it is finished
+  format::Put(this->Memory->GetData(), format::ClosedOffset, vtkTypeUInt32(1));
+  std::atomic_thread_fence(std::memory_order_release);
+  this->Memory->Close();
+}
+
+//------------------------------------------------------------------------------
+unsigned char* vtkLookingGlassSharedQuiltPublisher::BeginFrame(int width, int height)
+{
+  if (!this->IsOpen() || this->CurrentSlot)
+  {
+    vtkErrorMacro("BeginFrame() requires an open segment and no frame in progress");
+    return nullptr;
+  }
+  if (static_cast<vtkTypeUInt64>(width) * height * 3 > this->SlotCapacity)
+  {
+    vtkErrorMacro("A quilt of " << width << "x" << height << " does not fit in " << this->Name);
+    return nullptr;
+  }
+
+  const vtkTypeUInt64 frame = this->NumberOfFrames + 1;
+  unsigned char* slot = this->Memory->GetData() + format::HeaderSize +
+    ((frame - 1) % this->NumberOfSlots) * this->SlotStride;
+
+  // an odd sequence number tells readers the slot is being written
+  auto& sequence = format::AtomicAt(slot, format::SequenceOffset);
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  this->CurrentSlot = slot;
+  this->CurrentSize[0] = width;
+  this->CurrentSize[1] = height;
+  return slot + format::SlotHeaderSize;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSharedQuiltPublisher::EndFrame()
+{
+  unsigned char* slot = this->CurrentSlot;
+  if (!slot)
+  {
+    return;
+  }
+
+  const vtkTypeUInt64 frame = ++this->NumberOfFrames;
+  const vtkTypeInt64 timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+  format::Put(slot, format::FrameOffset, frame);
+  format::Put(slot, format::TimestampOffset, timestamp);
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkTypeUInt32 step = static_cast<vtkTypeUInt32>(i * sizeof(vtkTypeInt32));
+    format::Put(slot, format::QuiltSizeOffset + step, vtkTypeInt32(this->CurrentSize[i]));
+    format::Put(slot, format::QuiltTilesOffset + step, vtkTypeInt32(this->QuiltTiles[i]));
+  }
+  format::Put(slot, format::ComponentsOffset, vtkTypeInt32(3));
+  format::Put(slot, format::AspectRatioOffset, this->AspectRatio);
+  format::Put(slot, format::ViewAngleOffset, this->ViewAngle);
+  char deviceType[format::DeviceTypeLength] = {};
+  std::strncpy(deviceType, this->DeviceType.c_str(), format::DeviceTypeLength - 1);
+  std::memcpy(slot + format::DeviceTypeOffset, deviceType, format::DeviceTypeLength);
+
+  auto& sequence = format::AtomicAt(slot, format::SequenceOffset);
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  format::AtomicAt(this->Memory->GetData(), format::LatestFrameOffset)
+    .store(frame, std::memory_order_release);
+
+  this->CurrentSlot = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltPublisher::Publish(vtkImageData* quilt)
+{
+  if (!quilt || quilt->GetScalarType() != VTK_UNSIGNED_CHAR ||
+    quilt->GetNumberOfScalarComponents() != 3)
+  {
+    vtkErrorMacro("Quilts must have 3 unsigned char components");
+    return false;
+  }
+
+  int* dims = quilt->GetDimensions();
+  unsigned char* pixels = this->BeginFrame(dims[0], dims[1]);
+  if (!pixels)
+  {
+    return false;
+  }
+  std::memcpy(pixels, quilt->GetScalarPointer(), static_cast<size_t>(dims[0]) * dims[1] * 3);
+  this->EndFrame();
+  return true;
+}
@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSharedQuiltPublisher
+ * @brief   Publish quilts to other processes through shared memory.
+ *
+ * Quilts are written to a ring of slots in a named shared memory segment,
+ * along with the frame number, a timestamp, the tile layout and the device
+ * type. Readers never block the publisher: each slot is guarded by a
+ * sequence number that tells readers whether the slot was overwritten while
+ * they copied it. vtkLookingGlassInterface::StartPublishingQuilt() uses this
+ * class to publish every rendered quilt, reading it back from the GPU
+ * straight into the shared memory.
+ *
+ * @sa
+ * vtkLookingGlassSharedQuiltReader
+ */
+
+#ifndef vtkLookingGlassSharedQuiltPublisher_h
+#define vtkLookingGlassSharedQuiltPublisher_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <string> // For std::string
+
+class vtkImageData;
+class vtkLookingGlassSharedMemory;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassSharedQuiltPublisher : public vtkObject
+{
+public:
+  static vtkLookingGlassSharedQuiltPublisher* New();
+  vtkTypeMacro(vtkLookingGlassSharedQuiltPublisher, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the name of the shared memory segment, for example
+   * "lookingglass_quilt".
+   */
+  vtkSetStringMacro(Name);
+  vtkGetStringMacro(Name);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of slots of the ring. More slots give slow readers
+   * more time to copy a frame before it is overwritten. Default is 3.
+   */
+  vtkSetClampMacro(NumberOfSlots, int, 2, 16);
+  vtkGetMacro(NumberOfSlots, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the metadata published with the next frames.
+   */
+  vtkSetVector2Macro(QuiltTiles, int);
+  vtkGetVector2Macro(QuiltTiles, int);
+  vtkSetMacro(DeviceType, std::string);
+  vtkGetMacro(DeviceType, std::string);
+  vtkSetMacro(AspectRatio, double);
+  vtkGetMacro(AspectRatio, double);
+  vtkSetMacro(ViewAngle, double);
+  vtkGetMacro(ViewAngle, double);
+  //@}
+
+  /**
+   * Create the shared memory segment with slots large enough for quilts of
+   * up to the given size. Returns false if it cannot be created.
+   */
+  bool Open(int maximumWidth, int maximumHeight);
+
+  /**
+   * Tell readers that no more frames will come and remove the segment.
+   */
+  void Close();
+
+  /**
+   * Check if the segment is open.
+   */
+  bool IsOpen() const;
+
+  /**
+   * Start writing a frame of the given size and return where its RGB pixels
+   * go, bottom row first. Returns nullptr if the quilt does not fit in a
+   * slot. EndFrame() must be called once the pixels are written.
+   */
+  unsigned char* BeginFrame(int width, int height);
+
+  /**
+   * Finish the frame started by BeginFrame() and make it the latest frame.
+   */
+  void EndFrame();
+
+  /**
+   * Publish a quilt with 3 unsigned char components.
+   */
+  bool Publish(vtkImageData* quilt);
+
+  /**
+   * Get the number of frames published since Open().
+   */
+  vtkGetMacro(NumberOfFrames, vtkTypeUInt64);
+
+protected:
+  vtkLookingGlassSharedQuiltPublisher();
+  ~vtkLookingGlassSharedQuiltPublisher() override;
+
+  char* Name;
+  int NumberOfSlots;
+  int QuiltTiles[2];
+  std::string DeviceType;
+  double AspectRatio;
+  double ViewAngle;
+
+  vtkLookingGlassSharedMemory* Memory;
+  vtkTypeUInt64 SlotCapacity;
+  vtkTypeUInt64 SlotStride;
+  vtkTypeUInt64 NumberOfFrames;
+
+  // the slot being written between BeginFrame() and EndFrame()
+  unsigned char* CurrentSlot;
+  int CurrentSize[2];
+
+private:
+  vtkLookingGlassSharedQuiltPublisher(const vtkLookingGlassSharedQuiltPublisher&) = delete;
+  void operator=(const vtkLookingGlassSharedQuiltPublisher&) = delete;
+};
+
+#endif
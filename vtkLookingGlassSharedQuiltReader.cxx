@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassSharedQuiltReader.h"
+
+#include "vtkImageData.h"
+#include "vtkLookingGlassSharedMemory.h"
+#include "vtkLookingGlassSharedQuiltFormat.h"
+#include "vtkObjectFactory.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace format = vtkLookingGlassSharedQuiltFormat;
+
+vtkStandardNewMacro(vtkLookingGlassSharedQuiltReader);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSharedQuiltReader::vtkLookingGlassSharedQuiltReader()
+  : Name(nullptr)
+  , Memory(new vtkLookingGlassSharedMemory)
+  , Frame(0)
+  , Timestamp(0)
+  , AspectRatio(0.0)
+  , ViewAngle(0.0)
+{
+  this->QuiltTiles[0] = 0;
+  this->QuiltTiles[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassSharedQuiltReader::~vtkLookingGlassSharedQuiltReader()
+{
+  delete this->Memory;
+  this->SetName(nullptr);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSharedQuiltReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Name: " << (this->Name ? this->Name : "(none)") << "\n";
+  os << indent << "Frame: " << this->Frame << "\n";
+  os << indent << "QuiltTiles: " << this->QuiltTiles[0] << "x" << this->QuiltTiles[1] << "\n";
+  os << indent << "DeviceType: " << this->DeviceType << "\n";
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltReader::IsOpen() const
+{
+  return this->Memory->GetData() != nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltReader::Open()
+{
+  this->Close();
+  if (!this->Name || !this->Memory->Open(this->Name))
+  {
+    return false;
+  }
+
+  const unsigned char* header = this->Memory->GetData();
+  const bool valid = this->Memory->GetSize() >= format::HeaderSize &&
+    std::memcmp(header + format::MagicOffset, format::Magic, sizeof(format::Magic)) == 0 &&
+    format::Get<vtkTypeUInt32>(header, format::VersionOffset) <= format::Version &&
+    format::HeaderSize +
+        format::Get<vtkTypeUInt64>(header, format::SlotStrideOffset) *
+          format::Get<vtkTypeUInt32>(header, format::NumberOfSlotsOffset) <=
+      this->Memory->GetSize();
+  if (!valid)
+  {
+    // either not a quilt segment or the publisher is still setting it up
+    this->Memory->Close();
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassSharedQuiltReader::Close()
+{
+  this->Memory->Close();
+}
+
+//------------------------------------------------------------------------------
+vtkTypeUInt64 vtkLookingGlassSharedQuiltReader::GetLatestFrame() const
+{
+  if (!this->IsOpen())
+  {
+    return 0;
+  }
+  return format::AtomicAt(static_cast<const unsigned char*>(this->Memory->GetData()),
+    format::LatestFrameOffset)
+    .load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltReader::IsPublisherClosed() const
+{
+  if (!this->IsOpen())
+  {
+    return true;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return format::Get<vtkTypeUInt32>(this->Memory->GetData(), format::ClosedOffset) != 0;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltReader::WaitForFrame(vtkTypeUInt64 frame, double timeout)
+{
+  auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+  while (this->GetLatestFrame() <= frame)
+  {
+    if (this->IsPublisherClosed() || std::chrono::steady_clock::now() > end)
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassSharedQuiltReader::ReadLatest(vtkImageData* quilt)
+{
+  if (!this->IsOpen())
+  {
+    vtkErrorMacro("The shared memory is not open");
+    return false;
+  }
+
+  const unsigned char* data = this->Memory->GetData();
+  const vtkTypeUInt32 numberOfSlots = format::Get<vtkTypeUInt32>(data, format::NumberOfSlotsOffset);
+  const vtkTypeUInt64 slotStride = format::Get<vtkTypeUInt64>(data, format::SlotStrideOffset);
+  const vtkTypeUInt64 slotCapacity = format::Get<vtkTypeUInt64>(data, format::SlotCapacityOffset);
+
+  // the publisher moves on to another slot for every frame, so a retry
+  // only fails again if it is faster than copying a frame
+  for (int attempt = 0; attempt < 100; ++attempt)
+  {
+    const vtkTypeUInt64 frame = this->GetLatestFrame();
+    if (frame == 0)
+    {
+      return false;
+    }
+
+    const unsigned char* slot =
+      data + format::HeaderSize + ((frame - 1) % numberOfSlots) * slotStride;
+    const auto& sequence = format::AtomicAt(slot, format::SequenceOffset);
+    const vtkTypeUInt64 before = sequence.load(std::memory_order_acquire);
+    if (before % 2 != 0)
+    {
+      continue;
+    }
+
+    int size[2];
+    size[0] = format::Get<vtkTypeInt32>(slot, format::QuiltSizeOffset);
+    size[1] = format::Get<vtkTypeInt32>(slot, format::QuiltSizeOffset + 4);
+    const vtkTypeUInt64 bytes = static_cast<vtkTypeUInt64>(size[0]) * size[1] * 3;
+    if (size[0] <= 0 || size[1] <= 0 || bytes > slotCapacity)
+    {
+      continue;
+    }
+
+    int* dims = quilt->GetDimensions();
+    if (dims[0] != size[0] || dims[1] != size[1] || quilt->GetNumberOfScalarComponents() != 3 ||
+      quilt->GetScalarType() != VTK_UNSIGNED_CHAR)
+    {
+      quilt->SetDimensions(size[0], size[1], 1);
+      quilt->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+    }
+    std::memcpy(quilt->GetScalarPointer(), slot + format::SlotHeaderSize, bytes);
+
+    const vtkTypeUInt64 slotFrame = format::Get<vtkTypeUInt64>(slot, format::FrameOffset);
+    const vtkTypeInt64 timestamp = format::Get<vtkTypeInt64>(slot, format::TimestampOffset);
+    const int tiles[2] = { format::Get<vtkTypeInt32>(slot, format::QuiltTilesOffset),
+      format::Get<vtkTypeInt32>(slot, format::QuiltTilesOffset + 4) };
+    const double aspectRatio = format::Get<double>(slot, format::AspectRatioOffset);
+    const double viewAngle = format::Get<double>(slot, format::ViewAngleOffset);
+    char deviceType[format::DeviceTypeLength];
+    std::memcpy(deviceType, slot + format::DeviceTypeOffset, format::DeviceTypeLength);
+    deviceType[format::DeviceTypeLength - 1] = '\0';
+
+    // the copy is only valid if the slot was not written in the meantime
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) != before || slotFrame != frame)
+    {
+      continue;
+    }
+
+    this->Frame = slotFrame;
+    this->Timestamp = timestamp;
+    this->QuiltTiles[0] = tiles[0];
+    this->QuiltTiles[1] = tiles[1];
+    this->AspectRatio = aspectRatio;
+    this->ViewAngle = viewAngle;
+    this->DeviceType = deviceType;
+    this->Modified();
+    return true;
+  }
+
+  vtkErrorMacro("The publisher kept overwriting the frames being read");
+  return false;
+}
@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassSharedQuiltReader
+ * @brief   Read the quilts published by another process.
+ *
+ * This opens the shared memory segment of a
+ * vtkLookingGlassSharedQuiltPublisher and copies its latest quilt. Reading
+ * never blocks the publisher, a frame that is overwritten while it is copied
+ * is simply read again. The vtkmodules.lookingglass Python module provides
+ * the same reader for processes that do not use VTK.
+ *
+ * @sa
+ * vtkLookingGlassSharedQuiltPublisher
+ */
+
+#ifndef vtkLookingGlassSharedQuiltReader_h
+#define vtkLookingGlassSharedQuiltReader_h
+
+#include "vtkObject.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+
+#include <string> // For std::string
+
+class vtkImageData;
+class vtkLookingGlassSharedMemory;
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassSharedQuiltReader : public vtkObject
+{
+public:
+  static vtkLookingGlassSharedQuiltReader* New();
+  vtkTypeMacro(vtkLookingGlassSharedQuiltReader, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * Set/Get the name of the shared memory segment.
+   */
+  vtkSetStringMacro(Name);
+  vtkGetStringMacro(Name);
+  //@}
+
+  /**
+   * Open the segment. Returns false if no publisher created it yet.
+   */
+  bool Open();
+
+  /**
+   * Close the segment.
+   */
+  void Close();
+
+  /**
+   * Check if the segment is open.
+   */
+  bool IsOpen() const;
+
+  /**
+   * Get the number of the latest published frame, 0 if there is none yet.
+   */
+  vtkTypeUInt64 GetLatestFrame() const;
+
+  /**
+   * Check if the publisher was closed, in which case no more frames come.
+   */
+  bool IsPublisherClosed() const;
+
+  /**
+   * Wait until a frame newer than `frame` is published, for up to `timeout`
+   * seconds. Returns false on timeout or if the publisher was closed.
+   */
+  bool WaitForFrame(vtkTypeUInt64 frame, double timeout);
+
+  /**
+   * Copy the latest quilt into an image with 3 unsigned char components,
+   * resizing it if needed, and update the metadata below. Returns false if
+   * no frame was published yet.
+   */
+  bool ReadLatest(vtkImageData* quilt);
+
+  //@{
+  /**
+   * Get the metadata of the frame read by ReadLatest(). The timestamp is in
+   * nanoseconds since the epoch.
+   */
+  vtkGetMacro(Frame, vtkTypeUInt64);
+  vtkGetMacro(Timestamp, vtkTypeInt64);
+  vtkGetVector2Macro(QuiltTiles, int);
+  vtkGetMacro(AspectRatio, double);
+  vtkGetMacro(ViewAngle, double);
+  std::string GetDeviceType() const { return this->DeviceType; }
+  //@}
+
+protected:
+  vtkLookingGlassSharedQuiltReader();
+  ~vtkLookingGlassSharedQuiltReader() override;
+
+  char* Name;
+  vtkLookingGlassSharedMemory* Memory;
+
+  vtkTypeUInt64 Frame;
+  vtkTypeInt64 Timestamp;
+  int QuiltTiles[2];
+  double AspectRatio;
+  double ViewAngle;
+  std::string DeviceType;
+
+private:
+  vtkLookingGlassSharedQuiltReader(const vtkLookingGlassSharedQuiltReader&) = delete;
+  void operator=(const vtkLookingGlassSharedQuiltReader&) = delete;
+};
+
+#endif
@@ -0,0 +1,268 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassTimeSeriesSource.h"
+
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkLookingGlassTrace.h"
+#include "vtkObjectFactory.h"
+
+#include <algorithm>
+#include <chrono>
+
+vtkStandardNewMacro(vtkLookingGlassTimeSeriesSource);
+
+//------------------------------------------------------------------------------
+vtkLookingGlassTimeSeriesSource::vtkLookingGlassTimeSeriesSource()
+  : NumberOfFrames(1)
+  , Frame(0)
+  , PrefetchCount(3)
+  , NumberOfThreads(2)
+  , NumberOfPrefetchHits(0)
+  , WaitTime(0.0)
+  , Running(false)
+  , FramesLoaded(0)
+{
+  this->SetNumberOfInputPorts(0);
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassTimeSeriesSource::~vtkLookingGlassTimeSeriesSource()
+{
+  this->StopWorkers();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+  os << indent << "Frame: " << this->Frame << "\n";
+  os << indent << "PrefetchCount: " << this->PrefetchCount << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "NumberOfPrefetchHits: " << this->NumberOfPrefetchHits << "\n";
+  os << indent << "WaitTime: " << this->WaitTime << "\n";
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::SetFrameLoader(FrameLoader loader)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Loader = loader;
+    // the frames being loaded are dropped by their worker
+    this->Frames.clear();
+    this->Queue.clear();
+  }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassTimeSeriesSource::GetNumberOfFramesLoaded()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->FramesLoaded;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::StartWorkers()
+{
+  if (!this->Threads.empty())
+  {
+    return;
+  }
+  this->Running = true;
+  // a frame waited for must have a worker to load it
+  const int numberOfThreads = std::max(this->NumberOfThreads, 1);
+  for (int i = 0; i < numberOfThreads; ++i)
+  {
+    this->Threads.emplace_back(&vtkLookingGlassTimeSeriesSource::Run, this);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Running = false;
+  }
+  this->Wakeup.notify_all();
+  for (std::thread& thread : this->Threads)
+  {
+    thread.join();
+  }
+  this->Threads.clear();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::Run()
+{
+  vtkLookingGlassTraceThreadName("Time series loader");
+  for (;;)
+  {
+    int frame;
+    FrameLoader loader;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Wakeup.wait(lock, [this] { return !this->Running || !this->Queue.empty(); });
+      if (!this->Running)
+      {
+        return;
+      }
+      frame = this->Queue.front();
+      this->Queue.pop_front();
+      this->Frames[frame].Loading = true;
+      loader = this->Loader;
+    }
+
+    vtkSmartPointer<vtkDataObject> data;
+    if (loader)
+    {
+      vtkLookingGlassTraceScope("LoadFrame");
+      data = loader(frame);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      auto entry = this->Frames.find(frame);
+      if (entry != this->Frames.end() && entry->second.Loading)
+      {
+        entry->second.Loading = false;
+        entry->second.Done = true;
+        entry->second.Data = data;
+      }
+      ++this->FramesLoaded;
+    }
+    this->Loaded.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::Schedule(int frame)
+{
+  const int last = std::min(frame + this->PrefetchCount, this->NumberOfFrames - 1);
+
+  // drop the frames out of the window, and the requests that were not
+  // started yet, the window is queued again in order
+  for (auto entry = this->Frames.begin(); entry != this->Frames.end();)
+  {
+    if ((entry->first < frame || entry->first > last) && !entry->second.Loading)
+    {
+      entry = this->Frames.erase(entry);
+    }
+    else
+    {
+      ++entry;
+    }
+  }
+  this->Queue.clear();
+  for (int f = frame; f <= last; ++f)
+  {
+    Entry& entry = this->Frames[f];
+    if (!entry.Loading && !entry.Done)
+    {
+      this->Queue.push_back(f);
+    }
+  }
+  this->Wakeup.notify_all();
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTimeSeriesSource::Prefetch(int frame)
+{
+  if (this->NumberOfFrames < 1)
+  {
+    vtkErrorMacro("The time series has no frames");
+    return;
+  }
+  this->StartWorkers();
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Schedule(std::min(std::max(frame, 0), this->NumberOfFrames - 1));
+}
+
+//------------------------------------------------------------------------------
+vtkDataObject* vtkLookingGlassTimeSeriesSource::GetFrameData(int frame, bool& ready)
+{
+  if (this->NumberOfFrames < 1)
+  {
+    vtkErrorMacro("The time series has no frames");
+    ready = false;
+    return nullptr;
+  }
+  this->StartWorkers();
+  frame = std::min(std::max(frame, 0), this->NumberOfFrames - 1);
+
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->Schedule(frame);
+  auto isDone = [this, frame] {
+    auto entry = this->Frames.find(frame);
+    return entry == this->Frames.end() || entry->second.Done;
+  };
+  ready = isDone();
+  if (!ready)
+  {
+    vtkLookingGlassTraceScope("WaitForFrame");
+    const auto start = std::chrono::steady_clock::now();
+    this->Loaded.wait(lock, isDone);
+    this->WaitTime +=
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  auto entry = this->Frames.find(frame);
+  return entry != this->Frames.end() ? entry->second.Data.GetPointer() : nullptr;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassTimeSeriesSource::RequestDataObject(
+  vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector)
+{
+  // the output has the type of the frame, this is the first request of an
+  // update so it is the one that may find the frame loaded ahead
+  bool ready;
+  vtkDataObject* data = this->GetFrameData(this->Frame, ready);
+  if (!data)
+  {
+    vtkErrorMacro("Frame " << this->Frame << " could not be loaded");
+    return 0;
+  }
+  if (ready)
+  {
+    ++this->NumberOfPrefetchHits;
+  }
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject* output = vtkDataObject::GetData(outInfo);
+  if (!output || !output->IsA(data->GetClassName()))
+  {
+    vtkSmartPointer<vtkDataObject> newOutput = vtk::TakeSmartPointer(data->NewInstance());
+    outInfo->Set(vtkDataObject::DATA_OBJECT(), newOutput);
+  }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassTimeSeriesSource::RequestData(
+  vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector)
+{
+  bool ready;
+  vtkDataObject* data = this->GetFrameData(this->Frame, ready);
+  if (!data)
+  {
+    vtkErrorMacro("Frame " << this->Frame << " could not be loaded");
+    return 0;
+  }
+
+  // the output shares the arrays of the loaded frame
+  vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
+  output->ShallowCopy(data);
+  return 1;
+}
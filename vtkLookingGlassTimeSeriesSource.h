@@ -0,0 +1,177 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassTimeSeriesSource
+ * @brief   Produce the frames of time-varying data, loaded ahead of time.
+ *
+ * The output is the dataset of the current Frame, produced by a loader
+ * function. While a frame is rendered, worker threads already load the
+ * next PrefetchCount frames, so that moving to the next frame only swaps
+ * the output for a dataset that is decoded and ready to upload.
+ *
+ * The loader is called from the worker threads, several at a time, and
+ * must not share pipeline objects between its calls: a loader that reads
+ * a file typically creates its own reader for each frame.
+ *
+ * \code{.cpp}
+ * source->SetFrameLoader([&](int frame) {
+ *   vtkNew<vtkXMLPolyDataReader> reader;
+ *   reader->SetFileName(fileNames[frame].c_str());
+ *   reader->Update();
+ *   return vtkSmartPointer<vtkDataObject>(reader->GetOutputDataObject(0));
+ * });
+ * \endcode
+ *
+ * Give it to vtkLookingGlassQuiltAnimationRecorder::SetTimeSeries() to
+ * record a quilt per frame. The recorder moves to the next frame while the
+ * GPU is still rendering the tiles of the current quilt.
+ *
+ * @sa
+ * vtkLookingGlassQuiltAnimationRecorder
+ */
+
+#ifndef vtkLookingGlassTimeSeriesSource_h
+#define vtkLookingGlassTimeSeriesSource_h
+
+#include "vtkDataObjectAlgorithm.h"
+#include "vtkRenderingLookingGlassModule.h" // For export macro
+#include "vtkSmartPointer.h"                // For vtkSmartPointer
+
+#include <condition_variable> // For std::condition_variable
+#include <deque>              // For std::deque
+#include <functional>         // For std::function
+#include <map>                // For std::map
+#include <mutex>              // For std::mutex
+#include <thread>             // For std::thread
+#include <vector>             // For std::vector
+
+class VTKRENDERINGLOOKINGGLASS_EXPORT vtkLookingGlassTimeSeriesSource
+  : public vtkDataObjectAlgorithm
+{
+public:
+  static vtkLookingGlassTimeSeriesSource* New();
+  vtkTypeMacro(vtkLookingGlassTimeSeriesSource, vtkDataObjectAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  using FrameLoader = std::function<vtkSmartPointer<vtkDataObject>(int)>;
+
+  /**
+   * Set the function that loads the dataset of a frame. It is called from
+   * the worker threads. Frames already loaded are dropped.
+   */
+  void SetFrameLoader(FrameLoader loader);
+
+  //@{
+  /**
+   * Set/Get the number of frames. Default is 1.
+   */
+  vtkSetClampMacro(NumberOfFrames, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfFrames, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the frame produced by the output.
+   */
+  vtkSetMacro(Frame, int);
+  vtkGetMacro(Frame, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of frames after the current one that are loaded
+   * ahead. Default is 3.
+   */
+  vtkSetClampMacro(PrefetchCount, int, 0, 256);
+  vtkGetMacro(PrefetchCount, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of worker threads. Takes effect when the workers
+   * are started by the next update. Default is 2.
+   */
+  vtkSetClampMacro(NumberOfThreads, int, 1, 64);
+  vtkGetMacro(NumberOfThreads, int);
+  //@}
+
+  /**
+   * Start loading the frames from `frame` on, as the next update for that
+   * frame would, without waiting for them.
+   */
+  void Prefetch(int frame);
+
+  //@{
+  /**
+   * Get the number of frames loaded so far, how many updates found their
+   * frame already loaded, and the total time in seconds the updates waited
+   * for their frame.
+   */
+  int GetNumberOfFramesLoaded();
+  vtkGetMacro(NumberOfPrefetchHits, int);
+  vtkGetMacro(WaitTime, double);
+  //@}
+
+protected:
+  vtkLookingGlassTimeSeriesSource();
+  ~vtkLookingGlassTimeSeriesSource() override;
+
+  int RequestDataObject(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  // the dataset of a frame, waiting for it if needed, `ready` tells if it
+  // was loaded before
+  vtkDataObject* GetFrameData(int frame, bool& ready);
+
+  // keep the frames from `frame` to PrefetchCount frames after it, called
+  // with the mutex locked
+  void Schedule(int frame);
+
+  void StartWorkers();
+  void StopWorkers();
+
+  // the body of the worker threads
+  void Run();
+
+  FrameLoader Loader;
+  int NumberOfFrames;
+  int Frame;
+  int PrefetchCount;
+  int NumberOfThreads;
+  int NumberOfPrefetchHits;
+  double WaitTime;
+
+  // a frame queued, being loaded or loaded, the data stays null if the
+  // loader failed
+  struct Entry
+  {
+    bool Loading = false;
+    bool Done = false;
+    vtkSmartPointer<vtkDataObject> Data;
+  };
+
+  // shared with the worker threads
+  std::vector<std::thread> Threads;
+  std::mutex Mutex;
+  std::condition_variable Wakeup;
+  std::condition_variable Loaded;
+  bool Running;
+  std::map<int, Entry> Frames;
+  std::deque<int> Queue;
+  int FramesLoaded;
+
+private:
+  vtkLookingGlassTimeSeriesSource(const vtkLookingGlassTimeSeriesSource&) = delete;
+  void operator=(const vtkLookingGlassTimeSeriesSource&) = delete;
+};
+
+#endif
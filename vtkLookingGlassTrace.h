@@ -0,0 +1,71 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * Instrumentation points for the trace capture of vtkLookingGlassTracer.
+ *
+ * When the module is configured without LookingGlass_ENABLE_TRACING these
+ * macros expand to nothing and their arguments are not evaluated.
+ */
+
+#ifndef vtkLookingGlassTrace_h
+#define vtkLookingGlassTrace_h
+
+#ifdef VTK_LOOKINGGLASS_TRACING
+
+#include "vtkLookingGlassTracer.h"
+
+#define vtkLookingGlassTraceConcatImpl(a, b) a##b
+#define vtkLookingGlassTraceConcat(a, b) vtkLookingGlassTraceConcatImpl(a, b)
+
+// a CPU span of the calling thread until the end of the enclosing scope
+#define vtkLookingGlassTraceScope(name)                                                            \
+  vtkLookingGlassTracer::Scope vtkLookingGlassTraceConcat(lgTraceScope, __LINE__)(name)
+#define vtkLookingGlassTraceTileScope(name, tile)                                                  \
+  vtkLookingGlassTracer::Scope vtkLookingGlassTraceConcat(lgTraceScope, __LINE__)(name, tile)
+
+#define vtkLookingGlassTraceBeginFrame() vtkLookingGlassTracer::GetInstance().BeginFrame()
+#define vtkLookingGlassTraceEndFrame() vtkLookingGlassTracer::GetInstance().EndFrame()
+#define vtkLookingGlassTraceStop() vtkLookingGlassTracer::GetInstance().Stop()
+
+// a GPU span, the OpenGL context must be current
+#define vtkLookingGlassTraceBeginGPU(name, tile)                                                   \
+  vtkLookingGlassTracer::GetInstance().BeginGPUSpan(name, tile)
+#define vtkLookingGlassTraceEndGPU() vtkLookingGlassTracer::GetInstance().EndGPUSpan()
+
+// the per tile counters, around the rendering of a tile
+#define vtkLookingGlassTraceBeginTile(tile, renderers)                                             \
+  vtkLookingGlassTracer::GetInstance().BeginTile(tile, renderers)
+#define vtkLookingGlassTraceEndTile(tile, renderers)                                               \
+  vtkLookingGlassTracer::GetInstance().EndTile(tile, renderers)
+
+#define vtkLookingGlassTraceCounter(track, name, value)                                            \
+  vtkLookingGlassTracer::GetInstance().SetCounter(track, name, static_cast<double>(value))
+#define vtkLookingGlassTraceThreadName(name)                                                       \
+  vtkLookingGlassTracer::GetInstance().SetThreadName(name)
+
+#else
+
+#define vtkLookingGlassTraceScope(name) do { } while (0)
+#define vtkLookingGlassTraceTileScope(name, tile) do { } while (0)
+#define vtkLookingGlassTraceBeginFrame() do { } while (0)
+#define vtkLookingGlassTraceEndFrame() do { } while (0)
+#define vtkLookingGlassTraceStop() do { } while (0)
+#define vtkLookingGlassTraceBeginGPU(name, tile) do { } while (0)
+#define vtkLookingGlassTraceEndGPU() do { } while (0)
+#define vtkLookingGlassTraceBeginTile(tile, renderers) do { } while (0)
+#define vtkLookingGlassTraceEndTile(tile, renderers) do { } while (0)
+#define vtkLookingGlassTraceCounter(track, name, value) do { } while (0)
+#define vtkLookingGlassTraceThreadName(name) do { } while (0)
+
+#endif
+
+#endif
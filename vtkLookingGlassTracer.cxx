@@ -0,0 +1,447 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassTracer.h"
+
+#include "vtkOpenGLRenderTimer.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+
+#include "vtk_glad.h"
+
+#include <cstdio>
+
+namespace
+{
+// the GPU track comes first, the threads follow in the order they report
+const int GPUThread = 0;
+
+void WriteString(FILE* file, const std::string& text)
+{
+  fputc('"', file);
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      fputc('\\', file);
+    }
+    fputc(c, file);
+  }
+  fputc('"', file);
+}
+
+bool UsesDepthPeeling(vtkRendererCollection* renderers)
+{
+  vtkCollectionSimpleIterator rit;
+  renderers->InitTraversal(rit);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(rit))
+  {
+    if (renderer->GetUseDepthPeeling())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassTracer& vtkLookingGlassTracer::GetInstance()
+{
+  static vtkLookingGlassTracer tracer;
+  return tracer;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassTracer::~vtkLookingGlassTracer()
+{
+  // the context is long gone at exit, only the host side is freed
+  for (GPUSpan& span : this->GPUQueries)
+  {
+    delete span.Timer;
+  }
+  for (GPUSpan& span : this->OpenGPUSpans)
+  {
+    delete span.Timer;
+  }
+  for (vtkOpenGLRenderTimer* timer : this->FreeTimers)
+  {
+    delete timer;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassTracer::Start(const std::string& fileName, int numberOfFrames)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->Capturing)
+  {
+    return false;
+  }
+
+  this->Clear();
+  this->FileName = fileName;
+  this->NumberOfFrames = numberOfFrames;
+  this->Origin = std::chrono::steady_clock::now();
+  this->Capturing = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassTracer::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (!this->Capturing)
+    {
+      return false;
+    }
+    // spans ending from now on are dropped
+    this->Capturing = false;
+  }
+
+  this->PollQueries(true);
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  const bool written = this->Write();
+  this->Clear();
+  return written;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::Clear()
+{
+  this->Events.clear();
+  this->FramesDone = 0;
+  this->FrameOpen = false;
+  this->HaveGPUOffset = false;
+  for (GPUSpan& span : this->OpenGPUSpans)
+  {
+    if (span.Timer)
+    {
+      this->FreeTimers.push_back(span.Timer);
+    }
+  }
+  this->OpenGPUSpans.clear();
+}
+
+//------------------------------------------------------------------------------
+double vtkLookingGlassTracer::Now() const
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - this->Origin)
+    .count();
+}
+
+//------------------------------------------------------------------------------
+int vtkLookingGlassTracer::GetThreadIndex()
+{
+  const std::thread::id id = std::this_thread::get_id();
+  auto it = this->Threads.find(id);
+  if (it != this->Threads.end())
+  {
+    return it->second;
+  }
+  const int index = static_cast<int>(this->ThreadNames.size()) + 1;
+  this->Threads[id] = index;
+  this->ThreadNames.push_back("Thread " + std::to_string(index));
+  return index;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::SetThreadName(const char* name)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->ThreadNames[this->GetThreadIndex() - 1] = name;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::BeginFrame()
+{
+  if (!this->IsCapturing())
+  {
+    return;
+  }
+  this->EndFrame();
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->Capturing)
+  {
+    this->FrameOpen = true;
+    this->FrameStart = this->Now();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::EndFrame()
+{
+  bool done;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (!this->Capturing || !this->FrameOpen)
+    {
+      return;
+    }
+    this->FrameOpen = false;
+    ++this->FramesDone;
+    this->Events.push_back({ 'X', "Frame " + std::to_string(this->FramesDone),
+      this->GetThreadIndex(), this->FrameStart, this->Now() - this->FrameStart, {} });
+    done = this->FramesDone >= this->NumberOfFrames;
+  }
+
+  if (done)
+  {
+    this->Stop();
+  }
+  else
+  {
+    this->PollQueries(false);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::AddSpan(const char* name, double start, double end, int tile)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (!this->Capturing)
+  {
+    return;
+  }
+  Event event{ 'X', name, this->GetThreadIndex(), start, end - start, {} };
+  if (tile >= 0)
+  {
+    event.Args.emplace_back("tile", tile);
+  }
+  this->Events.push_back(std::move(event));
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::SetCounter(const char* track, const char* name, double value)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (!this->Capturing)
+  {
+    return;
+  }
+  this->Events.push_back(
+    { 'C', track, this->GetThreadIndex(), this->Now(), 0.0, { { name, value } } });
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::BeginGPUSpan(const char* name, int tile)
+{
+  if (!this->IsCapturing())
+  {
+    return;
+  }
+
+  GPUSpan span{ name, tile, nullptr };
+  if (vtkOpenGLRenderTimer::IsSupported())
+  {
+    if (!this->HaveGPUOffset)
+    {
+      GLint64 gpuNow = 0;
+      glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+      this->GPUOffset = this->Now() - gpuNow / 1000.0;
+      this->HaveGPUOffset = true;
+    }
+    if (this->FreeTimers.empty())
+    {
+      span.Timer = new vtkOpenGLRenderTimer;
+    }
+    else
+    {
+      span.Timer = this->FreeTimers.back();
+      this->FreeTimers.pop_back();
+    }
+    span.Timer->Reset();
+    span.Timer->Start();
+  }
+  this->OpenGPUSpans.push_back(span);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::EndGPUSpan()
+{
+  if (this->OpenGPUSpans.empty())
+  {
+    return;
+  }
+
+  GPUSpan span = this->OpenGPUSpans.back();
+  this->OpenGPUSpans.pop_back();
+  if (!span.Timer)
+  {
+    return;
+  }
+  span.Timer->Stop();
+  this->GPUQueries.push_back(span);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::BeginTile(int, vtkRendererCollection* renderers)
+{
+  if (!this->IsCapturing() || UsesDepthPeeling(renderers))
+  {
+    return;
+  }
+  glGenQueries(1, &this->ActiveSampleQuery);
+  glBeginQuery(GL_SAMPLES_PASSED, this->ActiveSampleQuery);
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::EndTile(int tile, vtkRendererCollection* renderers)
+{
+  const unsigned int query = this->ActiveSampleQuery;
+  this->ActiveSampleQuery = 0;
+  if (!query && !this->IsCapturing())
+  {
+    return;
+  }
+  if (query)
+  {
+    glEndQuery(GL_SAMPLES_PASSED);
+  }
+
+  int props = 0;
+  vtkCollectionSimpleIterator rit;
+  renderers->InitTraversal(rit);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(rit))
+  {
+    props += renderer->GetNumberOfPropsRendered();
+  }
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (!this->Capturing)
+  {
+    if (query)
+    {
+      glDeleteQueries(1, &query);
+    }
+    return;
+  }
+  if (query)
+  {
+    // the counter is set once the samples are known
+    this->SampleQueries.push_back({ tile, this->Now(), props, query });
+  }
+  else
+  {
+    this->Events.push_back({ 'C', "Tile " + std::to_string(tile), this->GetThreadIndex(),
+      this->Now(), 0.0, { { "props", props } } });
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassTracer::PollQueries(bool wait)
+{
+  if (wait && (!this->GPUQueries.empty() || !this->SampleQueries.empty()))
+  {
+    glFinish();
+  }
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  // the queries complete in order, stop at the first one still in flight
+  while (!this->GPUQueries.empty() && this->GPUQueries.front().Timer->Ready())
+  {
+    GPUSpan span = this->GPUQueries.front();
+    this->GPUQueries.pop_front();
+    const double start = span.Timer->GetStartTime() / 1000.0 + this->GPUOffset;
+    const double end = span.Timer->GetStopTime() / 1000.0 + this->GPUOffset;
+    Event event{ 'X', span.Name, GPUThread, start, end - start, {} };
+    if (span.Tile >= 0)
+    {
+      event.Args.emplace_back("tile", span.Tile);
+    }
+    this->Events.push_back(std::move(event));
+    this->FreeTimers.push_back(span.Timer);
+  }
+  if (wait)
+  {
+    // whatever is left never completes, do not wait for it forever
+    for (GPUSpan& span : this->GPUQueries)
+    {
+      this->FreeTimers.push_back(span.Timer);
+    }
+    this->GPUQueries.clear();
+  }
+
+  while (!this->SampleQueries.empty())
+  {
+    SampleQuery& sample = this->SampleQueries.front();
+    GLuint available = 0;
+    glGetQueryObjectuiv(sample.Query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available && !wait)
+    {
+      break;
+    }
+    GLuint samples = 0;
+    glGetQueryObjectuiv(sample.Query, GL_QUERY_RESULT, &samples);
+    glDeleteQueries(1, &sample.Query);
+    this->Events.push_back({ 'C', "Tile " + std::to_string(sample.Tile), GPUThread, sample.Time,
+      0.0, { { "props", sample.Props }, { "samples", samples } } });
+    this->SampleQueries.pop_front();
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassTracer::Write()
+{
+  FILE* file = fopen(this->FileName.c_str(), "w");
+  if (!file)
+  {
+    return false;
+  }
+
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  fprintf(file,
+    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+    "\"args\":{\"name\":\"LookingGlass\"}},\n");
+  fprintf(file,
+    "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+    "\"args\":{\"name\":\"GPU\"}}",
+    GPUThread);
+  for (size_t i = 0; i < this->ThreadNames.size(); ++i)
+  {
+    fprintf(file,
+      ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+      static_cast<int>(i) + 1);
+    WriteString(file, this->ThreadNames[i]);
+    fprintf(file, "}}");
+  }
+
+  for (const Event& event : this->Events)
+  {
+    fprintf(file, ",\n{\"name\":");
+    WriteString(file, event.Name);
+    fprintf(file, ",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", event.Phase, event.Thread,
+      event.Start);
+    if (event.Phase == 'X')
+    {
+      fprintf(file, ",\"dur\":%.3f", event.Duration);
+    }
+    if (!event.Args.empty())
+    {
+      fprintf(file, ",\"args\":{");
+      for (size_t i = 0; i < event.Args.size(); ++i)
+      {
+        if (i)
+        {
+          fputc(',', file);
+        }
+        WriteString(file, event.Args[i].first);
+        fprintf(file, ":%.17g", event.Args[i].second);
+      }
+      fprintf(file, "}");
+    }
+    fprintf(file, "}");
+  }
+  fprintf(file, "\n]}\n");
+  return fclose(file) == 0;
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassTracer
+ * @brief   Capture timestamped spans of a few frames into a trace file.
+ *
+ * This is a helper for vtkLookingGlassInterface, only built when the module
+ * is configured with LookingGlass_ENABLE_TRACING. It is not used directly
+ * but through the macros of vtkLookingGlassTrace.h, which compile to nothing
+ * when tracing is off.
+ *
+ * A capture records the CPU spans of every thread that reports them, GPU
+ * spans measured with timer queries, and counters, for a given number of
+ * frames. The trace is then written as a Chrome trace event JSON file, which
+ * chrome://tracing and Perfetto open. The GPU spans go on their own track,
+ * the counters of each tile on a track per tile. There is one capture per
+ * process, the tracer is shared by all the interfaces.
+ */
+
+#ifndef vtkLookingGlassTracer_h
+#define vtkLookingGlassTracer_h
+
+#include "vtkType.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class vtkOpenGLRenderTimer;
+class vtkRendererCollection;
+
+class vtkLookingGlassTracer
+{
+public:
+  static vtkLookingGlassTracer& GetInstance();
+
+  // Start capturing the next `numberOfFrames` frames, the trace is written
+  // to `fileName` once they are done or when the capture is stopped.
+  // Returns false if a capture is already running.
+  bool Start(const std::string& fileName, int numberOfFrames);
+
+  // Write what was captured so far and stop. Must be called with the
+  // context of the GPU spans current, to read their last queries.
+  bool Stop();
+
+  bool IsCapturing() const { return this->Capturing.load(); }
+
+  // A frame runs from BeginFrame() to EndFrame(), the capture stops after
+  // its last frame ends. EndFrame() does nothing when no frame is open.
+  void BeginFrame();
+  void EndFrame();
+
+  // Record a span of the calling thread, see Scope.
+  void AddSpan(const char* name, double start, double end, int tile = -1);
+
+  // GPU spans do not nest across tiles but may nest in each other. The
+  // context must be current and stay the same until the capture ends.
+  void BeginGPUSpan(const char* name, int tile = -1);
+  void EndGPUSpan();
+
+  // Set a counter on the track with the given name.
+  void SetCounter(const char* track, const char* name, double value);
+
+  // Count the props rendered by the tile and, with an occlusion query, the
+  // samples that passed the depth test. The samples are only counted when
+  // no renderer uses depth peeling, which has its own occlusion queries.
+  void BeginTile(int tile, vtkRendererCollection* renderers);
+  void EndTile(int tile, vtkRendererCollection* renderers);
+
+  // Name the calling thread in the trace.
+  void SetThreadName(const char* name);
+
+  // Microseconds since the start of the capture.
+  double Now() const;
+
+  // Records a span of the calling thread from its construction to its
+  // destruction.
+  class Scope
+  {
+  public:
+    Scope(const char* name, int tile = -1)
+      : Name(name)
+      , Tile(tile)
+      , Start(-1.0)
+    {
+      vtkLookingGlassTracer& tracer = vtkLookingGlassTracer::GetInstance();
+      if (tracer.IsCapturing())
+      {
+        this->Start = tracer.Now();
+      }
+    }
+    ~Scope()
+    {
+      vtkLookingGlassTracer& tracer = vtkLookingGlassTracer::GetInstance();
+      if (this->Start >= 0.0 && tracer.IsCapturing())
+      {
+        tracer.AddSpan(this->Name, this->Start, tracer.Now(), this->Tile);
+      }
+    }
+
+  private:
+    const char* Name;
+    int Tile;
+    double Start;
+  };
+
+private:
+  vtkLookingGlassTracer() = default;
+  ~vtkLookingGlassTracer();
+  vtkLookingGlassTracer(const vtkLookingGlassTracer&) = delete;
+  void operator=(const vtkLookingGlassTracer&) = delete;
+
+  struct Event
+  {
+    char Phase; // 'X' for spans, 'C' for counters
+    std::string Name;
+    int Thread;
+    double Start;
+    double Duration;
+    std::vector<std::pair<std::string, double>> Args;
+  };
+
+  struct GPUSpan
+  {
+    std::string Name;
+    int Tile;
+    vtkOpenGLRenderTimer* Timer;
+  };
+
+  struct SampleQuery
+  {
+    int Tile;
+    double Time;
+    int Props;
+    unsigned int Query;
+  };
+
+  int GetThreadIndex();
+  void PollQueries(bool wait);
+  bool Write();
+  void Clear();
+
+  std::atomic<bool> Capturing{ false };
+  mutable std::mutex Mutex;
+  std::string FileName;
+  int NumberOfFrames = 0;
+  int FramesDone = 0;
+  bool FrameOpen = false;
+  double FrameStart = 0.0;
+  std::chrono::steady_clock::time_point Origin;
+
+  std::vector<Event> Events;
+  std::map<std::thread::id, int> Threads;
+  std::vector<std::string> ThreadNames;
+
+  // GPU timestamps are in nanoseconds since an arbitrary origin, the offset
+  // maps them to the capture clock, measured at the first GPU span
+  bool HaveGPUOffset = false;
+  double GPUOffset = 0.0;
+  std::vector<GPUSpan> OpenGPUSpans;
+  std::deque<GPUSpan> GPUQueries;
+  std::vector<vtkOpenGLRenderTimer*> FreeTimers;
+  unsigned int ActiveSampleQuery = 0;
+  std::deque<SampleQuery> SampleQueries;
+};
+
+#endif
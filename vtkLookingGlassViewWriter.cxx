@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLookingGlassViewWriter.h"
+
+#include "vtkLookingGlassTrace.h"
+
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <cstdio>
+
+namespace
+{
+const int NumberOfChunks = 2;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassViewWriter::~vtkLookingGlassViewWriter()
+{
+  this->End();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassViewWriter::Start(
+  const std::string& directory, int numberOfViews, int width, int height, bool depth)
+{
+  this->End();
+
+  if (!vtksys::SystemTools::MakeDirectory(directory))
+  {
+    return false;
+  }
+
+  this->Directory = directory;
+  this->NumberOfViews = numberOfViews;
+  this->Width = width;
+  this->Height = height;
+  this->WithDepth = depth;
+  this->Failed = false;
+
+  const size_t pixels = static_cast<size_t>(numberOfViews) * width * height;
+  this->Chunks.resize(NumberOfChunks);
+  for (Chunk& chunk : this->Chunks)
+  {
+    chunk.Colors.resize(pixels * 3);
+    chunk.Depth.resize(depth ? pixels : 0);
+    chunk.Matrices.resize(static_cast<size_t>(numberOfViews) * 32);
+    this->Free.push_back(&chunk);
+  }
+
+  this->Thread = std::thread(&vtkLookingGlassViewWriter::WriteLoop, this);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkLookingGlassViewWriter::Chunk* vtkLookingGlassViewWriter::TakeChunk()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->Condition.wait(lock, [this] { return !this->Free.empty(); });
+  Chunk* chunk = this->Free.front();
+  this->Free.pop_front();
+  return chunk;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassViewWriter::WriteChunk(Chunk* chunk)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Ready.push_back(chunk);
+  this->Condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassViewWriter::End()
+{
+  if (this->Thread.joinable())
+  {
+    this->WriteChunk(nullptr);
+    this->Thread.join();
+  }
+  this->Free.clear();
+  this->Ready.clear();
+  this->Chunks.clear();
+  return !this->Failed;
+}
+
+//------------------------------------------------------------------------------
+void vtkLookingGlassViewWriter::WriteLoop()
+{
+  vtkLookingGlassTraceThreadName("View writer");
+  while (true)
+  {
+    Chunk* chunk;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Condition.wait(lock, [this] { return !this->Ready.empty(); });
+      chunk = this->Ready.front();
+      this->Ready.pop_front();
+    }
+    if (!chunk)
+    {
+      return;
+    }
+
+    bool written;
+    {
+      vtkLookingGlassTraceScope("WriteViews");
+      written = this->Write(*chunk);
+    }
+
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Failed = this->Failed || !written;
+    this->Free.push_back(chunk);
+    this->Condition.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassViewWriter::Write(const Chunk& chunk)
+{
+  char index[16];
+  std::snprintf(index, sizeof(index), "%06d", chunk.Index);
+  const std::string prefix = this->Directory + "/";
+  const size_t views = this->NumberOfViews;
+  const size_t width = this->Width;
+  const size_t height = this->Height;
+
+  bool ok = WriteArray(prefix + "views_" + index + ".npy", "|u1", { views, height, width, 3 },
+    chunk.Colors.data(), chunk.Colors.size());
+  if (this->WithDepth)
+  {
+    ok = WriteArray(prefix + "depth_" + index + ".npy", "<f4", { views, height, width },
+           chunk.Depth.data(), chunk.Depth.size() * sizeof(float)) &&
+      ok;
+  }
+  ok = WriteArray(prefix + "matrices_" + index + ".npy", "<f8", { views, 2, 4, 4 },
+         chunk.Matrices.data(), chunk.Matrices.size() * sizeof(double)) &&
+    ok;
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+bool vtkLookingGlassViewWriter::WriteArray(const std::string& fileName, const char* descr,
+  const std::vector<size_t>& shape, const void* data, size_t size)
+{
+  std::string header = std::string("{'descr': '") + descr + "', 'fortran_order': False, 'shape': (";
+  for (size_t i = 0; i < shape.size(); ++i)
+  {
+    header += std::to_string(shape[i]) + (shape.size() == 1 || i + 1 < shape.size() ? "," : "");
+    header += i + 1 < shape.size() ? " " : "";
+  }
+  header += "), }";
+
+  // version 1.0 of the format, the header is padded with spaces so that the
+  // data starts on a multiple of 64 bytes
+  const size_t preamble = 10;
+  header.append(63 - (preamble + header.size()) % 64, ' ');
+  header += '\n';
+
+  vtksys::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  const unsigned char magic[8] = { 0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0 };
+  const unsigned char length[2] = { static_cast<unsigned char>(header.size() & 0xff),
+    static_cast<unsigned char>(header.size() >> 8) };
+  file.write(reinterpret_cast<const char*>(magic), sizeof(magic));
+  file.write(reinterpret_cast<const char*>(length), sizeof(length));
+  file << header;
+  file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  return static_cast<bool>(file);
+}
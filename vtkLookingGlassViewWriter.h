@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLookingGlassViewWriter
+ * @brief   Write the views rendered for a set of cameras as NumPy files.
+ *
+ * This is a helper for vtkLookingGlassInterface::RenderViews(). Each camera
+ * gets a chunk holding its views, optionally their depth, and the view and
+ * projection matrices of each view. The chunks are written on a background
+ * thread as `.npy` files while the next camera renders, see
+ * RenderViews() for the file layout. It does not touch OpenGL.
+ */
+
+#ifndef vtkLookingGlassViewWriter_h
+#define vtkLookingGlassViewWriter_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class vtkLookingGlassViewWriter
+{
+public:
+  struct Chunk
+  {
+    int Index = 0;
+    // views x height x width x 3, top row first
+    std::vector<unsigned char> Colors;
+    // views x height x width, top row first, empty without depth
+    std::vector<float> Depth;
+    // views x 2 x 4 x 4, the view then the projection matrix, row major
+    std::vector<double> Matrices;
+  };
+
+  vtkLookingGlassViewWriter() = default;
+  ~vtkLookingGlassViewWriter();
+
+  // Create the directory if needed and start the writing thread. Returns
+  // false if the directory cannot be created.
+  bool Start(const std::string& directory, int numberOfViews, int width, int height, bool depth);
+
+  // Wait for a chunk that is free to fill, sized for the settings of
+  // Start(). The writer falls behind by at most two chunks.
+  Chunk* TakeChunk();
+
+  // Queue a filled chunk for writing.
+  void WriteChunk(Chunk* chunk);
+
+  // Wait for the queued chunks to be written and stop the thread. Returns
+  // false if any file could not be written.
+  bool End();
+
+  // Write a single array as a `.npy` file. `descr` is the NumPy type
+  // description, such as "|u1" or "<f4".
+  static bool WriteArray(const std::string& fileName, const char* descr,
+    const std::vector<size_t>& shape, const void* data, size_t size);
+
+private:
+  void WriteLoop();
+  bool Write(const Chunk& chunk);
+
+  std::string Directory;
+  int NumberOfViews = 0;
+  int Width = 0;
+  int Height = 0;
+  bool WithDepth = false;
+  bool Failed = false;
+
+  std::thread Thread;
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::vector<Chunk> Chunks;
+  std::deque<Chunk*> Free;
+  // a null chunk stops the thread
+  std::deque<Chunk*> Ready;
+};
+
+#endif
@@ -0,0 +1,16 @@
+/*=========================================================================
+
+  Copyright (c) 2020 Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkOSOpenGLLookingGlassRenderWindow.h"
+
+#define vtkLookingGlassHeadless
+#define className vtkOSOpenGLLookingGlassRenderWindow
+#include "vtkLookingGlassRenderWindowImpl.h"